@@ -0,0 +1,208 @@
+package bench
+
+import (
+	"circuit/element"
+	_ "circuit/element/base"
+	"circuit/element/time"
+	"circuit/load"
+	"circuit/maths"
+	"runtime"
+	"runtime/metrics"
+	"testing"
+)
+
+// heapSampler 在仿真回调中周期性采样堆对象字节数，记录峰值。
+type heapSampler struct {
+	sample []metrics.Sample
+	peak   uint64
+	calls  int
+}
+
+// newHeapSampler 创建堆采样器，并以当前值作为初始峰值。
+func newHeapSampler() *heapSampler {
+	h := &heapSampler{sample: []metrics.Sample{{Name: "/memory/classes/heap/objects:bytes"}}}
+	h.read()
+	return h
+}
+
+// read 读取一次堆对象字节数。
+func (h *heapSampler) read() {
+	metrics.Read(h.sample)
+	if h.sample[0].Value.Kind() == metrics.KindUint64 {
+		if v := h.sample[0].Value.Uint64(); v > h.peak {
+			h.peak = v
+		}
+	}
+}
+
+// step 每 64 次回调采样一次。
+func (h *heapSampler) step() {
+	h.calls++
+	if h.calls&63 == 0 {
+		h.read()
+	}
+}
+
+// loadCircuit 加载电路并设置仿真时间。
+func loadCircuit(tb testing.TB, c Circuit, target float64) *element.Context {
+	tb.Helper()
+	con, err := load.LoadString(c.Netlist)
+	if err != nil {
+		tb.Fatalf("%s: 加载上下文失败: %s", c.Name, err)
+	}
+	con.Time, err = time.NewTimeMNA(target)
+	if err != nil {
+		tb.Fatalf("%s: 创建仿真时间失败 %s", c.Name, err)
+	}
+	return con
+}
+
+// runTransient 执行一次瞬态仿真，返回接受的时间步数。
+func runTransient(tb testing.TB, con *element.Context, name string, heap *heapSampler) int {
+	tb.Helper()
+	steps := 0
+	if err := time.TransientSimulation(con, func(voltages []float64) {
+		steps++
+		if heap != nil {
+			heap.step()
+		}
+	}); err != nil {
+		tb.Fatalf("%s: 仿真失败 %s", name, err)
+	}
+	return steps
+}
+
+// benchmarkTransient 基准测试瞬态仿真，报告时间步速率与峰值堆内存。
+func benchmarkTransient(b *testing.B, c Circuit, opts *element.ParallelOptions) {
+	b.ReportAllocs()
+	runtime.GC()
+	heap := newHeapSampler()
+	totalSteps := 0
+	for i := 0; i < b.N; i++ {
+		b.StopTimer()
+		con := loadCircuit(b, c, c.Target)
+		con.ParallelOpts = opts
+		b.StartTimer()
+		totalSteps += runTransient(b, con, c.Name, heap)
+	}
+	heap.read()
+	b.ReportMetric(float64(totalSteps)/b.Elapsed().Seconds(), "steps/s")
+	b.ReportMetric(float64(totalSteps)/float64(b.N), "steps/op")
+	b.ReportMetric(float64(heap.peak), "peak-heap-B")
+}
+
+// TestSuite 冒烟测试：最小规模的每个电路都能加载并完成短时仿真。
+func TestSuite(t *testing.T) {
+	for _, c := range Suite(true) {
+		t.Run(c.Name, func(t *testing.T) {
+			con := loadCircuit(t, c, 2e-5)
+			if steps := runTransient(t, con, c.Name, nil); steps == 0 {
+				t.Fatalf("没有完成任何时间步")
+			}
+		})
+	}
+}
+
+// BenchmarkLoad 基准测试网表解析、子电路展开与上下文构建。
+func BenchmarkLoad(b *testing.B) {
+	for _, c := range Suite(false) {
+		b.Run(c.Name, func(b *testing.B) {
+			b.ReportAllocs()
+			b.SetBytes(int64(len(c.Netlist)))
+			for i := 0; i < b.N; i++ {
+				if _, err := load.LoadString(c.Netlist); err != nil {
+					b.Fatalf("加载上下文失败: %s", err)
+				}
+			}
+		})
+	}
+}
+
+// BenchmarkDC 基准测试直流工作点：仅求解 t=0 的首个时间步（复位、加盖与牛顿迭代）。
+func BenchmarkDC(b *testing.B) {
+	for _, c := range Suite(false) {
+		b.Run(c.Name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				con := loadCircuit(b, c, 1e-6)
+				b.StartTimer()
+				runTransient(b, con, c.Name, nil)
+			}
+		})
+	}
+}
+
+// BenchmarkTransient 基准测试串行瞬态仿真。
+func BenchmarkTransient(b *testing.B) {
+	for _, c := range Suite(false) {
+		b.Run(c.Name, func(b *testing.B) {
+			benchmarkTransient(b, c, nil)
+		})
+	}
+}
+
+// BenchmarkParallel 对比串行与不同 ParallelOptions 配置下的瞬态仿真。
+func BenchmarkParallel(b *testing.B) {
+	configs := []struct {
+		name string
+		opts *element.ParallelOptions
+	}{
+		{"serial", nil},
+		{"workers=1", &element.ParallelOptions{StampWorkers: 1}},
+		{"workers=2", &element.ParallelOptions{StampWorkers: 2}},
+		{"workers=4", &element.ParallelOptions{StampWorkers: 4}},
+		{"workers=4/cache", &element.ParallelOptions{StampWorkers: 4, CacheThreshold: 1e-9}},
+	}
+	for _, c := range Suite(false) {
+		for _, cfg := range configs {
+			b.Run(c.Name+"/"+cfg.name, func(b *testing.B) {
+				benchmarkTransient(b, c, cfg.opts)
+			})
+		}
+	}
+}
+
+// BenchmarkLU 在各电路首个牛顿迭代的 MNA 矩阵上对比各 LU 实现的分解与求解。
+func BenchmarkLU(b *testing.B) {
+	variants := []struct {
+		name string
+		new  func(n int) (maths.LU[float64], error)
+	}{
+		{"dense", maths.NewLU[float64]},
+		{"sparse", maths.NewLUSparse[float64]},
+		{"block", maths.NewLUBlock[float64]},
+		{"parallel=4", func(n int) (maths.LU[float64], error) { return maths.NewParallelLU[float64](n, 4) }},
+	}
+	for _, c := range Suite(false) {
+		con := loadCircuit(b, c, c.Target)
+		con.CallMark(element.MarkReset)
+		con.CallMark(element.MarkStartIteration)
+		con.CallMark(element.MarkStamp)
+		con.Update()
+		con.CallMark(element.MarkDoStep)
+		n := con.GetNodeNum() + con.GetVoltageSourcesNum()
+		for _, v := range variants {
+			b.Run(c.Name+"/"+v.name, func(b *testing.B) {
+				lu, err := v.new(n)
+				if err != nil {
+					b.Fatalf("创建 LU 求解器失败: %s", err)
+				}
+				// 部分实现不做主元选取，无法分解含零对角元的矩阵时跳过
+				if err := lu.Decompose(con.GetA()); err != nil {
+					b.Skipf("%s 无法分解该矩阵: %s", v.name, err)
+				}
+				b.ReportAllocs()
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					if err := lu.Decompose(con.GetA()); err != nil {
+						b.Fatalf("矩阵分解失败: %s", err)
+					}
+					if err := lu.SolveReuse(con.GetZ(), con.GetX()); err != nil {
+						b.Fatalf("方程求解失败: %s", err)
+					}
+				}
+			})
+		}
+	}
+}
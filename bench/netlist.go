@@ -0,0 +1,203 @@
+// Package bench 提供规模可调的代表性电路网表，用于端到端性能基准测试。
+// 网表覆盖线性 RC 网络、二极管整流、三极管放大、门级计数器、变压器/电机驱动与多层嵌套子电路，
+// 配合 bench_test.go 中的基准测试捕获加载、求解与并行加盖的性能回退。
+package bench
+
+import (
+	"fmt"
+	"strings"
+)
+
+// Circuit 基准测试电路。
+type Circuit struct {
+	Name    string  // 电路名称（含规模），用作子基准名。
+	Netlist string  // 网表文本。
+	Target  float64 // 瞬态仿真目标时间（秒）。
+}
+
+// netlistBuilder 网表构建辅助，负责分配节点编号与元件编号。
+type netlistBuilder struct {
+	b     strings.Builder
+	node  int            // 下一个可用节点编号。
+	index map[string]int // 元件类型 → 下一个元件编号。
+}
+
+// newBuilder 创建网表构建器，节点编号从 0 开始。
+func newBuilder() *netlistBuilder {
+	return &netlistBuilder{index: make(map[string]int)}
+}
+
+// newNode 分配一个新节点编号。
+func (nb *netlistBuilder) newNode() int {
+	n := nb.node
+	nb.node++
+	return n
+}
+
+// add 追加一个元件，pins 为引脚节点，values 为参数（为空时省略参数列表）。
+func (nb *netlistBuilder) add(typ string, pins []int, values ...any) {
+	nb.index[typ]++
+	fmt.Fprintf(&nb.b, "%s%d [", typ, nb.index[typ])
+	for i, p := range pins {
+		if i > 0 {
+			nb.b.WriteByte(',')
+		}
+		fmt.Fprintf(&nb.b, "%d", p)
+	}
+	nb.b.WriteByte(']')
+	if len(values) > 0 {
+		nb.b.WriteString(" [")
+		for i, v := range values {
+			if i > 0 {
+				nb.b.WriteByte(',')
+			}
+			fmt.Fprint(&nb.b, v)
+		}
+		nb.b.WriteByte(']')
+	}
+	nb.b.WriteByte('\n')
+}
+
+// line 追加原始文本行（子电路定义等）。
+func (nb *netlistBuilder) line(format string, args ...any) {
+	fmt.Fprintf(&nb.b, format, args...)
+	nb.b.WriteByte('\n')
+}
+
+// String 返回网表文本。
+func (nb *netlistBuilder) String() string {
+	return nb.b.String()
+}
+
+// gnd 地节点。
+const gnd = -1
+
+// RCLadder 生成 n 节 RC 梯形网络，由 1kHz 正弦源驱动。
+// 元件数 2n+1，纯线性电路，主要衡量加盖与 LU 求解开销。
+func RCLadder(n int) Circuit {
+	nb := newBuilder()
+	in := nb.newNode()
+	nb.add("v", []int{in, gnd}, 1, 0, 1000, 0, 5)
+	prev := in
+	for range n {
+		next := nb.newNode()
+		nb.add("r", []int{prev, next}, 100)
+		nb.add("c", []int{next, gnd}, 1e-7)
+		prev = next
+	}
+	return Circuit{Name: fmt.Sprintf("RCLadder/n=%d", n), Netlist: nb.String(), Target: 2e-4}
+}
+
+// DiodeBridge 生成 n 组独立的全桥整流电路，每组带滤波电容与负载。
+// 每组 4 个二极管，衡量非线性元件的牛顿迭代开销。
+func DiodeBridge(n int) Circuit {
+	nb := newBuilder()
+	for range n {
+		ac, pos, neg := nb.newNode(), nb.newNode(), nb.newNode()
+		nb.add("v", []int{ac, gnd}, 1, 0, 50, 0, 10)
+		nb.add("d", []int{ac, pos}, 1e-14, 0.0, 1.0, 0.1, 300.15)
+		nb.add("d", []int{gnd, pos}, 1e-14, 0.0, 1.0, 0.1, 300.15)
+		nb.add("d", []int{neg, ac}, 1e-14, 0.0, 1.0, 0.1, 300.15)
+		nb.add("d", []int{neg, gnd}, 1e-14, 0.0, 1.0, 0.1, 300.15)
+		nb.add("r", []int{pos, neg}, 1000)
+		nb.add("c", []int{pos, neg}, 1e-5)
+		nb.add("r", []int{neg, gnd}, 1e6)
+	}
+	return Circuit{Name: fmt.Sprintf("DiodeBridge/n=%d", n), Netlist: nb.String(), Target: 2e-4}
+}
+
+// BJTAmplifier 生成 n 级电容耦合的共射放大器级联。
+// 每级含分压偏置、集电极/发射极电阻与耦合电容，衡量三极管模型开销。
+func BJTAmplifier(n int) Circuit {
+	nb := newBuilder()
+	vcc, in := nb.newNode(), nb.newNode()
+	nb.add("v", []int{vcc, gnd}, 0, 0, 0, 0, 12)
+	nb.add("v", []int{in, gnd}, 1, 0, 1000, 0, 0.01)
+	prev := in
+	for range n {
+		b, c, e := nb.newNode(), nb.newNode(), nb.newNode()
+		nb.add("c", []int{prev, b}, 1e-5)
+		nb.add("r", []int{vcc, b}, 47000)
+		nb.add("r", []int{b, gnd}, 10000)
+		nb.add("r", []int{vcc, c}, 2200)
+		nb.add("r", []int{e, gnd}, 470)
+		nb.add("q", []int{b, c, e}, false, 100.0)
+		prev = c
+	}
+	nb.add("r", []int{prev, gnd}, 10000)
+	return Circuit{Name: fmt.Sprintf("BJTAmplifier/n=%d", n), Netlist: nb.String(), Target: 2e-4}
+}
+
+// GateCounter 生成 n 位异步行波计数器（D 触发器 Q̄ 反馈到 D），
+// 并用与门/异或门对相邻位做译码，衡量布尔元件与电压源型输出的开销。
+func GateCounter(n int) Circuit {
+	nb := newBuilder()
+	clk := nb.newNode()
+	nb.add("v", []int{clk, gnd}, 2, 2.5, 100000, 0, 2.5, 0.5)
+	qs := make([]int, n)
+	for i := range n {
+		q, nq := nb.newNode(), nb.newNode()
+		nb.add("f", []int{clk, nq, q, nq}, 5.0)
+		qs[i] = q
+		clk = nq
+	}
+	for i := 0; i+1 < n; i++ {
+		and, xor := nb.newNode(), nb.newNode()
+		nb.add("u", []int{qs[i], qs[i+1], and}, 1, 5.0)
+		nb.add("u", []int{qs[i], qs[i+1], xor}, 5, 5.0)
+		nb.add("r", []int{and, gnd}, 10000)
+		nb.add("r", []int{xor, gnd}, 10000)
+	}
+	return Circuit{Name: fmt.Sprintf("GateCounter/n=%d", n), Netlist: nb.String(), Target: 1e-4}
+}
+
+// MotorDrive 生成 n 路变压器耦合的电机驱动：交流源经限流电阻接变压器原边，副边驱动直流电机。
+func MotorDrive(n int) Circuit {
+	nb := newBuilder()
+	for range n {
+		ac, p, s := nb.newNode(), nb.newNode(), nb.newNode()
+		nb.add("v", []int{ac, gnd}, 1, 0, 50, 0, 24)
+		nb.add("r", []int{ac, p}, 1)
+		nb.add("xfmr", []int{p, gnd, s, gnd}, 4.0, 0.5, 0.999)
+		nb.add("motor", []int{s, gnd}, 12.0, 1000.0, 0.1, 0.01, 0.05, 0.001, 0.01)
+	}
+	return Circuit{Name: fmt.Sprintf("MotorDrive/n=%d", n), Netlist: nb.String(), Target: 2e-4}
+}
+
+// NestedSubckt 生成 depth 层嵌套的子电路：第 0 层为 RC 单元，
+// 第 k 层由两个第 k-1 层实例串联而成，共展开 2^depth 个 RC 单元，衡量子电路展开与层级命名开销。
+func NestedSubckt(depth int) Circuit {
+	nb := newBuilder()
+	nb.line(".subckt cell0 a b")
+	nb.line("r1 [a,b] [100]")
+	nb.line("c1 [b,-1] [1e-7]")
+	nb.line(".ends cell0")
+	for k := 1; k <= depth; k++ {
+		nb.line(".subckt cell%d a b", k)
+		nb.line("x1 [a,m] cell%d", k-1)
+		nb.line("x2 [m,b] cell%d", k-1)
+		nb.line(".ends cell%d", k)
+	}
+	in, out := nb.newNode(), nb.newNode()
+	nb.add("v", []int{in, gnd}, 1, 0, 1000, 0, 5)
+	nb.line("x1 [%d,%d] cell%d", in, out, depth)
+	nb.add("r", []int{out, gnd}, 1000)
+	return Circuit{Name: fmt.Sprintf("NestedSubckt/depth=%d", depth), Netlist: nb.String(), Target: 2e-4}
+}
+
+// Suite 返回默认的基准电路集合，small 为 true 时只包含最小规模。
+func Suite(small bool) []Circuit {
+	sizes := []int{2, 4, 8}
+	depths := []int{1, 3, 5}
+	if small {
+		sizes, depths = sizes[:1], depths[:1]
+	}
+	var out []Circuit
+	for _, n := range sizes {
+		out = append(out, RCLadder(n), DiodeBridge(n), BJTAmplifier(n), GateCounter(n), MotorDrive(n))
+	}
+	for _, d := range depths {
+		out = append(out, NestedSubckt(d))
+	}
+	return out
+}
@@ -0,0 +1,60 @@
+package base
+
+import (
+	"circuit/element"
+	"circuit/element/time"
+	"circuit/load"
+	"testing"
+)
+
+// TestDiagnostics 验证不收敛诊断：限制牛顿迭代次数后，二极管应被记录为阻塞收敛的元件
+func TestDiagnostics(t *testing.T) {
+	netlist := `
+	v1 [in,-1]
+	r1 [in,out] [100]
+	d1 [out,-1] [1e-14,0.0,1.0,0.1,300.15]
+	`
+	con, err := load.LoadString(netlist)
+	if err != nil {
+		t.Fatalf("加载上下文失败: %s", err)
+	}
+	con.Time, err = time.NewTimeMNA(0.001)
+	if err != nil {
+		t.Fatalf("创建仿真时间失败 %s", err)
+	}
+	// 仅允许一次牛顿迭代，第一个时间步必然耗尽迭代次数
+	if err := con.SetIterationLimits(2, 1); err != nil {
+		t.Fatalf("设置迭代次数失败 %s", err)
+	}
+	con.Diagnostics = element.NewDiagnostics()
+	con.Diagnostics.MaxReports = 1 << 16
+
+	// 元件迭代耗尽时时间步被强制接受，仿真本身不会失败
+	if err := time.TransientSimulation(con, func(voltages []float64) {}); err != nil {
+		t.Fatalf("仿真失败 %s", err)
+	}
+
+	reports := con.Diagnostics.Reports
+	if len(reports) == 0 {
+		t.Fatalf("没有生成诊断报告")
+	}
+	// 二极管在电压变化较大的初始阶段调用 NoConverged
+	var blocked *element.ConvergenceReport
+	for i := range reports {
+		if !reports[i].Accepted {
+			t.Errorf("报告应标记为强制接受: %+v", reports[i])
+		}
+		for _, e := range reports[i].Elements {
+			if e.Name == "D#2" && e.Calls > 0 && len(e.Pins) == 2 && e.Pins[0] == "out" && e.Pins[1] == "gnd" {
+				blocked = &reports[i]
+			}
+		}
+	}
+	if blocked == nil {
+		t.Fatalf("未记录二极管阻塞收敛")
+	}
+	if len(blocked.Update) == 0 || len(blocked.Update) > 5 {
+		t.Errorf("更新量节点数量不正确: %+v", blocked.Update)
+	}
+	t.Log("\n" + blocked.String())
+}
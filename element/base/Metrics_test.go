@@ -0,0 +1,89 @@
+package base
+
+import (
+	"circuit/element"
+	"circuit/element/time"
+	"circuit/load"
+	"sync"
+	"testing"
+)
+
+// TestMetrics 验证仿真指标统计：RC 电路瞬态仿真后各计数器应与仿真流程一致
+func TestMetrics(t *testing.T) {
+	netlist := `
+	v1 [1,-1]
+	r1 [1,0] [100]
+	c1 [0,-1] [1e-6]
+	`
+	con, err := load.LoadString(netlist)
+	if err != nil {
+		t.Fatalf("加载上下文失败: %s", err)
+	}
+	con.Time, err = time.NewTimeMNA(0.001)
+	if err != nil {
+		t.Fatalf("创建仿真时间失败 %s", err)
+	}
+	con.Metrics = element.NewMetrics(true)
+
+	steps := 0
+	if err := time.TransientSimulation(con, func(voltages []float64) {
+		steps++
+	}); err != nil {
+		t.Fatalf("仿真失败 %s", err)
+	}
+
+	s := con.Metrics.Snapshot()
+	if s.Steps != uint64(steps) {
+		t.Errorf("接受步数不正确: 期望 %d, 实际 %d", steps, s.Steps)
+	}
+	if s.NewtonIters < s.Steps {
+		t.Errorf("牛顿迭代次数 %d 少于时间步数 %d", s.NewtonIters, s.Steps)
+	}
+	// 每次牛顿迭代与次级迭代各做一次 LU 分解
+	if s.Decompose != s.NewtonIters+s.ElemIters {
+		t.Errorf("LU 分解次数 %d, 牛顿 %d, 次级 %d", s.Decompose, s.NewtonIters, s.ElemIters)
+	}
+	var hist uint64
+	for i, n := range s.NewtonHist {
+		hist += n
+		if n > 0 && uint64(i) > s.MaxNewtonPerStep {
+			t.Errorf("牛顿迭代分布 %v 超出单步最大值 %d", s.NewtonHist, s.MaxNewtonPerStep)
+		}
+	}
+	if hist != s.Steps+s.RejectedSteps {
+		t.Errorf("牛顿迭代分布 %v 合计 %d, 时间步 %d 拒绝 %d", s.NewtonHist, hist, s.Steps, s.RejectedSteps)
+	}
+	if s.StepMin <= 0 || s.StepMin > s.StepMax {
+		t.Errorf("步长统计不正确: 最小 %v, 最大 %v", s.StepMin, s.StepMax)
+	}
+	if s.Marks["DoStep"].Calls < s.NewtonIters {
+		t.Errorf("DoStep 阶段调用次数 %d 少于牛顿迭代次数 %d", s.Marks["DoStep"].Calls, s.NewtonIters)
+	}
+	for _, name := range []string{"R", "C", "V"} {
+		if s.Elements[name].Calls == 0 {
+			t.Errorf("元件 %s 没有回调统计", name)
+		}
+	}
+	if s.RunTime <= 0 {
+		t.Errorf("仿真耗时未记录")
+	}
+	t.Log("\n" + s.String())
+}
+
+// TestMetricsNewtonHist 验证单步牛顿迭代分布与并发更新的单步最大值
+func TestMetricsNewtonHist(t *testing.T) {
+	m := element.NewMetrics(false)
+	var wg sync.WaitGroup
+	for _, iters := range []int{3, 1, 40, 3} {
+		wg.Add(1)
+		go func(iters int) {
+			defer wg.Done()
+			m.EndNewton(iters)
+		}(iters)
+	}
+	wg.Wait()
+	s := m.Snapshot()
+	if s.MaxNewtonPerStep != 40 || len(s.NewtonHist) != 10 || s.NewtonHist[1] != 1 || s.NewtonHist[3] != 2 || s.NewtonHist[9] != 1 {
+		t.Errorf("单步最大 %d, 分布 %v", s.MaxNewtonPerStep, s.NewtonHist)
+	}
+}
@@ -0,0 +1,57 @@
+package base
+
+import (
+	"circuit/element/time"
+	"circuit/load"
+	"math"
+	"testing"
+)
+
+// TestProbeSampler 验证探针采样：RC 充电电路的电容电压上升到电源电压，电容电流逐渐衰减
+func TestProbeSampler(t *testing.T) {
+	netlist := `
+	v1 [1,-1]
+	r1 [1,0] [100]
+	c1 [0,-1] [1e-6]
+	`
+	con, err := load.LoadString(netlist)
+	if err != nil {
+		t.Fatalf("加载上下文失败: %s", err)
+	}
+	con.Time, err = time.NewTimeMNA(0.1)
+	if err != nil {
+		t.Fatalf("创建仿真时间失败 %s", err)
+	}
+	capacitor := con.Nodelist[2]
+	var times, volts, currents, drops []float64
+	call := time.Sampler(con, func(t float64, values []float64) {
+		times = append(times, t)
+		volts = append(volts, values[0])
+		currents = append(currents, values[1])
+		drops = append(drops, values[2])
+	}, time.NodeVoltage(0), time.BranchCurrent(capacitor, 0), time.DifferentialVoltage(1, 0))
+	if err := time.TransientSimulation(con, call); err != nil {
+		t.Fatalf("仿真失败 %s", err)
+	}
+	if len(times) < 10 {
+		t.Fatalf("只采样了 %d 步", len(times))
+	}
+	for i := 1; i < len(times); i++ {
+		if times[i] <= times[i-1] {
+			t.Fatalf("第 %d 步时间 %g 不大于上一步 %g", i, times[i], times[i-1])
+		}
+	}
+	if v := volts[len(volts)-1]; math.Abs(v-5) > 0.1 {
+		t.Errorf("电容最终电压 %g，期望 5", v)
+	}
+	first, last := math.Abs(currents[0]), math.Abs(currents[len(currents)-1])
+	if first < 1e-3 || last > first*0.01 {
+		t.Errorf("电容电流没有衰减: 开始 %g，结束 %g", first, last)
+	}
+	// 电阻两端电压等于电流乘以电阻
+	for i := range drops {
+		if math.Abs(math.Abs(drops[i])-100*math.Abs(currents[i])) > 0.05 {
+			t.Fatalf("第 %d 步电阻电压 %g，电流 %g", i, drops[i], currents[i])
+		}
+	}
+}
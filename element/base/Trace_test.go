@@ -0,0 +1,111 @@
+package base
+
+import (
+	"bytes"
+	"circuit/element"
+	"circuit/element/time"
+	"circuit/load"
+	"encoding/json"
+	"sync"
+	"testing"
+)
+
+// TestTracer 验证求解阶段追踪：并行模式下应记录各阶段、LU 与并行分片区间，并能导出 Chrome trace JSON
+func TestTracer(t *testing.T) {
+	netlist := `
+	v1 [1,-1]
+	r1 [1,0] [100]
+	c1 [0,-1] [1e-6]
+	`
+	con, err := load.LoadString(netlist)
+	if err != nil {
+		t.Fatalf("加载上下文失败: %s", err)
+	}
+	con.Time, err = time.NewTimeMNA(0.0001)
+	if err != nil {
+		t.Fatalf("创建仿真时间失败 %s", err)
+	}
+	con.ParallelOpts = &element.ParallelOptions{StampWorkers: 2}
+	con.Tracer = element.NewTracer(1 << 10)
+
+	if err := time.TransientSimulation(con, func(voltages []float64) {}); err != nil {
+		t.Fatalf("仿真失败 %s", err)
+	}
+	if con.Tracer.Len() != 1<<10 {
+		t.Errorf("环形缓冲区应已写满: %d", con.Tracer.Len())
+	}
+
+	var buf bytes.Buffer
+	if err := con.Tracer.WriteChromeTrace(&buf); err != nil {
+		t.Fatalf("导出追踪失败: %s", err)
+	}
+	var trace struct {
+		TraceEvents []struct {
+			Name string  `json:"name"`
+			Ph   string  `json:"ph"`
+			Dur  float64 `json:"dur"`
+			Tid  int     `json:"tid"`
+		} `json:"traceEvents"`
+	}
+	if err := json.Unmarshal(buf.Bytes(), &trace); err != nil {
+		t.Fatalf("解析追踪 JSON 失败: %s", err)
+	}
+	seen := map[string]bool{}
+	for _, ev := range trace.TraceEvents {
+		if ev.Ph != "X" || ev.Dur < 0 {
+			t.Fatalf("无效的追踪事件: %+v", ev)
+		}
+		if ev.Name == "DoStep chunk" && ev.Tid < 1 {
+			t.Errorf("并行分片应使用工作线程编号: %+v", ev)
+		}
+		seen[ev.Name] = true
+	}
+	for _, name := range []string{"DoStep", "DoStep chunk", "Decompose", "SolveReuse", "CalculateMNAResidual", "UpdateElements"} {
+		if !seen[name] {
+			t.Errorf("缺少追踪区间 %s", name)
+		}
+	}
+}
+
+// TestTracerConcurrent 验证多个协程并发写入并反复绕回环形缓冲区时没有数据竞争，导出的区间完整有效
+func TestTracerConcurrent(t *testing.T) {
+	tr := element.NewTracer(16)
+	const writers, spans = 8, 2000
+	var wg sync.WaitGroup
+	for w := 1; w <= writers; w++ {
+		wg.Add(1)
+		go func(tid int) {
+			defer wg.Done()
+			for i := 0; i < spans; i++ {
+				tr.End(tr.Begin(), "span", tid)
+			}
+		}(w)
+	}
+	wg.Wait()
+	var buf bytes.Buffer
+	if err := tr.WriteChromeTrace(&buf); err != nil {
+		t.Fatalf("导出追踪失败: %s", err)
+	}
+	var trace struct {
+		TraceEvents []struct {
+			Name string `json:"name"`
+			Tid  int    `json:"tid"`
+		} `json:"traceEvents"`
+	}
+	if err := json.Unmarshal(buf.Bytes(), &trace); err != nil {
+		t.Fatalf("解析追踪 JSON 失败: %s", err)
+	}
+	if len(trace.TraceEvents)+int(tr.Dropped()) < 16 || len(trace.TraceEvents) > 16 {
+		t.Fatalf("导出 %d 个区间，丢弃 %d", len(trace.TraceEvents), tr.Dropped())
+	}
+	for _, ev := range trace.TraceEvents {
+		if ev.Name != "span" || ev.Tid < 1 || ev.Tid > writers {
+			t.Fatalf("无效的追踪事件: %+v", ev)
+		}
+	}
+	tr.Reset()
+	tr.End(tr.Begin(), "after reset", 0)
+	if tr.Len() != 1 || tr.Dropped() != 0 {
+		t.Fatalf("重置后 %d 个区间，丢弃 %d", tr.Len(), tr.Dropped())
+	}
+}
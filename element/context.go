@@ -4,6 +4,7 @@ import (
 	"circuit/mna"
 	"log"
 	"sync"
+	"time"
 )
 
 // Context 上下文。
@@ -19,6 +20,9 @@ type Context struct {
 	cacheTime                   float64                      // 缓存时间戳。
 	cacheMu                     sync.Mutex                   // 缓存访问互斥锁。
 	HasReactive                 bool                         // 电路中包含储能元件（电容/电感）
+	Metrics                     *Metrics                     // 仿真指标统计，nil=不统计。
+	Tracer                      *Tracer                      // 求解阶段区间追踪，nil=不追踪。
+	Diagnostics                 *Diagnostics                 // 牛顿迭代不收敛诊断，nil=关闭。
 }
 
 // ComputeStateDerivative 基于当前 MNA 解和元件状态计算状态导数向量 dx/dt。
@@ -78,7 +82,15 @@ func (con *Context) GetHierarchicalNodeVoltage(path string) float64 {
 }
 
 // CallMark 统一调用。
+// 未挂载指标统计时每个元件回调只多一次分支判断，不取时间、不查询元件类型。
 func (con *Context) CallMark(mark Mark) {
+	if con.Metrics != nil {
+		defer con.Metrics.markDone(mark, time.Now())
+	}
+	timing := con.Metrics.elementTiming()
+	if con.Tracer != nil {
+		defer con.Tracer.End(con.Tracer.Begin(), mark.String(), 0)
+	}
 	switch mark {
 	case MarkReset:
 		for i := range con.Nodelist {
@@ -86,7 +98,13 @@ func (con *Context) CallMark(mark Mark) {
 			if !ok {
 				continue
 			}
-			elemFace.Reset(con.Nodelist[i])
+			if timing {
+				start := time.Now()
+				elemFace.Reset(con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.Reset(con.Nodelist[i])
+			}
 		}
 		con.MnaUpdateType.MnaType.A.Zero()
 		con.MnaUpdateType.MnaType.Z.Zero()
@@ -107,7 +125,13 @@ func (con *Context) CallMark(mark Mark) {
 			if !ok {
 				continue
 			}
-			elemFace.StartIteration(con, con.Time, con.Nodelist[i])
+			if timing {
+				start := time.Now()
+				elemFace.StartIteration(con, con.Time, con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.StartIteration(con, con.Time, con.Nodelist[i])
+			}
 		}
 	case MarkStamp:
 		for i := range con.Nodelist {
@@ -115,15 +139,32 @@ func (con *Context) CallMark(mark Mark) {
 			if !ok {
 				continue
 			}
-			elemFace.Stamp(con, con.Time, con.Nodelist[i])
+			if timing {
+				start := time.Now()
+				elemFace.Stamp(con, con.Time, con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.Stamp(con, con.Time, con.Nodelist[i])
+			}
 		}
 	case MarkDoStep:
+		// 诊断模式下通过探针记录调用 NoConverged 的元件
+		tm, probe := con.Diagnostics.doStepTime(con)
 		for i := range con.Nodelist {
 			elemFace, ok := ElementList[con.Nodelist[i].Base().NodeType]
 			if !ok {
 				continue
 			}
-			elemFace.DoStep(con, con.Time, con.Nodelist[i])
+			if probe != nil {
+				probe.elem = i
+			}
+			if timing {
+				start := time.Now()
+				elemFace.DoStep(con, tm, con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.DoStep(con, tm, con.Nodelist[i])
+			}
 		}
 	case MarkCalculateCurrent:
 		for i := range con.Nodelist {
@@ -131,7 +172,13 @@ func (con *Context) CallMark(mark Mark) {
 			if !ok {
 				continue
 			}
-			elemFace.CalculateCurrent(con, con.Time, con.Nodelist[i])
+			if timing {
+				start := time.Now()
+				elemFace.CalculateCurrent(con, con.Time, con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.CalculateCurrent(con, con.Time, con.Nodelist[i])
+			}
 		}
 	case MarkStepFinished:
 		for i := range con.Nodelist {
@@ -139,7 +186,13 @@ func (con *Context) CallMark(mark Mark) {
 			if !ok {
 				continue
 			}
-			elemFace.StepFinished(con, con.Time, con.Nodelist[i])
+			if timing {
+				start := time.Now()
+				elemFace.StepFinished(con, con.Time, con.Nodelist[i])
+				con.Metrics.elementDone(con.Nodelist[i].Base().NodeType, start)
+			} else {
+				elemFace.StepFinished(con, con.Time, con.Nodelist[i])
+			}
 		}
 	default:
 		log.Fatalf("未知 CallMark 操作: %d", mark)
@@ -0,0 +1,292 @@
+package element
+
+import (
+	"circuit/mna"
+	"fmt"
+	"math"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+)
+
+// BlockingElement 在未收敛时间步内调用过 NoConverged 的元件。
+type BlockingElement struct {
+	Index int      // 元件在 Context.Nodelist 中的下标。
+	Name  string   // 元件描述，如 "D#2"。
+	Pins  []string // 引脚所连节点名称。
+	Calls int      // 本时间步内调用 NoConverged 的次数。
+}
+
+// NodeNorm MNA 解向量中某一项的诊断数值。
+type NodeNorm struct {
+	Index int     // 解向量下标（节点电压在前，电压源支路电流在后）。
+	Name  string  // 层级节点名称或支路描述。
+	Value float64 // 残差或更新量的绝对值。
+}
+
+// ConvergenceReport 单个未收敛时间步的诊断报告。
+type ConvergenceReport struct {
+	Time         float64           // 仿真时间。
+	Step         float64           // 步长。
+	NewtonIters  int               // 已执行的牛顿迭代次数。
+	ResidualNorm float64           // 最后一次迭代的残差范数。
+	Accepted     bool              // 是否因元件迭代耗尽被强制接受（false 表示仿真因此失败）。
+	Elements     []BlockingElement // 调用 NoConverged 的元件，按调用次数降序。
+	Residual     []NodeNorm        // 残差 |A*X-Z| 最大的若干项。
+	Update       []NodeNorm        // 最后一次迭代更新量 |ΔX| 最大的若干项。
+}
+
+// Diagnostics 牛顿迭代不收敛诊断。
+// 挂载到 Context.Diagnostics 后，TransientSimulation 在牛顿迭代耗尽 MaxNonlinearIter 的时间步
+// 生成 ConvergenceReport，记录阻塞收敛的元件以及残差和更新量最大的节点。
+// 诊断模式会在每次迭代额外复制解向量并计算残差向量，仅用于排查问题。
+type Diagnostics struct {
+	TopNodes   int                 // 每份报告记录的节点数，<=0 时为 5。
+	MaxReports int                 // 保留的报告数上限，超出后丢弃最早的报告，<=0 时为 16。
+	Reports    []ConvergenceReport // 已生成的报告。
+
+	mu        sync.Mutex       // 保护 blockers（并行 DoStep 时并发写入）。
+	blockers  map[int]int      // 本时间步内元件下标 → NoConverged 调用次数。
+	prevX     []float64        // 求解前的解向量。
+	residual  []float64        // 最后一次迭代的残差向量。
+	update    []float64        // 最后一次迭代的更新量。
+	nodeNames map[int]string   // 解向量下标 → 名称，首次生成报告时建立。
+	probe     convergenceProbe // 串行 DoStep 复用的探针。
+}
+
+// NewDiagnostics 创建不收敛诊断。
+func NewDiagnostics() *Diagnostics {
+	return &Diagnostics{blockers: make(map[int]int)}
+}
+
+// timeFace mna.Time 的别名，嵌入时字段名不与 Time() 方法冲突。
+type timeFace = mna.Time
+
+// convergenceProbe 包装 mna.Time，记录调用 NoConverged 的元件后再转发。
+type convergenceProbe struct {
+	timeFace
+	diag *Diagnostics
+	elem int
+}
+
+// NoConverged 记录当前元件并标记未收敛。
+func (p *convergenceProbe) NoConverged() {
+	p.diag.addBlocker(p.elem)
+	p.timeFace.NoConverged()
+}
+
+// doStepTime 返回传给元件 DoStep 的时间接口：诊断关闭时为 con.Time，开启时为复用的探针。
+func (d *Diagnostics) doStepTime(con *Context) (mna.Time, *convergenceProbe) {
+	if d == nil {
+		return con.Time, nil
+	}
+	d.probe = convergenceProbe{timeFace: con.Time, diag: d}
+	return &d.probe, &d.probe
+}
+
+// addBlocker 记录一次 NoConverged 调用。
+func (d *Diagnostics) addBlocker(elem int) {
+	d.mu.Lock()
+	if d.blockers == nil {
+		d.blockers = make(map[int]int)
+	}
+	d.blockers[elem]++
+	d.mu.Unlock()
+}
+
+// BeginStep 开始新的时间步，清空本步的元件记录。
+func (d *Diagnostics) BeginStep() {
+	if d == nil {
+		return
+	}
+	d.mu.Lock()
+	clear(d.blockers)
+	d.mu.Unlock()
+}
+
+// BeforeSolve 在求解前保存解向量，用于计算本次迭代的更新量。
+func (d *Diagnostics) BeforeSolve(con *Context) {
+	if d == nil {
+		return
+	}
+	x := con.GetX()
+	n := x.Length()
+	if len(d.prevX) != n {
+		d.prevX = make([]float64, n)
+	}
+	for i := range n {
+		d.prevX[i] = x.Get(i)
+	}
+}
+
+// AfterResidual 在残差计算后记录残差向量与更新量。
+func (d *Diagnostics) AfterResidual(con *Context) {
+	if d == nil {
+		return
+	}
+	x, z := con.GetX(), con.GetZ()
+	ax := con.GetA().MatrixVectorMultiply(x)
+	n := x.Length()
+	if len(d.residual) != n {
+		d.residual = make([]float64, n)
+		d.update = make([]float64, n)
+	}
+	for i := range n {
+		d.residual[i] = math.Abs(ax.Get(i) - z.Get(i))
+		if i < len(d.prevX) {
+			d.update[i] = math.Abs(x.Get(i) - d.prevX[i])
+		}
+	}
+}
+
+// Record 为牛顿迭代耗尽的时间步生成报告并返回。
+// 参数newtonIters: 本时间步执行的牛顿迭代次数。
+// 参数accepted: 本时间步是否被强制接受。
+func (d *Diagnostics) Record(con *Context, newtonIters int, accepted bool) *ConvergenceReport {
+	if d == nil {
+		return nil
+	}
+	if d.nodeNames == nil {
+		d.nodeNames = buildNodeNames(con)
+	}
+	top := d.TopNodes
+	if top <= 0 {
+		top = 5
+	}
+	report := ConvergenceReport{
+		Time:         con.CurrentTime(),
+		Step:         con.CurrentStep(),
+		NewtonIters:  newtonIters,
+		ResidualNorm: con.ResidualNorm(),
+		Accepted:     accepted,
+		Residual:     d.topNodes(d.residual, top),
+		Update:       d.topNodes(d.update, top),
+	}
+	d.mu.Lock()
+	for idx, calls := range d.blockers {
+		report.Elements = append(report.Elements, d.describeElement(con, idx, calls))
+	}
+	d.mu.Unlock()
+	sort.Slice(report.Elements, func(i, j int) bool {
+		if report.Elements[i].Calls != report.Elements[j].Calls {
+			return report.Elements[i].Calls > report.Elements[j].Calls
+		}
+		return report.Elements[i].Index < report.Elements[j].Index
+	})
+
+	limit := d.MaxReports
+	if limit <= 0 {
+		limit = 16
+	}
+	if len(d.Reports) >= limit {
+		d.Reports = append(d.Reports[:0], d.Reports[len(d.Reports)-limit+1:]...)
+	}
+	d.Reports = append(d.Reports, report)
+	return &d.Reports[len(d.Reports)-1]
+}
+
+// topNodes 返回数值最大的 k 项。
+func (d *Diagnostics) topNodes(values []float64, k int) []NodeNorm {
+	out := make([]NodeNorm, 0, len(values))
+	for i, v := range values {
+		if v > 0 {
+			out = append(out, NodeNorm{Index: i, Name: d.nodeNames[i], Value: v})
+		}
+	}
+	sort.Slice(out, func(i, j int) bool { return out[i].Value > out[j].Value })
+	if len(out) > k {
+		out = out[:k]
+	}
+	return out
+}
+
+// describeElement 生成元件描述。
+func (d *Diagnostics) describeElement(con *Context, idx, calls int) BlockingElement {
+	be := BlockingElement{Index: idx, Name: elementLabel(con, idx), Calls: calls}
+	if idx < 0 || idx >= len(con.Nodelist) {
+		return be
+	}
+	for _, n := range con.Nodelist[idx].Base().Nodes {
+		if n < 0 {
+			be.Pins = append(be.Pins, "gnd")
+		} else {
+			be.Pins = append(be.Pins, d.nodeNames[int(n)])
+		}
+	}
+	return be
+}
+
+// elementLabel 返回元件的类型名与下标，如 "D#2"。
+func elementLabel(con *Context, idx int) string {
+	if idx < 0 || idx >= len(con.Nodelist) {
+		return "#" + strconv.Itoa(idx)
+	}
+	name := strconv.Itoa(int(con.Nodelist[idx].Type()))
+	if face, ok := ElementList[con.Nodelist[idx].Type()]; ok {
+		name = face.GetName()
+	}
+	return name + "#" + strconv.Itoa(idx)
+}
+
+// buildNodeNames 建立解向量下标到名称的映射。
+// 外部节点优先使用 HierarchicalNodeID 中最短的层级名，其次为网表中的原始编号；
+// 内部节点与电压源支路电流使用所属元件及其配置中的名称。
+func buildNodeNames(con *Context) map[int]string {
+	names := make(map[int]string, con.GetNodeNum()+con.GetVoltageSourcesNum())
+	for raw, compact := range con.CompactNodeID {
+		names[compact] = strconv.Itoa(int(raw))
+	}
+	hier := make(map[int]string, len(con.HierarchicalNodeID))
+	for path, id := range con.HierarchicalNodeID {
+		old, ok := hier[int(id)]
+		if !ok || len(path) < len(old) || (len(path) == len(old) && path < old) {
+			hier[int(id)] = path
+		}
+	}
+	for id, path := range hier {
+		names[id] = path
+	}
+	nodesNum := con.GetNodeNum()
+	for i, elem := range con.Nodelist {
+		base := elem.Base()
+		cfg := elem.Config()
+		label := elementLabel(con, i)
+		for j, n := range base.NodeInternal {
+			sub := strconv.Itoa(j)
+			if cfg != nil && j < len(cfg.Internal) {
+				sub = cfg.Internal[j]
+			}
+			names[int(n)] = label + "." + sub
+		}
+		for j, v := range base.VoltSource {
+			sub := strconv.Itoa(j)
+			if cfg != nil && j < len(cfg.Voltage) {
+				sub = cfg.Voltage[j]
+			}
+			names[nodesNum+int(v)] = "I(" + label + "." + sub + ")"
+		}
+	}
+	return names
+}
+
+// String 返回报告的可读文本。
+func (r *ConvergenceReport) String() string {
+	var b strings.Builder
+	state := "仿真失败"
+	if r.Accepted {
+		state = "强制接受"
+	}
+	fmt.Fprintf(&b, "时间 %.6e 步长 %.3e: 牛顿迭代 %d 次未收敛（%s），残差范数 %.3e\n",
+		r.Time, r.Step, r.NewtonIters, state, r.ResidualNorm)
+	for _, e := range r.Elements {
+		fmt.Fprintf(&b, "  元件 %s [%s] 调用 NoConverged %d 次\n", e.Name, strings.Join(e.Pins, ","), e.Calls)
+	}
+	for _, n := range r.Residual {
+		fmt.Fprintf(&b, "  残差 %-20s %.3e\n", n.Name, n.Value)
+	}
+	for _, n := range r.Update {
+		fmt.Fprintf(&b, "  更新 %-20s %.3e\n", n.Name, n.Value)
+	}
+	return b.String()
+}
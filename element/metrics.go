@@ -0,0 +1,346 @@
+package element
+
+import (
+	"expvar"
+	"fmt"
+	"math"
+	"sort"
+	"strings"
+	"sync/atomic"
+	"time"
+)
+
+// markNames Mark 阶段名称，用于指标输出。
+var markNames = [...]string{
+	MarkReset:            "Reset",
+	MarkStartIteration:   "StartIteration",
+	MarkStamp:            "Stamp",
+	MarkDoStep:           "DoStep",
+	MarkCalculateCurrent: "CalculateCurrent",
+	MarkStepFinished:     "StepFinished",
+	MarkUpdateElements:   "UpdateElements",
+	MarkRollbackElements: "RollbackElements",
+}
+
+// String 返回阶段名称。
+func (mark Mark) String() string {
+	if int(mark) < len(markNames) {
+		return markNames[mark]
+	}
+	return fmt.Sprintf("Mark(%d)", mark)
+}
+
+// newtonHistLen 单步牛顿迭代次数分布的桶数，最后一个桶累计所有更多次数的时间步。
+const newtonHistLen = 10
+
+// elementStat 单个元件类型的回调统计。
+type elementStat struct {
+	calls atomic.Uint64 // 回调次数。
+	nanos atomic.Int64  // 累计耗时（纳秒）。
+}
+
+// Metrics 仿真指标统计。
+// 挂载到 Context.Metrics 后由 CallMark 与 TransientSimulation 更新，nil 时不产生任何开销以外的判断。
+// 计数器均为原子变量，可在仿真运行时由其他协程（如 expvar HTTP 处理）读取。
+type Metrics struct {
+	ElementTiming bool // 是否统计每种元件类型的回调耗时（每次回调额外两次取时）。
+
+	steps          atomic.Uint64 // 接受的时间步数。
+	rejectedSteps  atomic.Uint64 // 被拒绝（残差不可接受）的时间步数。
+	newtonIters    atomic.Uint64 // 牛顿迭代总次数。
+	maxNewtonIters atomic.Uint64 // 单个时间步内的最大牛顿迭代次数。
+	elemIters      atomic.Uint64 // 元件次级迭代总次数。
+	decompose      atomic.Uint64 // LU 分解次数。
+	stepMin        atomic.Uint64 // 最小步长（float64 位模式）。
+	stepMax        atomic.Uint64 // 最大步长（float64 位模式）。
+	stepSum        atomic.Uint64 // 步长累加（float64 位模式）。
+	runNanos       atomic.Int64  // 仿真运行总耗时（纳秒）。
+	runStart       time.Time     // 当前仿真开始时间。
+
+	newtonHist [newtonHistLen]atomic.Uint64 // 单步牛顿迭代次数分布，下标为迭代次数。
+
+	markCalls [len(markNames)]atomic.Uint64 // 各阶段调用次数。
+	markNanos [len(markNames)]atomic.Int64  // 各阶段累计耗时（纳秒）。
+
+	elements map[NodeType]*elementStat // 各元件类型统计，创建时按 ElementList 预分配，之后只读。
+}
+
+// NewMetrics 创建仿真指标统计。
+// 参数elementTiming: 是否统计每种元件类型的回调耗时。
+func NewMetrics(elementTiming bool) *Metrics {
+	m := &Metrics{
+		ElementTiming: elementTiming,
+		elements:      make(map[NodeType]*elementStat, len(ElementList)),
+	}
+	for t := range ElementList {
+		m.elements[t] = &elementStat{}
+	}
+	m.Reset()
+	return m
+}
+
+// Reset 清零所有计数器。
+func (m *Metrics) Reset() {
+	if m == nil {
+		return
+	}
+	m.steps.Store(0)
+	m.rejectedSteps.Store(0)
+	m.newtonIters.Store(0)
+	m.maxNewtonIters.Store(0)
+	m.elemIters.Store(0)
+	m.decompose.Store(0)
+	m.stepMin.Store(math.Float64bits(math.Inf(1)))
+	m.stepMax.Store(0)
+	m.stepSum.Store(0)
+	m.runNanos.Store(0)
+	for i := range m.newtonHist {
+		m.newtonHist[i].Store(0)
+	}
+	for i := range m.markCalls {
+		m.markCalls[i].Store(0)
+		m.markNanos[i].Store(0)
+	}
+	for _, s := range m.elements {
+		s.calls.Store(0)
+		s.nanos.Store(0)
+	}
+}
+
+// BeginRun 标记一次仿真开始，清零计数器并开始计时。
+func (m *Metrics) BeginRun() {
+	if m == nil {
+		return
+	}
+	m.Reset()
+	m.runStart = time.Now()
+}
+
+// EndRun 标记一次仿真结束，记录总耗时。
+func (m *Metrics) EndRun() {
+	if m == nil {
+		return
+	}
+	m.runNanos.Store(int64(time.Since(m.runStart)))
+}
+
+// AddNewtonIter 记录一次牛顿迭代。
+func (m *Metrics) AddNewtonIter() {
+	if m != nil {
+		m.newtonIters.Add(1)
+	}
+}
+
+// EndNewton 记录一个时间步内的牛顿迭代次数，用于统计单步最大值与分布。
+func (m *Metrics) EndNewton(iters int) {
+	if m == nil {
+		return
+	}
+	storeMax(&m.maxNewtonIters, uint64(iters))
+	m.newtonHist[min(max(iters, 0), newtonHistLen-1)].Add(1)
+}
+
+// AddElemIter 记录一次元件次级迭代。
+func (m *Metrics) AddElemIter() {
+	if m != nil {
+		m.elemIters.Add(1)
+	}
+}
+
+// AddDecompose 记录一次 LU 分解。
+func (m *Metrics) AddDecompose() {
+	if m != nil {
+		m.decompose.Add(1)
+	}
+}
+
+// AddRejectedStep 记录一次被拒绝的时间步。
+func (m *Metrics) AddRejectedStep() {
+	if m != nil {
+		m.rejectedSteps.Add(1)
+	}
+}
+
+// AddStep 记录一次被接受的时间步及其步长。
+func (m *Metrics) AddStep(step float64) {
+	if m == nil {
+		return
+	}
+	m.steps.Add(1)
+	updateFloat(&m.stepMin, func(v float64) (float64, bool) { return step, step < v })
+	updateFloat(&m.stepMax, func(v float64) (float64, bool) { return step, step > v })
+	updateFloat(&m.stepSum, func(v float64) (float64, bool) { return v + step, true })
+}
+
+// storeMax 以 CAS 循环将 v 与当前值中的较大者写入 a，并发更新时不丢失最大值。
+func storeMax(a *atomic.Uint64, v uint64) {
+	for old := a.Load(); v > old; old = a.Load() {
+		if a.CompareAndSwap(old, v) {
+			return
+		}
+	}
+}
+
+// updateFloat 以 CAS 循环更新按位存储的 float64。
+// 参数:
+//   - a: float64 位模式的原子变量。
+//   - f: 由当前值计算新值，第二个返回值为 false 时不写入。
+func updateFloat(a *atomic.Uint64, f func(float64) (float64, bool)) {
+	for {
+		old := a.Load()
+		v, ok := f(math.Float64frombits(old))
+		if !ok || a.CompareAndSwap(old, math.Float64bits(v)) {
+			return
+		}
+	}
+}
+
+// markDone 结束阶段计时。
+func (m *Metrics) markDone(mark Mark, start time.Time) {
+	if m == nil || int(mark) >= len(m.markCalls) {
+		return
+	}
+	m.markCalls[mark].Add(1)
+	m.markNanos[mark].Add(int64(time.Since(start)))
+}
+
+// elementTiming 是否统计元件回调耗时。
+func (m *Metrics) elementTiming() bool {
+	return m != nil && m.ElementTiming
+}
+
+// elementDone 结束元件回调计时，仅在 elementTiming 为真时调用。
+func (m *Metrics) elementDone(t NodeType, start time.Time) {
+	if s := m.elements[t]; s != nil {
+		s.calls.Add(1)
+		s.nanos.Add(int64(time.Since(start)))
+	}
+}
+
+// PhaseStat 阶段或元件类型的调用统计。
+type PhaseStat struct {
+	Calls uint64        // 调用次数。
+	Time  time.Duration // 累计耗时。
+}
+
+// MetricsSnapshot 指标快照，字段均为普通值，可直接序列化为 JSON。
+type MetricsSnapshot struct {
+	Steps             uint64               // 接受的时间步数。
+	RejectedSteps     uint64               // 被拒绝的时间步数。
+	NewtonIters       uint64               // 牛顿迭代总次数。
+	MaxNewtonPerStep  uint64               // 单步最大牛顿迭代次数。
+	NewtonHist        []uint64             // 单步牛顿迭代次数分布：下标为迭代次数，最后一项累计更多次数，末尾的零已去除。
+	ElemIters         uint64               // 元件次级迭代总次数。
+	Decompose         uint64               // LU 分解次数。
+	StepMin           float64              // 最小步长。
+	StepMax           float64              // 最大步长。
+	StepMean          float64              // 平均步长。
+	RunTime           time.Duration        // 仿真总耗时（运行中为 0）。
+	Marks             map[string]PhaseStat // 各 Mark 阶段统计。
+	Elements          map[string]PhaseStat // 各元件类型统计（需启用 ElementTiming）。
+	NewtonItersPerSec float64              // 牛顿迭代速率（次/秒）。
+}
+
+// Snapshot 读取当前指标快照，可在仿真运行时并发调用。
+func (m *Metrics) Snapshot() MetricsSnapshot {
+	var s MetricsSnapshot
+	if m == nil {
+		return s
+	}
+	s.Steps = m.steps.Load()
+	s.RejectedSteps = m.rejectedSteps.Load()
+	s.NewtonIters = m.newtonIters.Load()
+	s.MaxNewtonPerStep = m.maxNewtonIters.Load()
+	s.ElemIters = m.elemIters.Load()
+	s.Decompose = m.decompose.Load()
+	for i := range m.newtonHist {
+		if n := m.newtonHist[i].Load(); n > 0 {
+			s.NewtonHist = append(s.NewtonHist, make([]uint64, i+1-len(s.NewtonHist))...)
+			s.NewtonHist[i] = n
+		}
+	}
+	if s.Steps > 0 {
+		s.StepMin = math.Float64frombits(m.stepMin.Load())
+		s.StepMax = math.Float64frombits(m.stepMax.Load())
+		s.StepMean = math.Float64frombits(m.stepSum.Load()) / float64(s.Steps)
+	}
+	s.RunTime = time.Duration(m.runNanos.Load())
+	if s.RunTime > 0 {
+		s.NewtonItersPerSec = float64(s.NewtonIters) / s.RunTime.Seconds()
+	}
+	s.Marks = make(map[string]PhaseStat, len(markNames))
+	for i := range m.markCalls {
+		if calls := m.markCalls[i].Load(); calls > 0 {
+			s.Marks[markNames[i]] = PhaseStat{Calls: calls, Time: time.Duration(m.markNanos[i].Load())}
+		}
+	}
+	s.Elements = make(map[string]PhaseStat)
+	for t, e := range m.elements {
+		calls := e.calls.Load()
+		if calls == 0 {
+			continue
+		}
+		name := fmt.Sprintf("%d", t)
+		if face, ok := ElementList[t]; ok {
+			name = face.GetName()
+		}
+		s.Elements[name] = PhaseStat{Calls: calls, Time: time.Duration(e.nanos.Load())}
+	}
+	return s
+}
+
+// Publish 以 expvar 变量的形式导出指标快照，重复发布同名变量时忽略。
+// 参数name: expvar 变量名。
+func (m *Metrics) Publish(name string) {
+	if expvar.Get(name) != nil {
+		return
+	}
+	expvar.Publish(name, expvar.Func(func() any { return m.Snapshot() }))
+}
+
+// String 返回单次仿真的指标汇总。
+func (s MetricsSnapshot) String() string {
+	var b strings.Builder
+	fmt.Fprintf(&b, "时间步: 接受 %d, 拒绝 %d, 步长 [%.3e, %.3e] 平均 %.3e\n",
+		s.Steps, s.RejectedSteps, s.StepMin, s.StepMax, s.StepMean)
+	fmt.Fprintf(&b, "牛顿迭代: %d (单步最多 %d), 元件次级迭代: %d\n", s.NewtonIters, s.MaxNewtonPerStep, s.ElemIters)
+	if len(s.NewtonHist) > 0 {
+		b.WriteString("单步牛顿迭代分布:")
+		for i, n := range s.NewtonHist {
+			if n == 0 {
+				continue
+			}
+			if i == newtonHistLen-1 {
+				fmt.Fprintf(&b, " >=%d:%d", i, n)
+			} else {
+				fmt.Fprintf(&b, " %d:%d", i, n)
+			}
+		}
+		b.WriteByte('\n')
+	}
+	fmt.Fprintf(&b, "LU 分解: %d\n", s.Decompose)
+	if s.RunTime > 0 {
+		fmt.Fprintf(&b, "总耗时: %v (%.0f 次牛顿迭代/秒)\n", s.RunTime, s.NewtonItersPerSec)
+	}
+	writePhases(&b, "阶段", s.Marks)
+	writePhases(&b, "元件", s.Elements)
+	return b.String()
+}
+
+// writePhases 按耗时降序输出阶段统计。
+func writePhases(b *strings.Builder, title string, phases map[string]PhaseStat) {
+	if len(phases) == 0 {
+		return
+	}
+	names := make([]string, 0, len(phases))
+	for name := range phases {
+		names = append(names, name)
+	}
+	sort.Slice(names, func(i, j int) bool {
+		return phases[names[i]].Time > phases[names[j]].Time
+	})
+	for _, name := range names {
+		p := phases[name]
+		fmt.Fprintf(b, "%s %-16s 调用 %8d 次, 耗时 %v\n", title, name, p.Calls, p.Time)
+	}
+}
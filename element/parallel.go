@@ -4,6 +4,7 @@ import (
 	"circuit/mna"
 	"runtime"
 	"sync"
+	"time"
 )
 
 // ParallelOptions 并行盖章选项
@@ -38,12 +39,24 @@ func (con *Context) ParallelCallMark(mark Mark) error {
 		con.CallMark(MarkReset)
 		return nil
 	case MarkUpdateElements:
+		if con.Metrics != nil {
+			defer con.Metrics.markDone(mark, time.Now())
+		}
+		if con.Tracer != nil {
+			defer con.Tracer.End(con.Tracer.Begin(), mark.String(), 0)
+		}
 		con.UpdateX()
 		for i := range con.Nodelist {
 			con.Nodelist[i].Base().Update()
 		}
 		return nil
 	case MarkRollbackElements:
+		if con.Metrics != nil {
+			defer con.Metrics.markDone(mark, time.Now())
+		}
+		if con.Tracer != nil {
+			defer con.Tracer.End(con.Tracer.Begin(), mark.String(), 0)
+		}
 		con.RollbackX()
 		for i := range con.Nodelist {
 			con.Nodelist[i].Base().Rollback()
@@ -56,6 +69,12 @@ func (con *Context) ParallelCallMark(mark Mark) error {
 		con.CallMark(MarkStamp)
 		return nil
 	case MarkDoStep:
+		if con.Metrics != nil {
+			defer con.Metrics.markDone(mark, time.Now())
+		}
+		if con.Tracer != nil {
+			defer con.Tracer.End(con.Tracer.Begin(), mark.String(), 0)
+		}
 		return con.parallelDoStep()
 	case MarkCalculateCurrent:
 		con.CallMark(MarkCalculateCurrent)
@@ -77,6 +96,7 @@ func (con *Context) parallelDoStep() error {
 		workers = runtime.GOMAXPROCS(0)
 	}
 	useCache := con.ParallelOpts.CacheThreshold > 0
+	timing := con.Metrics.elementTiming()
 
 	n := len(con.Nodelist)
 	if n == 0 {
@@ -98,10 +118,23 @@ func (con *Context) parallelDoStep() error {
 			break
 		}
 		wg.Add(1)
-		go func(s, e int) {
+		go func(w, s, e int) {
 			defer wg.Done()
+			if con.Tracer != nil {
+				defer con.Tracer.End(con.Tracer.Begin(), "DoStep chunk", w+1)
+			}
+			// 诊断模式下每个工作线程使用独立的探针记录调用 NoConverged 的元件
+			var tm mna.Time = con.Time
+			var probe *convergenceProbe
+			if con.Diagnostics != nil {
+				probe = &convergenceProbe{timeFace: con.Time, diag: con.Diagnostics}
+				tm = probe
+			}
 			for idx := s; idx < e; idx++ {
 				node := con.Nodelist[idx]
+				if probe != nil {
+					probe.elem = idx
+				}
 
 				elemFace, ok := ElementList[node.Base().NodeType]
 				if !ok {
@@ -123,7 +156,13 @@ func (con *Context) parallelDoStep() error {
 					}
 
 					collector := mna.NewStampCollector(con)
-					elemFace.DoStep(collector, con.Time, node)
+					if timing {
+						start := time.Now()
+						elemFace.DoStep(collector, tm, node)
+						con.Metrics.elementDone(node.Base().NodeType, start)
+					} else {
+						elemFace.DoStep(collector, tm, node)
+					}
 
 					con.cacheMu.Lock()
 					if cache == nil {
@@ -139,13 +178,19 @@ func (con *Context) parallelDoStep() error {
 					collectorMu.Unlock()
 				} else {
 					collector := mna.NewStampCollector(con)
-					elemFace.DoStep(collector, con.Time, node)
+					if timing {
+						start := time.Now()
+						elemFace.DoStep(collector, tm, node)
+						con.Metrics.elementDone(node.Base().NodeType, start)
+					} else {
+						elemFace.DoStep(collector, tm, node)
+					}
 					collectorMu.Lock()
 					collectors[idx] = collector
 					collectorMu.Unlock()
 				}
 			}
-		}(start, end)
+		}(w, start, end)
 	}
 	wg.Wait()
 
@@ -0,0 +1,61 @@
+package time
+
+import "circuit/element"
+
+// Probe 探针：从一步仿真结果中读取一个测量值
+// 参数:
+//   - con: 仿真上下文
+//   - voltages: 本步的节点电压数组（TransientSimulation 回调的参数）
+//
+// 返回值: 测量值
+type Probe func(con *element.Context, voltages []float64) float64
+
+// NodeVoltage 返回读取节点电压的探针，node 为 -1 时是地（恒为 0）
+func NodeVoltage(node int) Probe {
+	return func(con *element.Context, voltages []float64) float64 {
+		if node < 0 || node >= len(voltages) {
+			return 0
+		}
+		return voltages[node]
+	}
+}
+
+// DifferentialVoltage 返回读取两节点电压差 V(pos)-V(neg) 的探针，节点为 -1 时是地
+func DifferentialVoltage(pos, neg int) Probe {
+	p, n := NodeVoltage(pos), NodeVoltage(neg)
+	return func(con *element.Context, voltages []float64) float64 {
+		return p(con, voltages) - n(con, voltages)
+	}
+}
+
+// BranchCurrent 返回读取元件第 k 个电流值（元件配置 Current 列出的索引）的探针
+// 元件没有第 k 个电流值时探针返回 0。
+func BranchCurrent(ele element.NodeFace, k int) Probe {
+	current := ele.Config().Current
+	if k < 0 || k >= len(current) {
+		return func(*element.Context, []float64) float64 { return 0 }
+	}
+	index := current[k]
+	return func(*element.Context, []float64) float64 {
+		return ele.GetFloat64(index)
+	}
+}
+
+// Sampler 把探针组合为 TransientSimulation 的回调函数
+// 每步仿真后按顺序读取各探针，连同当前仿真时间交给 sink。values 切片在各步之间复用，
+// sink 需要保留数据时应复制，例如 gui.Scope.Push 把它复制到环形缓冲区中。
+//
+// 示例用法：
+//
+//	scope := gui.NewScope(0, 0, 240, 135, 1e-5, 4096,
+//		gui.ScopeChannel{Color: gui.Yellow, Min: 0, Max: 5})
+//	err := time.TransientSimulation(con, time.Sampler(con, scope.Push, time.NodeVoltage(0)))
+func Sampler(con *element.Context, sink func(t float64, values []float64), probes ...Probe) func([]float64) {
+	values := make([]float64, len(probes))
+	return func(voltages []float64) {
+		for i, probe := range probes {
+			values[i] = probe(con, voltages)
+		}
+		sink(con.CurrentTime(), values)
+	}
+}
@@ -27,6 +27,10 @@ import (
 //     d. 后处理：计算电流、更新元件状态、提取节点电压
 //     e. 纯DC电路：估计局部截断误差(LTE)并自适应调整步长
 //     f. 推进仿真时间，调用用户回调
+//
+// 若 con.Metrics 非 nil，每次调用开始时清零并记录迭代、LU 与步长统计；
+// 若 con.Tracer 非 nil，记录各阶段、LU 分解/求解与残差计算的区间；
+// 若 con.Diagnostics 非 nil，牛顿迭代耗尽的时间步会生成不收敛诊断报告。
 func TransientSimulation(con *element.Context, call func([]float64)) error {
 	// 初始化阶段：获取电路规模并创建求解器
 	nodesNum, voltageSourcesNum := con.GetNodeNum(), con.GetVoltageSourcesNum()
@@ -47,6 +51,10 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 	voltages := make([]float64, nodesNum)
 	// 标记是否需要重新加盖线性元件（步长变化或首次迭代）
 	needLinearStamp := true
+	// 仿真指标统计（con.Metrics 为 nil 时各记录调用均为空操作）
+	metrics := con.Metrics
+	metrics.BeginRun()
+	defer metrics.EndRun()
 	// 初始化所有元件状态
 	con.CallMark(element.MarkReset)
 
@@ -66,6 +74,7 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 		}
 
 		con.ResetNonlinearIter()
+		con.Diagnostics.BeginStep()
 		// 回滚到线性状态（丢弃非线性迭代的修改）
 		con.A.Rollback()
 		con.Z.Rollback()
@@ -104,6 +113,7 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 		newtonIterCount := 0
 		for con.NextNonlinearIter() {
 			newtonIterCount++
+			metrics.AddNewtonIter()
 			// 回滚到线性基准状态（MarkStamp），避免上一轮DoStep的累积
 			con.A.Rollback()
 			con.Z.Rollback()
@@ -112,15 +122,15 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 				return err
 			}
 			// 求解MNA方程
-			if err := luSolver.Decompose(con.GetA()); err != nil {
+			if err := decompose(con, luSolver); err != nil {
 				return fmt.Errorf("矩阵分解失败（时间=%.6e，步长=%.6e）: %v", con.CurrentTime(), con.CurrentStep(), err)
 			}
 			// 执行前向替换和后向替换
-			if err := luSolver.SolveReuse(con.GetZ(), con.GetX()); err != nil {
+			if err := solveReuse(con, luSolver); err != nil {
 				return fmt.Errorf("方程求解失败（时间=%.6e）: %v", con.CurrentTime(), err)
 			}
 			// 计算残差并检查收敛
-			if err := con.CalculateMNAResidual(con); err != nil {
+			if err := calculateResidual(con); err != nil {
 				return fmt.Errorf("残差计算失败: %v", err)
 			}
 			// 检查全局收敛条件
@@ -134,6 +144,7 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 			con.ResetElemIter()
 			// 开始次级迭代循环
 			for con.NextElemIter() {
+				metrics.AddElemIter()
 				// 将矩阵回滚到加盖线性元件之后的状态
 				con.A.Rollback()
 				con.Z.Rollback()
@@ -142,14 +153,14 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 					return err
 				}
 				// 重新求解MNA方程
-				if err := luSolver.Decompose(con.GetA()); err != nil {
+				if err := decompose(con, luSolver); err != nil {
 					return fmt.Errorf("元件迭代中矩阵分解失败: %v", err)
 				}
-				if err := luSolver.SolveReuse(con.GetZ(), con.GetX()); err != nil {
+				if err := solveReuse(con, luSolver); err != nil {
 					return fmt.Errorf("元件迭代中方程求解失败: %v", err)
 				}
 				// 重新计算残差并检查收敛
-				if err := con.CalculateMNAResidual(con); err != nil {
+				if err := calculateResidual(con); err != nil {
 					return fmt.Errorf("残差计算失败: %v", err)
 				}
 				con.CheckResidualConvergence()
@@ -166,8 +177,17 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 				newtonConverged = true
 			}
 		}
+		metrics.EndNewton(newtonIterCount)
+		// 诊断模式：牛顿迭代耗尽时记录阻塞收敛的元件与节点
+		var report *element.ConvergenceReport
+		if con.Diagnostics != nil && con.IsNonlinIterExhausted() {
+			report = con.Diagnostics.Record(con, newtonIterCount, newtonConverged)
+		}
 		// 检查牛顿迭代是否成功收敛
 		if !newtonConverged {
+			if report != nil {
+				return fmt.Errorf("牛顿迭代在时间 %.6e 未收敛（达到最大迭代次数 %d）\n%s", con.CurrentTime(), con.MaxNonlinearIter(), report)
+			}
 			return fmt.Errorf("牛顿迭代在时间 %.6e 未收敛（达到最大迭代次数 %d）", con.CurrentTime(), con.MaxNonlinearIter())
 		}
 		// 后处理：计算电流和更新元件状态
@@ -204,6 +224,7 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 		// 检查残差是否可接受并推进时间
 		if con.IsResidualConverged() {
 			// 残差可接受，推进时间
+			metrics.AddStep(con.CurrentStep())
 			if err := con.Time.AdvanceTimeSimple(); err != nil {
 				return fmt.Errorf("时间推进失败: %v", err)
 			}
@@ -221,6 +242,7 @@ func TransientSimulation(con *element.Context, call func([]float64)) error {
 			call(voltages)
 		} else {
 			// 残差不可接受，减小步长并重新计算当前步
+			metrics.AddRejectedStep()
 			needLinearStamp = true
 			continue
 		}
@@ -243,6 +265,36 @@ func doStep(con *element.Context) error {
 	return nil
 }
 
+// decompose 对 MNA 矩阵执行 LU 分解，并记录指标与追踪区间
+func decompose(con *element.Context, luSolver maths.LU[float64]) error {
+	con.Metrics.AddDecompose()
+	if con.Tracer != nil {
+		defer con.Tracer.End(con.Tracer.Begin(), "Decompose", 0)
+	}
+	return luSolver.Decompose(con.GetA())
+}
+
+// solveReuse 用刚完成的 LU 分解结果求解，并记录追踪区间
+func solveReuse(con *element.Context, luSolver maths.LU[float64]) error {
+	con.Diagnostics.BeforeSolve(con)
+	if con.Tracer != nil {
+		defer con.Tracer.End(con.Tracer.Begin(), "SolveReuse", 0)
+	}
+	return luSolver.SolveReuse(con.GetZ(), con.GetX())
+}
+
+// calculateResidual 计算 MNA 残差，并记录追踪区间与诊断数据
+func calculateResidual(con *element.Context) error {
+	if con.Tracer != nil {
+		defer con.Tracer.End(con.Tracer.Begin(), "CalculateMNAResidual", 0)
+	}
+	if err := con.CalculateMNAResidual(con); err != nil {
+		return err
+	}
+	con.Diagnostics.AfterResidual(con)
+	return nil
+}
+
 // extractAndValidateVoltages 从MNA求解器提取节点电压并验证有效性
 func extractAndValidateVoltages(mnaSolver mna.Mna, nodesNum int, voltages []float64) bool {
 	allValid := true
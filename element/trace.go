@@ -0,0 +1,148 @@
+package element
+
+import (
+	"encoding/json"
+	"io"
+	"sync/atomic"
+	"time"
+)
+
+// traceEvent 追踪环形缓冲区中的一个完成区间。
+// seq 为槽位序号：第 n 个区间（从 0 计）写入期间为 2n+1，发布后为 2n+2，
+// 写入者以 CAS 占有槽位后才写其余字段，绕回同一槽位的并发写入不会同时写同一个区间。
+type traceEvent struct {
+	seq   atomic.Uint64
+	name  string // 区间名称。
+	tid   int    // 线程编号：0=仿真主循环，>0=并行工作分片。
+	start int64  // 开始时间（相对 Tracer 创建时刻，纳秒）。
+	dur   int64  // 持续时间（纳秒）。
+}
+
+// Tracer 求解阶段区间追踪器。
+// 区间写入固定容量的环形缓冲区，写满后覆盖最早的记录，可导出为 Chrome trace JSON
+// （chrome://tracing 或 Perfetto 可直接打开）。
+// 挂载到 Context.Tracer 后生效；nil 时 Begin/End 内联为一次判空。
+// 写入以原子下标预留位置、以槽位序号发布，可被多个协程并发调用；
+// 绕回时槽位仍被更早的写入占用则丢弃本次区间，计入 Dropped。
+type Tracer struct {
+	origin  time.Time     // 时间原点。
+	events  []traceEvent  // 环形缓冲区。
+	next    atomic.Uint64 // 下一个写入位置（单调递增，取模得到下标）。
+	dropped atomic.Uint64 // 因槽位被占用而丢弃的区间数。
+}
+
+// NewTracer 创建追踪器。
+// 参数capacity: 环形缓冲区容量（区间个数），<=0 时使用 65536。
+func NewTracer(capacity int) *Tracer {
+	if capacity <= 0 {
+		capacity = 1 << 16
+	}
+	return &Tracer{origin: time.Now(), events: make([]traceEvent, capacity)}
+}
+
+// Reset 清空已记录的区间并重置时间原点，不能与 End 并发调用。
+func (tr *Tracer) Reset() {
+	tr.origin = time.Now()
+	tr.next.Store(0)
+	tr.dropped.Store(0)
+	for i := range tr.events {
+		tr.events[i].seq.Store(0)
+	}
+}
+
+// Begin 开始一个区间，返回开始时间戳，传给 End 使用。
+func (tr *Tracer) Begin() int64 {
+	if tr == nil {
+		return 0
+	}
+	return int64(time.Since(tr.origin))
+}
+
+// End 结束区间并写入环形缓冲区，可被多个协程并发调用。
+// 参数start: Begin 返回的时间戳。
+// 参数name: 区间名称。
+// 参数tid: 线程编号，0 表示仿真主循环，并行分片使用 1 起的编号。
+func (tr *Tracer) End(start int64, name string, tid int) {
+	if tr == nil {
+		return
+	}
+	tr.record(start, name, tid)
+}
+
+// record 写入一个完成区间。
+// 预留第 n 个位置后，只有槽位中是更早且已发布的区间时才以 CAS 占有并写入；
+// 槽位正在被写或已被更新的区间占用时丢弃。
+func (tr *Tracer) record(start int64, name string, tid int) {
+	now := int64(time.Since(tr.origin))
+	n := tr.next.Add(1) - 1
+	ev := &tr.events[n%uint64(len(tr.events))]
+	busy := 2*n + 1
+	for {
+		seq := ev.seq.Load()
+		if seq&1 != 0 || seq >= busy {
+			tr.dropped.Add(1)
+			return
+		}
+		if ev.seq.CompareAndSwap(seq, busy) {
+			break
+		}
+	}
+	ev.name, ev.tid, ev.start, ev.dur = name, tid, start, now-start
+	ev.seq.Store(busy + 1)
+}
+
+// Dropped 返回因并发写入绕回同一槽位而丢弃的区间数。
+func (tr *Tracer) Dropped() uint64 {
+	return tr.dropped.Load()
+}
+
+// Len 返回缓冲区中有效的区间个数。
+func (tr *Tracer) Len() int {
+	n := tr.next.Load()
+	if n > uint64(len(tr.events)) {
+		return len(tr.events)
+	}
+	return int(n)
+}
+
+// chromeEvent Chrome trace 的完整事件（ph="X"），时间单位为微秒。
+type chromeEvent struct {
+	Name string  `json:"name"`
+	Cat  string  `json:"cat"`
+	Ph   string  `json:"ph"`
+	Ts   float64 `json:"ts"`
+	Dur  float64 `json:"dur"`
+	Pid  int     `json:"pid"`
+	Tid  int     `json:"tid"`
+}
+
+// WriteChromeTrace 按记录顺序将缓冲区中的区间以 Chrome trace JSON 格式写出，跳过未发布或被丢弃的区间。
+// 必须在仿真结束后（或暂停期间）调用，不能与 End 并发。
+func (tr *Tracer) WriteChromeTrace(w io.Writer) error {
+	n := tr.next.Load()
+	count := uint64(len(tr.events))
+	first := uint64(0)
+	if n > count {
+		first = n - count
+	}
+	out := struct {
+		TraceEvents     []chromeEvent `json:"traceEvents"`
+		DisplayTimeUnit string        `json:"displayTimeUnit"`
+	}{TraceEvents: make([]chromeEvent, 0, n-first), DisplayTimeUnit: "ns"}
+	for i := first; i < n; i++ {
+		ev := &tr.events[i%count]
+		if ev.seq.Load() != 2*i+2 {
+			continue
+		}
+		out.TraceEvents = append(out.TraceEvents, chromeEvent{
+			Name: ev.name,
+			Cat:  "solver",
+			Ph:   "X",
+			Ts:   float64(ev.start) / 1e3,
+			Dur:  float64(ev.dur) / 1e3,
+			Pid:  1,
+			Tid:  ev.tid,
+		})
+	}
+	return json.NewEncoder(w).Encode(&out)
+}
@@ -0,0 +1,213 @@
+package async
+
+import (
+	"bytes"
+	"fmt"
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestSPICoalesce(t *testing.T) {
+	spi := NewLoopbackSPI()
+	q := NewQueue(NewSPIBackend(spi, 64), 0)
+	defer q.Close()
+	done := make(chan *Transfer, 16)
+	var ts []*Transfer
+	var want []byte
+	for i := range 12 {
+		tx := []byte{byte(i), byte(i), byte(i), byte(i), byte(i), byte(i), byte(i), byte(i)}
+		want = append(want, tx...)
+		tr := &Transfer{Op: OpWrite, Tx: tx, Coalesce: i != 0, C: done}
+		if i >= 4 {
+			tr.ChipSelect = 1 // 片选改变处不能合并
+		}
+		ts = append(ts, tr)
+	}
+	if err := q.SubmitBatch(ts); err != nil {
+		t.Fatal(err)
+	}
+	for i := range ts {
+		if tr := <-done; tr != ts[i] || tr.Err != nil || tr.N != 8 {
+			t.Fatalf("第 %d 个完成通知 %+v", i, tr)
+		}
+	}
+	// 0-3 合并；4-11 共 64 字节合并为一次
+	if got := spi.Written(); !bytes.Equal(got, want) {
+		t.Fatalf("写入 %x，期望 %x", got, want)
+	}
+	if s := spi.Stats(); s.Calls != 2 {
+		t.Fatalf("总线调用 %d 次，期望 2", s.Calls)
+	}
+	// 超过 maxBatch 的部分另起一次调用
+	ts = ts[:0]
+	for range 9 {
+		ts = append(ts, &Transfer{Op: OpWrite, Tx: make([]byte, 8), Coalesce: true})
+	}
+	q.SubmitBatch(ts)
+	q.Flush()
+	if s := spi.Stats(); s.Calls != 4 {
+		t.Fatalf("总线调用 %d 次，期望 4", s.Calls)
+	}
+}
+
+func TestSPIWriteReadSplit(t *testing.T) {
+	spi := NewLoopbackSPI()
+	q := NewQueue(NewSPIBackend(spi, 0), 0)
+	defer q.Close()
+	ts := []*Transfer{
+		{Op: OpWriteRead, Tx: []byte{0x81, 0}},
+		{Op: OpWriteRead, Tx: []byte{0x82, 0, 0, 0}, Coalesce: true},
+		{Op: OpWriteRead, Tx: []byte{0x83}, Coalesce: true, Rx: make([]byte, 0, 4)},
+		{Op: OpRead, RxLen: 3},
+	}
+	rx := ts[2].Rx[:1]
+	q.SubmitBatch(ts)
+	q.Flush()
+	for i, tr := range ts[:3] {
+		if tr.Err != nil || !bytes.Equal(tr.Rx, tr.Tx) || tr.N != len(tr.Tx) {
+			t.Fatalf("第 %d 个传输读取 %x (%v)，期望 %x", i, tr.Rx, tr.Err, tr.Tx)
+		}
+	}
+	if &ts[2].Rx[0] != &rx[0] {
+		t.Fatal("没有复用调用者提供的接收缓冲区")
+	}
+	if !bytes.Equal(ts[3].Rx, []byte{0xFF, 0xFF, 0xFF}) {
+		t.Fatalf("读取 %x", ts[3].Rx)
+	}
+	if s := spi.Stats(); s.Calls != 2 {
+		t.Fatalf("总线调用 %d 次，期望 2", s.Calls)
+	}
+}
+
+func TestUARTBackend(t *testing.T) {
+	uart := NewLoopbackUART()
+	q := NewQueue(NewUARTBackend(uart, 0), 0)
+	defer q.Close()
+	var ts []*Transfer
+	for i := range 5 {
+		ts = append(ts, &Transfer{Op: OpWrite, Tx: []byte(fmt.Sprintf("msg%d;", i))})
+	}
+	read := &Transfer{Op: OpRead, RxLen: 64, Rx: make([]byte, 64)}
+	q.SubmitBatch(append(ts, read))
+	q.Flush()
+	if string(read.Rx) != "msg0;msg1;msg2;msg3;msg4;" || read.Err != nil {
+		t.Fatalf("读取 %q (%v)", read.Rx, read.Err)
+	}
+	// 5 次写入合并为一次，加一次读取
+	if s := uart.Stats(); s.Calls != 2 {
+		t.Fatalf("总线调用 %d 次，期望 2", s.Calls)
+	}
+	if tr := (&Transfer{Op: OpWriteRead}); q.Do(tr) != ErrUnsupported {
+		t.Fatalf("UART 读写返回 %v", tr.Err)
+	}
+}
+
+func TestI2CBackend(t *testing.T) {
+	i2c := NewLoopbackI2C()
+	q := NewQueue(NewI2CBackend(i2c), 0)
+	defer q.Close()
+	const addr = 0x48 << 1
+	if err := q.Do(&Transfer{Op: OpWrite, Tx: []byte{addr, 0x10, 1, 2, 3}}); err != nil {
+		t.Fatal(err)
+	}
+	tr := &Transfer{Op: OpWriteRead, Tx: []byte{addr, 0x11}, RxLen: 2}
+	if err := q.Do(tr); err != nil || !bytes.Equal(tr.Rx, []byte{2, 3}) || tr.N != 2 {
+		t.Fatalf("读取 %x (%v)", tr.Rx, err)
+	}
+	// 其他地址上的设备互不影响
+	tr = &Transfer{Op: OpRead, Tx: []byte{0x50 << 1}, RxLen: 2}
+	if err := q.Do(tr); err != nil || !bytes.Equal(tr.Rx, []byte{0, 0}) {
+		t.Fatalf("读取 %x (%v)", tr.Rx, err)
+	}
+}
+
+func TestQueueConcurrent(t *testing.T) {
+	spi := NewLoopbackSPI()
+	spi.SetLatency(50 * time.Microsecond)
+	q := NewQueue(NewSPIBackend(spi, 0), 8)
+	var calls sync.Map
+	var wg sync.WaitGroup
+	for g := range 8 {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			for i := range 100 {
+				tr := &Transfer{Op: OpWriteRead, Tx: []byte{byte(g), byte(i)}, Coalesce: true}
+				if i%2 == 0 {
+					tr.Done = func(tr *Transfer) { calls.Store(tr, true) }
+					q.Submit(tr)
+					continue
+				}
+				if err := q.Do(tr); err != nil || !bytes.Equal(tr.Rx, tr.Tx) {
+					t.Errorf("协程 %d 第 %d 次读取 %x (%v)", g, i, tr.Rx, err)
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+	q.Flush()
+	n := 0
+	calls.Range(func(_, _ any) bool { n++; return true })
+	stats := q.Stats()
+	if n != 400 || stats.Transfers != 800 {
+		t.Fatalf("回调 %d 次，统计 %+v", n, stats)
+	}
+	// 并发提交在后端执行期间积累成批次
+	if spi.Stats().Calls >= 800 || stats.MaxBatch < 2 {
+		t.Fatalf("总线调用 %d 次，统计 %+v", spi.Stats().Calls, stats)
+	}
+	q.Close()
+	if err := q.Submit(&Transfer{}); err != ErrQueueClosed {
+		t.Fatalf("关闭后提交返回 %v", err)
+	}
+	q.Close()
+}
+
+func TestQueueZeroAlloc(t *testing.T) {
+	uart := NewLoopbackUART()
+	q := NewQueue(NewUARTBackend(uart, 0), 0)
+	defer q.Close()
+	w := &Transfer{Op: OpWrite, Tx: []byte("ping")}
+	r := &Transfer{Op: OpRead, RxLen: 16, Rx: make([]byte, 16)}
+	batch := []*Transfer{w, r}
+	q.SubmitBatch(batch)
+	q.Flush()
+	if allocs := testing.AllocsPerRun(100, func() {
+		q.SubmitBatch(batch)
+		q.Flush()
+	}); allocs != 0 {
+		t.Fatalf("每批分配 %.1f 次", allocs)
+	}
+}
+
+// BenchmarkSPISmallWrites 64 个 32 字节的写入，模拟每次总线调用 20µs 的 USB 往返
+func BenchmarkSPISmallWrites(b *testing.B) {
+	const n = 64
+	spi := NewLoopbackSPI()
+	spi.SetLatency(20 * time.Microsecond)
+	data := make([]byte, 32)
+	b.Run("direct", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for range n {
+				spi.Write(false, 0, data)
+			}
+			spi.Written()
+		}
+	})
+	b.Run("queue", func(b *testing.B) {
+		q := NewQueue(NewSPIBackend(spi, 0), 0)
+		defer q.Close()
+		ts := make([]*Transfer, n)
+		for i := range ts {
+			ts[i] = &Transfer{Op: OpWrite, Tx: data, Coalesce: true}
+		}
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			q.SubmitBatch(ts)
+			q.Flush()
+			spi.Written()
+		}
+	})
+}
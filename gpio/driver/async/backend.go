@@ -0,0 +1,192 @@
+package async
+
+import (
+	"circuit/gpio/driver"
+)
+
+// defaultMaxBatch 合并后单次总线调用的默认最大字节数
+const defaultMaxBatch = 4096
+
+// readIntoUART 支持读取到调用者缓冲区的 UART，例如 serial 包的实现
+type readIntoUART interface {
+	ReadInto(buf []byte) (int, error)
+}
+
+// UARTBackend 基于 driver.UART 的后端
+// 批次中相邻的写入合并为一次 Write；读取优先使用 ReadInto，避免分配。
+type UARTBackend struct {
+	uart     driver.UART
+	maxBatch int
+	buf      []byte
+}
+
+// NewUARTBackend 创建 UART 后端
+// 参数:
+//   - uart: UART 设备
+//   - maxBatch: 合并写入的最大字节数，0 使用默认值 4096
+func NewUARTBackend(uart driver.UART, maxBatch int) *UARTBackend {
+	if maxBatch <= 0 {
+		maxBatch = defaultMaxBatch
+	}
+	return &UARTBackend{uart: uart, maxBatch: maxBatch}
+}
+
+// Execute 实现 Backend 接口
+func (b *UARTBackend) Execute(batch []*Transfer) {
+	for i := 0; i < len(batch); {
+		t := batch[i]
+		switch t.Op {
+		case OpWrite:
+			j := mergeRun(batch, i, b.maxBatch, uartMergeable)
+			if j == i+1 {
+				t.N, t.Err = len(t.Tx), b.uart.Write(t.Tx)
+			} else {
+				b.buf = gather(b.buf[:0], batch[i:j])
+				err := b.uart.Write(b.buf)
+				for _, m := range batch[i:j] {
+					m.N, m.Err = len(m.Tx), err
+				}
+			}
+			i = j
+			continue
+		case OpRead:
+			b.read(t)
+		default:
+			t.Err = ErrUnsupported
+		}
+		i++
+	}
+}
+
+// uartMergeable 相邻的 UART 写入总是可以合并
+func uartMergeable(p, n *Transfer) bool {
+	return n.Op == OpWrite
+}
+
+// read 执行一次读取，读取的字节数可能小于 RxLen
+func (b *UARTBackend) read(t *Transfer) {
+	if ev, ok := b.uart.(readIntoUART); ok {
+		buf := t.rxBuffer(t.RxLen)
+		t.N, t.Err = ev.ReadInto(buf)
+		t.Rx = buf[:t.N]
+		return
+	}
+	data, err := b.uart.Read(t.RxLen)
+	t.Rx = append(t.Rx[:0], data...)
+	t.N, t.Err = len(data), err
+}
+
+// SPIBackend 基于 driver.SPI 的后端
+// 设置了 Coalesce、片选相同且操作相同的相邻写入或全双工传输合并为一次 Write 或 WriteRead，
+// 全双工合并后按各传输的长度切分读取的数据。
+type SPIBackend struct {
+	spi      driver.SPI
+	maxBatch int
+	buf      []byte
+}
+
+// NewSPIBackend 创建 SPI 后端
+// 参数:
+//   - spi: SPI 设备
+//   - maxBatch: 合并后单次传输的最大字节数，0 使用默认值 4096
+func NewSPIBackend(spi driver.SPI, maxBatch int) *SPIBackend {
+	if maxBatch <= 0 {
+		maxBatch = defaultMaxBatch
+	}
+	return &SPIBackend{spi: spi, maxBatch: maxBatch}
+}
+
+// spiMergeable 判断 n 能否与前一个传输 p 合并
+func spiMergeable(p, n *Transfer) bool {
+	return n.Coalesce && n.Op == p.Op && n.ChipSelect == p.ChipSelect && n.IgnoreCS == p.IgnoreCS
+}
+
+// Execute 实现 Backend 接口
+func (b *SPIBackend) Execute(batch []*Transfer) {
+	for i := 0; i < len(batch); {
+		t := batch[i]
+		j := i + 1
+		if t.Op == OpWrite || t.Op == OpWriteRead {
+			j = mergeRun(batch, i, b.maxBatch, spiMergeable)
+		}
+		switch {
+		case t.Op == OpRead:
+			data, err := b.spi.Read(t.IgnoreCS, t.ChipSelect, t.RxLen)
+			t.Rx = append(t.Rx[:0], data...)
+			t.N, t.Err = len(data), err
+		case j == i+1 && t.Op == OpWrite:
+			t.N, t.Err = len(t.Tx), b.spi.Write(t.IgnoreCS, t.ChipSelect, t.Tx)
+		case t.Op == OpWrite:
+			b.buf = gather(b.buf[:0], batch[i:j])
+			err := b.spi.Write(t.IgnoreCS, t.ChipSelect, b.buf)
+			for _, m := range batch[i:j] {
+				m.N, m.Err = len(m.Tx), err
+			}
+		case t.Op == OpWriteRead:
+			tx := t.Tx
+			if j > i+1 {
+				b.buf = gather(b.buf[:0], batch[i:j])
+				tx = b.buf
+			}
+			data, err := b.spi.WriteRead(t.IgnoreCS, t.ChipSelect, tx)
+			for _, m := range batch[i:j] {
+				n := min(len(m.Tx), len(data))
+				m.Rx = append(m.Rx[:0], data[:n]...)
+				data = data[n:]
+				m.N, m.Err = n, err
+			}
+		default:
+			t.Err = ErrUnsupported
+		}
+		i = j
+	}
+}
+
+// I2CBackend 基于 driver.I2C 的后端
+// I2C 每次 Stream 都有独立的起始与停止条件，不能在这一层合并，批次中的传输在后台协程中连续执行，
+// 省去的是每次调用的协程切换与等待。
+type I2CBackend struct {
+	i2c driver.I2C
+}
+
+// NewI2CBackend 创建 I2C 后端
+// Tx 的第一个字节为设备地址字节；OpRead 与 OpWriteRead 都写 Tx 后读取 RxLen 字节。
+func NewI2CBackend(i2c driver.I2C) *I2CBackend {
+	return &I2CBackend{i2c: i2c}
+}
+
+// Execute 实现 Backend 接口
+func (b *I2CBackend) Execute(batch []*Transfer) {
+	for _, t := range batch {
+		if t.Op == OpWrite {
+			_, t.Err = b.i2c.Stream(t.Tx, 0)
+			t.N = len(t.Tx)
+			continue
+		}
+		data, err := b.i2c.Stream(t.Tx, t.RxLen)
+		t.Rx = append(t.Rx[:0], data...)
+		t.N, t.Err = len(data), err
+	}
+}
+
+// mergeRun 返回从 batch[i] 开始可以合并的传输的结束下标（不含）
+// 合并的传输总长度不超过 maxBatch；单个超长的传输不与其他传输合并。
+func mergeRun(batch []*Transfer, i, maxBatch int, mergeable func(p, n *Transfer) bool) int {
+	size := len(batch[i].Tx)
+	j := i + 1
+	for ; j < len(batch); j++ {
+		if !mergeable(batch[j-1], batch[j]) || size+len(batch[j].Tx) > maxBatch {
+			break
+		}
+		size += len(batch[j].Tx)
+	}
+	return j
+}
+
+// gather 把传输的发送数据依次追加到 dst
+func gather(dst []byte, ts []*Transfer) []byte {
+	for _, t := range ts {
+		dst = append(dst, t.Tx...)
+	}
+	return dst
+}
@@ -0,0 +1,277 @@
+package async
+
+import (
+	"circuit/gpio/driver"
+	"errors"
+	"sync"
+	"sync/atomic"
+	"time"
+	"unsafe"
+)
+
+// 编译期检查回环设备实现驱动接口
+var (
+	_ driver.UART = (*LoopbackUART)(nil)
+	_ driver.SPI  = (*LoopbackSPI)(nil)
+	_ driver.I2C  = (*LoopbackI2C)(nil)
+)
+
+// errLoopbackClosed 回环设备已关闭
+var errLoopbackClosed = errors.New("async: loopback closed")
+
+// LoopbackStats 回环设备统计
+type LoopbackStats struct {
+	Calls uint64 // 总线调用次数，对应 USB 适配器上的往返次数
+	Bytes uint64 // 写入与读取的字节数
+}
+
+// loopback 回环设备的公共部分：调用统计与模拟往返延迟
+type loopback struct {
+	latency atomic.Int64
+	calls   atomic.Uint64
+	bytes   atomic.Uint64
+	closed  atomic.Bool
+}
+
+// SetLatency 设置每次总线调用的模拟往返延迟
+func (l *loopback) SetLatency(d time.Duration) {
+	l.latency.Store(int64(d))
+}
+
+// Stats 返回调用统计
+func (l *loopback) Stats() LoopbackStats {
+	return LoopbackStats{Calls: l.calls.Load(), Bytes: l.bytes.Load()}
+}
+
+// Close 关闭设备
+func (l *loopback) Close() error {
+	l.closed.Store(true)
+	return nil
+}
+
+// roundTrip 记录一次传输 n 个字节的总线调用并等待模拟延迟
+func (l *loopback) roundTrip(n int) error {
+	if l.closed.Load() {
+		return errLoopbackClosed
+	}
+	l.calls.Add(1)
+	l.bytes.Add(uint64(n))
+	if d := time.Duration(l.latency.Load()); d > 0 {
+		time.Sleep(d)
+	}
+	return nil
+}
+
+// LoopbackUART 软件回环 UART，写入的数据可以从同一设备读回
+type LoopbackUART struct {
+	loopback
+	mu     sync.Mutex
+	rx     []byte
+	config driver.UARTConfig
+}
+
+// NewLoopbackUART 创建回环 UART
+func NewLoopbackUART() *LoopbackUART {
+	return &LoopbackUART{config: driver.UARTConfig{BaudRate: 115200, ByteSize: 8}}
+}
+
+// Init 初始化 UART 配置
+func (u *LoopbackUART) Init(baudRate int, byteSize, parity, stopBits, byteTimeout uint8) error {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	u.config = driver.UARTConfig{BaudRate: uint32(baudRate), ByteSize: byteSize, Parity: parity, StopBits: stopBits, ByteTimeout: byteTimeout}
+	return nil
+}
+
+// GetConfig 获取 UART 配置
+func (u *LoopbackUART) GetConfig() (*driver.UARTConfig, error) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	cfg := u.config
+	return &cfg, nil
+}
+
+// Write 写入数据，数据进入接收缓冲区
+func (u *LoopbackUART) Write(data []byte) error {
+	if err := u.roundTrip(len(data)); err != nil {
+		return err
+	}
+	u.mu.Lock()
+	u.rx = append(u.rx, data...)
+	u.mu.Unlock()
+	return nil
+}
+
+// Read 读取最多 length 字节，没有数据时返回空切片
+func (u *LoopbackUART) Read(length int) ([]byte, error) {
+	buf := make([]byte, length)
+	n, err := u.ReadInto(buf)
+	return buf[:n], err
+}
+
+// ReadInto 读取到调用者提供的缓冲区，没有数据时返回 0
+func (u *LoopbackUART) ReadInto(buf []byte) (int, error) {
+	u.mu.Lock()
+	n := copy(buf, u.rx)
+	u.rx = u.rx[:copy(u.rx, u.rx[n:])]
+	u.mu.Unlock()
+	return n, u.roundTrip(n)
+}
+
+// LoopbackSPI 软件回环 SPI，MISO 与 MOSI 相连：全双工传输读回写入的数据
+// 写入的全部数据按顺序记录，可用 Written 取出检查。
+type LoopbackSPI struct {
+	loopback
+	mu      sync.Mutex
+	config  driver.SPIConfig
+	written []byte
+}
+
+// NewLoopbackSPI 创建回环 SPI
+func NewLoopbackSPI() *LoopbackSPI {
+	return &LoopbackSPI{config: driver.SPIConfig{SpiOutDefaultData: 0xFF}}
+}
+
+// Written 取出并清空已写入数据的记录
+func (s *LoopbackSPI) Written() []byte {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	w := s.written
+	s.written = nil
+	return w
+}
+
+// SetFrequency 设置 SPI 频率
+func (s *LoopbackSPI) SetFrequency(freqHz uint32) error { return nil }
+
+// Init 初始化 SPI 接口
+func (s *LoopbackSPI) Init(cfg *driver.SPIConfig) error {
+	s.mu.Lock()
+	s.config = *cfg
+	s.mu.Unlock()
+	return nil
+}
+
+// Write 写入 SPI 数据
+func (s *LoopbackSPI) Write(ignoreCS bool, chipSelect uint8, data []byte) error {
+	if err := s.roundTrip(len(data)); err != nil {
+		return err
+	}
+	s.mu.Lock()
+	s.written = append(s.written, data...)
+	s.mu.Unlock()
+	return nil
+}
+
+// Read 读取 SPI 数据，返回默认输出数据
+func (s *LoopbackSPI) Read(ignoreCS bool, chipSelect uint8, length int) ([]byte, error) {
+	if err := s.roundTrip(length); err != nil {
+		return nil, err
+	}
+	s.mu.Lock()
+	fill := s.config.SpiOutDefaultData
+	s.mu.Unlock()
+	data := make([]byte, length)
+	for i := range data {
+		data[i] = fill
+	}
+	return data, nil
+}
+
+// WriteRead 全双工传输，读回写入的数据
+func (s *LoopbackSPI) WriteRead(ignoreCS bool, chipSelect uint8, data []byte) ([]byte, error) {
+	if err := s.Write(ignoreCS, chipSelect, data); err != nil {
+		return nil, err
+	}
+	return append([]byte(nil), data...), nil
+}
+
+// SetAutoCS 设置 SPI 自动片选
+func (s *LoopbackSPI) SetAutoCS(disable bool) error { return nil }
+
+// SetDataBits 设置 SPI 数据位宽
+func (s *LoopbackSPI) SetDataBits(dataBits uint8) error { return nil }
+
+// GetConfig 获取 SPI 配置
+func (s *LoopbackSPI) GetConfig(cfg *driver.SPIConfig) error {
+	s.mu.Lock()
+	*cfg = s.config
+	s.mu.Unlock()
+	return nil
+}
+
+// ChangeCS 改变 SPI 片选状态
+func (s *LoopbackSPI) ChangeCS(status uint8) error { return nil }
+
+// GetHwStreamCfg 获取 SPI 硬件流配置，回环设备没有硬件流配置
+func (s *LoopbackSPI) GetHwStreamCfg(streamCfg unsafe.Pointer) error { return nil }
+
+// LoopbackI2C 软件 I2C 总线，每个 7 位地址上挂一个 256 字节的寄存器存储器
+// Stream 的第一个写入字节为地址字节，第二个字节为寄存器地址，其余字节从寄存器地址开始依次写入，
+// 随后的读取从当前寄存器地址开始，寄存器地址自动递增并在 256 处回绕。
+type LoopbackI2C struct {
+	loopback
+	mu   sync.Mutex
+	regs [128]*[256]byte
+	ptr  [128]uint8
+}
+
+// NewLoopbackI2C 创建回环 I2C 总线
+func NewLoopbackI2C() *LoopbackI2C {
+	return &LoopbackI2C{}
+}
+
+// Set 配置 I2C 接口模式
+func (d *LoopbackI2C) Set(mode int) error { return nil }
+
+// SetStretch 设置时钟拉伸使能
+func (d *LoopbackI2C) SetStretch(enable bool) error { return nil }
+
+// SetDriveMode 设置驱动模式
+func (d *LoopbackI2C) SetDriveMode(mode uint8) error { return nil }
+
+// SetIgnoreNack 设置忽略 NACK
+func (d *LoopbackI2C) SetIgnoreNack(mode uint8) error { return nil }
+
+// SetDelayMS 设置延迟时间（毫秒）
+func (d *LoopbackI2C) SetDelayMS(delay int) error { return nil }
+
+// SetAckClkDelay 设置 ACK 时钟延迟（微秒）
+func (d *LoopbackI2C) SetAckClkDelay(delay int) error { return nil }
+
+// Stream 执行 I2C 写后读
+func (d *LoopbackI2C) Stream(writeData []byte, readLength int) ([]byte, error) {
+	data, _, err := d.StreamWithAck(writeData, readLength)
+	return data, err
+}
+
+// StreamWithAck 执行 I2C 写后读，返回写入字节收到的 ACK 数
+func (d *LoopbackI2C) StreamWithAck(writeData []byte, readLength int) ([]byte, int, error) {
+	if len(writeData) == 0 {
+		return nil, 0, errors.New("async: i2c address byte required")
+	}
+	if err := d.roundTrip(len(writeData) + readLength); err != nil {
+		return nil, 0, err
+	}
+	addr := writeData[0] >> 1
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	regs := d.regs[addr]
+	if regs == nil {
+		regs = new([256]byte)
+		d.regs[addr] = regs
+	}
+	if len(writeData) > 1 {
+		d.ptr[addr] = writeData[1]
+		for _, v := range writeData[2:] {
+			regs[d.ptr[addr]] = v
+			d.ptr[addr]++
+		}
+	}
+	data := make([]byte, readLength)
+	for i := range data {
+		data[i] = regs[d.ptr[addr]]
+		d.ptr[addr]++
+	}
+	return data, len(writeData), nil
+}
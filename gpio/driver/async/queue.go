@@ -0,0 +1,187 @@
+package async
+
+import (
+	"sync"
+	"sync/atomic"
+)
+
+// defaultDepth 队列默认深度
+const defaultDepth = 256
+
+// QueueStats 队列统计
+type QueueStats struct {
+	Transfers uint64 // 完成的传输数
+	Batches   uint64 // 交给后端的批次数
+	MaxBatch  uint64 // 最大批次大小
+}
+
+// Queue 异步传输队列
+// 提交只把描述符追加到待处理列表，一个后台协程每次取走全部待处理传输作为一批交给后端执行，
+// 执行期间到达的提交组成下一批；待处理列表与执行中的批次交替复用，稳态下提交不分配内存。
+type Queue struct {
+	backend Backend
+	depth   int
+
+	mu      sync.Mutex
+	work    *sync.Cond // 有待处理传输或队列关闭
+	space   *sync.Cond // 待处理列表有空位
+	idle    *sync.Cond // 待处理列表为空且没有执行中的批次
+	pending []*Transfer
+	spare   []*Transfer
+	busy    bool
+	closed  bool
+	done    chan struct{}
+
+	transfers, batches, maxBatch atomic.Uint64
+}
+
+// NewQueue 创建异步传输队列并启动后台协程
+// 参数:
+//   - backend: 执行传输的后端
+//   - depth: 待处理传输的最大数量，超过时 Submit 阻塞等待；0 使用默认值 256
+//
+// 返回值:
+//   - *Queue: 传输队列，使用完毕后调用 Close
+func NewQueue(backend Backend, depth int) *Queue {
+	if depth <= 0 {
+		depth = defaultDepth
+	}
+	q := &Queue{
+		backend: backend,
+		depth:   depth,
+		pending: make([]*Transfer, 0, depth),
+		spare:   make([]*Transfer, 0, depth),
+		done:    make(chan struct{}),
+	}
+	q.work = sync.NewCond(&q.mu)
+	q.space = sync.NewCond(&q.mu)
+	q.idle = sync.NewCond(&q.mu)
+	go q.run()
+	return q
+}
+
+// Submit 提交一个传输，立即返回；待处理列表已满时阻塞等待
+// 队列关闭后返回 ErrQueueClosed。
+func (q *Queue) Submit(t *Transfer) error {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	for len(q.pending) >= q.depth && !q.closed {
+		q.space.Wait()
+	}
+	if q.closed {
+		return ErrQueueClosed
+	}
+	q.pending = append(q.pending, t)
+	q.work.Signal()
+	return nil
+}
+
+// SubmitBatch 一次提交多个传输，保证它们进入同一批次，以便后端合并相邻传输
+// 批次大小可以超过队列深度；待处理列表非空且加入后超过深度时先等待。
+func (q *Queue) SubmitBatch(ts []*Transfer) error {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	for len(q.pending) > 0 && len(q.pending)+len(ts) > q.depth && !q.closed {
+		q.space.Wait()
+	}
+	if q.closed {
+		return ErrQueueClosed
+	}
+	q.pending = append(q.pending, ts...)
+	q.work.Signal()
+	return nil
+}
+
+// donePool 同步执行使用的完成通道
+var donePool = sync.Pool{New: func() any { return make(chan *Transfer, 1) }}
+
+// Do 提交传输并等待完成，返回传输错误
+// 传输的 C 字段会被临时占用。
+func (q *Queue) Do(t *Transfer) error {
+	ch := donePool.Get().(chan *Transfer)
+	t.C = ch
+	if err := q.Submit(t); err != nil {
+		t.C = nil
+		donePool.Put(ch)
+		return err
+	}
+	<-ch
+	t.C = nil
+	donePool.Put(ch)
+	return t.Err
+}
+
+// Flush 等待此前提交的全部传输完成
+func (q *Queue) Flush() {
+	q.mu.Lock()
+	for len(q.pending) > 0 || q.busy {
+		q.idle.Wait()
+	}
+	q.mu.Unlock()
+}
+
+// Close 关闭队列，已提交的传输执行完毕后返回；之后的提交返回 ErrQueueClosed
+// 重复关闭是安全的。
+func (q *Queue) Close() error {
+	q.mu.Lock()
+	q.closed = true
+	q.work.Broadcast()
+	q.space.Broadcast()
+	q.mu.Unlock()
+	<-q.done
+	return nil
+}
+
+// Stats 返回队列统计
+func (q *Queue) Stats() QueueStats {
+	return QueueStats{
+		Transfers: q.transfers.Load(),
+		Batches:   q.batches.Load(),
+		MaxBatch:  q.maxBatch.Load(),
+	}
+}
+
+// run 后台协程：取走全部待处理传输，交给后端执行并通知完成
+func (q *Queue) run() {
+	defer close(q.done)
+	for {
+		q.mu.Lock()
+		for len(q.pending) == 0 && !q.closed {
+			q.work.Wait()
+		}
+		if len(q.pending) == 0 {
+			q.idle.Broadcast()
+			q.mu.Unlock()
+			return
+		}
+		batch := q.pending
+		q.pending = q.spare[:0]
+		q.busy = true
+		q.space.Broadcast()
+		q.mu.Unlock()
+
+		q.backend.Execute(batch)
+		q.batches.Add(1)
+		q.transfers.Add(uint64(len(batch)))
+		if n := uint64(len(batch)); n > q.maxBatch.Load() {
+			q.maxBatch.Store(n)
+		}
+		for i, t := range batch {
+			batch[i] = nil
+			if t.Done != nil {
+				t.Done(t)
+			}
+			if t.C != nil {
+				t.C <- t
+			}
+		}
+
+		q.mu.Lock()
+		q.spare = batch[:0]
+		q.busy = false
+		if len(q.pending) == 0 {
+			q.idle.Broadcast()
+		}
+		q.mu.Unlock()
+	}
+}
@@ -0,0 +1,88 @@
+// Package async 为 driver.UART、driver.SPI 与 driver.I2C 提供统一的异步传输接口。
+//
+// 调用者把传输描述符 (Transfer) 提交到队列 (Queue)，由后台协程按批次交给后端 (Backend) 执行，
+// 完成后通过回调或通道通知。后台协程执行一批传输期间到达的新提交会自动组成下一批，
+// 后端在一批之内把允许合并的相邻传输合并为一次总线调用，
+// 在 CH34x 这类 USB 适配器上即把多次小传输合并为一次 USB 往返。
+//
+// 示例用法：
+//
+//	spi, err := ch34x.OpenSPI("/dev/ch34x_pis0")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	q := async.NewQueue(async.NewSPIBackend(spi, 0), 0)
+//	defer q.Close()
+//
+//	// 批量提交，相邻的可合并写入只产生一次 spi.Write
+//	done := make(chan *async.Transfer, 2)
+//	q.SubmitBatch([]*async.Transfer{
+//	    {Op: async.OpWrite, Tx: cmd, C: done},
+//	    {Op: async.OpWrite, Tx: pixels, Coalesce: true, C: done},
+//	})
+//
+//	// 同步执行一次全双工读取
+//	t := &async.Transfer{Op: async.OpWriteRead, Tx: []byte{0x80 | reg, 0}}
+//	if err := q.Do(t); err != nil {
+//	    log.Fatal(err)
+//	}
+//	fmt.Printf("reg = %#x\n", t.Rx[1])
+//
+// 本包还提供软件回环后端 (LoopbackUART、LoopbackSPI、LoopbackI2C)，统计总线调用次数并可模拟每次调用的往返延迟，
+// 用于在没有硬件时测试批处理效果。
+package async
+
+import "errors"
+
+// Op 传输操作类型
+type Op uint8
+
+// 传输操作
+const (
+	OpWrite     Op = iota // 只写：发送 Tx
+	OpRead                // 只读：读取 RxLen 字节到 Rx
+	OpWriteRead           // 读写：SPI 为全双工传输（读取 len(Tx) 字节），I2C 为写 Tx 后读 RxLen 字节
+)
+
+// 错误定义
+var (
+	ErrQueueClosed = errors.New("async: queue closed")
+	ErrUnsupported = errors.New("async: operation not supported by backend")
+)
+
+// Transfer 传输描述符
+// 提交后直到完成通知之前，调用者不能修改描述符及 Tx 缓冲区。
+type Transfer struct {
+	Op         Op     // 操作类型
+	Tx         []byte // 发送数据
+	RxLen      int    // 读取长度，OpRead 以及 I2C 的 OpWriteRead 使用
+	ChipSelect uint8  // SPI 片选
+	IgnoreCS   bool   // SPI 是否忽略片选
+	// Coalesce 允许与批次中紧邻的前一个传输合并为一次总线调用。
+	// SPI 合并后片选在两个传输之间保持有效，只有不依赖片选边沿分隔命令的设备才能设置；
+	// UART 写入本身是字节流，总是可以合并，不需要设置。
+	Coalesce bool
+
+	Done func(t *Transfer) // 完成回调，在队列的后台协程中执行，不能阻塞
+	C    chan<- *Transfer  // 完成通道，完成的描述符会发送到该通道，调用者应保证通道有足够容量
+
+	// 完成后由后端填写
+	Rx  []byte // 读取的数据；提交时 cap(Rx) 足够则复用该缓冲区，不分配内存
+	N   int    // 实际写入或读取的字节数
+	Err error  // 传输错误
+}
+
+// rxBuffer 返回长度为 n 的接收缓冲区，优先复用 t.Rx
+func (t *Transfer) rxBuffer(n int) []byte {
+	if cap(t.Rx) >= n {
+		return t.Rx[:n]
+	}
+	return make([]byte, n)
+}
+
+// Backend 执行传输的后端
+// Execute 按顺序执行一批传输并填写每个传输的 Rx、N 与 Err，可以把相邻的可合并传输合并为一次总线调用。
+// 同一个后端的 Execute 不会被并发调用。
+type Backend interface {
+	Execute(batch []*Transfer)
+}
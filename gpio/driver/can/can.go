@@ -4,6 +4,8 @@ import (
 	"bytes"
 	"circuit/gpio/driver"
 	"errors"
+	"sync"
+	"sync/atomic"
 	"time"
 )
 
@@ -11,6 +13,14 @@ import (
 type CANDriver struct {
 	uart driver.UART       // 底层UART接口
 	cfg  *driver.CANConfig // CAN配置
+
+	mu     sync.Mutex                  // 保护读协程的启动与停止
+	reader atomic.Pointer[frameReader] // 后台读协程，未启动时为 nil
+
+	txMu       sync.Mutex                // 保护发送缓冲区与模板缓存
+	txBuf      []byte                    // 复用的发送缓冲区
+	txProto    *driver.CANProtocolConfig // txTemplate 对应的协议配置
+	txTemplate *frameTemplate            // 预编译的发送帧模板
 }
 
 // getProtocol 获取协议配置，如果为空则返回默认配置
@@ -75,8 +85,9 @@ func NewCANDriver(uart driver.UART, cfg *driver.CANConfig) (driver.CAN, error) {
 	}, nil
 }
 
-// Close 关闭设备
+// Close 关闭设备，同时停止后台读协程
 func (d *CANDriver) Close() error {
+	d.StopReader()
 	return d.uart.Close()
 }
 
@@ -109,11 +120,15 @@ func (d *CANDriver) InitCAN(uart driver.UART, cfg *driver.CANConfig) error {
 		return errors.New("CAN config cannot be nil")
 	}
 	// 如果已经有UART实例，先关闭旧的
+	d.StopReader()
 	if d.uart != nil {
 		d.uart.Close()
 	}
+	d.txMu.Lock()
 	d.uart = uart
 	d.cfg = cfg
+	d.txProto, d.txTemplate = nil, nil
+	d.txMu.Unlock()
 	// 使用协议配置中的初始化命令
 	return d.initCAN()
 }
@@ -123,62 +138,61 @@ func (d *CANDriver) SendFrame(frame *driver.CANFrame) error {
 	if frame == nil {
 		return errors.New("CAN frame cannot be nil")
 	}
-	protocol := d.getProtocol()
-	// 优先使用解析函数
-	if protocol.ParseSendFrame != nil {
-		cmd := protocol.ParseSendFrame(frame)
-		return d.uart.Write(cmd)
-	}
-	// 回退到模板逻辑
-	if len(protocol.SendFrameCmd) == 0 {
-		// 使用默认二进制协议的发送命令
-		protocol = CANProtocolBinary()
-	}
-	// 复制命令模板
-	cmd := make([]byte, len(protocol.SendFrameCmd))
-	copy(cmd, protocol.SendFrameCmd)
-	// 替换帧ID占位符
-	idBytes := []byte{
-		byte(frame.ID >> 24),
-		byte(frame.ID >> 16),
-		byte(frame.ID >> 8),
-		byte(frame.ID),
+	d.txMu.Lock()
+	defer d.txMu.Unlock()
+	d.txBuf = d.encodeFrame(d.txBuf[:0], frame)
+	return d.uart.Write(d.txBuf)
+}
+
+// SendFrames 批量发送CAN帧
+// 所有帧编码到复用的发送缓冲区后通过一次 uart.Write 发送，减少高负载时的系统调用与适配器往返。
+// 参数:
+//   - frames: 待发送的帧，按顺序编码
+//
+// 返回值:
+//   - error: 写入失败，此时无法确定适配器已接收的帧数
+func (d *CANDriver) SendFrames(frames []driver.CANFrame) error {
+	if len(frames) == 0 {
+		return nil
 	}
-	cmd = replacePlaceholder(cmd, "{ID}", idBytes)
-	// 替换扩展帧标志
-	extByte := []byte{0}
-	if frame.Extended {
-		extByte[0] = 1
-	}
-	cmd = replacePlaceholder(cmd, "{EXT}", extByte)
-	// 替换远程帧标志
-	rtrByte := []byte{0}
-	if frame.Remote {
-		rtrByte[0] = 1
-	}
-	cmd = replacePlaceholder(cmd, "{RTR}", rtrByte)
-	// 替换属性字节（合并EXT和RTR标志）
-	var attrByte byte
-	if frame.Extended {
-		attrByte |= 0x80
-	}
-	if frame.Remote {
-		attrByte |= 0x40
-	}
-	attrByte |= frame.DLC & 0x0F
-	cmd = replacePlaceholder(cmd, "{ATTR}", []byte{attrByte})
-	// 替换数据长度
-	dlcByte := []byte{frame.DLC & 0x0F}
-	cmd = replacePlaceholder(cmd, "{DLC}", dlcByte)
-	// 替换数据（如果有）
-	if !frame.Remote && frame.DLC > 0 {
-		cmd = replacePlaceholder(cmd, "{DATA}", frame.Data[:frame.DLC])
+	d.txMu.Lock()
+	defer d.txMu.Unlock()
+	buf := d.txBuf[:0]
+	for i := range frames {
+		buf = d.encodeFrame(buf, &frames[i])
 	}
-	return d.uart.Write(cmd)
+	d.txBuf = buf
+	return d.uart.Write(buf)
+}
+
+// encodeFrame 按协议把帧编码追加到 dst，调用者需持有 txMu
+// 优先使用 ParseSendFrame，否则使用预编译的 SendFrameCmd 模板（模板为空时使用默认二进制协议）。
+func (d *CANDriver) encodeFrame(dst []byte, frame *driver.CANFrame) []byte {
+	protocol := d.cfg.Protocol
+	if protocol != nil && protocol.ParseSendFrame != nil {
+		return append(dst, protocol.ParseSendFrame(frame)...)
+	}
+	if protocol == nil || len(protocol.SendFrameCmd) == 0 {
+		return defaultTemplate.appendFrame(dst, frame)
+	}
+	// 模板在协议首次发送时编译，InitCAN 更换配置后重新编译
+	if d.txProto != protocol {
+		d.txTemplate = compileFrameTemplate(protocol.SendFrameCmd)
+		d.txProto = protocol
+	}
+	return d.txTemplate.appendFrame(dst, frame)
 }
 
 // ReceiveFrame 接收CAN帧
+// 后台读协程运行时从接收队列取帧，timeout 为最长等待毫秒数；否则单次读取并解析。
 func (d *CANDriver) ReceiveFrame(timeout uint32) (*driver.CANFrame, error) {
+	if r := d.reader.Load(); r != nil {
+		frame := &driver.CANFrame{}
+		if err := r.read(frame, time.Duration(timeout)*time.Millisecond); err != nil {
+			return nil, err
+		}
+		return frame, nil
+	}
 	protocol := d.getProtocol()
 	// 优先使用解析函数
 	if protocol.ParseReceiveFrame != nil {
@@ -274,6 +288,9 @@ func (d *CANDriver) GetStatus() (uint32, error) {
 	if len(protocol.GetStatusCmd) == 0 {
 		return 0, errors.New("GetStatus command not defined in protocol")
 	}
+	if d.reader.Load() != nil {
+		return 0, ErrReaderRunning
+	}
 	err := d.uart.Write(protocol.GetStatusCmd)
 	if err != nil {
 		return 0, err
@@ -341,6 +358,9 @@ func (d *CANDriver) GetErrorCounters() (txErr, rxErr uint32, err error) {
 	if len(protocol.GetErrorCountersCmd) == 0 {
 		return 0, 0, errors.New("GetErrorCounters command not defined in protocol")
 	}
+	if d.reader.Load() != nil {
+		return 0, 0, ErrReaderRunning
+	}
 	err = d.uart.Write(protocol.GetErrorCountersCmd)
 	if err != nil {
 		return 0, 0, err
@@ -398,41 +418,7 @@ func (d *CANDriver) SetBaudRate(baudRate uint32) error {
 
 // buildCANPacket 构建CAN帧数据包（使用默认二进制协议模板）
 func (d *CANDriver) buildCANPacket(frame *driver.CANFrame) []byte {
-	// 使用默认二进制协议的发送帧模板
-	protocol := CANProtocolBinary()
-	if len(protocol.SendFrameCmd) == 0 {
-		// 如果默认协议也没有发送命令，返回空
-		return nil
-	}
-	// 复制命令模板
-	cmd := make([]byte, len(protocol.SendFrameCmd))
-	copy(cmd, protocol.SendFrameCmd)
-	// 替换帧ID占位符
-	idBytes := []byte{
-		byte(frame.ID >> 24),
-		byte(frame.ID >> 16),
-		byte(frame.ID >> 8),
-		byte(frame.ID),
-	}
-	cmd = replacePlaceholder(cmd, "{ID}", idBytes)
-	// 替换属性字节
-	var attrByte byte
-	if frame.Extended {
-		attrByte |= 0x80
-	}
-	if frame.Remote {
-		attrByte |= 0x40
-	}
-	attrByte |= frame.DLC & 0x0F
-	cmd = replacePlaceholder(cmd, "{ATTR}", []byte{attrByte})
-	// 替换数据长度
-	dlcByte := []byte{frame.DLC & 0x0F}
-	cmd = replacePlaceholder(cmd, "{DLC}", dlcByte)
-	// 替换数据（如果有）
-	if !frame.Remote && frame.DLC > 0 {
-		cmd = replacePlaceholder(cmd, "{DATA}", frame.Data[:frame.DLC])
-	}
-	return cmd
+	return defaultTemplate.appendFrame(nil, frame)
 }
 
 // parseCANPacket 解析CAN帧数据包
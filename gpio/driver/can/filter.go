@@ -0,0 +1,292 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// 帧 ID 位宽
+const (
+	standardIDBits = 11
+	extendedIDBits = 29
+)
+
+// FrameHandler 帧订阅回调，frame 只在回调期间有效
+type FrameHandler func(frame *driver.CANFrame)
+
+// Subscription 一条 ID/掩码订阅规则
+type Subscription struct {
+	ID       uint32       // 过滤 ID
+	Mask     uint32       // 过滤掩码，置位的位必须与 ID 相同
+	Extended bool         // 匹配扩展帧还是标准帧
+	handler  FrameHandler // 回调
+	d        *Dispatcher
+}
+
+// Cancel 取消订阅，之后开始的分发不再调用该回调
+func (s *Subscription) Cancel() {
+	s.d.remove(s)
+}
+
+// matches 判断帧是否满足订阅规则
+func (s *Subscription) matches(f *driver.CANFrame) bool {
+	return f.Extended == s.Extended && (f.ID^s.ID)&s.Mask == 0
+}
+
+// trieBucket 前缀树叶节点最多直接保存的规则数，规则更少时逐条比较比继续分裂更快
+const trieBucket = 4
+
+// trieNode 掩码前缀树节点
+// 内部节点按 bit 位把规则分为该位必须为 0、必须为 1 与不关心（掩码位为 0）三组，
+// 所有规则取向相同的位不产生节点；规则不超过 trieBucket 条或低位全部不关心时直接挂在节点上逐条比较。
+type trieNode struct {
+	bit   int8     // 分裂的 ID 位，-1 表示叶节点
+	child [3]int32 // 0、1、不关心子节点的下标，0 表示没有（下标 0、1 为根节点，不会作为子节点）
+	subs  []*Subscription
+}
+
+// dispatchTable 订阅规则的只读快照，分发时无锁读取
+type dispatchTable struct {
+	exact map[uint32][]*Subscription // 精确 ID（掩码覆盖全部位）规则，键为 ID | 扩展帧标志<<31
+	nodes []trieNode                 // nodes[0] 为标准帧根节点，nodes[1] 为扩展帧根节点
+	all   []*Subscription            // 全部规则，用于重建与计算硬件过滤器
+}
+
+// DispatchStats 分发统计
+type DispatchStats struct {
+	Frames    uint64 // 分发的帧数
+	Matched   uint64 // 至少匹配一条规则的帧数
+	Unmatched uint64 // 未匹配任何规则而被过滤的帧数
+	Calls     uint64 // 回调调用次数
+}
+
+// Dispatcher 主机侧 CAN 接收过滤与按 ID 分发
+// 精确 ID 规则存放在哈希表中，带掩码的规则存放在按位展开的三叉前缀树中，
+// 每帧只需一次哈希查找和一次沿 ID 位的前缀树遍历，与订阅数量基本无关，接收方不必各自扫描每一帧。
+// 订阅变化时重建只读快照并原子替换，分发路径不加锁、不分配内存。
+type Dispatcher struct {
+	mu    sync.Mutex
+	table atomic.Pointer[dispatchTable]
+
+	frames, matched, unmatched, calls atomic.Uint64
+}
+
+// NewDispatcher 创建没有订阅规则的分发器
+func NewDispatcher() *Dispatcher {
+	d := &Dispatcher{}
+	d.table.Store(buildTable(nil))
+	return d
+}
+
+// Subscribe 订阅单个帧 ID
+// 参数:
+//   - id: 帧 ID
+//   - extended: 是否为扩展帧
+//   - handler: 收到匹配帧时的回调，在调用 Dispatch 的协程中执行
+//
+// 返回值:
+//   - *Subscription: 订阅句柄，调用 Cancel 取消
+func (d *Dispatcher) Subscribe(id uint32, extended bool, handler FrameHandler) *Subscription {
+	return d.SubscribeMask(id, 0xFFFFFFFF, extended, handler)
+}
+
+// SubscribeMask 按 ID/掩码订阅，(frame.ID ^ id) & mask == 0 的帧匹配
+// 参数:
+//   - id: 过滤 ID
+//   - mask: 过滤掩码，超出 ID 位宽（标准帧 11 位、扩展帧 29 位）的位被忽略，0 匹配所有帧
+//   - extended: 是否为扩展帧
+//   - handler: 收到匹配帧时的回调
+//
+// 返回值:
+//   - *Subscription: 订阅句柄
+func (d *Dispatcher) SubscribeMask(id, mask uint32, extended bool, handler FrameHandler) *Subscription {
+	width := idMask(extended)
+	s := &Subscription{ID: id & width & mask, Mask: mask & width, Extended: extended, handler: handler, d: d}
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	old := d.table.Load().all
+	all := make([]*Subscription, len(old), len(old)+1)
+	copy(all, old)
+	d.table.Store(buildTable(append(all, s)))
+	return s
+}
+
+// remove 删除订阅并重建快照
+func (d *Dispatcher) remove(s *Subscription) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	old := d.table.Load().all
+	all := make([]*Subscription, 0, len(old))
+	for _, x := range old {
+		if x != s {
+			all = append(all, x)
+		}
+	}
+	if len(all) != len(old) {
+		d.table.Store(buildTable(all))
+	}
+}
+
+// idMask 返回帧类型的 ID 位宽掩码
+func idMask(extended bool) uint32 {
+	if extended {
+		return 1<<extendedIDBits - 1
+	}
+	return 1<<standardIDBits - 1
+}
+
+// exactKey 精确匹配哈希表的键
+func exactKey(id uint32, extended bool) uint32 {
+	if extended {
+		return id | 1<<31
+	}
+	return id
+}
+
+// buildTable 由订阅规则构建分发快照
+func buildTable(all []*Subscription) *dispatchTable {
+	t := &dispatchTable{
+		exact: make(map[uint32][]*Subscription),
+		nodes: make([]trieNode, 2),
+		all:   all,
+	}
+	var std, ext []*Subscription
+	for _, s := range all {
+		switch {
+		case s.Mask == idMask(s.Extended):
+			k := exactKey(s.ID, s.Extended)
+			t.exact[k] = append(t.exact[k], s)
+		case s.Extended:
+			ext = append(ext, s)
+		default:
+			std = append(std, s)
+		}
+	}
+	t.build(0, std, standardIDBits-1)
+	t.build(1, ext, extendedIDBits-1)
+	return t
+}
+
+// build 从第 b 位开始把规则 subs 展开到节点 node 之下
+func (t *dispatchTable) build(node int32, subs []*Subscription, b int) {
+	t.nodes[node].bit = -1
+	for ; b >= 0 && len(subs) > trieBucket; b-- {
+		var here []*Subscription
+		var parts [3][]*Subscription
+		for _, s := range subs {
+			switch {
+			case s.Mask&(1<<(b+1)-1) == 0:
+				here = append(here, s) // 剩余位全部不关心
+			case s.Mask>>b&1 == 0:
+				parts[2] = append(parts[2], s)
+			default:
+				c := s.ID >> b & 1
+				parts[c] = append(parts[c], s)
+			}
+		}
+		if len(here) == 0 && (len(parts[0]) == len(subs) || len(parts[1]) == len(subs) || len(parts[2]) == len(subs)) {
+			continue // 该位不区分任何规则，由叶节点的逐条比较检查
+		}
+		t.nodes[node].subs = here
+		t.nodes[node].bit = int8(b)
+		for c, part := range parts {
+			if len(part) == 0 {
+				continue
+			}
+			child := int32(len(t.nodes))
+			t.nodes = append(t.nodes, trieNode{})
+			t.nodes[node].child[c] = child
+			t.build(child, part, b-1)
+		}
+		return
+	}
+	t.nodes[node].subs = subs
+}
+
+// Dispatch 把帧分发给所有匹配的订阅，返回调用的回调数
+// 可以在多个协程中并发调用，订阅的增删不影响正在进行的分发。
+func (d *Dispatcher) Dispatch(frame *driver.CANFrame) int {
+	t := d.table.Load()
+	n := 0
+	for _, s := range t.exact[exactKey(frame.ID, frame.Extended)] {
+		s.handler(frame)
+		n++
+	}
+	if frame.Extended {
+		n += t.walk(1, frame)
+	} else {
+		n += t.walk(0, frame)
+	}
+	d.frames.Add(1)
+	if n > 0 {
+		d.matched.Add(1)
+		d.calls.Add(uint64(n))
+	} else {
+		d.unmatched.Add(1)
+	}
+	return n
+}
+
+// walk 沿前缀树匹配帧 ID，返回调用的回调数
+func (t *dispatchTable) walk(node int32, frame *driver.CANFrame) int {
+	nd := &t.nodes[node]
+	n := 0
+	for _, s := range nd.subs {
+		if s.matches(frame) {
+			s.handler(frame)
+			n++
+		}
+	}
+	if nd.bit < 0 {
+		return n
+	}
+	if c := nd.child[frame.ID>>nd.bit&1]; c != 0 {
+		n += t.walk(c, frame)
+	}
+	if c := nd.child[2]; c != 0 {
+		n += t.walk(c, frame)
+	}
+	return n
+}
+
+// Stats 返回分发统计
+func (d *Dispatcher) Stats() DispatchStats {
+	return DispatchStats{
+		Frames:    d.frames.Load(),
+		Matched:   d.matched.Load(),
+		Unmatched: d.unmatched.Load(),
+		Calls:     d.calls.Load(),
+	}
+}
+
+// CoverFilter 计算覆盖全部订阅的单个 ID/掩码，可传给 SetFilter 让适配器预先过滤
+// 掩码只保留所有规则都关心且取值一致的位，因此适配器放行的帧是订阅帧的超集，最终由 Dispatch 精确过滤。
+// 没有订阅时返回 ok 为 false。
+func (d *Dispatcher) CoverFilter() (id, mask uint32, ok bool) {
+	all := d.table.Load().all
+	if len(all) == 0 {
+		return 0, 0, false
+	}
+	id, mask = all[0].ID, 0xFFFFFFFF
+	for _, s := range all {
+		mask &= s.Mask &^ (s.ID ^ id)
+	}
+	return id & mask, mask, true
+}
+
+// Run 从接收端取帧并分发，直到接收端停止
+// 接收端为 CANDriver 时需要先调用 StartReader。
+func (d *Dispatcher) Run(src FrameSource) {
+	var frame driver.CANFrame
+	for {
+		switch err := src.ReadFrame(&frame, time.Second); err {
+		case nil:
+			d.Dispatch(&frame)
+		case ErrReceiveTimeout:
+		default:
+			return
+		}
+	}
+}
@@ -0,0 +1,147 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"math/rand"
+	"testing"
+)
+
+// randomRules 生成 n 条订阅规则：约一半为精确 ID，其余为随机前缀或随机位掩码
+func randomRules(rng *rand.Rand, n int) [][3]uint32 {
+	rules := make([][3]uint32, n)
+	for i := range rules {
+		ext := uint32(rng.Intn(2))
+		width := idMask(ext == 1)
+		id := rng.Uint32() & width
+		var mask uint32
+		switch rng.Intn(4) {
+		case 0, 1:
+			mask = width
+		case 2:
+			mask = width &^ (1<<rng.Intn(6) - 1) // 低位不关心
+		default:
+			mask = rng.Uint32() & width
+		}
+		rules[i] = [3]uint32{id, mask, ext}
+	}
+	return rules
+}
+
+func TestDispatcherMatchesLinearScan(t *testing.T) {
+	rng := rand.New(rand.NewSource(8))
+	d := NewDispatcher()
+	rules := randomRules(rng, 400)
+	hits := make([]int, len(rules))
+	subs := make([]*Subscription, len(rules))
+	for i, r := range rules {
+		i := i
+		subs[i] = d.SubscribeMask(r[0], r[1], r[2] == 1, func(*driver.CANFrame) { hits[i]++ })
+	}
+	// 取消一部分订阅
+	for i := 0; i < len(subs); i += 7 {
+		subs[i].Cancel()
+	}
+	frames := randomFrames(rng, 5000)
+	// 一半的帧使用规则中的 ID，保证有足够的命中
+	for i := 0; i < len(frames); i += 2 {
+		r := rules[rng.Intn(len(rules))]
+		frames[i].ID, frames[i].Extended = r[0]^(rng.Uint32()&^r[1]&idMask(r[2] == 1)), r[2] == 1
+	}
+	want := make([]int, len(rules))
+	for i := range frames {
+		got := d.Dispatch(&frames[i])
+		n := 0
+		for j, s := range subs {
+			if j%7 != 0 && s.matches(&frames[i]) {
+				want[j]++
+				n++
+			}
+		}
+		if got != n {
+			t.Fatalf("帧 %+v: 调用 %d 个回调，期望 %d", frames[i], got, n)
+		}
+	}
+	for j := range rules {
+		if hits[j] != want[j] {
+			t.Fatalf("规则 %d %x: 命中 %d 次，期望 %d", j, rules[j], hits[j], want[j])
+		}
+	}
+	stats := d.Stats()
+	if stats.Frames != uint64(len(frames)) || stats.Matched+stats.Unmatched != stats.Frames || stats.Matched == 0 {
+		t.Fatalf("统计 %+v", stats)
+	}
+}
+
+func TestDispatcherCoverFilter(t *testing.T) {
+	d := NewDispatcher()
+	if _, _, ok := d.CoverFilter(); ok {
+		t.Fatal("没有订阅时 CoverFilter 返回 ok")
+	}
+	d.Subscribe(0x120, false, func(*driver.CANFrame) {})
+	d.Subscribe(0x123, false, func(*driver.CANFrame) {})
+	d.SubscribeMask(0x130, 0x7F0, false, func(*driver.CANFrame) {})
+	id, mask, ok := d.CoverFilter()
+	if !ok || id != 0x120 || mask != 0x7E0 {
+		t.Fatalf("CoverFilter = %#x/%#x，期望 0x120/0x7e0", id, mask)
+	}
+}
+
+func TestDispatchZeroAlloc(t *testing.T) {
+	d := NewDispatcher()
+	for _, r := range randomRules(rand.New(rand.NewSource(9)), 200) {
+		d.SubscribeMask(r[0], r[1], r[2] == 1, func(*driver.CANFrame) {})
+	}
+	frames := randomFrames(rand.New(rand.NewSource(10)), 64)
+	if allocs := testing.AllocsPerRun(100, func() {
+		for i := range frames {
+			d.Dispatch(&frames[i])
+		}
+	}); allocs != 0 {
+		t.Fatalf("分发每轮分配 %.1f 次", allocs)
+	}
+}
+
+func BenchmarkDispatch(b *testing.B) {
+	rng := rand.New(rand.NewSource(11))
+	// vehicle: 数百个精确 ID 加少量按低位分组的范围订阅；mixed: 含 1/4 随机掩码的规则
+	vehicle := make([][3]uint32, 0, 500)
+	for i := 0; i < 450; i++ {
+		vehicle = append(vehicle, [3]uint32{rng.Uint32() & 0x7FF, 0x7FF, 0})
+	}
+	for i := 0; i < 50; i++ {
+		vehicle = append(vehicle, [3]uint32{rng.Uint32() & 0x7F0, 0x7F0, 0})
+	}
+	for _, set := range []struct {
+		name  string
+		rules [][3]uint32
+	}{{"vehicle", vehicle}, {"mixed", randomRules(rng, 500)}} {
+		rules := set.rules
+		frames := randomFrames(rng, 1024)
+		for i := range frames {
+			if i%2 == 0 {
+				r := rules[rng.Intn(len(rules))]
+				frames[i].ID, frames[i].Extended = r[0], r[2] == 1
+			}
+		}
+		d := NewDispatcher()
+		var subs []*Subscription
+		for _, r := range rules {
+			subs = append(subs, d.SubscribeMask(r[0], r[1], r[2] == 1, func(*driver.CANFrame) {}))
+		}
+		b.Run(set.name+"/linear", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				f := &frames[i%len(frames)]
+				for _, s := range subs {
+					if s.matches(f) {
+						s.handler(f)
+					}
+				}
+			}
+		})
+		b.Run(set.name+"/dispatcher", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				d.Dispatch(&frames[i%len(frames)])
+			}
+		})
+	}
+}
@@ -0,0 +1,228 @@
+package can
+
+import (
+	"bytes"
+	"circuit/gpio/driver"
+	"errors"
+)
+
+// slcanMaxLine SLCAN 一行的最大长度: 'T' + 8 位 ID + DLC + 16 位数据 + 4 位时间戳
+const slcanMaxLine = 1 + 8 + 1 + 16 + 4
+
+// 解析器类型
+const (
+	parserSLCAN  = iota // ASCII 行协议，以 '\r' 结束（SLCAN / CANable）
+	parserBinary        // 起始标记 + 4 字节 ID + 属性字节 + 数据
+)
+
+// 二进制帧的解析阶段
+const (
+	binMarker = iota // 匹配起始标记
+	binHeader        // 接收 ID 与属性字节
+	binData          // 接收数据
+)
+
+// frameParser 增量帧解析器
+// 每次 feed 消费任意长度的输入，不完整的帧保存在解析器状态中，跨越多次读取的帧无需拼接缓冲区。
+// 解析过程不分配内存。
+type frameParser struct {
+	kind      int
+	marker    []byte // 二进制帧起始标记
+	fail      []int  // 起始标记的 KMP 失配表：fail[i] 为 marker[:i+1] 最长的相等真前缀与后缀的长度
+	state     int
+	n         int // 当前阶段已接收的字节数
+	line      [slcanMaxLine]byte
+	header    [5]byte
+	skip      bool // SLCAN 行超长，丢弃直到行结束
+	frame     driver.CANFrame
+	malformed uint64 // 格式错误的帧数
+}
+
+// newFrameParser 根据协议配置选择解析器
+// 帧起始标记为 "\r" 的协议（SLCAN、CANable）按 ASCII 行解析，其他标记按二进制帧解析。
+func newFrameParser(protocol *driver.CANProtocolConfig) (*frameParser, error) {
+	switch {
+	case bytes.Equal(protocol.FrameStartMarker, []byte("\r")):
+		return &frameParser{kind: parserSLCAN}, nil
+	case len(protocol.FrameStartMarker) > 0:
+		marker := protocol.FrameStartMarker
+		return &frameParser{kind: parserBinary, marker: marker, fail: markerFailure(marker)}, nil
+	}
+	return nil, errors.New("can: streaming reader requires FrameStartMarker")
+}
+
+// markerFailure 计算起始标记的 KMP 失配表
+// 自重叠的标记（如 AA AA 55）失配时回退到已匹配部分的最长可用前缀，而不是从头重新匹配。
+func markerFailure(marker []byte) []int {
+	fail := make([]int, len(marker))
+	for i, k := 1, 0; i < len(marker); i++ {
+		for k > 0 && marker[i] != marker[k] {
+			k = fail[k-1]
+		}
+		if marker[i] == marker[k] {
+			k++
+		}
+		fail[i] = k
+	}
+	return fail
+}
+
+// feed 从 data 开头解析，遇到完整帧时停止
+// 返回值:
+//   - n: 消费的字节数
+//   - ok: 是否解析出完整帧，帧保存在 p.frame 中，下次 feed 前有效
+func (p *frameParser) feed(data []byte) (n int, ok bool) {
+	if p.kind == parserSLCAN {
+		return p.feedSLCAN(data)
+	}
+	return p.feedBinary(data)
+}
+
+// feedSLCAN 按行解析 SLCAN 数据帧（t/T/r/R），其他行（命令应答、'\a' 错误响应等）被忽略
+func (p *frameParser) feedSLCAN(data []byte) (int, bool) {
+	for i, b := range data {
+		switch b {
+		case '\r', '\n':
+			line := p.line[:p.n]
+			skip := p.skip
+			p.n, p.skip = 0, false
+			if skip || len(line) == 0 {
+				continue
+			}
+			switch line[0] {
+			case 't', 'T', 'r', 'R':
+				if p.decodeSLCAN(line) {
+					return i + 1, true
+				}
+				p.malformed++
+			}
+		case '\a':
+			// 适配器的错误响应没有行结束符
+			p.n, p.skip = 0, false
+		default:
+			if p.n == len(p.line) {
+				if !p.skip && (p.line[0] == 't' || p.line[0] == 'T' || p.line[0] == 'r' || p.line[0] == 'R') {
+					p.malformed++
+				}
+				p.skip = true
+				continue
+			}
+			if !p.skip {
+				p.line[p.n] = b
+				p.n++
+			}
+		}
+	}
+	return len(data), false
+}
+
+// decodeSLCAN 解析一行 SLCAN 帧: tIIILDD.. / TIIIIIIIILDD.. / rIIIL / RIIIIIIIIL，
+// 末尾可以带 4 位十六进制时间戳（忽略，使用主机时间戳）
+func (p *frameParser) decodeSLCAN(line []byte) bool {
+	f := &p.frame
+	*f = driver.CANFrame{}
+	idLen := 3
+	if line[0] == 'T' || line[0] == 'R' {
+		idLen = 8
+		f.Extended = true
+	}
+	f.Remote = line[0] == 'r' || line[0] == 'R'
+	if len(line) < 2+idLen {
+		return false
+	}
+	id, ok := parseHex(line[1 : 1+idLen])
+	dlc, ok2 := parseHex(line[1+idLen : 2+idLen])
+	if !ok || !ok2 || dlc > 8 {
+		return false
+	}
+	f.ID, f.DLC = id, uint8(dlc)
+	rest := line[2+idLen:]
+	if !f.Remote {
+		if len(rest) < 2*int(dlc) {
+			return false
+		}
+		for i := 0; i < int(dlc); i++ {
+			v, ok := parseHex(rest[2*i : 2*i+2])
+			if !ok {
+				return false
+			}
+			f.Data[i] = byte(v)
+		}
+		rest = rest[2*dlc:]
+	}
+	return len(rest) == 0 || len(rest) == 4
+}
+
+// parseHex 解析最多 8 位十六进制数字
+func parseHex(s []byte) (uint32, bool) {
+	var v uint32
+	for _, c := range s {
+		switch {
+		case c >= '0' && c <= '9':
+			c -= '0'
+		case c >= 'a' && c <= 'f':
+			c -= 'a' - 10
+		case c >= 'A' && c <= 'F':
+			c -= 'A' - 10
+		default:
+			return 0, false
+		}
+		v = v<<4 | uint32(c)
+	}
+	return v, true
+}
+
+// feedBinary 解析二进制帧: 起始标记 + ID(4 字节大端) + 属性(bit7=扩展帧, bit6=远程帧, 低 4 位 DLC) + 数据
+func (p *frameParser) feedBinary(data []byte) (int, bool) {
+	for i := 0; i < len(data); i++ {
+		b := data[i]
+		switch p.state {
+		case binMarker:
+			for p.n > 0 && b != p.marker[p.n] {
+				p.n = p.fail[p.n-1]
+			}
+			if b == p.marker[p.n] {
+				p.n++
+			}
+			if p.n == len(p.marker) {
+				p.state, p.n = binHeader, 0
+			}
+		case binHeader:
+			p.header[p.n] = b
+			p.n++
+			if p.n < len(p.header) {
+				continue
+			}
+			h := p.header
+			f := &p.frame
+			*f = driver.CANFrame{
+				ID:       uint32(h[0])<<24 | uint32(h[1])<<16 | uint32(h[2])<<8 | uint32(h[3]),
+				Extended: h[4]&0x80 != 0,
+				Remote:   h[4]&0x40 != 0,
+				DLC:      h[4] & 0x0F,
+			}
+			p.n = 0
+			switch {
+			case f.DLC > 8:
+				// 非法长度，重新搜索起始标记
+				p.malformed++
+				p.state = binMarker
+			case f.Remote || f.DLC == 0:
+				p.state = binMarker
+				return i + 1, true
+			default:
+				p.state = binData
+			}
+		case binData:
+			// 整段复制剩余数据
+			k := copy(p.frame.Data[p.n:p.frame.DLC], data[i:])
+			p.n += k
+			i += k - 1
+			if p.n == int(p.frame.DLC) {
+				p.state, p.n = binMarker, 0
+				return i + 1, true
+			}
+		}
+	}
+	return len(data), false
+}
@@ -0,0 +1,225 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"fmt"
+	"math/rand"
+	"testing"
+)
+
+// slcanLine 按 SLCAN 格式编码一帧
+func slcanLine(f *driver.CANFrame) string {
+	var s string
+	switch {
+	case f.Extended && f.Remote:
+		s = fmt.Sprintf("R%08X%d", f.ID, f.DLC)
+	case f.Extended:
+		s = fmt.Sprintf("T%08X%d", f.ID, f.DLC)
+	case f.Remote:
+		s = fmt.Sprintf("r%03X%d", f.ID, f.DLC)
+	default:
+		s = fmt.Sprintf("t%03X%d", f.ID, f.DLC)
+	}
+	if !f.Remote {
+		for _, b := range f.Data[:f.DLC] {
+			s += fmt.Sprintf("%02X", b)
+		}
+	}
+	return s + "\r"
+}
+
+// binaryPacket 按二进制协议编码一帧（起始标记 0xAA 0x55 0x0A）
+func binaryPacket(f *driver.CANFrame) []byte {
+	attr := f.DLC
+	if f.Extended {
+		attr |= 0x80
+	}
+	if f.Remote {
+		attr |= 0x40
+	}
+	p := []byte{0xAA, 0x55, 0x0A, byte(f.ID >> 24), byte(f.ID >> 16), byte(f.ID >> 8), byte(f.ID), attr}
+	if !f.Remote {
+		p = append(p, f.Data[:f.DLC]...)
+	}
+	return p
+}
+
+// randomFrames 生成 n 个随机帧
+func randomFrames(rng *rand.Rand, n int) []driver.CANFrame {
+	frames := make([]driver.CANFrame, n)
+	for i := range frames {
+		f := &frames[i]
+		f.Extended = rng.Intn(3) == 0
+		f.Remote = rng.Intn(8) == 0
+		f.DLC = uint8(rng.Intn(9))
+		if f.Extended {
+			f.ID = rng.Uint32() & 0x1FFFFFFF
+		} else {
+			f.ID = rng.Uint32() & 0x7FF
+		}
+		if !f.Remote {
+			rng.Read(f.Data[:f.DLC])
+		}
+	}
+	return frames
+}
+
+// recordedTraffic 生成一段包含帧、命令应答与噪声的串口流量
+func recordedTraffic(protocol *driver.CANProtocolConfig, frames []driver.CANFrame) []byte {
+	var out []byte
+	for i := range frames {
+		if protocol.FrameStartMarker[0] == '\r' {
+			if i%5 == 0 {
+				out = append(out, "z\r"...) // 发送应答
+			}
+			out = append(out, slcanLine(&frames[i])...)
+		} else {
+			if i%5 == 0 {
+				out = append(out, 0xAA, 0x13) // 起始标记不完整的噪声
+			}
+			out = append(out, binaryPacket(&frames[i])...)
+		}
+	}
+	return out
+}
+
+// sameFrame 比较帧内容（忽略时间戳）
+func sameFrame(a, b *driver.CANFrame) bool {
+	a2, b2 := *a, *b
+	a2.Timestamp, b2.Timestamp = 0, 0
+	return a2 == b2
+}
+
+func TestFrameParserChunked(t *testing.T) {
+	for _, protocol := range []*driver.CANProtocolConfig{CANProtocolSLCAN(), CANProtocolBinary()} {
+		rng := rand.New(rand.NewSource(1))
+		frames := randomFrames(rng, 500)
+		traffic := recordedTraffic(protocol, frames)
+		p, err := newFrameParser(protocol)
+		if err != nil {
+			t.Fatal(err)
+		}
+		// 以随机长度切分流量，模拟串口的任意读取边界
+		var got []driver.CANFrame
+		for data := traffic; len(data) > 0; {
+			k := 1 + rng.Intn(40)
+			if k > len(data) {
+				k = len(data)
+			}
+			chunk := data[:k]
+			data = data[k:]
+			for len(chunk) > 0 {
+				n, ok := p.feed(chunk)
+				chunk = chunk[n:]
+				if ok {
+					got = append(got, p.frame)
+				}
+			}
+		}
+		if len(got) != len(frames) {
+			t.Fatalf("%q: 解析出 %d 帧，期望 %d", protocol.FrameStartMarker, len(got), len(frames))
+		}
+		for i := range frames {
+			if !sameFrame(&got[i], &frames[i]) {
+				t.Fatalf("%q: 第 %d 帧 %+v，期望 %+v", protocol.FrameStartMarker, i, got[i], frames[i])
+			}
+		}
+		if p.malformed != 0 {
+			t.Fatalf("%q: malformed = %d", protocol.FrameStartMarker, p.malformed)
+		}
+	}
+}
+
+func TestFrameParserMalformed(t *testing.T) {
+	p, _ := newFrameParser(CANProtocolSLCAN())
+	input := []byte("t12X1AA\rt1239\r\a" + "t12300112233445566778899AABBCCDD\rt1231AB\r")
+	var got []driver.CANFrame
+	for len(input) > 0 {
+		n, ok := p.feed(input)
+		input = input[n:]
+		if ok {
+			got = append(got, p.frame)
+		}
+	}
+	if len(got) != 1 || got[0].ID != 0x123 || got[0].DLC != 1 || got[0].Data[0] != 0xAB {
+		t.Fatalf("解析结果 %+v", got)
+	}
+	if p.malformed != 3 {
+		t.Fatalf("malformed = %d，期望 3", p.malformed)
+	}
+}
+
+func TestFrameParserOverlappingMarker(t *testing.T) {
+	// 自重叠的起始标记：多出的 0xAA 与部分匹配后失配的字节不应使解析失去同步
+	protocol := &driver.CANProtocolConfig{FrameStartMarker: []byte{0xAA, 0xAA, 0x55}}
+	p, err := newFrameParser(protocol)
+	if err != nil {
+		t.Fatal(err)
+	}
+	packet := func(id byte) []byte { return []byte{0, 0, 0, id, 1, id} }
+	var input []byte
+	input = append(input, 0xAA, 0xAA, 0xAA, 0x55)
+	input = append(input, packet(1)...)
+	input = append(input, 0xAA, 0xAA, 0xAA, 0xAA, 0x55)
+	input = append(input, packet(2)...)
+	input = append(input, 0xAA, 0x55, 0xAA, 0xAA, 0x13, 0xAA, 0xAA, 0x55)
+	input = append(input, packet(3)...)
+	var got []byte
+	for len(input) > 0 {
+		n, ok := p.feed(input)
+		input = input[n:]
+		if ok {
+			if p.frame.DLC != 1 || p.frame.Data[0] != byte(p.frame.ID) {
+				t.Fatalf("帧 %+v", p.frame)
+			}
+			got = append(got, byte(p.frame.ID))
+		}
+	}
+	if string(got) != "\x01\x02\x03" {
+		t.Fatalf("解析出帧 %v，期望 [1 2 3]", got)
+	}
+}
+
+func TestFrameQueue(t *testing.T) {
+	q := newFrameQueue(4)
+	var f driver.CANFrame
+	for i := range 4 {
+		f.ID = uint32(i)
+		if !q.push(&f) {
+			t.Fatalf("第 %d 次入队失败", i)
+		}
+	}
+	if q.push(&f) {
+		t.Fatal("队列已满时入队成功")
+	}
+	for i := range 4 {
+		if !q.pop(&f) || f.ID != uint32(i) {
+			t.Fatalf("第 %d 次出队: %+v", i, f)
+		}
+	}
+	if q.pop(&f) {
+		t.Fatal("队列为空时出队成功")
+	}
+}
+
+func TestFrameParserZeroAlloc(t *testing.T) {
+	protocol := CANProtocolSLCAN()
+	traffic := recordedTraffic(protocol, randomFrames(rand.New(rand.NewSource(2)), 64))
+	p, _ := newFrameParser(protocol)
+	q := newFrameQueue(128)
+	var f driver.CANFrame
+	allocs := testing.AllocsPerRun(100, func() {
+		for data := traffic; len(data) > 0; {
+			n, ok := p.feed(data)
+			data = data[n:]
+			if ok {
+				q.push(&p.frame)
+			}
+		}
+		for q.pop(&f) {
+		}
+	})
+	if allocs != 0 {
+		t.Fatalf("解析与入队每轮分配 %.1f 次", allocs)
+	}
+}
@@ -0,0 +1,144 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"sync/atomic"
+)
+
+// queueSlot 帧队列中的一个槽位
+// seq 记录槽位当前可以被哪个位置写入或读取，帧数据在 seq 发布之后才对另一方可见。
+type queueSlot struct {
+	seq   atomic.Uint64
+	frame driver.CANFrame
+}
+
+// frameQueue 有界无锁多生产者多消费者帧队列
+// 基于每槽位序号的环形数组实现，入队与出队各只需一次 CAS，帧按值复制，不分配内存。
+type frameQueue struct {
+	slots []queueSlot
+	mask  uint64
+	_     [56]byte // 分隔读写位置，避免伪共享
+	tail  atomic.Uint64
+	_     [56]byte
+	head  atomic.Uint64
+}
+
+// newFrameQueue 创建容量为 size（向上取整到 2 的幂）的帧队列
+func newFrameQueue(size int) *frameQueue {
+	n := 2
+	for n < size {
+		n <<= 1
+	}
+	q := &frameQueue{slots: make([]queueSlot, n), mask: uint64(n - 1)}
+	for i := range q.slots {
+		q.slots[i].seq.Store(uint64(i))
+	}
+	return q
+}
+
+// push 复制帧到队尾，队列已满时返回 false
+func (q *frameQueue) push(f *driver.CANFrame) bool {
+	pos := q.tail.Load()
+	for {
+		s := &q.slots[pos&q.mask]
+		seq := s.seq.Load()
+		switch dif := int64(seq - pos); {
+		case dif == 0:
+			if q.tail.CompareAndSwap(pos, pos+1) {
+				s.frame = *f
+				s.seq.Store(pos + 1)
+				return true
+			}
+			pos = q.tail.Load()
+		case dif < 0:
+			return false
+		default:
+			pos = q.tail.Load()
+		}
+	}
+}
+
+// pop 取出队首帧复制到 f，队列为空时返回 false
+func (q *frameQueue) pop(f *driver.CANFrame) bool {
+	pos := q.head.Load()
+	for {
+		s := &q.slots[pos&q.mask]
+		seq := s.seq.Load()
+		switch dif := int64(seq - (pos + 1)); {
+		case dif == 0:
+			if q.head.CompareAndSwap(pos, pos+1) {
+				*f = s.frame
+				s.seq.Store(pos + q.mask + 1)
+				return true
+			}
+			pos = q.head.Load()
+		case dif < 0:
+			return false
+		default:
+			pos = q.head.Load()
+		}
+	}
+}
+
+// len 返回队列中的帧数（并发修改时为近似值）
+func (q *frameQueue) len() int {
+	n := int64(q.tail.Load() - q.head.Load())
+	if n < 0 {
+		return 0
+	}
+	return int(n)
+}
+
+// byteRing 读协程使用的字节环形缓冲区
+// 串口数据直接读入空闲区域，解析器从已读区域消费，跨越缓冲区末尾的帧不需要搬移数据。
+// 只由读协程访问，不需要同步。
+type byteRing struct {
+	buf  []byte
+	mask int
+	r, w int // 读写位置，单调递增，取模后索引
+}
+
+// newByteRing 创建容量为 size（向上取整到 2 的幂）的环形缓冲区
+func newByteRing(size int) byteRing {
+	n := 64
+	for n < size {
+		n <<= 1
+	}
+	return byteRing{buf: make([]byte, n), mask: n - 1}
+}
+
+// space 返回写位置开始的连续空闲区域
+func (b *byteRing) space() []byte {
+	if b.w-b.r == len(b.buf) {
+		return nil
+	}
+	start, end := b.w&b.mask, len(b.buf)
+	if r := b.r & b.mask; r > start {
+		end = r
+	}
+	return b.buf[start:end]
+}
+
+// commit 标记 space 返回区域中前 n 个字节已写入
+func (b *byteRing) commit(n int) {
+	b.w += n
+}
+
+// data 返回读位置开始的连续已写区域
+func (b *byteRing) data() []byte {
+	start := b.r & b.mask
+	n := b.w - b.r
+	if start+n > len(b.buf) {
+		return b.buf[start:]
+	}
+	return b.buf[start : start+n]
+}
+
+// consume 丢弃已读区域开头的 n 个字节
+func (b *byteRing) consume(n int) {
+	b.r += n
+	if b.r == b.w {
+		// 缓冲区为空时回到开头，使下一次读取获得最大的连续空间
+		b.r, b.w = 0, 0
+	}
+}
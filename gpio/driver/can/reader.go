@@ -0,0 +1,289 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"errors"
+	"io"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// 读协程相关错误
+var (
+	ErrReceiveTimeout = errors.New("can: receive timeout")
+	ErrReaderStopped  = errors.New("can: reader stopped")
+	ErrReaderRunning  = errors.New("can: command responses are consumed by the running reader")
+)
+
+// readerPoll 读协程单次等待数据的最长时间，决定 StopReader 的响应延迟
+const readerPoll = 50 * time.Millisecond
+
+// eventUART 支持就绪等待并读入调用者缓冲区的 UART（如 serial 包基于 epoll 的实现）
+// 读协程检测到 UART 实现该接口时阻塞等待可读事件并直接读入环形缓冲区，不分配内存。
+type eventUART interface {
+	WaitReadable(timeout time.Duration) (bool, error)
+	ReadInto(buf []byte) (int, error)
+}
+
+// FrameSource 可以不分配内存地逐帧读取的接收端，如启动了读协程的 CANDriver 与 VirtualNode
+type FrameSource interface {
+	ReadFrame(frame *driver.CANFrame, timeout time.Duration) error
+}
+
+// ReaderStats 读协程统计
+type ReaderStats struct {
+	Frames     uint64 // 解析出的帧数
+	Dropped    uint64 // 接收队列已满而丢弃的帧数
+	Malformed  uint64 // 格式错误的帧数
+	Bytes      uint64 // 读取的字节数
+	ReadErrors uint64 // 底层读取错误次数
+	Queued     int    // 队列中等待读取的帧数
+}
+
+// frameReader 后台读协程
+// 串口数据读入字节环形缓冲区，增量解析出的帧附带主机时间戳放入有界无锁队列，
+// 队列满时丢弃新帧并计数，接收方不会阻塞读协程。
+type frameReader struct {
+	uart   driver.UART
+	ev     eventUART
+	ring   byteRing
+	parser *frameParser
+	queue  *frameQueue
+	notify chan struct{} // 有新帧时的唤醒信号
+	stop   chan struct{}
+	done   chan struct{}
+
+	frames, dropped, malformed, bytes, readErrors atomic.Uint64
+}
+
+// timerPool 复用接收等待的定时器，稳态下 ReadFrame 不分配内存
+var timerPool sync.Pool
+
+// StartReader 启动后台读协程
+// 启动后 ReceiveFrame 与 ReadFrame 从接收队列取帧，突发到达的多个帧不会丢失；
+// 只支持按 FrameStartMarker 组帧的协议（SLCAN、CANable、二进制），仅提供 ParseReceiveFrame 的协议不支持。
+// 参数:
+//   - depth: 接收队列容量（向上取整到 2 的幂），队列满时新帧被丢弃并计入 ReaderStats.Dropped
+//
+// 返回值:
+//   - error: 读协程已在运行或协议不支持流式解析
+//
+// 注意: 运行期间串口数据全部由读协程消费，GetStatus 与 GetErrorCounters 返回 ErrReaderRunning。
+//
+// 示例用法：
+//
+//	c, _ := can.OpenCAN(uart, &driver.CANConfig{Protocol: can.CANProtocolSLCAN()})
+//	d := c.(*can.CANDriver)
+//	d.StartReader(1024)
+//	var frame driver.CANFrame
+//	for d.ReadFrame(&frame, time.Second) == nil {
+//		// 处理 frame
+//	}
+func (d *CANDriver) StartReader(depth int) error {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if d.reader.Load() != nil {
+		return errors.New("can: reader already running")
+	}
+	parser, err := newFrameParser(d.getProtocol())
+	if err != nil {
+		return err
+	}
+	if depth <= 0 {
+		depth = 256
+	}
+	r := &frameReader{
+		uart:   d.uart,
+		ring:   newByteRing(4096),
+		parser: parser,
+		queue:  newFrameQueue(depth),
+		notify: make(chan struct{}, 1),
+		stop:   make(chan struct{}),
+		done:   make(chan struct{}),
+	}
+	r.ev, _ = d.uart.(eventUART)
+	d.reader.Store(r)
+	go r.run()
+	return nil
+}
+
+// StopReader 停止后台读协程并等待其退出，队列中未读取的帧被丢弃
+func (d *CANDriver) StopReader() {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	r := d.reader.Swap(nil)
+	if r == nil {
+		return
+	}
+	close(r.stop)
+	<-r.done
+}
+
+// ReaderStats 返回读协程统计，读协程未启动时返回零值
+func (d *CANDriver) ReaderStats() ReaderStats {
+	r := d.reader.Load()
+	if r == nil {
+		return ReaderStats{}
+	}
+	return ReaderStats{
+		Frames:     r.frames.Load(),
+		Dropped:    r.dropped.Load(),
+		Malformed:  r.malformed.Load(),
+		Bytes:      r.bytes.Load(),
+		ReadErrors: r.readErrors.Load(),
+		Queued:     r.queue.len(),
+	}
+}
+
+// ReadFrame 从接收队列取出一帧复制到 frame，不分配内存
+// 参数:
+//   - frame: 接收帧的目标，Timestamp 为收到帧最后一个字节时的主机时间（UnixNano）
+//   - timeout: 最长等待时间，0 表示不等待
+//
+// 返回值:
+//   - error: 超时返回 ErrReceiveTimeout，读协程未启动或已停止返回 ErrReaderStopped
+func (d *CANDriver) ReadFrame(frame *driver.CANFrame, timeout time.Duration) error {
+	r := d.reader.Load()
+	if r == nil {
+		return ErrReaderStopped
+	}
+	return r.read(frame, timeout)
+}
+
+// read 从队列取帧，队列为空时等待唤醒信号或超时
+func (r *frameReader) read(frame *driver.CANFrame, timeout time.Duration) error {
+	if r.pop(frame) {
+		return nil
+	}
+	if timeout <= 0 {
+		select {
+		case <-r.done:
+			return ErrReaderStopped
+		default:
+			return ErrReceiveTimeout
+		}
+	}
+	t, _ := timerPool.Get().(*time.Timer)
+	if t == nil {
+		t = time.NewTimer(timeout)
+	} else {
+		t.Reset(timeout)
+	}
+	defer func() {
+		if !t.Stop() {
+			select {
+			case <-t.C:
+			default:
+			}
+		}
+		timerPool.Put(t)
+	}()
+	for {
+		select {
+		case <-r.notify:
+			if r.pop(frame) {
+				return nil
+			}
+		case <-t.C:
+			if r.pop(frame) {
+				return nil
+			}
+			return ErrReceiveTimeout
+		case <-r.done:
+			if r.pop(frame) {
+				return nil
+			}
+			return ErrReaderStopped
+		}
+	}
+}
+
+// pop 取出一帧，队列中仍有帧时把唤醒信号传给下一个等待者
+func (r *frameReader) pop(frame *driver.CANFrame) bool {
+	if !r.queue.pop(frame) {
+		return false
+	}
+	if r.queue.len() > 0 {
+		r.signal()
+	}
+	return true
+}
+
+// signal 非阻塞地发送唤醒信号
+func (r *frameReader) signal() {
+	select {
+	case r.notify <- struct{}{}:
+	default:
+	}
+}
+
+// run 读协程主循环
+func (r *frameReader) run() {
+	defer close(r.done)
+	for {
+		select {
+		case <-r.stop:
+			return
+		default:
+		}
+		space := r.ring.space()
+		n, err := r.receive(space)
+		if err != nil && err != io.EOF {
+			r.readErrors.Add(1)
+			time.Sleep(readerPoll / 10)
+			continue
+		}
+		if n == 0 {
+			continue
+		}
+		ts := uint64(time.Now().UnixNano())
+		r.ring.commit(n)
+		r.bytes.Add(uint64(n))
+		r.parse(ts)
+	}
+}
+
+// receive 读取数据到 buf
+// 支持事件等待的 UART 直接读入 buf；普通 UART 使用 Read 并复制，没有数据时短暂休眠避免空转。
+func (r *frameReader) receive(buf []byte) (int, error) {
+	if r.ev != nil {
+		ready, err := r.ev.WaitReadable(readerPoll)
+		if err != nil || !ready {
+			return 0, err
+		}
+		return r.ev.ReadInto(buf)
+	}
+	data, err := r.uart.Read(len(buf))
+	if len(data) == 0 {
+		if err == nil || err == io.EOF {
+			time.Sleep(time.Millisecond)
+		}
+		return 0, err
+	}
+	return copy(buf, data), err
+}
+
+// parse 解析环形缓冲区中的全部数据，完整的帧附带时间戳 ts 入队
+func (r *frameReader) parse(ts uint64) {
+	p := r.parser
+	for {
+		data := r.ring.data()
+		if len(data) == 0 {
+			break
+		}
+		n, ok := p.feed(data)
+		r.ring.consume(n)
+		if !ok {
+			continue
+		}
+		p.frame.Timestamp = ts
+		r.frames.Add(1)
+		if r.queue.push(&p.frame) {
+			r.signal()
+		} else {
+			r.dropped.Add(1)
+		}
+	}
+	r.malformed.Store(p.malformed)
+}
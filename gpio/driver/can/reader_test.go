@@ -0,0 +1,115 @@
+//go:build linux
+
+package can
+
+import (
+	"circuit/gpio/driver"
+	"circuit/gpio/driver/internal/ptytest"
+	"circuit/gpio/driver/serial"
+	"math/rand"
+	"os"
+	"testing"
+	"time"
+)
+
+// openPTY 打开一对 PTY：主端用于回放录制的适配器流量，从端按串口打开供 CAN 驱动使用。
+func openPTY(t *testing.T) (*os.File, driver.UART) {
+	t.Helper()
+	ptm, slave := ptytest.Open(t)
+	uart, err := serial.NewUART(slave, &driver.UARTConfig{
+		BaudRate: 115200, ByteSize: 8, ByteTimeout: 10,
+	})
+	if err != nil {
+		t.Skipf("打开 PTY 从端失败: %s", err)
+	}
+	return ptm, uart
+}
+
+func TestReaderOverPTY(t *testing.T) {
+	for _, protocol := range []*driver.CANProtocolConfig{CANProtocolSLCAN(), CANProtocolBinary()} {
+		ptm, uart := openPTY(t)
+		d, err := NewCANDriver(uart, &driver.CANConfig{Protocol: protocol})
+		if err != nil {
+			t.Fatal(err)
+		}
+		c := d.(*CANDriver)
+		if err := c.StartReader(4096); err != nil {
+			t.Fatal(err)
+		}
+
+		// 以突发方式回放录制的流量，每次写入长度随机，帧跨越写入边界
+		rng := rand.New(rand.NewSource(3))
+		frames := randomFrames(rng, 2000)
+		traffic := recordedTraffic(protocol, frames)
+		start := uint64(time.Now().UnixNano())
+		go func() {
+			for data := traffic; len(data) > 0; {
+				k := 1 + rng.Intn(512)
+				if k > len(data) {
+					k = len(data)
+				}
+				ptm.Write(data[:k])
+				data = data[k:]
+			}
+		}()
+
+		var f driver.CANFrame
+		for i := range frames {
+			if err := c.ReadFrame(&f, 2*time.Second); err != nil {
+				t.Fatalf("%q: 第 %d 帧: %s（%+v）", protocol.FrameStartMarker, i, err, c.ReaderStats())
+			}
+			if !sameFrame(&f, &frames[i]) {
+				t.Fatalf("%q: 第 %d 帧 %+v，期望 %+v", protocol.FrameStartMarker, i, f, frames[i])
+			}
+			if f.Timestamp < start {
+				t.Fatalf("时间戳 %d 早于回放开始 %d", f.Timestamp, start)
+			}
+		}
+		stats := c.ReaderStats()
+		if stats.Frames != uint64(len(frames)) || stats.Dropped != 0 || stats.Malformed != 0 {
+			t.Fatalf("%q: 统计 %+v", protocol.FrameStartMarker, stats)
+		}
+		// 回放结束后总线空闲：读协程阻塞在就绪等待上，不在帧之间轮询
+		const idle = 300 * time.Millisecond
+		cpu := ptytest.CPUTime()
+		time.Sleep(idle)
+		if used := ptytest.CPUTime() - cpu; used > idle/4 {
+			t.Fatalf("%q: 空闲 %s 期间读协程占用 CPU %s", protocol.FrameStartMarker, idle, used)
+		}
+		if _, err := c.GetStatus(); err != ErrReaderRunning {
+			t.Fatalf("读协程运行时 GetStatus 返回 %v", err)
+		}
+		if err := c.ReadFrame(&f, 10*time.Millisecond); err != ErrReceiveTimeout {
+			t.Fatalf("队列为空时 ReadFrame 返回 %v", err)
+		}
+		c.Close()
+		if err := c.ReadFrame(&f, 0); err != ErrReaderStopped {
+			t.Fatalf("关闭后 ReadFrame 返回 %v", err)
+		}
+	}
+}
+
+func TestReaderDropsWhenFull(t *testing.T) {
+	ptm, uart := openPTY(t)
+	d, _ := NewCANDriver(uart, &driver.CANConfig{Protocol: CANProtocolSLCAN()})
+	c := d.(*CANDriver)
+	if err := c.StartReader(16); err != nil {
+		t.Fatal(err)
+	}
+	defer c.Close()
+	frames := randomFrames(rand.New(rand.NewSource(4)), 100)
+	ptm.Write(recordedTraffic(CANProtocolSLCAN(), frames))
+	deadline := time.Now().Add(2 * time.Second)
+	for c.ReaderStats().Frames < uint64(len(frames)) && time.Now().Before(deadline) {
+		time.Sleep(5 * time.Millisecond)
+	}
+	stats := c.ReaderStats()
+	if stats.Frames != 100 || stats.Dropped != 100-16 || stats.Queued != 16 {
+		t.Fatalf("统计 %+v", stats)
+	}
+	// 队列中保留的是最早到达的帧
+	var f driver.CANFrame
+	if err := c.ReadFrame(&f, 0); err != nil || !sameFrame(&f, &frames[0]) {
+		t.Fatalf("第一帧 %+v (%v)", f, err)
+	}
+}
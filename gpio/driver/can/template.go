@@ -0,0 +1,131 @@
+package can
+
+import (
+	"bytes"
+	"circuit/gpio/driver"
+)
+
+// 发送帧模板中的字段
+const (
+	fieldLiteral = iota // 模板中的原样字节
+	fieldID             // {ID}: 4 字节大端帧 ID
+	fieldEXT            // {EXT}: 扩展帧标志，1 字节 0/1
+	fieldRTR            // {RTR}: 远程帧标志，1 字节 0/1
+	fieldATTR           // {ATTR}: 属性字节，bit7=扩展帧, bit6=远程帧, 低 4 位 DLC
+	fieldDLC            // {DLC}: 数据长度码，1 字节
+	fieldDATA           // {DATA}: DLC 个数据字节，远程帧为空
+)
+
+// templateFields 占位符与字段的对应关系
+var templateFields = [...]struct {
+	name  string
+	field uint8
+}{
+	{"{ID}", fieldID},
+	{"{EXT}", fieldEXT},
+	{"{RTR}", fieldRTR},
+	{"{ATTR}", fieldATTR},
+	{"{DLC}", fieldDLC},
+	{"{DATA}", fieldDATA},
+}
+
+// templateOp 预编译模板中的一段：原样字节或一个字段
+type templateOp struct {
+	field uint8
+	lit   []byte // fieldLiteral 时的原样字节，指向模板
+}
+
+// frameTemplate 预编译的发送帧命令模板
+// SendFrameCmd 只在编译时扫描一次，之后每帧按偏移表把字段直接编码到调用者的缓冲区，
+// 不再逐个占位符查找替换。
+type frameTemplate struct {
+	ops []templateOp
+	max int // 单帧编码后的最大长度
+}
+
+// compileFrameTemplate 把发送帧命令模板编译为字段表
+func compileFrameTemplate(tpl []byte) *frameTemplate {
+	t := &frameTemplate{}
+	start := 0
+	for i := 0; i < len(tpl); {
+		field := uint8(fieldLiteral)
+		n := 0
+		if tpl[i] == '{' {
+			for _, p := range templateFields {
+				if bytes.HasPrefix(tpl[i:], []byte(p.name)) {
+					field, n = p.field, len(p.name)
+					break
+				}
+			}
+		}
+		if field == fieldLiteral {
+			i++
+			continue
+		}
+		if i > start {
+			t.ops = append(t.ops, templateOp{lit: tpl[start:i]})
+			t.max += i - start
+		}
+		t.ops = append(t.ops, templateOp{field: field})
+		switch field {
+		case fieldID:
+			t.max += 4
+		case fieldDATA:
+			t.max += 8
+		default:
+			t.max++
+		}
+		i += n
+		start = i
+	}
+	if start < len(tpl) {
+		t.ops = append(t.ops, templateOp{lit: tpl[start:]})
+		t.max += len(tpl) - start
+	}
+	return t
+}
+
+// appendFrame 把帧按模板编码追加到 dst
+func (t *frameTemplate) appendFrame(dst []byte, f *driver.CANFrame) []byte {
+	dlc := f.DLC & 0x0F
+	for i := range t.ops {
+		op := &t.ops[i]
+		switch op.field {
+		case fieldLiteral:
+			dst = append(dst, op.lit...)
+		case fieldID:
+			dst = append(dst, byte(f.ID>>24), byte(f.ID>>16), byte(f.ID>>8), byte(f.ID))
+		case fieldEXT:
+			dst = append(dst, boolByte(f.Extended))
+		case fieldRTR:
+			dst = append(dst, boolByte(f.Remote))
+		case fieldATTR:
+			attr := dlc
+			if f.Extended {
+				attr |= 0x80
+			}
+			if f.Remote {
+				attr |= 0x40
+			}
+			dst = append(dst, attr)
+		case fieldDLC:
+			dst = append(dst, dlc)
+		case fieldDATA:
+			if !f.Remote {
+				dst = append(dst, f.Data[:min(dlc, 8)]...)
+			}
+		}
+	}
+	return dst
+}
+
+// boolByte 把标志编码为 0/1
+func boolByte(v bool) byte {
+	if v {
+		return 1
+	}
+	return 0
+}
+
+// defaultTemplate 默认二进制协议的预编译发送模板
+var defaultTemplate = compileFrameTemplate(CANProtocolBinary().SendFrameCmd)
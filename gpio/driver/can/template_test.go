@@ -0,0 +1,129 @@
+package can
+
+import (
+	"bytes"
+	"circuit/gpio/driver"
+	"math/rand"
+	"testing"
+)
+
+// recordUART 记录每次 Write 的 UART
+type recordUART struct {
+	writes [][]byte
+	n      int // 写入的总字节数
+	keep   bool
+}
+
+func (u *recordUART) Close() error                               { return nil }
+func (u *recordUART) Init(int, uint8, uint8, uint8, uint8) error { return nil }
+func (u *recordUART) GetConfig() (*driver.UARTConfig, error)     { return &driver.UARTConfig{}, nil }
+func (u *recordUART) Read(int) ([]byte, error)                   { return nil, nil }
+func (u *recordUART) Write(data []byte) error {
+	u.n += len(data)
+	if u.keep {
+		u.writes = append(u.writes, append([]byte(nil), data...))
+	}
+	return nil
+}
+
+// legacyEncode 逐个占位符查找替换的模板编码，作为预编译模板的参照。
+// 远程帧与空数据帧的 {DATA} 替换为空。
+func legacyEncode(tpl []byte, frame *driver.CANFrame) []byte {
+	cmd := append([]byte(nil), tpl...)
+	cmd = replacePlaceholder(cmd, "{ID}", []byte{byte(frame.ID >> 24), byte(frame.ID >> 16), byte(frame.ID >> 8), byte(frame.ID)})
+	cmd = replacePlaceholder(cmd, "{EXT}", []byte{boolByte(frame.Extended)})
+	cmd = replacePlaceholder(cmd, "{RTR}", []byte{boolByte(frame.Remote)})
+	attr := frame.DLC & 0x0F
+	if frame.Extended {
+		attr |= 0x80
+	}
+	if frame.Remote {
+		attr |= 0x40
+	}
+	cmd = replacePlaceholder(cmd, "{ATTR}", []byte{attr})
+	cmd = replacePlaceholder(cmd, "{DLC}", []byte{frame.DLC & 0x0F})
+	var data []byte
+	if !frame.Remote {
+		data = frame.Data[:frame.DLC]
+	}
+	return replacePlaceholder(cmd, "{DATA}", data)
+}
+
+func TestFrameTemplate(t *testing.T) {
+	templates := [][]byte{
+		CANProtocolBinary().SendFrameCmd,
+		CANProtocolSLCAN().SendFrameCmd,
+		[]byte("{EXT}{RTR}{ID}:{DLC}{DATA}\r"),
+		[]byte("{ID}{ID}{UNKNOWN}{DATA"),
+	}
+	frames := randomFrames(rand.New(rand.NewSource(5)), 200)
+	for _, tpl := range templates {
+		ft := compileFrameTemplate(tpl)
+		for i := range frames {
+			want := legacyEncode(tpl, &frames[i])
+			got := ft.appendFrame(nil, &frames[i])
+			if !bytes.Equal(got, want) {
+				t.Fatalf("模板 %q 帧 %+v: %x，期望 %x", tpl, frames[i], got, want)
+			}
+			if len(got) > ft.max {
+				t.Fatalf("模板 %q: 编码长度 %d 超过 max %d", tpl, len(got), ft.max)
+			}
+		}
+	}
+}
+
+func TestSendFrames(t *testing.T) {
+	uart := &recordUART{keep: true}
+	d, _ := NewCANDriver(uart, &driver.CANConfig{Protocol: CANProtocolBinary()})
+	c := d.(*CANDriver)
+	frames := randomFrames(rand.New(rand.NewSource(6)), 50)
+	if err := c.SendFrames(frames); err != nil {
+		t.Fatal(err)
+	}
+	if len(uart.writes) != 1 {
+		t.Fatalf("SendFrames 写入 %d 次，期望 1 次", len(uart.writes))
+	}
+	var want []byte
+	for i := range frames {
+		if err := c.SendFrame(&frames[i]); err != nil {
+			t.Fatal(err)
+		}
+		want = append(want, uart.writes[len(uart.writes)-1]...)
+	}
+	if !bytes.Equal(uart.writes[0], want) {
+		t.Fatal("批量编码与逐帧编码不一致")
+	}
+	uart.keep = false
+	if allocs := testing.AllocsPerRun(100, func() {
+		c.SendFrames(frames)
+		c.SendFrame(&frames[0])
+	}); allocs != 0 {
+		t.Fatalf("发送每轮分配 %.1f 次", allocs)
+	}
+}
+
+func BenchmarkSendFrame(b *testing.B) {
+	frames := randomFrames(rand.New(rand.NewSource(7)), 64)
+	tpl := CANProtocolBinary().SendFrameCmd
+	b.Run("legacy", func(b *testing.B) {
+		uart := &recordUART{}
+		for i := 0; i < b.N; i++ {
+			uart.Write(legacyEncode(tpl, &frames[i%len(frames)]))
+		}
+	})
+	b.Run("template", func(b *testing.B) {
+		uart := &recordUART{}
+		d, _ := NewCANDriver(uart, &driver.CANConfig{Protocol: CANProtocolBinary()})
+		for i := 0; i < b.N; i++ {
+			d.SendFrame(&frames[i%len(frames)])
+		}
+	})
+	b.Run("batch64", func(b *testing.B) {
+		uart := &recordUART{}
+		d, _ := NewCANDriver(uart, &driver.CANConfig{Protocol: CANProtocolBinary()})
+		c := d.(*CANDriver)
+		for i := 0; i < b.N; i += len(frames) {
+			c.SendFrames(frames)
+		}
+	})
+}
@@ -0,0 +1,790 @@
+package can
+
+import (
+	"bufio"
+	"bytes"
+	"circuit/gpio/driver"
+	"errors"
+	"fmt"
+	"io"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// 虚拟总线相关错误
+var (
+	ErrBusClosed    = errors.New("can: virtual bus closed")
+	ErrTxQueueFull  = errors.New("can: transmit queue full")
+	ErrListenOnly   = errors.New("can: node is in listen-only mode")
+	ErrNoVirtualIO  = errors.New("can: virtual node has no UART")
+	errInvalidFrame = errors.New("can: invalid frame")
+)
+
+// 虚拟节点队列深度
+const (
+	vnodeTxDepth = 256  // 每个节点的发送队列
+	vnodeRxDepth = 1024 // 每个节点的接收队列
+)
+
+// frameBits 返回帧在总线上占用的位数
+// 按 CAN 2.0 帧格式逐位生成 SOF 到 CRC 的填充区域并计算 CRC-15 与实际填充位，
+// 再加上 CRC 界定符、ACK 段、帧结束与帧间隔共 13 位。
+func frameBits(f *driver.CANFrame) int {
+	var bits [128]byte
+	n := 0
+	put := func(v uint32, width int) {
+		for i := width - 1; i >= 0; i-- {
+			bits[n] = byte(v >> i & 1)
+			n++
+		}
+	}
+	dlc := uint32(min(f.DLC, 8))
+	rtr := uint32(boolByte(f.Remote))
+	put(0, 1) // SOF
+	if f.Extended {
+		put(f.ID>>18, 11)
+		put(1, 1) // SRR
+		put(1, 1) // IDE
+		put(f.ID, 18)
+		put(rtr, 1)
+		put(0, 2) // r1, r0
+	} else {
+		put(f.ID, 11)
+		put(rtr, 1)
+		put(0, 2) // IDE, r0
+	}
+	put(dlc, 4)
+	if !f.Remote {
+		for _, b := range f.Data[:dlc] {
+			put(uint32(b), 8)
+		}
+	}
+	var crc uint32
+	for _, b := range bits[:n] {
+		next := uint32(b) ^ crc>>14&1
+		crc = crc << 1 & 0x7FFF
+		if next != 0 {
+			crc ^= 0x4599
+		}
+	}
+	put(crc, 15)
+
+	// 连续 5 个相同位后插入一个相反的填充位，填充位计入下一段连续位
+	stuffed, run, last := 0, 0, byte(2)
+	for _, b := range bits[:n] {
+		if b == last {
+			run++
+		} else {
+			last, run = b, 1
+		}
+		if run == 5 {
+			stuffed++
+			last, run = 1-b, 1
+		}
+	}
+	return n + stuffed + 13
+}
+
+// arbitrationKey 返回帧的仲裁优先级，数值越小优先级越高
+// 按总线上的位顺序排列: 基本 ID(11) + RTR/SRR + IDE + 扩展 ID(18) + RTR，
+// 因此同一基本 ID 的标准数据帧优先于标准远程帧，标准帧优先于扩展帧。
+func arbitrationKey(f *driver.CANFrame) uint32 {
+	rtr := uint32(boolByte(f.Remote))
+	if f.Extended {
+		return (f.ID>>18&0x7FF)<<21 | 1<<20 | 1<<19 | (f.ID&0x3FFFF)<<1 | rtr
+	}
+	return (f.ID&0x7FF)<<21 | rtr<<20
+}
+
+// pendingFrame 等待发送的帧
+type pendingFrame struct {
+	frame driver.CANFrame
+	ready time.Duration // 最早可以参与仲裁的总线时间
+}
+
+// BusStats 虚拟总线统计
+type BusStats struct {
+	Frames   uint64        // 成功传输的帧数
+	Bits     uint64        // 传输的总位数（含填充位与帧间隔）
+	Busy     time.Duration // 总线占用时间
+	Lost     uint64        // 仲裁失败次数（每次仲裁中未获胜的候选帧数之和）
+	AckError uint64        // 没有节点应答而丢弃的帧数
+	Now      time.Duration // 当前总线时间
+}
+
+// Load 返回总线负载率（占用时间 / 总线时间）
+func (s BusStats) Load() float64 {
+	if s.Now <= 0 {
+		return 0
+	}
+	return float64(s.Busy) / float64(s.Now)
+}
+
+// VirtualBus 进程内虚拟 CAN 总线
+// 多个 VirtualNode 挂接在同一总线上，总线空闲时各节点发送队列的队首帧按 ID 仲裁，
+// 获胜帧按位填充后的实际位数和波特率占用总线时间，然后投递给其他节点。
+// 总线时间从 0 开始，帧的 Timestamp 为传输结束时的总线时间（纳秒）。
+// 时间倍率为 0 时不等待，总线时间只随传输推进，可以远快于实时运行；
+// 倍率为 1 时按实时节奏传输，0.1 表示 10 倍速。
+// 相同的发送序列在不等待模式下得到相同的传输顺序与时间戳，适合确定性的基准测试。
+type VirtualBus struct {
+	bitrate uint32
+
+	mu     sync.Mutex
+	idle   *sync.Cond
+	scale  float64
+	wall0  time.Time     // 总线时间 0 对应的墙上时间（按倍率换算）
+	now    time.Duration // 最后一次传输结束的总线时间
+	nodes  []*VirtualNode
+	replay *VirtualNode // 回放源，只发送不接收
+	closed bool
+	active bool // 调度协程正在传输一帧
+	stats  BusStats
+
+	kick chan struct{}
+	done chan struct{}
+}
+
+// NewVirtualBus 创建虚拟总线并启动调度协程
+// 参数:
+//   - bitrate: 总线波特率（bit/s），为 0 时使用 500000
+//
+// 返回值:
+//   - *VirtualBus: 时间倍率为 0（不等待）的虚拟总线，使用完毕后调用 Close
+func NewVirtualBus(bitrate uint32) *VirtualBus {
+	if bitrate == 0 {
+		bitrate = 500000
+	}
+	b := &VirtualBus{
+		bitrate: bitrate,
+		wall0:   time.Now(),
+		kick:    make(chan struct{}, 1),
+		done:    make(chan struct{}),
+	}
+	b.idle = sync.NewCond(&b.mu)
+	b.replay = &VirtualNode{bus: b}
+	go b.run()
+	return b
+}
+
+// Bitrate 返回总线波特率
+func (b *VirtualBus) Bitrate() uint32 {
+	return b.bitrate
+}
+
+// FrameTime 返回帧在该总线上的传输时间
+func (b *VirtualBus) FrameTime(f *driver.CANFrame) time.Duration {
+	return time.Duration(int64(frameBits(f)) * int64(time.Second) / int64(b.bitrate))
+}
+
+// SetTimeScale 设置时间倍率
+// 参数:
+//   - scale: 墙上时间与总线时间之比，0 表示不等待，1 表示实时
+func (b *VirtualBus) SetTimeScale(scale float64) {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	if scale < 0 {
+		scale = 0
+	}
+	b.scale = scale
+	// 从当前总线时间开始按新倍率计时
+	b.wall0 = time.Now().Add(-time.Duration(float64(b.now) * scale))
+	b.wake()
+}
+
+// Attach 在总线上挂接一个节点
+// 参数:
+//   - cfg: 节点配置（模式与过滤器），为 nil 时为正常模式、不过滤
+//
+// 返回值:
+//   - *VirtualNode: 实现 driver.CAN 的节点，Close 时从总线上断开
+func (b *VirtualBus) Attach(cfg *driver.CANConfig) *VirtualNode {
+	n := &VirtualNode{bus: b, baudRate: b.bitrate}
+	n.rx = &frameReader{
+		queue:  newFrameQueue(vnodeRxDepth),
+		notify: make(chan struct{}, 1),
+		done:   make(chan struct{}),
+	}
+	n.apply(cfg)
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	if b.closed {
+		close(n.rx.done)
+		return n
+	}
+	// 节点列表写时复制，调度协程投递时无需持锁遍历
+	nodes := make([]*VirtualNode, len(b.nodes), len(b.nodes)+1)
+	copy(nodes, b.nodes)
+	b.nodes = append(nodes, n)
+	return n
+}
+
+// detach 从总线上移除节点
+func (b *VirtualBus) detach(n *VirtualNode) {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	nodes := make([]*VirtualNode, 0, len(b.nodes))
+	for _, x := range b.nodes {
+		if x != n {
+			nodes = append(nodes, x)
+		}
+	}
+	b.nodes = nodes
+	n.tx, n.txHead = nil, 0
+	b.idle.Broadcast()
+}
+
+// Close 停止调度协程并断开所有节点，未发送的帧被丢弃
+func (b *VirtualBus) Close() error {
+	b.mu.Lock()
+	if b.closed {
+		b.mu.Unlock()
+		return nil
+	}
+	b.closed = true
+	nodes := b.nodes
+	b.nodes = nil
+	b.idle.Broadcast()
+	b.mu.Unlock()
+	b.wake()
+	<-b.done
+	for _, n := range nodes {
+		n.closeRx()
+	}
+	return nil
+}
+
+// Stats 返回总线统计
+func (b *VirtualBus) Stats() BusStats {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	s := b.stats
+	s.Now = b.clock()
+	return s
+}
+
+// Flush 等待所有已提交（包括回放中）的帧传输完毕
+func (b *VirtualBus) Flush() {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	for !b.closed && (b.active || b.pending()) {
+		b.idle.Wait()
+	}
+}
+
+// pending 是否有节点的发送队列非空，调用者需持有 mu
+func (b *VirtualBus) pending() bool {
+	if b.replay.txHead < len(b.replay.tx) {
+		return true
+	}
+	for _, n := range b.nodes {
+		if n.txHead < len(n.tx) {
+			return true
+		}
+	}
+	return false
+}
+
+// clock 返回当前总线时间，调用者需持有 mu
+// 不等待模式下总线时间只随传输推进；按倍率运行时取墙上时间换算值与最后传输结束时间的较大者。
+func (b *VirtualBus) clock() time.Duration {
+	if b.scale == 0 {
+		return b.now
+	}
+	if t := time.Duration(float64(time.Since(b.wall0)) / b.scale); t > b.now {
+		return t
+	}
+	return b.now
+}
+
+// wake 唤醒调度协程
+func (b *VirtualBus) wake() {
+	select {
+	case b.kick <- struct{}{}:
+	default:
+	}
+}
+
+// submit 把帧放入节点的发送队列
+// 参数:
+//   - ready: 就绪的总线时间，小于 0 表示当前时间
+//   - limit: 发送队列长度上限，0 表示不限制
+func (b *VirtualBus) submit(n *VirtualNode, f *driver.CANFrame, ready time.Duration, limit int) error {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	return b.submitLocked(n, f, ready, limit)
+}
+
+// submitLocked 同 submit，调用者需持有 mu
+func (b *VirtualBus) submitLocked(n *VirtualNode, f *driver.CANFrame, ready time.Duration, limit int) error {
+	if b.closed || n.closed {
+		return ErrBusClosed
+	}
+	if limit > 0 && len(n.tx)-n.txHead >= limit {
+		return ErrTxQueueFull
+	}
+	if n.txHead > 0 && n.txHead == len(n.tx) {
+		n.tx, n.txHead = n.tx[:0], 0
+	}
+	if ready < 0 {
+		ready = b.clock()
+	}
+	n.tx = append(n.tx, pendingFrame{frame: *f, ready: ready})
+	b.wake()
+	return nil
+}
+
+// arbitrate 在总线时间 now 对所有已就绪的队首帧仲裁，调用者需持有 mu
+// 返回值:
+//   - winner: 获胜节点，没有就绪帧时为 nil
+//   - next: 没有就绪帧时最早的就绪时间，没有待发送帧时为 -1
+func (b *VirtualBus) arbitrate(now time.Duration) (winner *VirtualNode, next time.Duration) {
+	next = -1
+	var best uint32
+	candidates := 0
+	consider := func(n *VirtualNode) {
+		if n.txHead >= len(n.tx) {
+			return
+		}
+		p := &n.tx[n.txHead]
+		if p.ready > now {
+			if next < 0 || p.ready < next {
+				next = p.ready
+			}
+			return
+		}
+		candidates++
+		if k := arbitrationKey(&p.frame); winner == nil || k < best {
+			winner, best = n, k
+		}
+	}
+	consider(b.replay)
+	for _, n := range b.nodes {
+		consider(n)
+	}
+	if candidates > 1 {
+		b.stats.Lost += uint64(candidates - 1)
+	}
+	return winner, next
+}
+
+// run 调度协程：仲裁、按帧长推进总线时间并投递
+func (b *VirtualBus) run() {
+	defer close(b.done)
+	timer := time.NewTimer(time.Hour)
+	timer.Stop()
+	for {
+		b.mu.Lock()
+		if b.closed {
+			b.mu.Unlock()
+			return
+		}
+		now := b.clock()
+		winner, next := b.arbitrate(now)
+		if winner == nil {
+			b.idle.Broadcast()
+			if next >= 0 && b.scale == 0 {
+				// 不等待模式下空闲直接跳到下一帧的就绪时间
+				b.now = next
+				b.mu.Unlock()
+				continue
+			}
+			var wait time.Duration = -1
+			if next >= 0 {
+				wait = time.Duration(float64(next-now) * b.scale)
+			}
+			b.mu.Unlock()
+			if wait >= 0 {
+				timer.Reset(wait)
+				select {
+				case <-b.kick:
+				case <-timer.C:
+				}
+				if !timer.Stop() {
+					select {
+					case <-timer.C:
+					default:
+					}
+				}
+			} else {
+				<-b.kick
+			}
+			continue
+		}
+
+		frame := winner.tx[winner.txHead].frame
+		winner.txHead++
+		bits := frameBits(&frame)
+		dur := time.Duration(int64(bits) * int64(time.Second) / int64(b.bitrate))
+		end := now + dur
+		b.now = end
+		b.active = true
+		b.stats.Bits += uint64(bits)
+		b.stats.Busy += dur
+		scale, wall := b.scale, b.wall0.Add(time.Duration(float64(end)*b.scale))
+		nodes := b.nodes
+		b.mu.Unlock()
+
+		if scale > 0 {
+			if d := time.Until(wall); d > 0 {
+				time.Sleep(d)
+			}
+		}
+		frame.Timestamp = uint64(end)
+		acked := b.deliver(winner, nodes, &frame)
+
+		b.mu.Lock()
+		b.active = false
+		if acked {
+			b.stats.Frames++
+		} else {
+			b.stats.AckError++
+			if winner != b.replay {
+				winner.txErr.Add(8)
+			}
+		}
+		b.mu.Unlock()
+	}
+}
+
+// deliver 把帧投递给接收节点，返回是否有节点应答
+// 监听模式的节点接收但不应答，回环模式的节点接收自己发送的帧并自行应答。
+func (b *VirtualBus) deliver(sender *VirtualNode, nodes []*VirtualNode, f *driver.CANFrame) bool {
+	acked := false
+	for _, n := range nodes {
+		mode := n.mode.Load()
+		if n == sender {
+			if mode == 2 {
+				n.receive(f)
+				acked = true
+			}
+			continue
+		}
+		if mode != 1 {
+			acked = true
+		}
+		n.receive(f)
+	}
+	return acked
+}
+
+// Replay 从 candump 日志（candump -l 格式）回放帧
+// 每行形如 "(1436509052.249713) can0 123#DEADBEEF"，扩展帧 ID 为 8 位十六进制，远程帧数据部分为 "R"；
+// 帧按日志中的相对时间从当前总线时间开始就绪，与节点发送的帧一起参与仲裁，
+// 不等待模式下以总线允许的最快速度回放。CAN FD 帧（"##"）被跳过。
+// 参数:
+//   - r: 日志内容
+//
+// 返回值:
+//   - int: 排队回放的帧数
+//   - error: 日志格式错误（含行号），出错前解析的帧仍会回放
+func (b *VirtualBus) Replay(r io.Reader) (int, error) {
+	b.mu.Lock()
+	base := b.clock()
+	b.mu.Unlock()
+	sc := bufio.NewScanner(r)
+	var first time.Duration
+	count, line := 0, 0
+	for sc.Scan() {
+		line++
+		text := bytes.TrimSpace(sc.Bytes())
+		if len(text) == 0 || text[0] == '#' {
+			continue
+		}
+		ts, frame, ok, err := parseCandump(text)
+		if err != nil {
+			return count, fmt.Errorf("can: candump line %d: %w", line, err)
+		}
+		if !ok {
+			continue
+		}
+		if count == 0 {
+			first = ts
+		}
+		ready := base + ts - first
+		if err := b.submit(b.replay, &frame, ready, 0); err != nil {
+			return count, err
+		}
+		count++
+	}
+	return count, sc.Err()
+}
+
+// parseCandump 解析一行 candump -l 日志
+// 返回值 ok 为 false 表示跳过的帧（CAN FD）。
+func parseCandump(line []byte) (ts time.Duration, f driver.CANFrame, ok bool, err error) {
+	var fields [3][]byte
+	for i := range fields {
+		line = bytes.TrimLeft(line, " \t")
+		end := bytes.IndexAny(line, " \t")
+		if end < 0 {
+			end = len(line)
+		}
+		fields[i], line = line[:end], line[end:]
+	}
+	if len(fields[2]) == 0 || len(fields[0]) < 3 || fields[0][0] != '(' || fields[0][len(fields[0])-1] != ')' {
+		return 0, f, false, errors.New("expected \"(timestamp) interface frame\"")
+	}
+	if ts, err = parseCandumpTime(fields[0][1 : len(fields[0])-1]); err != nil {
+		return 0, f, false, err
+	}
+	id, data, found := bytes.Cut(fields[2], []byte("#"))
+	if !found {
+		return 0, f, false, errInvalidFrame
+	}
+	if len(data) > 0 && data[0] == '#' {
+		return ts, f, false, nil
+	}
+	v, okID := parseHex(id)
+	switch {
+	case !okID:
+		return 0, f, false, errInvalidFrame
+	case len(id) == 3:
+		f.ID = v
+	case len(id) == 8:
+		f.ID, f.Extended = v&0x1FFFFFFF, true
+	default:
+		return 0, f, false, errInvalidFrame
+	}
+	if len(data) > 0 && (data[0] == 'R' || data[0] == 'r') {
+		f.Remote = true
+		if len(data) == 2 {
+			dlc, okDLC := parseHex(data[1:])
+			if !okDLC || dlc > 8 {
+				return 0, f, false, errInvalidFrame
+			}
+			f.DLC = uint8(dlc)
+		}
+		return ts, f, true, nil
+	}
+	if bytes.IndexByte(data, '.') >= 0 {
+		data = bytes.ReplaceAll(data, []byte("."), nil) // candump 可选的字节分隔符
+	}
+	if len(data)%2 != 0 || len(data) > 16 {
+		return 0, f, false, errInvalidFrame
+	}
+	f.DLC = uint8(len(data) / 2)
+	for i := range int(f.DLC) {
+		b, okData := parseHex(data[2*i : 2*i+2])
+		if !okData {
+			return 0, f, false, errInvalidFrame
+		}
+		f.Data[i] = byte(b)
+	}
+	return ts, f, true, nil
+}
+
+// parseCandumpTime 解析 "秒.微秒" 形式的时间戳，整数运算避免浮点精度损失与内存分配
+func parseCandumpTime(s []byte) (time.Duration, error) {
+	secText, fracText, _ := bytes.Cut(s, []byte("."))
+	if len(secText) == 0 || len(secText) > 10 {
+		return 0, errors.New("invalid timestamp")
+	}
+	var sec int64
+	for _, c := range secText {
+		if c < '0' || c > '9' {
+			return 0, errors.New("invalid timestamp")
+		}
+		sec = sec*10 + int64(c-'0')
+	}
+	ts := time.Duration(sec) * time.Second
+	unit := time.Second
+	for _, c := range fracText {
+		if c < '0' || c > '9' {
+			return 0, errors.New("invalid timestamp")
+		}
+		if unit /= 10; unit > 0 {
+			ts += time.Duration(c-'0') * unit
+		}
+	}
+	return ts, nil
+}
+
+// VirtualNode 挂接在 VirtualBus 上的 CAN 节点，实现 driver.CAN
+// 发送的帧进入节点的发送队列，由总线按 ID 仲裁后投递；接收的帧经过节点过滤器后进入有界接收队列，
+// 队列满时丢弃新帧。节点没有底层 UART，Read 与 Write 返回 ErrNoVirtualIO。
+type VirtualNode struct {
+	bus *VirtualBus
+
+	// 以下字段由 bus.mu 保护
+	tx       []pendingFrame
+	txHead   int
+	closed   bool
+	baudRate uint32
+
+	rx     *frameReader
+	mode   atomic.Uint32 // 0=正常, 1=监听, 2=回环
+	filter atomic.Uint64 // 启用标志<<63 | 过滤 ID<<32 | 过滤掩码
+	txErr  atomic.Uint32
+	rxErr  atomic.Uint32
+	closeM sync.Once
+}
+
+// apply 应用节点配置
+func (n *VirtualNode) apply(cfg *driver.CANConfig) {
+	if cfg == nil {
+		return
+	}
+	n.mode.Store(uint32(cfg.Mode))
+	n.setFilter(cfg.FilterID, cfg.FilterMask, cfg.FilterMode != 0)
+}
+
+// setFilter 更新接收过滤器
+func (n *VirtualNode) setFilter(id, mask uint32, enable bool) {
+	var v uint64
+	if enable {
+		v = 1<<63 | uint64(id&0x7FFFFFFF)<<32 | uint64(mask)
+	}
+	n.filter.Store(v)
+}
+
+// receive 由调度协程调用，经过滤器后放入接收队列
+func (n *VirtualNode) receive(f *driver.CANFrame) {
+	if v := n.filter.Load(); v != 0 {
+		id, mask := uint32(v>>32)&0x7FFFFFFF, uint32(v)
+		if (f.ID^id)&mask != 0 {
+			return
+		}
+	}
+	if n.rx.queue.push(f) {
+		n.rx.frames.Add(1)
+		n.rx.signal()
+	} else {
+		n.rx.dropped.Add(1)
+	}
+}
+
+// closeRx 关闭接收队列，唤醒等待中的接收者
+func (n *VirtualNode) closeRx() {
+	n.closeM.Do(func() { close(n.rx.done) })
+}
+
+// Close 从总线上断开节点
+func (n *VirtualNode) Close() error {
+	n.bus.mu.Lock()
+	n.closed = true
+	n.bus.mu.Unlock()
+	n.bus.detach(n)
+	n.closeRx()
+	return nil
+}
+
+// Init 虚拟节点没有 UART，忽略串口参数
+func (n *VirtualNode) Init(baudRate int, byteSize, parity, stopBits, byteTimeout uint8) error {
+	return nil
+}
+
+// GetConfig 返回一个描述虚拟链路的 UART 配置
+func (n *VirtualNode) GetConfig() (*driver.UARTConfig, error) {
+	return &driver.UARTConfig{BaudRate: n.bus.bitrate, ByteSize: 8}, nil
+}
+
+// Read 虚拟节点没有 UART
+func (n *VirtualNode) Read(length int) ([]byte, error) {
+	return nil, ErrNoVirtualIO
+}
+
+// Write 虚拟节点没有 UART
+func (n *VirtualNode) Write(data []byte) error {
+	return ErrNoVirtualIO
+}
+
+// InitCAN 应用 CAN 配置，uart 参数被忽略
+func (n *VirtualNode) InitCAN(uart driver.UART, cfg *driver.CANConfig) error {
+	if cfg == nil {
+		return errors.New("CAN config cannot be nil")
+	}
+	n.apply(cfg)
+	return nil
+}
+
+// SendFrame 把帧放入发送队列，不等待传输完成
+func (n *VirtualNode) SendFrame(frame *driver.CANFrame) error {
+	if frame == nil {
+		return errors.New("CAN frame cannot be nil")
+	}
+	if frame.DLC > 8 || frame.ID > idMask(frame.Extended) {
+		return errInvalidFrame
+	}
+	if n.mode.Load() == 1 {
+		return ErrListenOnly
+	}
+	n.bus.mu.Lock()
+	ok := n.baudRate == n.bus.bitrate
+	n.bus.mu.Unlock()
+	if !ok {
+		n.txErr.Add(8)
+		return errors.New("can: node bitrate does not match bus")
+	}
+	return n.bus.submit(n, frame, -1, vnodeTxDepth)
+}
+
+// ReceiveFrame 从接收队列取帧，timeout 为最长等待毫秒数
+func (n *VirtualNode) ReceiveFrame(timeout uint32) (*driver.CANFrame, error) {
+	frame := &driver.CANFrame{}
+	if err := n.rx.read(frame, time.Duration(timeout)*time.Millisecond); err != nil {
+		return nil, err
+	}
+	return frame, nil
+}
+
+// ReadFrame 从接收队列取出一帧复制到 frame，不分配内存，语义同 CANDriver.ReadFrame
+func (n *VirtualNode) ReadFrame(frame *driver.CANFrame, timeout time.Duration) error {
+	return n.rx.read(frame, timeout)
+}
+
+// Dropped 返回接收队列满而丢弃的帧数
+func (n *VirtualNode) Dropped() uint64 {
+	return n.rx.dropped.Load()
+}
+
+// SetFilter 设置节点接收过滤器
+func (n *VirtualNode) SetFilter(filterID, filterMask uint32, enable bool) error {
+	n.setFilter(filterID, filterMask, enable)
+	return nil
+}
+
+// GetStatus 返回节点状态: bit0=监听模式, bit1=回环模式, bit2=错误被动（发送错误计数 >= 128）
+func (n *VirtualNode) GetStatus() (uint32, error) {
+	var status uint32
+	switch n.mode.Load() {
+	case 1:
+		status |= 1
+	case 2:
+		status |= 2
+	}
+	if n.txErr.Load() >= 128 {
+		status |= 4
+	}
+	return status, nil
+}
+
+// SetMode 设置工作模式: 0=正常, 1=监听, 2=回环
+func (n *VirtualNode) SetMode(mode uint8) error {
+	if mode > 2 {
+		return errors.New("invalid CAN mode")
+	}
+	n.mode.Store(uint32(mode))
+	return nil
+}
+
+// ClearErrors 清除错误计数器
+func (n *VirtualNode) ClearErrors() error {
+	n.txErr.Store(0)
+	n.rxErr.Store(0)
+	return nil
+}
+
+// GetErrorCounters 返回错误计数器，没有节点应答时发送错误计数加 8
+func (n *VirtualNode) GetErrorCounters() (txErr, rxErr uint32, err error) {
+	return n.txErr.Load(), n.rxErr.Load(), nil
+}
+
+// SetBaudRate 设置节点波特率，与总线不一致时节点无法发送
+func (n *VirtualNode) SetBaudRate(baudRate uint32) error {
+	n.bus.mu.Lock()
+	defer n.bus.mu.Unlock()
+	n.baudRate = baudRate
+	return nil
+}
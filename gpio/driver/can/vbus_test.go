@@ -0,0 +1,249 @@
+package can
+
+import (
+	"circuit/gpio/driver"
+	"fmt"
+	"math/rand"
+	"strings"
+	"testing"
+	"time"
+)
+
+// 编译期检查 VirtualNode 实现 driver.CAN
+var _ driver.CAN = (*VirtualNode)(nil)
+
+func TestFrameBits(t *testing.T) {
+	for _, f := range randomFrames(rand.New(rand.NewSource(12)), 2000) {
+		payload := int(f.DLC)
+		if f.Remote {
+			payload = 0
+		}
+		// 不含填充位的帧长: 标准帧 47+8n，扩展帧 67+8n；填充区域每 4 位最多插入一个填充位
+		base, region := 47+8*payload, 34+8*payload
+		if f.Extended {
+			base, region = 67+8*payload, 54+8*payload
+		}
+		if got := frameBits(&f); got < base || got > base+(region-1)/4 {
+			t.Fatalf("帧 %+v: %d 位，应在 [%d, %d] 之间", f, got, base, base+(region-1)/4)
+		}
+	}
+	// 全 0 数据与 ID 产生大量填充位
+	zero := driver.CANFrame{DLC: 8}
+	if got := frameBits(&zero); got <= 111 {
+		t.Fatalf("全 0 帧 %d 位，应包含填充位", got)
+	}
+}
+
+func TestArbitrationKey(t *testing.T) {
+	ordered := []driver.CANFrame{
+		{ID: 0x100},
+		{ID: 0x100, Remote: true},
+		{ID: 0x100 << 18, Extended: true},
+		{ID: 0x100<<18 | 1, Extended: true},
+		{ID: 0x100<<18 | 1, Extended: true, Remote: true},
+		{ID: 0x101},
+	}
+	for i := 1; i < len(ordered); i++ {
+		if arbitrationKey(&ordered[i-1]) >= arbitrationKey(&ordered[i]) {
+			t.Fatalf("%+v 应优先于 %+v", ordered[i-1], ordered[i])
+		}
+	}
+}
+
+func TestVirtualBusArbitration(t *testing.T) {
+	bus := NewVirtualBus(500000)
+	defer bus.Close()
+	nodes := []*VirtualNode{bus.Attach(nil), bus.Attach(nil), bus.Attach(nil)}
+	monitor := bus.Attach(&driver.CANConfig{Mode: 1})
+	// 三个节点的帧在同一总线时间就绪，按 ID 仲裁；同一节点的帧按提交顺序发送
+	ready := time.Millisecond
+	submit := []struct {
+		node int
+		id   uint32
+	}{{0, 0x300}, {0, 0x050}, {1, 0x200}, {2, 0x100}, {1, 0x010}}
+	bus.mu.Lock()
+	for _, s := range submit {
+		f := driver.CANFrame{ID: s.id, DLC: 2}
+		if err := bus.submitLocked(nodes[s.node], &f, ready, 0); err != nil {
+			t.Fatal(err)
+		}
+	}
+	bus.mu.Unlock()
+	bus.Flush()
+	want := []uint32{0x100, 0x200, 0x010, 0x300, 0x050}
+	end := ready
+	for i, id := range want {
+		f, err := monitor.ReceiveFrame(0)
+		if err != nil {
+			t.Fatalf("第 %d 帧: %s", i, err)
+		}
+		end += bus.FrameTime(f)
+		if f.ID != id || f.Timestamp != uint64(end) {
+			t.Fatalf("第 %d 帧 ID %#x 时间 %d，期望 %#x 时间 %d", i, f.ID, f.Timestamp, id, end)
+		}
+	}
+	stats := bus.Stats()
+	if stats.Frames != 5 || stats.Lost == 0 || stats.Now != end {
+		t.Fatalf("统计 %+v", stats)
+	}
+	// 发送方不会收到自己的帧
+	if f, err := nodes[2].ReceiveFrame(0); err != nil || f.ID == 0x100 {
+		t.Fatalf("节点 2 收到 %+v (%v)", f, err)
+	}
+}
+
+func TestVirtualNodeModes(t *testing.T) {
+	bus := NewVirtualBus(250000)
+	defer bus.Close()
+	a := bus.Attach(nil)
+	// 没有其他节点应答
+	if err := a.SendFrame(&driver.CANFrame{ID: 0x10}); err != nil {
+		t.Fatal(err)
+	}
+	bus.Flush()
+	if tx, _, _ := a.GetErrorCounters(); tx != 8 || bus.Stats().AckError != 1 {
+		t.Fatalf("发送错误计数 %d，统计 %+v", tx, bus.Stats())
+	}
+	// 回环模式自行应答并收到自己的帧
+	a.SetMode(2)
+	a.SendFrame(&driver.CANFrame{ID: 0x11})
+	bus.Flush()
+	if f, err := a.ReceiveFrame(0); err != nil || f.ID != 0x11 {
+		t.Fatalf("回环接收 %+v (%v)", f, err)
+	}
+	// 过滤器与监听模式
+	b := bus.Attach(&driver.CANConfig{Mode: 1, FilterMode: 1, FilterID: 0x120, FilterMask: 0x7F0})
+	if err := b.SendFrame(&driver.CANFrame{ID: 1}); err != ErrListenOnly {
+		t.Fatalf("监听模式发送返回 %v", err)
+	}
+	a.SetMode(0)
+	for _, id := range []uint32{0x121, 0x131, 0x12F} {
+		a.SendFrame(&driver.CANFrame{ID: id})
+	}
+	bus.Flush()
+	for _, id := range []uint32{0x121, 0x12F} {
+		if f, err := b.ReceiveFrame(0); err != nil || f.ID != id {
+			t.Fatalf("过滤后接收 %+v (%v)，期望 %#x", f, err, id)
+		}
+	}
+	if _, err := b.ReceiveFrame(0); err != ErrReceiveTimeout {
+		t.Fatalf("过滤掉的帧被接收: %v", err)
+	}
+	b.Close()
+	if _, err := b.ReceiveFrame(0); err != ErrReaderStopped {
+		t.Fatalf("断开后接收返回 %v", err)
+	}
+}
+
+const candumpLog = `(1436509052.249713) vcan0 044#2A366C2BBA
+(1436509052.449847) vcan0 0F6#7ADFE07BD2
+# 注释行
+(1436509052.650004) vcan0 1F3A2C10#0102030405060708
+(1436509052.850131) vcan0 123#R
+(1436509052.850200) vcan0 124#R4
+(1436509052.900000) vcan0 333##1112233
+(1436509053.050284) vcan0 5D0#
+`
+
+func TestVirtualBusReplay(t *testing.T) {
+	bus := NewVirtualBus(1000000)
+	defer bus.Close()
+	node := bus.Attach(nil)
+	n, err := bus.Replay(strings.NewReader(candumpLog))
+	if err != nil || n != 6 {
+		t.Fatalf("Replay = %d, %v", n, err)
+	}
+	bus.Flush()
+	want := []struct {
+		id     uint32
+		ext    bool
+		remote bool
+		dlc    uint8
+		offset time.Duration
+	}{
+		{0x044, false, false, 5, 0},
+		{0x0F6, false, false, 5, 200134 * time.Microsecond},
+		{0x1F3A2C10, true, false, 8, 400291 * time.Microsecond},
+		{0x123, false, true, 0, 600418 * time.Microsecond},
+		{0x124, false, true, 4, 600487 * time.Microsecond},
+		{0x5D0, false, false, 0, 800571 * time.Microsecond},
+	}
+	for i, w := range want {
+		f, err := node.ReceiveFrame(0)
+		if err != nil {
+			t.Fatalf("第 %d 帧: %s", i, err)
+		}
+		if f.ID != w.id || f.Extended != w.ext || f.Remote != w.remote || f.DLC != w.dlc {
+			t.Fatalf("第 %d 帧 %+v", i, f)
+		}
+		// 时间戳为传输结束时间，不早于日志中的相对时间
+		if ts := time.Duration(f.Timestamp); ts < w.offset || ts > w.offset+time.Millisecond {
+			t.Fatalf("第 %d 帧时间 %s，日志时间 %s", i, ts, w.offset)
+		}
+	}
+	if _, err := bus.Replay(strings.NewReader("(1.0) can0 123#00\n(2.0) can0 12#00\n")); err == nil || !strings.Contains(err.Error(), "line 2") {
+		t.Fatalf("格式错误返回 %v", err)
+	}
+}
+
+func TestVirtualBusRealTime(t *testing.T) {
+	bus := NewVirtualBus(125000)
+	defer bus.Close()
+	bus.SetTimeScale(1)
+	a, b := bus.Attach(nil), bus.Attach(nil)
+	start := time.Now()
+	for i := range 10 {
+		a.SendFrame(&driver.CANFrame{ID: uint32(i), DLC: 8})
+	}
+	bus.Flush()
+	elapsed := time.Since(start)
+	if busy := bus.Stats().Busy; elapsed < busy*9/10 {
+		t.Fatalf("实时模式耗时 %s，总线占用 %s", elapsed, busy)
+	}
+	var f driver.CANFrame
+	for i := range 10 {
+		if err := b.ReadFrame(&f, 0); err != nil || f.ID != uint32(i) {
+			t.Fatalf("第 %d 帧 %+v (%v)", i, f, err)
+		}
+	}
+}
+
+func BenchmarkVirtualBusReplay(b *testing.B) {
+	rng := rand.New(rand.NewSource(13))
+	var log strings.Builder
+	frames := randomFrames(rng, 1000)
+	for i, f := range frames {
+		data := ""
+		if f.Remote {
+			data = "R"
+		} else {
+			for _, v := range f.Data[:f.DLC] {
+				data += fmt.Sprintf("%02X", v)
+			}
+		}
+		id := fmt.Sprintf("%03X", f.ID)
+		if f.Extended {
+			id = fmt.Sprintf("%08X", f.ID)
+		}
+		fmt.Fprintf(&log, "(%d.%06d) can0 %s#%s\n", 1000+i/1000, (i%1000)*1000, id, data)
+	}
+	text := log.String()
+	bus := NewVirtualBus(1000000)
+	defer bus.Close()
+	node := bus.Attach(nil)
+	d := NewDispatcher()
+	for i := 0; i < 200; i++ {
+		d.Subscribe(frames[i].ID, frames[i].Extended, func(*driver.CANFrame) {})
+	}
+	go d.Run(node)
+	b.ResetTimer()
+	start := bus.Stats().Now
+	for i := 0; i < b.N; i++ {
+		bus.Replay(strings.NewReader(text))
+		bus.Flush()
+	}
+	b.StopTimer()
+	sim := bus.Stats().Now - start
+	b.ReportMetric(float64(len(frames)), "frames/op")
+	b.ReportMetric(float64(sim)/float64(b.Elapsed()), "x-realtime")
+}
@@ -78,6 +78,8 @@ bool CH347WriteEEPROM(int fd, int iEepromID, int iAddr, int iLength, uint8_t *iB
 import "C"
 import (
 	"circuit/gpio/driver"
+	"circuit/gpio/driver/ch34x/stream"
+	"encoding/binary"
 	"errors"
 	"fmt"
 	"sync"
@@ -320,40 +322,60 @@ func (lib *library) SPIWrite(fd int, ignoreCS bool, chipSelect uint8, data []byt
 
 // SPIRead 读取SPI数据
 func (lib *library) SPIRead(fd int, ignoreCS bool, chipSelect uint8, length int) ([]byte, error) {
-	lib.mu.RLock()
-	defer lib.mu.RUnlock()
 	if length <= 0 {
 		return nil, errors.New("invalid read length")
 	}
 	buffer := make([]byte, length)
+	n, err := lib.SPIReadInto(fd, ignoreCS, chipSelect, buffer)
+	if err != nil {
+		return nil, err
+	}
+	return buffer[:n], nil
+}
+
+// SPIReadInto 读取SPI数据到调用者提供的缓冲区，返回实际读取的字节数，不分配内存
+func (lib *library) SPIReadInto(fd int, ignoreCS bool, chipSelect uint8, buffer []byte) (int, error) {
+	lib.mu.RLock()
+	defer lib.mu.RUnlock()
+	if len(buffer) == 0 {
+		return 0, errors.New("invalid read length")
+	}
 	var outLength uint32
 	success := C.CH347SPI_Read(
 		C.int(fd),
 		C.bool(ignoreCS),
 		C.uchar(chipSelect),
-		C.int(length),
+		C.int(len(buffer)),
 		(*C.uint32_t)(unsafe.Pointer(&outLength)),
 		unsafe.Pointer(&buffer[0]),
 	)
 	if !success {
-		return nil, errors.New("failed to read SPI data")
-	}
-	if int(outLength) < length {
-		buffer = buffer[:outLength]
+		return 0, errors.New("failed to read SPI data")
 	}
-	return buffer, nil
+	return min(int(outLength), len(buffer)), nil
 }
 
 // SPIWriteRead 在全双工模式下写入和读取SPI数据
 func (lib *library) SPIWriteRead(fd int, ignoreCS bool, chipSelect uint8, data []byte) ([]byte, error) {
-	lib.mu.RLock()
-	defer lib.mu.RUnlock()
 	if len(data) == 0 {
 		return nil, nil
 	}
 	// Create a copy for in/out buffer
 	buffer := make([]byte, len(data))
 	copy(buffer, data)
+	if err := lib.SPIWriteReadInto(fd, ignoreCS, chipSelect, buffer); err != nil {
+		return nil, err
+	}
+	return buffer, nil
+}
+
+// SPIWriteReadInto 全双工SPI传输，写入buffer中的数据并把读取的数据原地写回buffer，不分配内存
+func (lib *library) SPIWriteReadInto(fd int, ignoreCS bool, chipSelect uint8, buffer []byte) error {
+	lib.mu.RLock()
+	defer lib.mu.RUnlock()
+	if len(buffer) == 0 {
+		return nil
+	}
 	success := C.CH347SPI_WriteRead(
 		C.int(fd),
 		C.bool(ignoreCS),
@@ -362,9 +384,9 @@ func (lib *library) SPIWriteRead(fd int, ignoreCS bool, chipSelect uint8, data [
 		unsafe.Pointer(&buffer[0]),
 	)
 	if !success {
-		return nil, errors.New("failed to write/read SPI data")
+		return errors.New("failed to write/read SPI data")
 	}
-	return buffer, nil
+	return nil
 }
 
 // GPIOGet 获取GPIO状态
@@ -553,27 +575,33 @@ func (lib *library) i2cStreamWithAck(fd int, writeData []byte, readLength int) (
 
 // StreamI2C 在流模式下执行I2C写/读操作
 func (lib *library) StreamI2C(fd int, writeData []byte, readLength int) ([]byte, error) {
-	lib.mu.RLock()
-	defer lib.mu.RUnlock()
 	var readBuffer []byte
 	if readLength > 0 {
 		readBuffer = make([]byte, readLength)
 	}
+	if err := lib.StreamI2CInto(fd, writeData, readBuffer); err != nil {
+		return nil, err
+	}
+	return readBuffer, nil
+}
+
+// StreamI2CInto 在流模式下执行I2C写/读操作，读取len(readBuffer)字节到调用者提供的缓冲区，不分配内存
+func (lib *library) StreamI2CInto(fd int, writeData, readBuffer []byte) error {
+	lib.mu.RLock()
+	defer lib.mu.RUnlock()
 	var writePtr unsafe.Pointer
-	var writeLen int
 	if len(writeData) > 0 {
 		writePtr = unsafe.Pointer(&writeData[0])
-		writeLen = len(writeData)
 	}
 	var readPtr unsafe.Pointer
-	if readLength > 0 {
+	if len(readBuffer) > 0 {
 		readPtr = unsafe.Pointer(&readBuffer[0])
 	}
-	success := C.CH347StreamI2C(C.int(fd), C.int(writeLen), writePtr, C.int(readLength), readPtr)
+	success := C.CH347StreamI2C(C.int(fd), C.int(len(writeData)), writePtr, C.int(len(readBuffer)), readPtr)
 	if !success {
-		return nil, errors.New("failed to perform stream I2C operation")
+		return errors.New("failed to perform stream I2C operation")
 	}
-	return readBuffer, nil
+	return nil
 }
 
 // JtagReset 重置JTAG TAP状态
@@ -720,6 +748,32 @@ func (lib *library) SPIGetHwStreamCfg(fd int, streamCfg unsafe.Pointer) error {
 	return nil
 }
 
+// hwStreamCfgSize 库中StreamHwCfgS结构体的大小（按1字节对齐）
+const hwStreamCfgSize = 26
+
+// SPIHwStreamConfig 获取并解析SPI硬件流配置
+func (lib *library) SPIHwStreamConfig(fd int) (stream.HwConfig, error) {
+	var raw [hwStreamCfgSize]byte
+	if err := lib.SPIGetHwStreamCfg(fd, unsafe.Pointer(&raw[0])); err != nil {
+		return stream.HwConfig{}, err
+	}
+	u16 := func(i int) uint16 { return binary.LittleEndian.Uint16(raw[i:]) }
+	return stream.HwConfig{
+		Direction:         u16(0),
+		Mode:              u16(2),
+		DataSize:          u16(4),
+		CPOL:              u16(6),
+		CPHA:              u16(8),
+		NSS:               u16(10),
+		BaudRatePrescaler: u16(12),
+		FirstBit:          u16(14),
+		CRCPolynomial:     u16(16),
+		WriteReadInterval: u16(18),
+		OutDefaultData:    raw[20],
+		Other:             raw[21],
+	}, nil
+}
+
 // SPISetAutoCS 设置SPI自动片选
 func (lib *library) SPISetAutoCS(fd int, disable bool) error {
 	lib.mu.RLock()
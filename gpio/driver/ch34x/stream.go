@@ -0,0 +1,64 @@
+package ch34x
+
+import "circuit/gpio/driver/ch34x/stream"
+
+// 编译期检查库后端实现 stream.Backend
+var _ stream.Backend = libBackend{}
+
+// libBackend 绑定到设备文件描述符的 CH34x 库，实现 stream.Backend
+// 缓冲区直接交给库函数，不复制、不分配内存。
+type libBackend struct {
+	lib *library
+	fd  int
+}
+
+// SPIWrite 写入SPI数据
+func (b libBackend) SPIWrite(ignoreCS bool, chipSelect uint8, data []byte) error {
+	return b.lib.SPIWrite(b.fd, ignoreCS, chipSelect, data)
+}
+
+// SPIWriteRead 原地全双工SPI传输
+func (b libBackend) SPIWriteRead(ignoreCS bool, chipSelect uint8, buf []byte) error {
+	return b.lib.SPIWriteReadInto(b.fd, ignoreCS, chipSelect, buf)
+}
+
+// SPIChangeCS 改变SPI片选状态
+func (b libBackend) SPIChangeCS(status uint8) error {
+	return b.lib.SPIChangeCS(b.fd, status)
+}
+
+// I2CStream 一次I2C流式读写
+func (b libBackend) I2CStream(write, read []byte) error {
+	return b.lib.StreamI2CInto(b.fd, write, read)
+}
+
+// JTAGByteWriteDR 按字节写入JTAG DR数据
+func (b libBackend) JTAGByteWriteDR(data []byte) error {
+	return b.lib.JtagByteWriteDR(b.fd, data)
+}
+
+// SPIHwStreamConfig 获取SPI硬件流配置
+func (b libBackend) SPIHwStreamConfig() (stream.HwConfig, error) {
+	return b.lib.SPIHwStreamConfig(b.fd)
+}
+
+// NewStream 创建批量流式 SPI 写入，见 stream.SPI
+// 流使用同一个设备，流关闭之前不应再直接调用 d 的传输方法。
+func (d *SPIDriver) NewStream(chipSelect uint8, cfg stream.Config) (*stream.SPI, error) {
+	return stream.NewSPI(libBackend{GlobalLib, d.fd}, chipSelect, cfg)
+}
+
+// HwStreamConfig 获取并解析SPI硬件流配置
+func (d *SPIDriver) HwStreamConfig() (stream.HwConfig, error) {
+	return GlobalLib.SPIHwStreamConfig(d.fd)
+}
+
+// NewStream 创建批量流式 I2C 写入，见 stream.I2C
+func (d *I2CDriver) NewStream(cfg stream.Config) (*stream.I2C, error) {
+	return stream.NewI2C(libBackend{GlobalLib, d.fd}, cfg)
+}
+
+// NewStream 创建批量流式 JTAG DR 写入，见 stream.JTAG
+func (d *JTAGDriver) NewStream(cfg stream.Config) *stream.JTAG {
+	return stream.NewJTAG(libBackend{GlobalLib, d.fd}, cfg)
+}
@@ -0,0 +1,168 @@
+package stream
+
+import (
+	"errors"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// 编译期检查模拟后端实现 Backend
+var _ Backend = (*Fake)(nil)
+
+// 模拟后端的错误
+var (
+	ErrFakeInjected   = errors.New("stream: fake injected failure")
+	ErrFakeConcurrent = errors.New("stream: fake backend called concurrently")
+)
+
+// FakeI2C 模拟后端记录的一次 I2C 传输
+type FakeI2C struct {
+	Write   []byte // 写入的字节（含地址字节）
+	ReadLen int    // 读取的字节数
+}
+
+// FakeStats 模拟后端统计
+type FakeStats struct {
+	Calls uint64 // 库调用次数，对应 USB 往返次数（含片选控制）
+	Bytes uint64 // 写入与读取的数据字节数
+}
+
+// Fake 进程内模拟的 CH34x 库后端
+// SPI 的 MISO 与 MOSI 相连（全双工传输读回写入的数据）；记录每个片选帧写入的字节、每次 I2C 传输与 JTAG DR 数据流。
+// 两个调用同时执行时返回 ErrFakeConcurrent，用于检查流的提交顺序。配置字段应在使用前设置。
+type Fake struct {
+	Hw      HwConfig      // SPIHwStreamConfig 返回的硬件流配置
+	Latency time.Duration // 每次调用的模拟往返延迟
+	FailAt  uint64        // 第 FailAt 次调用（从 1 开始）返回 ErrFakeInjected，0 表示不注入
+	// Gate 不为 nil 时每次调用先从中接收一个值，测试用它阻塞后端
+	Gate chan struct{}
+	// I2CRead 填充 I2C 读取的数据，nil 时读取 0xFF
+	I2CRead func(write, read []byte)
+	// NoRecord 只统计调用，不记录帧与传输（检查内存分配与基准测试使用）
+	NoRecord bool
+
+	busy  atomic.Bool
+	calls atomic.Uint64
+	bytes atomic.Uint64
+
+	mu     sync.Mutex
+	frames [][]byte
+	open   []byte // 手动片选期间写入的字节，nil 表示片选无效
+	i2c    []FakeI2C
+	jtag   []byte
+}
+
+// call 记录一次调用，执行 fn
+func (f *Fake) call(n int, fn func()) error {
+	if !f.busy.CompareAndSwap(false, true) {
+		return ErrFakeConcurrent
+	}
+	defer f.busy.Store(false)
+	if f.Gate != nil {
+		<-f.Gate
+	}
+	if c := f.calls.Add(1); c == f.FailAt {
+		return ErrFakeInjected
+	}
+	f.bytes.Add(uint64(n))
+	if f.Latency > 0 {
+		time.Sleep(f.Latency)
+	}
+	if !f.NoRecord {
+		f.mu.Lock()
+		fn()
+		f.mu.Unlock()
+	}
+	return nil
+}
+
+// spi 记录 SPI 写入：手动片选有效时加入当前帧，否则自成一帧
+func (f *Fake) spi(ignoreCS bool, data []byte) {
+	if ignoreCS {
+		if f.open != nil {
+			f.open = append(f.open, data...)
+		}
+		return
+	}
+	f.frames = append(f.frames, append([]byte(nil), data...))
+}
+
+// SPIWrite 写入 SPI 数据
+func (f *Fake) SPIWrite(ignoreCS bool, chipSelect uint8, data []byte) error {
+	return f.call(len(data), func() { f.spi(ignoreCS, data) })
+}
+
+// SPIWriteRead 全双工传输，buf 保持写入的数据（回环）
+func (f *Fake) SPIWriteRead(ignoreCS bool, chipSelect uint8, buf []byte) error {
+	return f.call(2*len(buf), func() { f.spi(ignoreCS, buf) })
+}
+
+// SPIChangeCS 设置或取消片选，取消时把期间写入的字节记为一帧
+func (f *Fake) SPIChangeCS(status uint8) error {
+	return f.call(0, func() {
+		switch {
+		case status != 0 && f.open == nil:
+			f.open = []byte{}
+		case status == 0 && f.open != nil:
+			f.frames = append(f.frames, f.open)
+			f.open = nil
+		}
+	})
+}
+
+// I2CStream 一次 I2C 传输
+func (f *Fake) I2CStream(write, read []byte) error {
+	return f.call(len(write)+len(read), func() {
+		f.i2c = append(f.i2c, FakeI2C{Write: append([]byte(nil), write...), ReadLen: len(read)})
+		if f.I2CRead != nil {
+			f.I2CRead(write, read)
+			return
+		}
+		for i := range read {
+			read[i] = 0xFF
+		}
+	})
+}
+
+// JTAGByteWriteDR 写入 JTAG DR 数据
+func (f *Fake) JTAGByteWriteDR(data []byte) error {
+	return f.call(len(data), func() { f.jtag = append(f.jtag, data...) })
+}
+
+// SPIHwStreamConfig 返回 Hw
+func (f *Fake) SPIHwStreamConfig() (HwConfig, error) {
+	return f.Hw, nil
+}
+
+// Frames 取出并清空已完成的 SPI 片选帧
+func (f *Fake) Frames() [][]byte {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	frames := f.frames
+	f.frames = nil
+	return frames
+}
+
+// I2C 取出并清空 I2C 传输记录
+func (f *Fake) I2C() []FakeI2C {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	t := f.i2c
+	f.i2c = nil
+	return t
+}
+
+// JTAG 取出并清空 JTAG DR 数据
+func (f *Fake) JTAG() []byte {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	d := f.jtag
+	f.jtag = nil
+	return d
+}
+
+// Stats 返回调用统计
+func (f *Fake) Stats() FakeStats {
+	return FakeStats{Calls: f.calls.Load(), Bytes: f.bytes.Load()}
+}
@@ -0,0 +1,103 @@
+package stream
+
+import "errors"
+
+// I2CMaxPrefix Write 与 WriteStream 的前缀最大长度
+const I2CMaxPrefix = 15
+
+// I2C 流的错误
+var (
+	ErrPrefix  = errors.New("stream: i2c prefix too long")
+	ErrTooLong = errors.New("stream: i2c write longer than packet")
+)
+
+// I2C 批量流式 I2C 写入
+//
+// 每个包是一次 CH347StreamI2C 写传输：地址字节（7 位地址左移一位）、前缀与数据。
+// Write 每次调用是一次独立的传输，适用于寄存器写入：连续两次写同一个寄存器仍是两次传输，
+// 不会变成一次地址自动递增的传输。WriteStream 把地址与前缀相同的连续写入合并为一次传输，超过包大小时拆分为多次传输，
+// 每次都重新发送地址与前缀，只适用于前缀之后的数据是连续数据流的设备，例如 SSD1306 的 0x40 数据前缀或 FIFO 寄存器。
+type I2C struct {
+	b    Backend
+	p    *pipeline
+	head []byte // 当前写入的包头
+	tx   []byte // Tx 的写缓冲区，在各次调用之间复用
+}
+
+// NewI2C 创建 I2C 流，cfg.Depth 为 0 时读取硬件流配置决定
+func NewI2C(b Backend, cfg Config) (*I2C, error) {
+	cfg, err := cfg.resolve(b)
+	if err != nil {
+		return nil, err
+	}
+	s := &I2C{b: b, head: make([]byte, 0, 1+I2CMaxPrefix)}
+	s.p = newPipeline(cfg, 1+I2CMaxPrefix, func(pk *packet) error { return b.I2CStream(pk.buf, nil) })
+	return s, nil
+}
+
+// Write 把一次独立的写传输加入队列，不与之前或之后的写入合并
+// 参数:
+//   - addr: 7 位设备地址
+//   - prefix: 传输开头的字节（控制字节或寄存器地址），最多 I2CMaxPrefix 字节
+//   - data: 数据，返回后即可修改；不能超过包大小
+func (s *I2C) Write(addr uint8, prefix, data []byte) error {
+	if len(prefix) > I2CMaxPrefix {
+		return ErrPrefix
+	}
+	if len(data) > s.p.size {
+		return ErrTooLong
+	}
+	s.head = append(append(s.head[:0], addr<<1), prefix...)
+	if err := s.p.write(s.head, data, false, nil); err != nil {
+		return err
+	}
+	s.p.submit()
+	return nil
+}
+
+// WriteStream 把数据流写入加入队列，与地址和前缀相同的上一次 WriteStream 合并为一次传输
+// 参数:
+//   - addr: 7 位设备地址
+//   - prefix: 每次传输开头的字节（例如 SSD1306 的 0x40 数据前缀），最多 I2CMaxPrefix 字节
+//   - data: 数据，返回后即可修改
+func (s *I2C) WriteStream(addr uint8, prefix, data []byte) error {
+	if len(prefix) > I2CMaxPrefix {
+		return ErrPrefix
+	}
+	s.head = append(append(s.head[:0], addr<<1), prefix...)
+	return s.p.write(s.head, data, true, nil)
+}
+
+// Tx 在之前的写入完成后执行一次写后读传输，读取的数据直接写入 read
+// 参数:
+//   - addr: 7 位设备地址
+//   - write: 地址字节之后写入的数据，可以为空
+//   - read: 读取缓冲区，长度为读取的字节数，可以为空
+func (s *I2C) Tx(addr uint8, write, read []byte) error {
+	if err := s.Flush(); err != nil {
+		return err
+	}
+	s.tx = append(append(s.tx[:0], addr<<1), write...)
+	if err := s.b.I2CStream(s.tx, read); err != nil {
+		return err
+	}
+	s.p.writes.Add(1)
+	s.p.packets.Add(1)
+	s.p.bytes.Add(uint64(len(write) + len(read)))
+	return nil
+}
+
+// Flush 提交剩余数据并等待全部写入完成，返回上次 Flush 以来第一个提交错误
+func (s *I2C) Flush() error {
+	return s.p.flush()
+}
+
+// Stats 返回流统计，Bytes 不含地址与前缀
+func (s *I2C) Stats() Stats {
+	return s.p.stats()
+}
+
+// Close 提交剩余数据，停止后台协程
+func (s *I2C) Close() error {
+	return s.p.close()
+}
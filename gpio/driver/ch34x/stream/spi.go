@@ -0,0 +1,186 @@
+package stream
+
+// SPI 批量流式 SPI 写入
+//
+// 数据按片选帧组织：EndFrame 之前的 Write 合并为一个帧，片选在整个帧期间保持有效。
+// 不超过一个包的帧只调用一次库函数，由库自动控制片选；跨越多个包的帧在第一个包之前设置片选，
+// 在最后一个包之后取消片选，中间的包不改变片选。不同的帧不会合并，片选边沿仍然分隔命令。
+type SPI struct {
+	b       Backend
+	cs      uint8
+	p       *pipeline
+	spilled bool // 当前帧已跨越多个包
+	csOpen  bool // 手动设置的片选仍然有效，只由提交包的协程访问
+}
+
+// NewSPI 创建 SPI 流
+// 参数:
+//   - b: 绑定到设备的后端
+//   - chipSelect: 片选，与 CH347SPI_Write 的 iChipSelect 相同
+//   - cfg: 流配置，Depth 为 0 时读取硬件流配置决定
+//
+// 返回值: SPI 流，读取硬件流配置失败时返回错误
+func NewSPI(b Backend, chipSelect uint8, cfg Config) (*SPI, error) {
+	cfg, err := cfg.resolve(b)
+	if err != nil {
+		return nil, err
+	}
+	s := &SPI{b: b, cs: chipSelect}
+	s.p = newPipeline(cfg, 0, s.send)
+	s.p.skip = s.skip
+	return s, nil
+}
+
+// send 提交一个包
+// 手动片选的包出错时取消片选，之后的包被丢弃，片选不会一直保持有效。
+func (s *SPI) send(pk *packet) error {
+	if pk.csBegin {
+		s.csOpen = true
+		if err := s.b.SPIChangeCS(1); err != nil {
+			s.releaseCS()
+			return err
+		}
+	}
+	if err := s.b.SPIWrite(pk.manualCS, s.cs, pk.buf); err != nil {
+		if pk.manualCS {
+			s.releaseCS()
+		}
+		return err
+	}
+	if pk.csEnd {
+		return s.releaseCS()
+	}
+	return nil
+}
+
+// skip 出错后丢弃的包结束帧时，取消仍然有效的片选
+func (s *SPI) skip(pk *packet) {
+	if pk.csEnd && s.csOpen {
+		s.releaseCS()
+	}
+}
+
+// releaseCS 取消片选，失败时保持 csOpen，由之后丢弃的帧尾包重试
+func (s *SPI) releaseCS() error {
+	if err := s.b.SPIChangeCS(0); err != nil {
+		return err
+	}
+	s.csOpen = false
+	return nil
+}
+
+// spill 当前帧跨越多个包：改为手动控制片选
+func (s *SPI) spill(pk *packet) {
+	if !s.spilled {
+		pk.csBegin = true
+		s.spilled = true
+	}
+	pk.manualCS = true
+}
+
+// Write 把 data 加入当前帧，data 在返回后即可修改
+// 返回值: 流已关闭或之前提交的包出错时返回错误
+func (s *SPI) Write(data []byte) error {
+	return s.p.write(nil, data, true, s.spill)
+}
+
+// EndFrame 结束当前帧并提交，下一个 Write 开始新的帧
+func (s *SPI) EndFrame() error {
+	if s.p.closed {
+		return ErrClosed
+	}
+	if pk := s.p.cur; pk != nil && s.spilled {
+		pk.manualCS, pk.csEnd = true, true
+	}
+	s.p.submit()
+	s.spilled = false
+	return s.p.check()
+}
+
+// Flush 结束当前帧并等待全部写入完成
+// 返回值: 上次 Flush 以来第一个提交错误；出错之后的包被丢弃，跨越多个包的帧的片选仍会取消
+func (s *SPI) Flush() error {
+	if s.p.closed {
+		return ErrClosed
+	}
+	s.EndFrame()
+	return s.p.flush()
+}
+
+// WriteRead 在之前的写入完成后执行一次全双工传输（一个片选帧）
+// 参数:
+//   - tx: 写入的数据
+//   - rx: 读取的数据，长度至少为 len(tx)，可以与 tx 是同一个切片；不分配内存
+func (s *SPI) WriteRead(tx, rx []byte) error {
+	if len(rx) < len(tx) {
+		return ErrShortRead
+	}
+	if err := s.Flush(); err != nil {
+		return err
+	}
+	if len(tx) == 0 {
+		return nil
+	}
+	buf := rx[:len(tx)]
+	copy(buf, tx)
+	if err := s.b.SPIWriteRead(false, s.cs, buf); err != nil {
+		return err
+	}
+	s.p.writes.Add(1)
+	s.p.packets.Add(1)
+	s.p.bytes.Add(uint64(len(buf)))
+	return nil
+}
+
+// Stats 返回流统计
+func (s *SPI) Stats() Stats {
+	return s.p.stats()
+}
+
+// Close 提交剩余数据，停止后台协程
+func (s *SPI) Close() error {
+	if s.p.closed {
+		return nil
+	}
+	s.EndFrame()
+	return s.p.close()
+}
+
+// JTAG 批量流式 JTAG DR 写入
+// 每个包是一次 CH347Jtag_ByteWriteDR 调用（一次 DR 扫描），连续的 Write 合并到同一次扫描中，
+// 适用于目标把 DR 数据当作连续数据流的场景，例如 FPGA 配置位流或调试口的批量下载。
+type JTAG struct {
+	b Backend
+	p *pipeline
+}
+
+// NewJTAG 创建 JTAG 流，Depth 为 0 时使用 2（JTAG 模式下没有 SPI 硬件流配置）
+func NewJTAG(b Backend, cfg Config) *JTAG {
+	if cfg.Depth <= 0 {
+		cfg.Depth = 2
+	}
+	cfg, _ = cfg.resolve(b)
+	j := &JTAG{b: b}
+	j.p = newPipeline(cfg, 0, func(pk *packet) error { return b.JTAGByteWriteDR(pk.buf) })
+	return j
+}
+
+// Write 把 data 加入 DR 数据流，data 在返回后即可修改
+func (j *JTAG) Write(data []byte) error {
+	return j.p.write(nil, data, true, nil)
+}
+
+// Flush 提交剩余数据并等待全部写入完成，返回上次 Flush 以来第一个提交错误
+func (j *JTAG) Flush() error {
+	return j.p.flush()
+}
+
+// Stats 返回流统计
+func (j *JTAG) Stats() Stats {
+	return j.p.stats()
+}
+
+// Close 提交剩余数据，停止后台协程
+func (j *JTAG) Close() error {
+	return j.p.close()
+}
@@ -0,0 +1,282 @@
+// Package stream 为 CH34x USB 适配器提供批量流式 SPI、I2C 与 JTAG 传输。
+//
+// CH34x 库的每次调用（CH347SPI_Write、CH347StreamI2C、CH347Jtag_ByteWriteDR 等）都是一次 cgo 调用和一次 USB 往返，
+// 逐条命令、逐行像素地调用时，闪存编程与屏幕刷新的耗时主要花在往返上。本包把连续的小写入合并到预先分配的包缓冲区中，
+// 攒满一个硬件包（默认 4096 字节，即库的命令包批量大小）才调用一次库函数；包缓冲区在创建流时分配并循环使用，
+// 稳定状态下不分配内存。
+// 流水深度大于 1 时，已满的包交给后台协程提交，调用者同时填充下一个包，USB 往返与数据准备重叠。
+//
+// 流不是并发安全的，同一时间只能由一个协程调用。读取类操作（SPI.WriteRead、I2C.Tx）先等待之前的写入完成，
+// 然后在调用者协程中同步执行并直接写入调用者提供的缓冲区。
+//
+// 后端 (Backend) 由 ch34x 包绑定到已打开的设备；Fake 是进程内的模拟后端，记录总线上的帧与调用次数，用于没有设备时测试。
+//
+// 示例用法：
+//
+//	spi, err := ch34x.OpenSPI("/dev/ch34x_pis0")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	s, err := spi.(*ch34x.SPIDriver).NewStream(0x80, stream.Config{})
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer s.Close()
+//	s.Write([]byte{0x02, byte(addr >> 16), byte(addr >> 8), byte(addr)}) // 页编程命令与地址
+//	for _, chunk := range page {
+//	    s.Write(chunk) // 与命令合并为一个片选帧
+//	}
+//	s.EndFrame()
+//	if err := s.Flush(); err != nil {
+//	    log.Fatal(err)
+//	}
+package stream
+
+import (
+	"bytes"
+	"errors"
+	"sync"
+	"sync/atomic"
+)
+
+// MaxPacketSize 默认的硬件包大小（字节），与库的命令包批量大小相同
+const MaxPacketSize = 4096
+
+// 错误定义
+var (
+	ErrClosed    = errors.New("stream: closed")
+	ErrShortRead = errors.New("stream: read buffer shorter than transfer")
+)
+
+// Backend 绑定到一个设备的 CH34x 库传输原语
+// 传入的缓冲区只在调用期间有效，实现不能保留。流保证同一时间只有一个调用在执行。
+type Backend interface {
+	SPIWrite(ignoreCS bool, chipSelect uint8, data []byte) error    // 写入 SPI 数据，ignoreCS 为 false 时自动控制片选
+	SPIWriteRead(ignoreCS bool, chipSelect uint8, buf []byte) error // 全双工传输，读取的数据原地写回 buf
+	SPIChangeCS(status uint8) error                                 // 设置 (1) 或取消 (0) 片选
+	I2CStream(write, read []byte) error                             // 一次 I2C 传输：写 write（首字节为地址）后读 len(read) 字节
+	JTAGByteWriteDR(data []byte) error                              // 按字节写入 JTAG DR
+	SPIHwStreamConfig() (HwConfig, error)                           // 读取硬件流配置
+}
+
+// HwConfig 硬件流配置，对应库的 StreamHwCfgS（CH347SPI_GetHwStreamCfg）
+type HwConfig struct {
+	Direction         uint16 // SPI 方向
+	Mode              uint16 // SPI 主从模式
+	DataSize          uint16 // 数据位宽
+	CPOL              uint16 // 时钟极性
+	CPHA              uint16 // 时钟相位
+	NSS               uint16 // 片选管理方式
+	BaudRatePrescaler uint16 // 波特率分频
+	FirstBit          uint16 // 位序
+	CRCPolynomial     uint16 // CRC 多项式
+	WriteReadInterval uint16 // SPI 读写间隔，单位微秒
+	OutDefaultData    uint8  // 读取时的默认输出数据
+	Other             uint8  // 其他配置：BIT7/BIT6 为 CS1/CS2 极性，BIT5 为 I2C 时钟拉伸，BIT4 为 I2C 读最后一个字节时是否产生 NACK
+}
+
+// Config 流配置
+type Config struct {
+	PacketSize int // 每个硬件包的最大数据字节数，0 为 MaxPacketSize
+	// Depth 包缓冲区数量：1 为同步提交；大于 1 时已满的包由后台协程按顺序提交，调用者同时填充下一个包，
+	// 全部缓冲区都在排队时调用者等待。
+	// 0 为自动：硬件流配置的读写间隔为 0 时使用 2（双缓冲），否则使用 1。
+	// 读写间隔是为慢速外设留出的操作间隔，流水提交时下一个包已在 USB 端排队，不再保证这段间隔。
+	Depth int
+}
+
+// Stats 流统计
+type Stats struct {
+	Writes  uint64 // 调用者的写入次数
+	Packets uint64 // 提交的硬件包数（库调用次数，不含片选控制）
+	Bytes   uint64 // 提交的数据字节数
+}
+
+// resolve 按硬件流配置补全默认值
+func (c Config) resolve(b Backend) (Config, error) {
+	if c.PacketSize <= 0 {
+		c.PacketSize = MaxPacketSize
+	}
+	if c.Depth <= 0 {
+		hw, err := b.SPIHwStreamConfig()
+		if err != nil {
+			return c, err
+		}
+		c.Depth = 2
+		if hw.WriteReadInterval != 0 {
+			c.Depth = 1
+		}
+	}
+	return c, nil
+}
+
+// packet 包缓冲区
+type packet struct {
+	buf  []byte // 包头与数据，容量为包头最大长度加 PacketSize
+	head int    // 包头长度（I2C 的地址与前缀），包头相同的写入可以合并
+	// SPI 片选控制：跨越多个包的帧在第一个包之前设置片选，在最后一个包之后取消片选，
+	// 只有一个包的帧由库自动控制片选
+	csBegin, csEnd, manualCS bool
+}
+
+// pipeline 包的合并、流水提交与错误记录，由各类流共用
+type pipeline struct {
+	send    func(pk *packet) error // 提交一个包，在后台协程或调用者协程中执行
+	skip    func(pk *packet)       // 出错后丢弃一个包时调用，可以为 nil；与 send 在同一协程中执行
+	size    int
+	free    chan *packet
+	work    chan *packet // 流水提交的包，Depth 为 1 时为 nil
+	pending sync.WaitGroup
+	cur     *packet
+	closed  bool
+
+	mu  sync.Mutex
+	err error // 第一个提交错误，Flush 返回后清除；出错后丢弃在途的包
+
+	writes, packets, bytes atomic.Uint64
+}
+
+// newPipeline 分配包缓冲区，Depth 大于 1 时启动后台提交协程
+func newPipeline(cfg Config, headMax int, send func(pk *packet) error) *pipeline {
+	p := &pipeline{send: send, size: cfg.PacketSize, free: make(chan *packet, cfg.Depth)}
+	for range cfg.Depth {
+		p.free <- &packet{buf: make([]byte, 0, headMax+cfg.PacketSize)}
+	}
+	if cfg.Depth > 1 {
+		p.work = make(chan *packet, cfg.Depth)
+		go p.run()
+	}
+	return p
+}
+
+// run 后台提交协程
+func (p *pipeline) run() {
+	for pk := range p.work {
+		p.exec(pk)
+		p.free <- pk
+		p.pending.Done()
+	}
+}
+
+// exec 提交一个包并记录错误
+func (p *pipeline) exec(pk *packet) {
+	p.mu.Lock()
+	failed := p.err != nil
+	p.mu.Unlock()
+	if failed {
+		if p.skip != nil {
+			p.skip(pk)
+		}
+		return
+	}
+	if err := p.send(pk); err != nil {
+		p.setErr(err)
+		return
+	}
+	p.packets.Add(1)
+	p.bytes.Add(uint64(len(pk.buf) - pk.head))
+}
+
+func (p *pipeline) setErr(err error) {
+	p.mu.Lock()
+	if p.err == nil {
+		p.err = err
+	}
+	p.mu.Unlock()
+}
+
+// check 返回关闭或提交错误，不清除错误
+func (p *pipeline) check() error {
+	if p.closed {
+		return ErrClosed
+	}
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.err
+}
+
+// open 返回可以继续写入 head 开头数据的当前包
+// merge 为 false 或当前包的包头不同时先提交当前包。
+func (p *pipeline) open(head []byte, merge bool) *packet {
+	if p.cur != nil && (!merge || !bytes.Equal(p.cur.buf[:p.cur.head], head)) {
+		p.submit()
+	}
+	if p.cur == nil {
+		p.cur = <-p.free
+		p.cur.buf = append(p.cur.buf[:0], head...)
+		p.cur.head = len(head)
+		p.cur.csBegin, p.cur.csEnd, p.cur.manualCS = false, false, false
+	}
+	return p.cur
+}
+
+// write 把 data 加入包头为 head 的包，包满时提交并以相同的包头继续
+// full 在每个已满的包提交之前调用，可以为 nil。
+func (p *pipeline) write(head, data []byte, merge bool, full func(pk *packet)) error {
+	if err := p.check(); err != nil {
+		return err
+	}
+	p.writes.Add(1)
+	pk := p.open(head, merge)
+	for {
+		n := min(pk.head+p.size-len(pk.buf), len(data))
+		pk.buf = append(pk.buf, data[:n]...)
+		data = data[n:]
+		if len(data) == 0 {
+			return nil
+		}
+		if full != nil {
+			full(pk)
+		}
+		p.submit()
+		pk = p.open(head, true)
+	}
+}
+
+// submit 提交当前包
+func (p *pipeline) submit() {
+	pk := p.cur
+	if pk == nil {
+		return
+	}
+	p.cur = nil
+	if p.work == nil {
+		p.exec(pk)
+		p.free <- pk
+		return
+	}
+	p.pending.Add(1)
+	p.work <- pk
+}
+
+// flush 提交当前包并等待全部包完成，返回并清除提交错误
+func (p *pipeline) flush() error {
+	if p.closed {
+		return ErrClosed
+	}
+	p.submit()
+	p.pending.Wait()
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	err := p.err
+	p.err = nil
+	return err
+}
+
+// close 提交剩余的包，停止后台协程
+func (p *pipeline) close() error {
+	if p.closed {
+		return nil
+	}
+	err := p.flush()
+	p.closed = true
+	if p.work != nil {
+		close(p.work)
+	}
+	return err
+}
+
+// stats 返回统计
+func (p *pipeline) stats() Stats {
+	return Stats{Writes: p.writes.Load(), Packets: p.packets.Load(), Bytes: p.bytes.Load()}
+}
@@ -0,0 +1,322 @@
+package stream
+
+import (
+	"bytes"
+	"errors"
+	"runtime"
+	"testing"
+	"time"
+)
+
+// command 模拟闪存命令：命令字节、三字节地址与数据，分三次写入
+func command(s *SPI, i int) []byte {
+	cmd := []byte{0x02}
+	addr := []byte{byte(i >> 16), byte(i >> 8), byte(i)}
+	data := bytes.Repeat([]byte{byte(i)}, 20)
+	s.Write(cmd)
+	s.Write(addr)
+	s.Write(data)
+	return append(append(cmd, addr...), data...)
+}
+
+func TestSPIFrames(t *testing.T) {
+	for _, depth := range []int{1, 2, 4} {
+		f := &Fake{}
+		s, err := NewSPI(f, 0x80, Config{PacketSize: 64, Depth: depth})
+		if err != nil {
+			t.Fatal(err)
+		}
+		var want [][]byte
+		for i := range 100 {
+			want = append(want, command(s, i))
+			s.EndFrame()
+		}
+		if err := s.Flush(); err != nil {
+			t.Fatal(err)
+		}
+		got := f.Frames()
+		if len(got) != len(want) {
+			t.Fatalf("深度 %d：%d 个帧，期望 %d", depth, len(got), len(want))
+		}
+		for i := range want {
+			if !bytes.Equal(got[i], want[i]) {
+				t.Fatalf("深度 %d 第 %d 帧 %x，期望 %x", depth, i, got[i], want[i])
+			}
+		}
+		// 每帧三次写入合并为一次库调用
+		if st := f.Stats(); st.Calls != 100 {
+			t.Fatalf("深度 %d：库调用 %d 次", depth, st.Calls)
+		}
+		if st := s.Stats(); st.Writes != 300 || st.Packets != 100 || st.Bytes != 2400 {
+			t.Fatalf("深度 %d：统计 %+v", depth, st)
+		}
+		s.Close()
+	}
+}
+
+func TestSPILongFrame(t *testing.T) {
+	// 1000 字节的帧每次写入 10 字节，包大小 256：4 个包，片选在整个帧期间有效
+	f := &Fake{}
+	s, _ := NewSPI(f, 0, Config{PacketSize: 256, Depth: 2})
+	defer s.Close()
+	var want []byte
+	for i := range 100 {
+		chunk := bytes.Repeat([]byte{byte(i)}, 10)
+		want = append(want, chunk...)
+		s.Write(chunk)
+	}
+	// 帧结束后的短帧仍由库自动控制片选
+	s.EndFrame()
+	s.Write([]byte{0x06})
+	if err := s.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	got := f.Frames()
+	if len(got) != 2 || !bytes.Equal(got[0], want) || !bytes.Equal(got[1], []byte{0x06}) {
+		t.Fatalf("帧 %d 个: %x", len(got), got)
+	}
+	if st := f.Stats(); st.Calls != 2+4+1 {
+		t.Fatalf("库调用 %d 次，期望 7", st.Calls)
+	}
+	// 恰好填满一个包的帧不需要手动片选
+	s.Write(make([]byte, 256))
+	s.Flush()
+	if got := f.Frames(); len(got) != 1 || len(got[0]) != 256 {
+		t.Fatalf("整包帧 %d 个", len(got))
+	}
+	if st := f.Stats(); st.Calls != 8 {
+		t.Fatalf("整包帧后库调用 %d 次", st.Calls)
+	}
+}
+
+func TestSPIWriteRead(t *testing.T) {
+	f := &Fake{}
+	s, _ := NewSPI(f, 0, Config{PacketSize: 32, Depth: 2})
+	defer s.Close()
+	s.Write([]byte{1, 2, 3})
+	rx := make([]byte, 4)
+	// 全双工传输在之前的写入之后执行
+	if err := s.WriteRead([]byte{9, 8, 7}, rx); err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(rx[:3], []byte{9, 8, 7}) {
+		t.Fatalf("读取 %x", rx)
+	}
+	if got := f.Frames(); len(got) != 2 || !bytes.Equal(got[0], []byte{1, 2, 3}) || !bytes.Equal(got[1], []byte{9, 8, 7}) {
+		t.Fatalf("帧 %x", got)
+	}
+	if err := s.WriteRead([]byte{1, 2}, rx[:1]); err != ErrShortRead {
+		t.Fatalf("短缓冲区返回 %v", err)
+	}
+	// 稳定状态下写入、全双工传输与等待不分配内存
+	f.NoRecord = true
+	data := make([]byte, 40)
+	allocs := testing.AllocsPerRun(100, func() {
+		s.Write(data)
+		s.EndFrame()
+		s.WriteRead(data[:4], rx)
+	})
+	if allocs != 0 {
+		t.Fatalf("每次分配 %v 次", allocs)
+	}
+}
+
+func TestPipelineOverlap(t *testing.T) {
+	// 后端阻塞时，调用者仍可以填充下一个包
+	f := &Fake{Gate: make(chan struct{})}
+	s, _ := NewSPI(f, 0, Config{PacketSize: 16, Depth: 2})
+	s.Write(make([]byte, 16))
+	s.Write(make([]byte, 8)) // 第一个包已满并提交给后台协程，后端仍被阻塞
+	close(f.Gate)
+	if err := s.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	if got := f.Frames(); len(got) != 1 || len(got[0]) != 24 {
+		t.Fatalf("帧 %d 个", len(got))
+	}
+	s.Close()
+}
+
+func TestStreamError(t *testing.T) {
+	f := &Fake{FailAt: 2}
+	s, _ := NewSPI(f, 0, Config{PacketSize: 8, Depth: 2})
+	for i := range 5 {
+		s.Write([]byte{byte(i)})
+		s.EndFrame()
+	}
+	if err := s.Flush(); !errors.Is(err, ErrFakeInjected) {
+		t.Fatalf("Flush 返回 %v", err)
+	}
+	// 出错之后的包被丢弃
+	if got := f.Frames(); len(got) != 1 {
+		t.Fatalf("出错后提交了 %d 个帧", len(got))
+	}
+	// Flush 返回错误后流可以继续使用
+	s.Write([]byte{7})
+	if err := s.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	if got := f.Frames(); len(got) != 1 || got[0][0] != 7 {
+		t.Fatalf("恢复后的帧 %x", got)
+	}
+	s.Close()
+	if err := s.Write([]byte{1}); err != ErrClosed {
+		t.Fatalf("关闭后写入返回 %v", err)
+	}
+	// 跨越多个包的帧出错：第 2 次调用（第一个包）或第 3 次调用（第二个包）失败后片选被取消，
+	// 下一个帧不会在片选仍然有效时发送
+	for _, failAt := range []uint64{2, 3} {
+		f := &Fake{FailAt: failAt}
+		s, _ := NewSPI(f, 0, Config{PacketSize: 8, Depth: 2})
+		s.Write(make([]byte, 20))
+		if err := s.Flush(); !errors.Is(err, ErrFakeInjected) {
+			t.Fatalf("第 %d 次调用失败：Flush 返回 %v", failAt, err)
+		}
+		f.Frames()
+		if f.open != nil {
+			t.Fatalf("第 %d 次调用失败后片选仍然有效", failAt)
+		}
+		s.Write([]byte{7})
+		if err := s.Flush(); err != nil {
+			t.Fatal(err)
+		}
+		if got := f.Frames(); len(got) != 1 || !bytes.Equal(got[0], []byte{7}) {
+			t.Fatalf("第 %d 次调用失败后的帧 %x", failAt, got)
+		}
+		s.Close()
+	}
+}
+
+func TestDropWithoutClose(t *testing.T) {
+	// 同步提交的流不持有后台协程，没有 Close 就被回收也不会出错
+	for range 3 {
+		s, _ := NewSPI(&Fake{}, 0, Config{Depth: 1})
+		s.Write([]byte{1, 2, 3})
+		s.Flush()
+		i, _ := NewI2C(&Fake{}, Config{Depth: 1})
+		i.Write(0x50, []byte{0}, []byte{1})
+	}
+	runtime.GC()
+	runtime.GC()
+}
+
+func TestHwConfigDepth(t *testing.T) {
+	for _, c := range []struct {
+		interval uint16
+		depth    int
+	}{{0, 2}, {5, 1}} {
+		f := &Fake{Hw: HwConfig{WriteReadInterval: c.interval}}
+		s, err := NewSPI(f, 0, Config{})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if got := cap(s.p.free); got != c.depth || (s.p.work != nil) != (c.depth > 1) {
+			t.Fatalf("读写间隔 %d：深度 %d，期望 %d", c.interval, got, c.depth)
+		}
+		if s.p.size != MaxPacketSize {
+			t.Fatalf("包大小 %d", s.p.size)
+		}
+		s.Close()
+	}
+}
+
+func TestI2CMerge(t *testing.T) {
+	f := &Fake{I2CRead: func(write, read []byte) {
+		for i := range read {
+			read[i] = write[len(write)-1] + byte(i)
+		}
+	}}
+	s, _ := NewI2C(f, Config{PacketSize: 16, Depth: 2})
+	defer s.Close()
+	data := []byte{0x40}
+	// 相同前缀的数据流写入合并，超过包大小时拆分并重复地址与前缀
+	s.WriteStream(0x3C, data, bytes.Repeat([]byte{1}, 10))
+	s.WriteStream(0x3C, data, bytes.Repeat([]byte{2}, 10))
+	s.WriteStream(0x3C, []byte{0x00}, []byte{0xAF}) // 前缀不同
+	s.WriteStream(0x50, []byte{0x00}, []byte{0xAF}) // 地址不同
+	// 寄存器写入不合并：连续两次写同一个寄存器是两次传输，也不与之前和之后的数据流合并
+	s.Write(0x50, []byte{0x00}, []byte{0x80})
+	s.Write(0x50, []byte{0x00}, []byte{0x01})
+	s.WriteStream(0x50, []byte{0x00}, []byte{0x02})
+	rx := make([]byte, 3)
+	if err := s.Tx(0x50, []byte{0x10}, rx); err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(rx, []byte{0x10, 0x11, 0x12}) {
+		t.Fatalf("读取 %x", rx)
+	}
+	want := []FakeI2C{
+		{Write: append([]byte{0x78, 0x40}, append(bytes.Repeat([]byte{1}, 10), 2, 2, 2, 2, 2, 2)...)},
+		{Write: []byte{0x78, 0x40, 2, 2, 2, 2}},
+		{Write: []byte{0x78, 0x00, 0xAF}},
+		{Write: []byte{0xA0, 0x00, 0xAF}},
+		{Write: []byte{0xA0, 0x00, 0x80}},
+		{Write: []byte{0xA0, 0x00, 0x01}},
+		{Write: []byte{0xA0, 0x00, 0x02}},
+		{Write: []byte{0xA0, 0x10}, ReadLen: 3},
+	}
+	got := f.I2C()
+	if len(got) != len(want) {
+		t.Fatalf("%d 次传输: %+v", len(got), got)
+	}
+	for i := range want {
+		if !bytes.Equal(got[i].Write, want[i].Write) || got[i].ReadLen != want[i].ReadLen {
+			t.Fatalf("第 %d 次传输 %+v，期望 %+v", i, got[i], want[i])
+		}
+	}
+	if err := s.Write(0x3C, make([]byte, I2CMaxPrefix+1), nil); err != ErrPrefix {
+		t.Fatalf("过长前缀返回 %v", err)
+	}
+	if err := s.Write(0x3C, data, make([]byte, 17)); err != ErrTooLong {
+		t.Fatalf("超过包大小的寄存器写入返回 %v", err)
+	}
+}
+
+func TestJTAGStream(t *testing.T) {
+	f := &Fake{}
+	j := NewJTAG(f, Config{PacketSize: 100})
+	var want []byte
+	for i := range 250 {
+		want = append(want, byte(i), byte(i>>8))
+		j.Write([]byte{byte(i), byte(i >> 8)})
+	}
+	if err := j.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if got := f.JTAG(); !bytes.Equal(got, want) {
+		t.Fatal("DR 数据流不同")
+	}
+	if st := f.Stats(); st.Calls != 5 {
+		t.Fatalf("库调用 %d 次，期望 5", st.Calls)
+	}
+}
+
+// BenchmarkSPIFrames 比较每次写入调用一次库函数（direct）与流式合并（stream），每个帧写入命令、地址与数据三段，
+// 后端模拟 50µs 的 USB 往返
+func BenchmarkSPIFrames(b *testing.B) {
+	cmd, addr, data := []byte{0x02}, []byte{0, 1, 2}, make([]byte, 64)
+	b.Run("direct", func(b *testing.B) {
+		f := &Fake{NoRecord: true, Latency: 50 * time.Microsecond}
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			f.SPIWrite(false, 0, cmd)
+			f.SPIWrite(false, 0, addr)
+			f.SPIWrite(false, 0, data)
+		}
+		b.ReportMetric(float64(f.Stats().Calls)/float64(b.N), "calls/op")
+	})
+	b.Run("stream", func(b *testing.B) {
+		f := &Fake{NoRecord: true, Latency: 50 * time.Microsecond}
+		s, _ := NewSPI(f, 0, Config{})
+		defer s.Close()
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			s.Write(cmd)
+			s.Write(addr)
+			s.Write(data)
+			s.EndFrame()
+		}
+		s.Flush()
+		b.ReportMetric(float64(f.Stats().Calls)/float64(b.N), "calls/op")
+	})
+}
@@ -0,0 +1,48 @@
+//go:build linux
+
+// Package ptytest 为串口相关驱动的测试提供伪终端（PTY）。
+// 主端模拟对端设备，从端路径交给被测驱动按普通串口打开。
+package ptytest
+
+import (
+	"fmt"
+	"os"
+	"testing"
+	"time"
+
+	"golang.org/x/sys/unix"
+)
+
+// Open 打开一对 PTY，测试结束时关闭主端；系统不支持 PTY 时跳过测试。
+// 参数:
+//   - t: 当前测试。
+//
+// 返回值:
+//   - ptm: PTY 主端。
+//   - slave: 从端设备路径，如 /dev/pts/3。
+func Open(t testing.TB) (ptm *os.File, slave string) {
+	t.Helper()
+	ptm, err := os.OpenFile("/dev/ptmx", os.O_RDWR|unix.O_NOCTTY, 0)
+	if err != nil {
+		t.Skipf("无法打开 /dev/ptmx: %s", err)
+	}
+	t.Cleanup(func() { ptm.Close() })
+	if err := unix.IoctlSetPointerInt(int(ptm.Fd()), unix.TIOCSPTLCK, 0); err != nil {
+		t.Skipf("解锁 PTY 失败: %s", err)
+	}
+	n, err := unix.IoctlGetInt(int(ptm.Fd()), unix.TIOCGPTN)
+	if err != nil {
+		t.Skipf("获取 PTY 编号失败: %s", err)
+	}
+	return ptm, fmt.Sprintf("/dev/pts/%d", n)
+}
+
+// CPUTime 返回进程已使用的 CPU 时间（用户态与内核态之和）。
+// 用于检查空闲的等待循环阻塞在就绪通知上，而不是忙轮询。
+func CPUTime() time.Duration {
+	var ru unix.Rusage
+	if err := unix.Getrusage(unix.RUSAGE_SELF, &ru); err != nil {
+		return 0
+	}
+	return time.Duration(ru.Utime.Nano() + ru.Stime.Nano())
+}
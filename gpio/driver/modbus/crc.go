@@ -0,0 +1,79 @@
+package modbus
+
+// crcSliceMin 使用按 8 字节分片查表的最小数据长度，更短的数据逐字节查表。
+const crcSliceMin = 16
+
+// crcTable CRC16/MODBUS 查找表
+// crcTable[0] 为逐字节查表使用的标准表，crcTable[k][b] 为字节 b 之后再经过 k 个零字节的余式，
+// 用于一次处理 8 个字节（slicing-by-8）。
+var crcTable = makeCRCTable()
+
+// makeCRCTable 生成 CRC16/MODBUS（反向多项式 0xA001）查找表
+func makeCRCTable() *[8][256]uint16 {
+	t := new([8][256]uint16)
+	for b := range 256 {
+		crc := uint16(b)
+		for range 8 {
+			if crc&0x0001 != 0 {
+				crc = crc>>1 ^ 0xA001
+			} else {
+				crc >>= 1
+			}
+		}
+		t[0][b] = crc
+	}
+	for b := range 256 {
+		crc := t[0][b]
+		for k := 1; k < 8; k++ {
+			crc = crc>>8 ^ t[0][crc&0xFF]
+			t[k][b] = crc
+		}
+	}
+	return t
+}
+
+// CRC16 计算 Modbus RTU 的 CRC16 校验
+// 参数:
+//   - data: 需要计算 CRC 的字节切片
+//
+// 返回值:
+//   - uint16: CRC16 校验值，低字节在前写入帧尾
+func CRC16(data []byte) uint16 {
+	return UpdateCRC(0xFFFF, data)
+}
+
+// UpdateCRC 在已有 CRC 的基础上继续计算，用于边接收边校验
+// 参数:
+//   - crc: 之前数据的 CRC，首次调用传入 0xFFFF
+//   - data: 新到达的数据
+//
+// 返回值:
+//   - uint16: 包含 data 在内的 CRC16 校验值
+//
+// 示例:
+//
+//	crc := uint16(0xFFFF)
+//	crc = modbus.UpdateCRC(crc, chunk1)
+//	crc = modbus.UpdateCRC(crc, chunk2) // 等于 CRC16(append(chunk1, chunk2...))
+func UpdateCRC(crc uint16, data []byte) uint16 {
+	t := crcTable
+	if len(data) >= crcSliceMin {
+		for len(data) >= 8 {
+			x := crc ^ (uint16(data[0]) | uint16(data[1])<<8)
+			crc = t[7][x&0xFF] ^ t[6][x>>8] ^
+				t[5][data[2]] ^ t[4][data[3]] ^
+				t[3][data[4]] ^ t[2][data[5]] ^
+				t[1][data[6]] ^ t[0][data[7]]
+			data = data[8:]
+		}
+	}
+	for _, b := range data {
+		crc = crc>>8 ^ t[0][byte(crc)^b]
+	}
+	return crc
+}
+
+// calculateCRC 计算 Modbus RTU 帧的 CRC16 校验，Master 与 Server 共用
+func calculateCRC(data []byte) uint16 {
+	return UpdateCRC(0xFFFF, data)
+}
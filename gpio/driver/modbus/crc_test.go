@@ -0,0 +1,80 @@
+package modbus
+
+import (
+	"fmt"
+	"math/rand"
+	"testing"
+)
+
+// crcBitwise 逐位计算的 CRC16/MODBUS，作为查表实现的参照。
+func crcBitwise(data []byte) uint16 {
+	crc := uint16(0xFFFF)
+	for _, b := range data {
+		crc ^= uint16(b)
+		for range 8 {
+			if crc&0x0001 != 0 {
+				crc = crc>>1 ^ 0xA001
+			} else {
+				crc >>= 1
+			}
+		}
+	}
+	return crc
+}
+
+func TestCRC16(t *testing.T) {
+	// 标准校验值: CRC-16/MODBUS("123456789") = 0x4B37
+	if crc := CRC16([]byte("123456789")); crc != 0x4B37 {
+		t.Fatalf("CRC16(123456789) = %#04x，期望 0x4b37", crc)
+	}
+	// 读保持寄存器请求 01 03 00 00 00 0A 的 CRC 为 C5 CD（低字节在前）
+	if crc := CRC16([]byte{0x01, 0x03, 0x00, 0x00, 0x00, 0x0A}); crc != 0xCDC5 {
+		t.Fatalf("请求帧 CRC = %#04x，期望 0xcdc5", crc)
+	}
+	rng := rand.New(rand.NewSource(1))
+	data := make([]byte, 300)
+	rng.Read(data)
+	for n := range len(data) + 1 {
+		want := crcBitwise(data[:n])
+		if got := CRC16(data[:n]); got != want {
+			t.Fatalf("长度 %d: CRC16 = %#04x，期望 %#04x", n, got, want)
+		}
+		// 任意切分后增量计算结果应一致
+		split := rng.Intn(n + 1)
+		if got := UpdateCRC(UpdateCRC(0xFFFF, data[:split]), data[split:n]); got != want {
+			t.Fatalf("长度 %d 在 %d 处切分: UpdateCRC = %#04x，期望 %#04x", n, split, got, want)
+		}
+	}
+}
+
+// crcSink 保存基准测试结果，防止计算被优化掉。
+var crcSink uint16
+
+func BenchmarkCRC16(b *testing.B) {
+	for _, n := range []int{8, 64, 256} {
+		data := make([]byte, n)
+		rand.New(rand.NewSource(1)).Read(data)
+		b.Run(fmt.Sprintf("bitwise/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(n))
+			for i := 0; i < b.N; i++ {
+				crcSink = crcBitwise(data)
+			}
+		})
+		b.Run(fmt.Sprintf("table/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(n))
+			for i := 0; i < b.N; i++ {
+				crc := uint16(0xFFFF)
+				for _, v := range data {
+					crc = crc>>8 ^ crcTable[0][byte(crc)^v]
+				}
+				crcSink = crc
+			}
+		})
+		b.Run(fmt.Sprintf("slicing8/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(n))
+			for i := 0; i < b.N; i++ {
+				crcSink = CRC16(data)
+			}
+		})
+	}
+}
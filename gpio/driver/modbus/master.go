@@ -1,4 +1,4 @@
-// Package modbus 提供基于 driver.UART 接口的 Modbus RTU 协议实现。
+// Package modbus 提供基于 driver.UART 接口的 Modbus RTU 协议实现，以及 Modbus TCP 传输与 TCP 到 RTU 网关。
 //
 // 该包包含两个主要组件：
 // 1. Master (主站) - 用于主动发起 Modbus 请求
@@ -43,6 +43,9 @@ import (
 	"time"
 )
 
+// ErrBroadcastRead 从站地址为广播地址 0 时发起读请求返回，广播没有响应。
+var ErrBroadcastRead = errors.New("modbus: read requests cannot be broadcast")
+
 // Exception 表示 Modbus 异常响应
 // 当从站返回异常响应时，会返回此类型的错误
 type Exception struct {
@@ -54,12 +57,21 @@ func (e *Exception) Error() string {
 	return fmt.Sprintf("modbus exception code: 0x%02X", e.Code)
 }
 
-// Master 表示一个 Modbus RTU 主站（客户端）
-// 用于向 Modbus 从站发送请求并接收响应
+// Master 表示一个 Modbus 主站（客户端）
+// 用于向 Modbus 从站发送请求并接收响应，底层可以是 RTU 串口（NewMaster）或 TCP 连接（NewTCPMaster）
 type Master struct {
-	uart    driver.UART   // 底层的 UART 接口，用于串口通信
-	slaveID uint8         // 目标从站地址，范围 1-247
-	timeout time.Duration // 读写操作超时时间
+	transport transport     // 底层传输，负责组帧、发送与接收
+	slaveID   uint8         // 目标从站地址（TCP 下为单元标识符），范围 1-247，0 为广播
+	timeout   time.Duration // 读写操作超时时间
+}
+
+// transport 主站的底层传输
+type transport interface {
+	// roundTrip 向从站 slaveID 发送请求 PDU 并在 timeout 内接收响应，
+	// 返回的响应 PDU 在下次调用前有效
+	roundTrip(slaveID uint8, pdu []byte, timeout time.Duration) ([]byte, error)
+	// close 关闭传输
+	close() error
 }
 
 // NewMaster 创建一个新的 Modbus 主站
@@ -72,23 +84,30 @@ type Master struct {
 // 注意: 默认从站地址为 1，超时时间为 100ms
 func NewMaster(uart driver.UART) *Master {
 	return &Master{
-		uart:    uart,
-		slaveID: 1, // 默认从站地址
-		timeout: 100 * time.Millisecond,
+		transport: &rtuReader{uart: uart},
+		slaveID:   1, // 默认从站地址
+		timeout:   100 * time.Millisecond,
 	}
 }
 
+// Close 关闭主站的底层传输
+// 注意: RTU 主站不拥有 UART，Close 不会关闭串口；TCP 主站会关闭连接
+func (c *Master) Close() error {
+	return c.transport.close()
+}
+
 // SetSlaveID 设置 Modbus 从站地址
 // 参数:
-//   - id: 从站地址，范围 1-247
+//   - id: 从站地址，范围 1-247；0 为广播地址
 //
 // 返回值:
 //   - error: 如果地址无效则返回错误
 //
-// 注意: Modbus 协议规定从站地址范围为 1-247，0 为广播地址
+// 注意: 广播只能用于写操作，RTU 主站发送后等待超时时间让从站处理，不接收响应；
+// 广播时读操作返回 ErrBroadcastRead
 func (c *Master) SetSlaveID(id uint8) error {
-	if id == 0 || id > 247 {
-		return errors.New("modbus: slave ID must be between 1 and 247")
+	if id > 247 {
+		return errors.New("modbus: slave ID must be between 0 and 247")
 	}
 	c.slaveID = id
 	return nil
@@ -96,105 +115,43 @@ func (c *Master) SetSlaveID(id uint8) error {
 
 // SetTimeout 设置读写超时时间
 // 参数:
-//   - timeout: 超时时间，影响 sendRequest 中等待响应的时长
+//   - timeout: 超时时间，从请求帧传输完毕开始计算等待响应的时长
 //
-// 注意: 超时时间用于控制 UART 读取操作的等待时间
+// 注意: 底层 UART 的单次读取应能在超时内返回（如设置 ByteTimeout），否则超时无法生效
 func (c *Master) SetTimeout(timeout time.Duration) {
 	c.timeout = timeout
 }
 
 // 内部辅助函数
 
-// calculateCRC 计算 Modbus RTU 的 CRC16 校验
-// 参数:
-//   - data: 需要计算 CRC 的字节切片
-//
-// 返回值:
-//   - uint16: 计算得到的 CRC16 校验值（小端字节序）
-//
-// 算法: 使用 Modbus RTU 标准的 CRC-16-IBM 多项式 0x8005（反向为 0xA001）
-func calculateCRC(data []byte) uint16 {
-	crc := uint16(0xFFFF)
-	for _, b := range data {
-		crc ^= uint16(b)
-		for i := 0; i < 8; i++ {
-			if crc&0x0001 != 0 {
-				crc >>= 1
-				crc ^= 0xA001
-			} else {
-				crc >>= 1
-			}
-		}
-	}
-	return crc
-}
-
 // sendRequest 发送请求并接收响应
 // 这是内部方法，所有公共的读写方法都通过此方法发送请求
 // 参数:
 //   - pdu: Protocol Data Unit，即功能码和数据部分
 //
 // 返回值:
-//   - []byte: 响应中的 PDU 部分（去掉从站地址和 CRC）
+//   - []byte: 响应中的 PDU 部分（去掉从站地址和 CRC 或 MBAP 报文头），RTU 广播请求为 nil
 //   - error: 发送或接收过程中出现的错误，包括异常响应
-//
-// 处理流程:
-//  1. 构建 RTU 帧: 从站地址 + PDU + CRC
-//  2. 发送帧到串口
-//  3. 接收响应数据
-//  4. 验证响应格式、CRC 和从站地址
-//  5. 检查异常响应，如有异常则返回 Exception 错误
 func (c *Master) sendRequest(pdu []byte) ([]byte, error) {
-	// 构建 RTU 帧: 从站地址 + PDU + CRC
-	frame := make([]byte, 1+len(pdu)+2)
-	frame[0] = c.slaveID
-	copy(frame[1:], pdu)
-	crc := calculateCRC(frame[:len(frame)-2])
-	frame[len(frame)-2] = byte(crc & 0xFF)
-	frame[len(frame)-1] = byte(crc >> 8)
-
-	// 发送请求
-	if err := c.uart.Write(frame); err != nil {
-		return nil, err
+	if c.slaveID == 0 && pdu[0] >= FuncCodeReadCoils && pdu[0] <= FuncCodeReadInputRegisters {
+		return nil, ErrBroadcastRead
 	}
-
-	// 接收响应
-	// 简单实现: 读取足够大的缓冲区，解析响应
-	// 实际实现应考虑超时和帧间隔检测
-	readBuf, err := c.uart.Read(256)
+	response, err := c.transport.roundTrip(c.slaveID, pdu, c.timeout)
 	if err != nil {
 		return nil, err
 	}
-
-	// 验证响应
-	if len(readBuf) < 5 {
-		return nil, errors.New("modbus: response too short")
+	if response == nil && c.slaveID == 0 {
+		return nil, nil // 广播没有响应
 	}
-
-	// 检查从站地址
-	if readBuf[0] != c.slaveID {
-		return nil, errors.New("modbus: slave ID mismatch")
-	}
-
-	// 检查 CRC
-	receivedCRC := uint16(readBuf[len(readBuf)-2]) | uint16(readBuf[len(readBuf)-1])<<8
-	expectedCRC := calculateCRC(readBuf[:len(readBuf)-2])
-	if receivedCRC != expectedCRC {
-		return nil, errors.New("modbus: CRC error")
+	if len(response) < 2 {
+		return nil, errors.New("modbus: response too short")
 	}
 
 	// 检查异常响应
-	if readBuf[1]&0x80 != 0 {
-		// 异常响应
-		if len(readBuf) < 5 {
-			return nil, errors.New("modbus: malformed exception response")
-		}
-		exceptionCode := readBuf[2]
-		return nil, &Exception{Code: exceptionCode}
+	if response[0]&0x80 != 0 {
+		return nil, &Exception{Code: response[1]}
 	}
-
-	// 返回 PDU (去掉从站地址和 CRC)
-	return readBuf[1 : len(readBuf)-2], nil
+	return response, nil
 }
 
 // 功能码常量定义
@@ -429,8 +386,8 @@ func (c *Master) WriteSingleCoil(address uint16, value bool) error {
 	}
 
 	response, err := c.sendRequest(pdu)
-	if err != nil {
-		return err
+	if err != nil || response == nil {
+		return err // 出错或广播
 	}
 
 	// 响应应该回显请求
@@ -467,8 +424,8 @@ func (c *Master) WriteSingleRegister(address uint16, value uint16) error {
 	pdu[4] = byte(value)
 
 	response, err := c.sendRequest(pdu)
-	if err != nil {
-		return err
+	if err != nil || response == nil {
+		return err // 出错或广播
 	}
 
 	// 响应应该回显请求
@@ -509,8 +466,8 @@ func (c *Master) WriteMultipleCoils(address uint16, values []bool) error {
 	}
 
 	response, err := c.sendRequest(pdu)
-	if err != nil {
-		return err
+	if err != nil || response == nil {
+		return err // 出错或广播
 	}
 
 	// 响应应该是地址和数量
@@ -549,8 +506,8 @@ func (c *Master) WriteMultipleRegisters(address uint16, values []uint16) error {
 	}
 
 	response, err := c.sendRequest(pdu)
-	if err != nil {
-		return err
+	if err != nil || response == nil {
+		return err // 出错或广播
 	}
 
 	// 响应应该是地址和数量
@@ -0,0 +1,490 @@
+package modbus
+
+import (
+	"circuit/gpio/driver"
+	"errors"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// ErrPipelineStopped 在流水线停止后仍有未完成的请求，或停止后提交新请求时返回。
+var ErrPipelineStopped = errors.New("modbus: pipeline stopped")
+
+// Call 表示一次提交到 Pipeline 的 Modbus 请求
+// 请求完成后 Done 返回的通道被关闭，Response 与 Err 可读。
+type Call struct {
+	SlaveID  uint8  // 从站地址，0 为广播（无响应）
+	Request  []byte // 请求 PDU
+	Response []byte // 响应 PDU（去掉地址与 CRC），广播请求为 nil
+	Err      error  // 通信错误或 Exception
+
+	done     chan struct{}
+	address  uint16 // 读寄存器请求的起始地址
+	quantity uint16 // 读寄存器请求的数量，0 表示不可合并
+	solo     bool   // 合并请求返回异常后改为单独发送
+}
+
+// Done 返回请求完成时关闭的通道
+func (c *Call) Done() <-chan struct{} {
+	return c.done
+}
+
+// Wait 等待请求完成
+// 返回值:
+//   - []byte: 响应 PDU
+//   - error: 通信错误或 Exception
+func (c *Call) Wait() ([]byte, error) {
+	<-c.done
+	return c.Response, c.Err
+}
+
+// Registers 等待读寄存器请求完成并解析寄存器值
+// 返回值:
+//   - []uint16: 寄存器值切片
+//   - error: 通信错误、Exception 或响应长度不匹配
+func (c *Call) Registers() ([]uint16, error) {
+	response, err := c.Wait()
+	if err != nil {
+		return nil, err
+	}
+	if len(response) < 2 {
+		return nil, errors.New("modbus: invalid response length")
+	}
+	byteCount := int(response[1])
+	if len(response) != 2+byteCount || (c.quantity > 0 && byteCount != int(c.quantity)*2) {
+		return nil, errors.New("modbus: response data length mismatch")
+	}
+	registers := make([]uint16, byteCount/2)
+	for i := range registers {
+		offset := 2 + i*2
+		registers[i] = uint16(response[offset])<<8 | uint16(response[offset+1])
+	}
+	return registers, nil
+}
+
+// finish 完成请求
+func (c *Call) finish(response []byte, err error) {
+	c.Response, c.Err = response, err
+	close(c.done)
+}
+
+// slaveQueue 单个从站的请求队列
+type slaveQueue struct {
+	calls   []*Call       // 待发送的请求，按提交顺序
+	timeout time.Duration // 本从站的响应超时，0 表示使用默认值
+}
+
+// batch 一次总线事务：一个请求帧及其服务的所有 Call
+type batch struct {
+	slaveID  uint8
+	calls    []*Call
+	address  uint16 // 合并后的起始地址
+	quantity uint16 // 合并后的寄存器数量
+	timeout  time.Duration
+}
+
+// PipelineStats 流水线统计
+type PipelineStats struct {
+	Frames     uint64 // 发送的请求帧数
+	Calls      uint64 // 完成的请求数
+	Coalesced  uint64 // 合并到其他请求帧中的读请求数
+	Timeouts   uint64 // 响应超时次数
+	Errors     uint64 // CRC、地址或长度错误次数
+	Exceptions uint64 // 从站异常响应次数
+}
+
+// Pipeline 多从站 Modbus RTU 主站引擎
+// 每个从站拥有独立的请求队列与响应超时，后台协程按轮询顺序依次服务各从站，
+// 响应按功能码解析出的期望长度接收（无需等待固定超时），帧间只保留 t3.5 静默。
+// 同一从站排队中的相邻或重叠的读保持/输入寄存器请求会合并为一个多寄存器请求，
+// 响应再按各自的地址范围拆分。
+//
+// 示例用法：
+//
+//	p := modbus.NewPipeline(uart)
+//	p.SetSlaveTimeout(7, 20*time.Millisecond)
+//	p.Start()
+//	defer p.Stop()
+//	calls := make([]*modbus.Call, 0, 60)
+//	for id := uint8(1); id <= 60; id++ {
+//	    calls = append(calls, p.ReadHoldingRegisters(id, 0, 4))
+//	}
+//	for _, c := range calls {
+//	    regs, err := c.Registers()
+//	    ...
+//	}
+type Pipeline struct {
+	reader  rtuReader
+	timeout time.Duration // 默认响应超时
+	maxGap  uint16        // 合并时允许跨越的未请求寄存器数
+
+	mu       sync.Mutex
+	slaves   map[uint8]*slaveQueue
+	order    []uint8 // 轮询顺序
+	next     int     // 下一次轮询的起点
+	running  bool
+	halted   bool // 已调用 Stop 且没有再次 Start，新请求立即以 ErrPipelineStopped 完成
+	wake     chan struct{}
+	stopChan chan struct{}
+	stopped  chan struct{}
+
+	frames     atomic.Uint64
+	calls      atomic.Uint64
+	coalesced  atomic.Uint64
+	timeouts   atomic.Uint64
+	errors     atomic.Uint64
+	exceptions atomic.Uint64
+}
+
+// NewPipeline 创建多从站 Modbus RTU 主站引擎
+// 参数:
+//   - uart: 实现 driver.UART 接口的串口设备，单次读取应能在超时内返回（如设置 ByteTimeout）
+//
+// 返回值:
+//   - *Pipeline: 新创建的引擎，调用 Start 后开始发送请求
+//
+// 注意: 默认响应超时为 100ms，只合并相邻或重叠的寄存器范围
+func NewPipeline(uart driver.UART) *Pipeline {
+	return &Pipeline{
+		reader:  rtuReader{uart: uart},
+		timeout: 100 * time.Millisecond,
+		slaves:  make(map[uint8]*slaveQueue),
+		wake:    make(chan struct{}, 1),
+	}
+}
+
+// SetTimeout 设置默认响应超时
+func (p *Pipeline) SetTimeout(timeout time.Duration) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.timeout = timeout
+}
+
+// SetSlaveTimeout 设置单个从站的响应超时
+// 参数:
+//   - id: 从站地址，0 为广播请求发送后的等待时间
+//   - timeout: 超时时间，0 表示使用默认值
+func (p *Pipeline) SetSlaveTimeout(id uint8, timeout time.Duration) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.queue(id).timeout = timeout
+}
+
+// SetMaxGap 设置合并读请求时允许跨越的未请求寄存器数
+// 较大的值可以减少请求帧数，但被跨越的地址在从站上必须可读，否则合并请求会返回异常
+// （此时各请求会自动改为单独发送）。
+func (p *Pipeline) SetMaxGap(gap uint16) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.maxGap = gap
+}
+
+// Start 启动后台协程开始发送请求
+func (p *Pipeline) Start() error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if p.running {
+		return errors.New("pipeline already running")
+	}
+	p.running, p.halted = true, false
+	p.stopChan = make(chan struct{})
+	p.stopped = make(chan struct{})
+	go p.run(p.stopChan, p.stopped)
+	return nil
+}
+
+// Stop 停止后台协程，等待当前事务结束，未发送的请求以 ErrPipelineStopped 完成
+func (p *Pipeline) Stop() {
+	p.mu.Lock()
+	if !p.running {
+		p.mu.Unlock()
+		return
+	}
+	p.running, p.halted = false, true
+	close(p.stopChan)
+	stopped := p.stopped
+	p.mu.Unlock()
+	<-stopped
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	for _, q := range p.slaves {
+		for _, c := range q.calls {
+			c.finish(nil, ErrPipelineStopped)
+		}
+		q.calls = nil
+	}
+}
+
+// Stats 返回统计快照
+func (p *Pipeline) Stats() PipelineStats {
+	return PipelineStats{
+		Frames:     p.frames.Load(),
+		Calls:      p.calls.Load(),
+		Coalesced:  p.coalesced.Load(),
+		Timeouts:   p.timeouts.Load(),
+		Errors:     p.errors.Load(),
+		Exceptions: p.exceptions.Load(),
+	}
+}
+
+// Submit 提交一个任意功能码的请求
+// 参数:
+//   - slaveID: 从站地址，0 为广播
+//   - pdu: 请求 PDU（功能码 + 数据），调用后可以复用
+//
+// 返回值:
+//   - *Call: 请求句柄，通过 Wait 获取响应
+func (p *Pipeline) Submit(slaveID uint8, pdu []byte) *Call {
+	c := &Call{SlaveID: slaveID, Request: append([]byte(nil), pdu...), done: make(chan struct{})}
+	if slaveID > 247 {
+		c.finish(nil, errors.New("modbus: slave ID must be between 0 and 247"))
+		return c
+	}
+	if len(pdu) == 0 || len(pdu) > rtuMaxFrame-3 {
+		c.finish(nil, errors.New("modbus: invalid PDU length"))
+		return c
+	}
+	if len(pdu) == 5 && slaveID != 0 &&
+		(pdu[0] == FuncCodeReadHoldingRegisters || pdu[0] == FuncCodeReadInputRegisters) {
+		c.address = uint16(pdu[1])<<8 | uint16(pdu[2])
+		c.quantity = uint16(pdu[3])<<8 | uint16(pdu[4])
+	}
+
+	p.mu.Lock()
+	if p.halted {
+		p.mu.Unlock()
+		c.finish(nil, ErrPipelineStopped)
+		return c
+	}
+	q := p.queue(slaveID)
+	q.calls = append(q.calls, c)
+	p.mu.Unlock()
+	select {
+	case p.wake <- struct{}{}:
+	default:
+	}
+	return c
+}
+
+// ReadHoldingRegisters 提交读保持寄存器请求 (功能码 0x03)
+// 参数:
+//   - slaveID: 从站地址，范围 1-247
+//   - address: 起始寄存器地址
+//   - quantity: 寄存器数量，范围 1-125
+func (p *Pipeline) ReadHoldingRegisters(slaveID uint8, address, quantity uint16) *Call {
+	return p.readRegisters(FuncCodeReadHoldingRegisters, slaveID, address, quantity)
+}
+
+// ReadInputRegisters 提交读输入寄存器请求 (功能码 0x04)
+// 参数:
+//   - slaveID: 从站地址，范围 1-247
+//   - address: 起始寄存器地址
+//   - quantity: 寄存器数量，范围 1-125
+func (p *Pipeline) ReadInputRegisters(slaveID uint8, address, quantity uint16) *Call {
+	return p.readRegisters(FuncCodeReadInputRegisters, slaveID, address, quantity)
+}
+
+// readRegisters 提交读寄存器请求
+func (p *Pipeline) readRegisters(fc byte, slaveID uint8, address, quantity uint16) *Call {
+	var err error
+	if slaveID == 0 {
+		err = errors.New("modbus: read requests cannot be broadcast")
+	} else if quantity < 1 || quantity > 125 {
+		err = errors.New("modbus: quantity must be between 1 and 125")
+	}
+	if err != nil {
+		c := &Call{SlaveID: slaveID, done: make(chan struct{})}
+		c.finish(nil, err)
+		return c
+	}
+	return p.Submit(slaveID, []byte{fc, byte(address >> 8), byte(address), byte(quantity >> 8), byte(quantity)})
+}
+
+// queue 返回从站的请求队列，不存在时创建（调用者持有 mu）
+func (p *Pipeline) queue(id uint8) *slaveQueue {
+	q := p.slaves[id]
+	if q == nil {
+		q = &slaveQueue{}
+		p.slaves[id] = q
+		p.order = append(p.order, id)
+	}
+	return q
+}
+
+// run 后台事务循环
+func (p *Pipeline) run(stop, stopped chan struct{}) {
+	defer close(stopped)
+	for {
+		select {
+		case <-stop:
+			return
+		default:
+		}
+		b := p.nextBatch()
+		if b == nil {
+			select {
+			case <-p.wake:
+			case <-stop:
+				return
+			}
+			continue
+		}
+		p.execute(b)
+	}
+}
+
+// nextBatch 按轮询顺序取出下一个从站的请求，并合并可合并的读请求
+func (p *Pipeline) nextBatch() *batch {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	for i := range p.order {
+		idx := (p.next + i) % len(p.order)
+		id := p.order[idx]
+		q := p.slaves[id]
+		if len(q.calls) == 0 {
+			continue
+		}
+		p.next = idx + 1
+		b := &batch{slaveID: id, timeout: q.timeout}
+		if b.timeout <= 0 {
+			b.timeout = p.timeout
+		}
+		head := q.calls[0]
+		b.calls = append(b.calls, head)
+		b.address, b.quantity = head.address, head.quantity
+		q.calls = q.calls[1:]
+		if head.quantity > 0 && !head.solo {
+			q.calls = p.coalesce(b, head.Request[0], q.calls)
+		}
+		if len(q.calls) == 0 {
+			q.calls = nil
+		}
+		return b
+	}
+	return nil
+}
+
+// coalesce 将队列中与 b 相邻或重叠的同功能码读请求合并到 b，返回剩余队列
+// 合并只跨越读请求：遇到其他请求时停止，保证写请求与其后的读请求顺序不变。
+func (p *Pipeline) coalesce(b *batch, fc byte, calls []*Call) []*Call {
+	end := len(calls)
+	for i, c := range calls {
+		if c.quantity == 0 || c.Request[0] != fc {
+			end = i
+			break
+		}
+	}
+	lo, hi := uint32(b.address), uint32(b.address)+uint32(b.quantity)
+	gap := uint32(p.maxGap)
+	merged := make([]bool, end)
+	for changed := true; changed; {
+		changed = false
+		for i := 0; i < end; i++ {
+			c := calls[i]
+			if merged[i] || c.solo {
+				continue
+			}
+			clo, chi := uint32(c.address), uint32(c.address)+uint32(c.quantity)
+			if clo > hi+gap || chi+gap < lo {
+				continue
+			}
+			nlo, nhi := min(lo, clo), max(hi, chi)
+			if nhi-nlo > 125 {
+				continue
+			}
+			lo, hi = nlo, nhi
+			merged[i] = true
+			b.calls = append(b.calls, c)
+			changed = true
+		}
+	}
+	b.address, b.quantity = uint16(lo), uint16(hi-lo)
+
+	rest := calls[:0]
+	for i, c := range calls {
+		if i >= end || !merged[i] {
+			rest = append(rest, c)
+		}
+	}
+	for i := len(rest); i < len(calls); i++ {
+		calls[i] = nil
+	}
+	return rest
+}
+
+// execute 执行一次总线事务并分发响应
+func (p *Pipeline) execute(b *batch) {
+	head := b.calls[0]
+	pdu := head.Request
+	if len(b.calls) > 1 {
+		pdu = []byte{pdu[0], byte(b.address >> 8), byte(b.address), byte(b.quantity >> 8), byte(b.quantity)}
+		p.coalesced.Add(uint64(len(b.calls) - 1))
+	}
+
+	body, err := p.reader.roundTrip(b.slaveID, pdu, b.timeout)
+	p.frames.Add(1)
+	if err != nil {
+		if err == ErrTimeout {
+			p.timeouts.Add(1)
+		} else {
+			p.errors.Add(1)
+			p.reader.drain(b.timeout)
+		}
+		p.complete(b, nil, err)
+		return
+	}
+	if body == nil {
+		p.complete(b, nil, nil) // 广播
+		return
+	}
+	if body[0]&0x80 != 0 {
+		p.exceptions.Add(1)
+		if len(b.calls) > 1 {
+			// 合并范围内可能含有从站不支持的地址，改为逐个发送
+			p.requeue(b)
+			return
+		}
+		p.complete(b, nil, &Exception{Code: body[1]})
+		return
+	}
+	if len(b.calls) == 1 {
+		p.complete(b, append([]byte(nil), body...), nil)
+		return
+	}
+
+	if len(body) != 2+int(b.quantity)*2 || int(body[1]) != int(b.quantity)*2 {
+		p.errors.Add(1)
+		p.complete(b, nil, errors.New("modbus: response data length mismatch"))
+		return
+	}
+	for _, c := range b.calls {
+		out := make([]byte, 2+int(c.quantity)*2)
+		out[0] = body[0]
+		out[1] = byte(c.quantity * 2)
+		offset := 2 + int(c.address-b.address)*2
+		copy(out[2:], body[offset:offset+int(c.quantity)*2])
+		c.finish(out, nil)
+	}
+	p.calls.Add(uint64(len(b.calls)))
+}
+
+// complete 以相同结果完成事务中的所有请求
+func (p *Pipeline) complete(b *batch, response []byte, err error) {
+	for _, c := range b.calls {
+		c.finish(response, err)
+	}
+	p.calls.Add(uint64(len(b.calls)))
+}
+
+// requeue 将合并失败的请求标记为单独发送并放回队首
+func (p *Pipeline) requeue(b *batch) {
+	for _, c := range b.calls {
+		c.solo = true
+	}
+	p.mu.Lock()
+	q := p.queue(b.slaveID)
+	q.calls = append(append([]*Call(nil), b.calls...), q.calls...)
+	p.mu.Unlock()
+}
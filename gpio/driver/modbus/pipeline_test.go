@@ -0,0 +1,288 @@
+//go:build linux
+
+package modbus
+
+import (
+	"circuit/gpio/driver"
+	"circuit/gpio/driver/internal/ptytest"
+	"circuit/gpio/driver/serial"
+	"errors"
+	"os"
+	"sync"
+	"testing"
+	"time"
+)
+
+// ptyUART 以 driver.UART 接口包装 PTY 主端，作为 Server 一侧的总线。
+type ptyUART struct {
+	f *os.File
+}
+
+func (u *ptyUART) Close() error                               { return u.f.Close() }
+func (u *ptyUART) Init(int, uint8, uint8, uint8, uint8) error { return nil }
+func (u *ptyUART) GetConfig() (*driver.UARTConfig, error) {
+	return &driver.UARTConfig{BaudRate: 115200, ByteSize: 8}, nil
+}
+func (u *ptyUART) Write(data []byte) error { _, err := u.f.Write(data); return err }
+func (u *ptyUART) Read(length int) ([]byte, error) {
+	buf := make([]byte, length)
+	n, err := u.f.Read(buf)
+	return buf[:n], err
+}
+
+// openPTY 打开一对 PTY：主端由 Server 使用，从端按串口打开供主站使用。
+func openPTY(t *testing.T) (server *ptyUART, master driver.UART) {
+	t.Helper()
+	ptm, slave := ptytest.Open(t)
+	uart, err := serial.NewUART(slave, &driver.UARTConfig{
+		BaudRate: 115200, ByteSize: 8, ByteTimeout: 10,
+	})
+	if err != nil {
+		t.Skipf("打开 PTY 从端失败: %s", err)
+	}
+	return &ptyUART{f: ptm}, uart
+}
+
+// startServer 在 PTY 主端启动从站，保持寄存器 i 的值为 1000+i。
+func startServer(t *testing.T, bus *ptyUART, id uint8) {
+	t.Helper()
+	handler := NewDefaultHandler(16, 16, 125, 125)
+	for i := range handler.holdingRegisters {
+		handler.holdingRegisters[i] = uint16(1000 + i)
+	}
+	server := NewServer(bus, id)
+	server.SetHandler(handler)
+	if err := server.Start(); err != nil {
+		t.Fatal(err)
+	}
+	t.Cleanup(func() {
+		server.Stop()
+		bus.Close()
+	})
+}
+
+func TestMasterOverPTY(t *testing.T) {
+	bus, uart := openPTY(t)
+	defer uart.Close()
+	startServer(t, bus, 1)
+
+	master := NewMaster(uart)
+	if err := master.WriteSingleRegister(3, 42); err != nil {
+		t.Fatalf("写寄存器失败: %s", err)
+	}
+	regs, err := master.ReadHoldingRegisters(2, 3)
+	if err != nil {
+		t.Fatalf("读寄存器失败: %s", err)
+	}
+	if regs[0] != 1002 || regs[1] != 42 || regs[2] != 1004 {
+		t.Fatalf("寄存器值错误: %v", regs)
+	}
+	var ex *Exception
+	if _, err := master.ReadHoldingRegisters(120, 10); !errors.As(err, &ex) || ex.Code != ExceptionIllegalDataAddress {
+		t.Fatalf("期望非法地址异常，得到 %v", err)
+	}
+}
+
+func TestMasterBroadcast(t *testing.T) {
+	bus, uart := openPTY(t)
+	defer uart.Close()
+	startServer(t, bus, 1)
+
+	master := NewMaster(uart)
+	master.SetTimeout(20 * time.Millisecond)
+	if err := master.SetSlaveID(0); err != nil {
+		t.Fatal(err)
+	}
+	// 广播写不等待响应，从站执行写入但不应答
+	if err := master.WriteSingleRegister(3, 42); err != nil {
+		t.Fatalf("广播写寄存器失败: %s", err)
+	}
+	if err := master.WriteMultipleRegisters(5, []uint16{7, 8}); err != nil {
+		t.Fatalf("广播写多个寄存器失败: %s", err)
+	}
+	if _, err := master.ReadHoldingRegisters(3, 1); err != ErrBroadcastRead {
+		t.Fatalf("广播读返回 %v", err)
+	}
+	master.SetSlaveID(1)
+	regs, err := master.ReadHoldingRegisters(3, 4)
+	if err != nil {
+		t.Fatalf("读寄存器失败: %s", err)
+	}
+	if regs[0] != 42 || regs[1] != 1004 || regs[2] != 7 || regs[3] != 8 {
+		t.Fatalf("寄存器值错误: %v", regs)
+	}
+}
+
+func TestPipelineCoalesceAndTimeout(t *testing.T) {
+	bus, uart := openPTY(t)
+	defer uart.Close()
+	startServer(t, bus, 1)
+
+	p := NewPipeline(uart)
+	p.SetSlaveTimeout(2, 20*time.Millisecond) // 从站 2 不存在
+	// 启动前排队：四个相邻读请求应合并为一个请求帧
+	calls := []*Call{
+		p.ReadHoldingRegisters(1, 10, 5),
+		p.ReadHoldingRegisters(1, 0, 10),
+		p.ReadHoldingRegisters(1, 15, 5),
+		p.ReadHoldingRegisters(1, 5, 8),
+	}
+	missing := p.ReadHoldingRegisters(2, 0, 1)
+	if err := p.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer p.Stop()
+
+	for _, c := range calls {
+		regs, err := c.Registers()
+		if err != nil {
+			t.Fatalf("读寄存器失败: %s", err)
+		}
+		for i, v := range regs {
+			if want := uint16(1000 + int(c.address) + i); v != want {
+				t.Fatalf("地址 %d 的值为 %d，期望 %d", int(c.address)+i, v, want)
+			}
+		}
+	}
+	if _, err := missing.Wait(); err != ErrTimeout {
+		t.Fatalf("期望超时，得到 %v", err)
+	}
+
+	// 合并范围越界时返回异常，各请求应改为单独发送
+	ok, bad := p.ReadHoldingRegisters(1, 100, 20), p.ReadHoldingRegisters(1, 120, 10)
+	if _, err := ok.Registers(); err != nil {
+		t.Fatalf("单独重试失败: %s", err)
+	}
+	var ex *Exception
+	if _, err := bad.Registers(); !errors.As(err, &ex) {
+		t.Fatalf("期望异常，得到 %v", err)
+	}
+
+	stats := p.Stats()
+	if stats.Coalesced < 3 || stats.Timeouts != 1 {
+		t.Fatalf("统计错误: %+v", stats)
+	}
+}
+
+func TestPipelineSubmitAfterStop(t *testing.T) {
+	_, uart := openPTY(t)
+	defer uart.Close()
+	p := NewPipeline(uart)
+	if err := p.Start(); err != nil {
+		t.Fatal(err)
+	}
+	p.Stop()
+	// 停止后提交的请求立即完成，不会一直等待
+	c := p.ReadHoldingRegisters(1, 0, 1)
+	select {
+	case <-c.Done():
+	case <-time.After(time.Second):
+		t.Fatal("停止后提交的请求没有完成")
+	}
+	if _, err := c.Wait(); err != ErrPipelineStopped {
+		t.Fatalf("期望 ErrPipelineStopped，得到 %v", err)
+	}
+	// 再次启动后恢复接受请求：没有从站，请求超时或在停止时完成
+	p.Start()
+	c = p.ReadHoldingRegisters(1, 0, 1)
+	p.Stop()
+	if _, err := c.Wait(); err != ErrTimeout && err != ErrPipelineStopped {
+		t.Fatalf("重新启动后的请求返回 %v", err)
+	}
+}
+
+func TestEventServerOverPTY(t *testing.T) {
+	// 角色互换：从站使用 serial 包的串口（epoll 就绪等待），主站使用 PTY 主端
+	bus, uart := openPTY(t)
+	defer bus.Close()
+	regs := NewRegisterMap(16, 16, 32, 32)
+	regs.SetInputFloats(0, []float64{1.5, -2.25})
+	server := NewServer(uart, 3)
+	server.SetHandler(regs)
+	if err := server.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer func() {
+		server.Stop()
+		uart.Close()
+	}()
+
+	master := NewMaster(bus)
+	master.SetSlaveID(3)
+	if err := master.WriteMultipleRegisters(4, []uint16{7, 8, 9}); err != nil {
+		t.Fatalf("写寄存器失败: %s", err)
+	}
+	if err := master.WriteSingleCoil(5, true); err != nil {
+		t.Fatalf("写线圈失败: %s", err)
+	}
+	values, err := master.ReadInputRegisters(0, 4)
+	if err != nil {
+		t.Fatalf("读输入寄存器失败: %s", err)
+	}
+	if values[0] != 0x3FC0 || values[1] != 0 || values[2] != 0xC010 || values[3] != 0 {
+		t.Fatalf("输入寄存器值错误: %04x", values)
+	}
+	coils, err := master.ReadCoils(4, 3)
+	if err != nil || coils[0] || !coils[1] || coils[2] {
+		t.Fatalf("线圈值错误: %v %v", coils, err)
+	}
+	holding := make([]uint16, 3)
+	regs.HoldingRegisters(4, holding)
+	if holding[0] != 7 || holding[1] != 8 || holding[2] != 9 {
+		t.Fatalf("保持寄存器值错误: %v", holding)
+	}
+	// 处理过请求后总线空闲：监听循环阻塞在就绪等待上，不占用 CPU
+	const idle = 300 * time.Millisecond
+	cpu := ptytest.CPUTime()
+	time.Sleep(idle)
+	if used := ptytest.CPUTime() - cpu; used > idle/4 {
+		t.Fatalf("空闲 %s 期间从站占用 CPU %s", idle, used)
+	}
+}
+
+func TestGatewayOverPTY(t *testing.T) {
+	bus, uart := openPTY(t)
+	defer uart.Close()
+	startServer(t, bus, 1)
+
+	gateway := NewGateway(uart)
+	gateway.Pipeline().SetSlaveTimeout(9, 20*time.Millisecond) // 从站 9 不存在
+	l := listenLocal(t)
+	go gateway.Serve(l)
+	defer gateway.Close()
+
+	// 多个 TCP 客户端共享同一条 RTU 总线
+	var wg sync.WaitGroup
+	for c := range 4 {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			master, err := NewTCPMaster(l.Addr().String())
+			if err != nil {
+				t.Error(err)
+				return
+			}
+			defer master.Close()
+			for i := range 10 {
+				address := uint16(c*10 + i)
+				regs, err := master.ReadHoldingRegisters(address, 2)
+				if err != nil || regs[0] != 1000+address || regs[1] != 1001+address {
+					t.Errorf("客户端 %d 读地址 %d: %v %v", c, address, regs, err)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+
+	master, err := NewTCPMaster(l.Addr().String())
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer master.Close()
+	master.SetSlaveID(9)
+	var ex *Exception
+	if _, err := master.ReadHoldingRegisters(0, 1); !errors.As(err, &ex) || ex.Code != ExceptionGatewayTargetDevice {
+		t.Fatalf("期望网关目标设备无响应异常，得到 %v", err)
+	}
+}
@@ -0,0 +1,398 @@
+package modbus
+
+import (
+	"math"
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// Table Modbus 数据表
+type Table uint8
+
+// 数据表常量
+const (
+	TableCoils            Table = iota // 线圈（可读写位）
+	TableDiscreteInputs                // 离散输入（只读位）
+	TableHoldingRegisters              // 保持寄存器（可读写 16 位）
+	TableInputRegisters                // 输入寄存器（只读 16 位）
+)
+
+// 预分配的异常，处理器在热路径上返回时不产生分配
+var (
+	errIllegalDataAddress = &Exception{Code: ExceptionIllegalDataAddress}
+	errIllegalFunction    = &Exception{Code: ExceptionIllegalFunction}
+)
+
+// BufferHandler 可选的零分配请求处理器接口
+// Server 的处理器实现该接口时，读请求直接写入响应缓冲区、写请求直接读取请求帧中的数据，
+// 不再经过 RequestHandler 的 []bool/[]uint16 中间切片。
+// 位数据按 Modbus 线上格式打包（每字节 8 位，低位在前），寄存器数据为大端字节序。
+type BufferHandler interface {
+	// ReadBits 读取 quantity 个位打包写入 dst，dst 长度为 (quantity+7)/8
+	ReadBits(table Table, address, quantity uint16, dst []byte) error
+	// ReadRegisters 读取 quantity 个寄存器写入 dst，dst 长度为 quantity*2
+	ReadRegisters(table Table, address, quantity uint16, dst []byte) error
+	// WriteBits 将 src 中打包的 quantity 个位写入线圈
+	WriteBits(address, quantity uint16, src []byte) error
+	// WriteRegisters 将 src 中的 quantity 个大端寄存器写入保持寄存器
+	WriteRegisters(address, quantity uint16, src []byte) error
+}
+
+// regTable 以 64 位字紧凑存储的数据表，由顺序锁（seqlock）保护
+// 读者无锁：读取前后序号相同且为偶数时数据一致，否则重试；
+// 写者之间由互斥锁串行化，写入期间序号为奇数。
+// 数据字均以原子操作访问，读者与写者并发时不存在数据竞争。
+type regTable struct {
+	seq   atomic.Uint32
+	wmu   sync.Mutex
+	words []atomic.Uint64
+	size  int // 位数或寄存器数
+}
+
+// newBitTable 创建位表，每个字存储 64 位
+func newBitTable(n int) regTable {
+	return regTable{words: make([]atomic.Uint64, (n+63)/64), size: n}
+}
+
+// newRegTable 创建寄存器表，每个字存储 4 个寄存器
+func newRegTable(n int) regTable {
+	return regTable{words: make([]atomic.Uint64, (n+3)/4), size: n}
+}
+
+// check 检查地址范围
+func (t *regTable) check(address, quantity uint16) error {
+	if int(address)+int(quantity) > t.size {
+		return errIllegalDataAddress
+	}
+	return nil
+}
+
+// readBegin 开始一次读取，等待进行中的写入完成并返回序号
+func (t *regTable) readBegin() uint32 {
+	for {
+		if s := t.seq.Load(); s&1 == 0 {
+			return s
+		}
+		runtime.Gosched()
+	}
+}
+
+// readRetry 判断读取期间是否发生了写入
+func (t *regTable) readRetry(s uint32) bool {
+	return t.seq.Load() != s
+}
+
+// writeBegin 开始一次写入
+func (t *regTable) writeBegin() {
+	t.wmu.Lock()
+	t.seq.Add(1)
+}
+
+// writeEnd 结束一次写入
+func (t *regTable) writeEnd() {
+	t.seq.Add(1)
+	t.wmu.Unlock()
+}
+
+// bit 读取第 i 位
+func (t *regTable) bit(i int) byte {
+	return byte(t.words[i>>6].Load() >> (i & 63) & 1)
+}
+
+// setBit 设置第 i 位（调用者处于写入区间）
+func (t *regTable) setBit(i int, v bool) {
+	w := &t.words[i>>6]
+	mask := uint64(1) << (i & 63)
+	if v {
+		w.Store(w.Load() | mask)
+	} else {
+		w.Store(w.Load() &^ mask)
+	}
+}
+
+// reg 读取第 i 个寄存器
+func (t *regTable) reg(i int) uint16 {
+	return uint16(t.words[i>>2].Load() >> ((i & 3) * 16))
+}
+
+// setReg 设置第 i 个寄存器（调用者处于写入区间）
+func (t *regTable) setReg(i int, v uint16) {
+	w := &t.words[i>>2]
+	shift := (i & 3) * 16
+	w.Store(w.Load()&^(0xFFFF<<shift) | uint64(v)<<shift)
+}
+
+// RegisterMap 紧凑存储、读者无锁的 Modbus 寄存器映射
+// 线圈与离散输入按位存储，寄存器每 4 个存储在一个 64 位字中；每张表独立的顺序锁保证
+// 一次请求读取到的多个寄存器（如由两个寄存器组成的 float32）来自同一次更新。
+// 仿真代码可以在 Server 服务请求的同时更新数据，例如在瞬态仿真回调中发布节点电压：
+//
+//	regs := modbus.NewRegisterMap(0, 0, 16, 2*nodes)
+//	server.SetHandler(regs)
+//	time.TransientSimulation(con, func(voltages []float64) {
+//	    regs.SetInputFloats(0, voltages)
+//	})
+//
+// RegisterMap 同时实现 RequestHandler 与 BufferHandler，Server 优先使用零分配的 BufferHandler。
+type RegisterMap struct {
+	coils    regTable
+	discrete regTable
+	holding  regTable
+	input    regTable
+}
+
+// NewRegisterMap 创建寄存器映射
+// 参数:
+//   - coils: 线圈数量
+//   - discreteInputs: 离散输入数量
+//   - holdingRegs: 保持寄存器数量
+//   - inputRegs: 输入寄存器数量
+func NewRegisterMap(coils, discreteInputs, holdingRegs, inputRegs int) *RegisterMap {
+	return &RegisterMap{
+		coils:    newBitTable(coils),
+		discrete: newBitTable(discreteInputs),
+		holding:  newRegTable(holdingRegs),
+		input:    newRegTable(inputRegs),
+	}
+}
+
+// table 返回数据表
+func (m *RegisterMap) table(table Table) *regTable {
+	switch table {
+	case TableCoils:
+		return &m.coils
+	case TableDiscreteInputs:
+		return &m.discrete
+	case TableHoldingRegisters:
+		return &m.holding
+	case TableInputRegisters:
+		return &m.input
+	}
+	return nil
+}
+
+// ReadBits 读取位表并按线上格式打包写入 dst
+func (m *RegisterMap) ReadBits(table Table, address, quantity uint16, dst []byte) error {
+	t := m.table(table)
+	if t == nil || table > TableDiscreteInputs {
+		return errIllegalFunction
+	}
+	if err := t.check(address, quantity); err != nil {
+		return err
+	}
+	dst = dst[:(int(quantity)+7)/8]
+	for {
+		s := t.readBegin()
+		clear(dst)
+		for i := 0; i < int(quantity); i++ {
+			dst[i>>3] |= t.bit(int(address)+i) << (i & 7)
+		}
+		if !t.readRetry(s) {
+			return nil
+		}
+	}
+}
+
+// ReadRegisters 读取寄存器表并以大端字节序写入 dst
+func (m *RegisterMap) ReadRegisters(table Table, address, quantity uint16, dst []byte) error {
+	t := m.table(table)
+	if t == nil || table < TableHoldingRegisters {
+		return errIllegalFunction
+	}
+	if err := t.check(address, quantity); err != nil {
+		return err
+	}
+	dst = dst[:int(quantity)*2]
+	for {
+		s := t.readBegin()
+		for i := 0; i < int(quantity); i++ {
+			v := t.reg(int(address) + i)
+			dst[2*i] = byte(v >> 8)
+			dst[2*i+1] = byte(v)
+		}
+		if !t.readRetry(s) {
+			return nil
+		}
+	}
+}
+
+// WriteBits 将打包的位数据写入线圈
+func (m *RegisterMap) WriteBits(address, quantity uint16, src []byte) error {
+	t := &m.coils
+	if err := t.check(address, quantity); err != nil {
+		return err
+	}
+	t.writeBegin()
+	for i := 0; i < int(quantity); i++ {
+		t.setBit(int(address)+i, src[i>>3]>>(i&7)&1 != 0)
+	}
+	t.writeEnd()
+	return nil
+}
+
+// WriteRegisters 将大端寄存器数据写入保持寄存器
+func (m *RegisterMap) WriteRegisters(address, quantity uint16, src []byte) error {
+	t := &m.holding
+	if err := t.check(address, quantity); err != nil {
+		return err
+	}
+	t.writeBegin()
+	for i := 0; i < int(quantity); i++ {
+		t.setReg(int(address)+i, uint16(src[2*i])<<8|uint16(src[2*i+1]))
+	}
+	t.writeEnd()
+	return nil
+}
+
+// setBits 写入位表
+func (t *regTable) setBits(address uint16, values []bool) error {
+	if err := t.check(address, uint16(len(values))); err != nil || len(values) > math.MaxUint16 {
+		return errIllegalDataAddress
+	}
+	t.writeBegin()
+	for i, v := range values {
+		t.setBit(int(address)+i, v)
+	}
+	t.writeEnd()
+	return nil
+}
+
+// setRegs 写入寄存器表
+func (t *regTable) setRegs(address uint16, values []uint16) error {
+	if err := t.check(address, uint16(len(values))); err != nil || len(values) > math.MaxUint16 {
+		return errIllegalDataAddress
+	}
+	t.writeBegin()
+	for i, v := range values {
+		t.setReg(int(address)+i, v)
+	}
+	t.writeEnd()
+	return nil
+}
+
+// getBits 一致地读取位表
+func (t *regTable) getBits(address uint16, dst []bool) error {
+	if err := t.check(address, uint16(len(dst))); err != nil || len(dst) > math.MaxUint16 {
+		return errIllegalDataAddress
+	}
+	for {
+		s := t.readBegin()
+		for i := range dst {
+			dst[i] = t.bit(int(address)+i) != 0
+		}
+		if !t.readRetry(s) {
+			return nil
+		}
+	}
+}
+
+// getRegs 一致地读取寄存器表
+func (t *regTable) getRegs(address uint16, dst []uint16) error {
+	if err := t.check(address, uint16(len(dst))); err != nil || len(dst) > math.MaxUint16 {
+		return errIllegalDataAddress
+	}
+	for {
+		s := t.readBegin()
+		for i := range dst {
+			dst[i] = t.reg(int(address) + i)
+		}
+		if !t.readRetry(s) {
+			return nil
+		}
+	}
+}
+
+// SetCoils 设置线圈
+func (m *RegisterMap) SetCoils(address uint16, values []bool) error {
+	return m.coils.setBits(address, values)
+}
+
+// SetDiscreteInputs 设置离散输入
+func (m *RegisterMap) SetDiscreteInputs(address uint16, values []bool) error {
+	return m.discrete.setBits(address, values)
+}
+
+// SetHoldingRegisters 设置保持寄存器
+func (m *RegisterMap) SetHoldingRegisters(address uint16, values []uint16) error {
+	return m.holding.setRegs(address, values)
+}
+
+// SetInputRegisters 设置输入寄存器
+func (m *RegisterMap) SetInputRegisters(address uint16, values []uint16) error {
+	return m.input.setRegs(address, values)
+}
+
+// SetInputFloats 以 IEEE 754 单精度格式将 values 写入输入寄存器，不分配内存
+// 每个值占两个寄存器，高 16 位在前（大端字序），所有值在同一次更新中可见。
+// 参数:
+//   - address: 起始输入寄存器地址
+//   - values: 浮点值，如瞬态仿真回调中的节点电压
+func (m *RegisterMap) SetInputFloats(address uint16, values []float64) error {
+	t := &m.input
+	if int(address)+2*len(values) > t.size {
+		return errIllegalDataAddress
+	}
+	t.writeBegin()
+	for i, v := range values {
+		bits := math.Float32bits(float32(v))
+		t.setReg(int(address)+2*i, uint16(bits>>16))
+		t.setReg(int(address)+2*i+1, uint16(bits))
+	}
+	t.writeEnd()
+	return nil
+}
+
+// Coils 读取线圈到 dst
+func (m *RegisterMap) Coils(address uint16, dst []bool) error {
+	return m.coils.getBits(address, dst)
+}
+
+// HoldingRegisters 读取保持寄存器到 dst，用于仿真代码获取主站写入的设定值
+func (m *RegisterMap) HoldingRegisters(address uint16, dst []uint16) error {
+	return m.holding.getRegs(address, dst)
+}
+
+// HandleReadCoils 处理读线圈请求
+func (m *RegisterMap) HandleReadCoils(address, quantity uint16) ([]bool, error) {
+	result := make([]bool, quantity)
+	return result, m.coils.getBits(address, result)
+}
+
+// HandleReadDiscreteInputs 处理读离散输入请求
+func (m *RegisterMap) HandleReadDiscreteInputs(address, quantity uint16) ([]bool, error) {
+	result := make([]bool, quantity)
+	return result, m.discrete.getBits(address, result)
+}
+
+// HandleReadHoldingRegisters 处理读保持寄存器请求
+func (m *RegisterMap) HandleReadHoldingRegisters(address, quantity uint16) ([]uint16, error) {
+	result := make([]uint16, quantity)
+	return result, m.holding.getRegs(address, result)
+}
+
+// HandleReadInputRegisters 处理读输入寄存器请求
+func (m *RegisterMap) HandleReadInputRegisters(address, quantity uint16) ([]uint16, error) {
+	result := make([]uint16, quantity)
+	return result, m.input.getRegs(address, result)
+}
+
+// HandleWriteSingleCoil 处理写单个线圈请求
+func (m *RegisterMap) HandleWriteSingleCoil(address uint16, value bool) error {
+	return m.coils.setBits(address, []bool{value})
+}
+
+// HandleWriteSingleRegister 处理写单个寄存器请求
+func (m *RegisterMap) HandleWriteSingleRegister(address uint16, value uint16) error {
+	return m.holding.setRegs(address, []uint16{value})
+}
+
+// HandleWriteMultipleCoils 处理写多个线圈请求
+func (m *RegisterMap) HandleWriteMultipleCoils(address uint16, values []bool) error {
+	return m.coils.setBits(address, values)
+}
+
+// HandleWriteMultipleRegisters 处理写多个寄存器请求
+func (m *RegisterMap) HandleWriteMultipleRegisters(address uint16, values []uint16) error {
+	return m.holding.setRegs(address, values)
+}
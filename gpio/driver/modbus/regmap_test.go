@@ -0,0 +1,88 @@
+package modbus
+
+import (
+	"circuit/gpio/driver"
+	"math"
+	"sync"
+	"testing"
+)
+
+// discardUART 丢弃写入数据的 UART，用于测量服务器处理开销。
+type discardUART struct{ frames int }
+
+func (u *discardUART) Close() error                               { return nil }
+func (u *discardUART) Init(int, uint8, uint8, uint8, uint8) error { return nil }
+func (u *discardUART) GetConfig() (*driver.UARTConfig, error) {
+	return &driver.UARTConfig{BaudRate: 115200}, nil
+}
+func (u *discardUART) Read(int) ([]byte, error) { return nil, nil }
+func (u *discardUART) Write([]byte) error       { u.frames++; return nil }
+
+// rtuFrame 为 PDU 加上地址与 CRC。
+func rtuFrame(id byte, pdu ...byte) []byte {
+	frame := append([]byte{id}, pdu...)
+	crc := CRC16(frame)
+	return append(frame, byte(crc), byte(crc>>8))
+}
+
+func TestServerZeroAlloc(t *testing.T) {
+	uart := &discardUART{}
+	server := NewServer(uart, 1)
+	frames := [][]byte{
+		rtuFrame(1, FuncCodeReadHoldingRegisters, 0, 0, 0, 100),
+		rtuFrame(1, FuncCodeReadCoils, 0, 3, 0, 200),
+		rtuFrame(1, FuncCodeWriteSingleCoil, 0, 7, 0xFF, 0),
+		rtuFrame(1, FuncCodeWriteMultipleRegisters, 0, 2, 0, 2, 4, 1, 2, 3, 4),
+	}
+	for _, frame := range frames {
+		if allocs := testing.AllocsPerRun(100, func() { server.processFrame(frame) }); allocs != 0 {
+			t.Fatalf("功能码 %#02x 每次请求分配 %v 次", frame[1], allocs)
+		}
+	}
+	if uart.frames == 0 {
+		t.Fatal("没有发送任何响应")
+	}
+}
+
+func TestRegisterMapSeqlock(t *testing.T) {
+	// 写者成对写入 (v, -v)，读者读取到的每一对必须一致
+	m := NewRegisterMap(0, 0, 0, 4)
+	var wg sync.WaitGroup
+	stop := make(chan struct{})
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		values := make([]float64, 2)
+		for i := 0; ; i++ {
+			select {
+			case <-stop:
+				return
+			default:
+			}
+			values[0], values[1] = float64(i), -float64(i)
+			m.SetInputFloats(0, values)
+		}
+	}()
+	defer func() {
+		close(stop)
+		wg.Wait()
+	}()
+	dst := make([]byte, 8)
+	for range 10000 {
+		m.ReadRegisters(TableInputRegisters, 0, 4, dst)
+		a := math.Float32frombits(uint32(dst[0])<<24 | uint32(dst[1])<<16 | uint32(dst[2])<<8 | uint32(dst[3]))
+		b := math.Float32frombits(uint32(dst[4])<<24 | uint32(dst[5])<<16 | uint32(dst[6])<<8 | uint32(dst[7]))
+		if a != -b {
+			t.Fatalf("读取到不一致的数据: %v %v", a, b)
+		}
+	}
+}
+
+func BenchmarkServerReadHolding(b *testing.B) {
+	server := NewServer(&discardUART{}, 1)
+	frame := rtuFrame(1, FuncCodeReadHoldingRegisters, 0, 0, 0, 100)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		server.processFrame(frame)
+	}
+}
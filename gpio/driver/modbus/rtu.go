@@ -0,0 +1,269 @@
+package modbus
+
+import (
+	"circuit/gpio/driver"
+	"errors"
+	"io"
+	"time"
+)
+
+// rtuMaxFrame RTU 帧的最大长度（地址 + 253 字节 PDU + CRC）。
+const rtuMaxFrame = 256
+
+// ErrTimeout 在超时时间内未收到响应时返回。
+var ErrTimeout = errors.New("modbus: response timeout")
+
+// FrameTiming RTU 帧时序参数
+// Modbus RTU 以 3.5 个字符时间的总线静默作为帧边界，
+// 波特率高于 19200 时规范规定使用固定的 1.75ms。
+type FrameTiming struct {
+	Char    time.Duration // 单个字符（起始位 + 数据位 + 校验位 + 停止位）的传输时间
+	Silence time.Duration // 帧间静默时间 t3.5
+}
+
+// NewFrameTiming 根据 UART 配置计算 RTU 帧时序
+// 参数:
+//   - cfg: UART 配置，为 nil 或波特率为 0 时按 9600 8N1 计算
+//
+// 返回值:
+//   - FrameTiming: 字符时间与帧间静默时间
+func NewFrameTiming(cfg *driver.UARTConfig) FrameTiming {
+	baud, bits := uint32(9600), 10
+	if cfg != nil && cfg.BaudRate > 0 {
+		baud = cfg.BaudRate
+		bits = 2 + int(cfg.ByteSize) // 起始位 + 数据位 + 1 个停止位
+		if cfg.ByteSize == 0 {
+			bits = 10
+		}
+		if cfg.Parity != 0 {
+			bits++
+		}
+		if cfg.StopBits == 2 {
+			bits++
+		}
+	}
+	t := FrameTiming{Char: time.Duration(bits) * time.Second / time.Duration(baud)}
+	if baud > 19200 {
+		t.Silence = 1750 * time.Microsecond
+	} else {
+		t.Silence = t.Char * 7 / 2
+	}
+	return t
+}
+
+// TxTime 返回 n 个字节在总线上的传输时间
+func (t FrameTiming) TxTime(n int) time.Duration {
+	return time.Duration(n) * t.Char
+}
+
+// expectedLength 根据已收到的响应头部计算完整 RTU 帧长度
+// 返回值:
+//   - >0: 完整帧长度（含地址与 CRC）
+//   - 0: 头部尚不完整，需要继续接收
+//   - -1: 未知功能码，只能依靠帧间静默判断帧结束
+func expectedLength(frame []byte) int {
+	if len(frame) < 2 {
+		return 0
+	}
+	fc := frame[1]
+	if fc&0x80 != 0 {
+		return 5 // 地址 + 功能码 + 异常码 + CRC
+	}
+	switch fc {
+	case FuncCodeReadCoils, FuncCodeReadDiscreteInputs,
+		FuncCodeReadHoldingRegisters, FuncCodeReadInputRegisters:
+		if len(frame) < 3 {
+			return 0
+		}
+		return 5 + int(frame[2]) // 地址 + 功能码 + 字节数 + 数据 + CRC
+	case FuncCodeWriteSingleCoil, FuncCodeWriteSingleRegister,
+		FuncCodeWriteMultipleCoils, FuncCodeWriteMultipleRegisters:
+		return 8
+	}
+	return -1
+}
+
+// rtuReader RTU 响应帧接收器
+// 按功能码解析出的期望长度判断帧结束，无法确定长度时以 t3.5 静默作为帧边界，
+// 接收缓冲区在多次请求间复用。
+type rtuReader struct {
+	uart    driver.UART
+	timing  FrameTiming
+	buf     [rtuMaxFrame]byte // 接收缓冲区
+	tx      [rtuMaxFrame]byte // 发送缓冲区
+	lastRx  time.Time         // 最后一次收到字节的时间，用于保证下一帧发送前的静默间隔
+	timeSet bool              // timing 是否已初始化
+}
+
+// init 首次使用时根据 UART 配置计算帧时序
+func (r *rtuReader) init() {
+	if r.timeSet {
+		return
+	}
+	cfg, err := r.uart.GetConfig()
+	if err != nil {
+		cfg = nil
+	}
+	r.timing = NewFrameTiming(cfg)
+	r.timeSet = true
+}
+
+// waitSilence 等待距最后一次收发满足 t3.5 帧间静默
+func (r *rtuReader) waitSilence() {
+	if r.lastRx.IsZero() {
+		return
+	}
+	if d := r.timing.Silence - time.Since(r.lastRx); d > 0 {
+		time.Sleep(d)
+	}
+}
+
+// writeFrame 发送 RTU 帧并返回帧在总线上传输完毕的预计时间
+func (r *rtuReader) writeFrame(frame []byte) (time.Time, error) {
+	r.waitSilence()
+	if err := r.uart.Write(frame); err != nil {
+		return time.Time{}, err
+	}
+	done := time.Now().Add(r.timing.TxTime(len(frame)))
+	r.lastRx = done
+	return done, nil
+}
+
+// roundTrip 发送 RTU 请求并接收响应 PDU
+// 处理流程:
+//  1. 构建 RTU 帧: 从站地址 + PDU + CRC
+//  2. 等待帧间静默后发送帧到串口
+//  3. 按功能码解析期望长度接收响应，未知功能码以 t3.5 静默判断帧结束
+//  4. 验证响应格式、CRC 和从站地址
+//
+// 广播请求（slaveID 为 0）发送后等待 timeout 并返回 nil 响应。
+func (r *rtuReader) roundTrip(slaveID uint8, pdu []byte, timeout time.Duration) ([]byte, error) {
+	if len(pdu) == 0 || len(pdu) > rtuMaxFrame-3 {
+		return nil, errors.New("modbus: invalid PDU length")
+	}
+	frame := r.tx[:1+len(pdu)+2]
+	frame[0] = slaveID
+	copy(frame[1:], pdu)
+	crc := calculateCRC(frame[:len(frame)-2])
+	frame[len(frame)-2] = byte(crc & 0xFF)
+	frame[len(frame)-1] = byte(crc >> 8)
+
+	r.init()
+	sent, err := r.writeFrame(frame)
+	if err != nil {
+		return nil, err
+	}
+	if slaveID == 0 {
+		// 广播没有响应，等待从站处理完毕
+		time.Sleep(time.Until(sent.Add(timeout)))
+		return nil, nil
+	}
+	resp, err := r.readResponse(slaveID, sent.Add(timeout))
+	if err != nil {
+		return nil, err
+	}
+	// 返回 PDU (去掉从站地址和 CRC)
+	return resp[1 : len(resp)-2], nil
+}
+
+// close RTU 传输不拥有 UART，关闭时不做任何操作
+func (r *rtuReader) close() error {
+	return nil
+}
+
+// readResponse 接收从站 slaveID 的响应帧
+// 参数:
+//   - slaveID: 期望的从站地址
+//   - deadline: 接收截止时间
+//
+// 返回值:
+//   - []byte: 完整响应帧（含地址与 CRC），指向内部缓冲区，下次接收前有效
+//   - error: 超时、地址不匹配、CRC 错误或底层读取错误
+func (r *rtuReader) readResponse(slaveID uint8, deadline time.Time) ([]byte, error) {
+	n := 0
+	var last time.Time
+	// 帧尾两字节之前的数据在到达时增量计算 CRC，帧结束后只需补算剩余部分
+	crc, crcN := uint16(0xFFFF), 0
+	for {
+		need := expectedLength(r.buf[:n])
+		if need > rtuMaxFrame {
+			return nil, errors.New("modbus: invalid response length")
+		}
+		if need > 0 && n >= need {
+			return r.checkFrame(slaveID, r.buf[:need], r.frameCRC(crc, crcN, need))
+		}
+		now := time.Now()
+		// 未知功能码：以 t3.5 静默或缓冲区满作为帧结束
+		if need < 0 && (n == len(r.buf) || now.Sub(last) >= r.timing.Silence) {
+			if n < 5 {
+				return nil, errors.New("modbus: response too short")
+			}
+			return r.checkFrame(slaveID, r.buf[:n], r.frameCRC(crc, crcN, n))
+		}
+		if now.After(deadline) {
+			if n == 0 {
+				return nil, ErrTimeout
+			}
+			return nil, errors.New("modbus: incomplete response")
+		}
+
+		want := len(r.buf) - n
+		if need > 0 {
+			want = need - n
+		}
+		chunk, err := r.uart.Read(want)
+		if err != nil && err != io.EOF {
+			return nil, err
+		}
+		if len(chunk) > 0 {
+			n += copy(r.buf[n:], chunk)
+			if n-2 > crcN {
+				crc = UpdateCRC(crc, r.buf[crcN:n-2])
+				crcN = n - 2
+			}
+			last = time.Now()
+			r.lastRx = last
+			continue
+		}
+		// 非阻塞设备没有数据时让出一个字符时间，避免空转
+		time.Sleep(r.timing.Char)
+	}
+}
+
+// frameCRC 补算长度为 size 的帧在 CRC 两字节之前的剩余数据
+// 参数crc: 前 crcN 个字节的增量 CRC；单次读取超出帧长时 crcN 可能越过帧尾，此时重新计算。
+func (r *rtuReader) frameCRC(crc uint16, crcN, size int) uint16 {
+	if crcN > size-2 {
+		return CRC16(r.buf[:size-2])
+	}
+	return UpdateCRC(crc, r.buf[crcN:size-2])
+}
+
+// checkFrame 校验响应帧的长度、从站地址与 CRC
+// 参数crc: 帧中除 CRC 两字节外全部数据的 CRC。
+func (r *rtuReader) checkFrame(slaveID uint8, frame []byte, crc uint16) ([]byte, error) {
+	if len(frame) < 5 {
+		return nil, errors.New("modbus: response too short")
+	}
+	if frame[0] != slaveID {
+		return nil, errors.New("modbus: slave ID mismatch")
+	}
+	receivedCRC := uint16(frame[len(frame)-2]) | uint16(frame[len(frame)-1])<<8
+	if receivedCRC != crc {
+		return nil, errors.New("modbus: CRC error")
+	}
+	return frame, nil
+}
+
+// drain 丢弃总线上残留的字节（超时后迟到的响应或损坏的帧），
+// 直到一次读取没有数据或超过 limit。
+func (r *rtuReader) drain(limit time.Duration) {
+	end := time.Now().Add(limit)
+	for time.Now().Before(end) {
+		chunk, err := r.uart.Read(len(r.buf))
+		if (err != nil && err != io.EOF) || len(chunk) == 0 {
+			return
+		}
+		r.lastRx = time.Now()
+	}
+}
@@ -42,6 +42,7 @@ package modbus
 import (
 	"circuit/gpio/driver"
 	"errors"
+	"io"
 	"sync"
 	"time"
 )
@@ -61,6 +62,17 @@ type Server struct {
 	discreteInputs   []bool         // 内部离散输入存储（如果使用默认处理器）
 	holdingRegisters []uint16       // 内部保持寄存器存储（如果使用默认处理器）
 	inputRegisters   []uint16       // 内部输入寄存器存储（如果使用默认处理器）
+	timing           FrameTiming    // RTU 帧时序，Start 时根据 UART 配置计算
+	rx               [rtuMaxFrame]byte
+	tx               [rtuMaxFrame]byte
+	tcp              tcpConns // Modbus TCP 监听器与连接
+}
+
+// eventUART 支持就绪等待并读入调用者缓冲区的 UART（如 serial 包基于 epoll 的实现）
+// Server 检测到 UART 实现该接口时阻塞等待可读事件，而不是轮询 Read。
+type eventUART interface {
+	WaitReadable(timeout time.Duration) (bool, error)
+	ReadInto(buf []byte) (int, error)
 }
 
 // RequestHandler 定义请求处理器接口
@@ -218,13 +230,14 @@ const (
 )
 
 // NewServer 创建一个新的 Modbus 服务器
+// 默认处理器为 2000 线圈、2000 离散输入、125 保持寄存器、125 输入寄存器的 RegisterMap
 func NewServer(uart driver.UART, slaveID uint8) *Server {
 	return &Server{
 		uart:     uart,
 		slaveID:  slaveID,
 		timeout:  100 * time.Millisecond,
 		stopChan: make(chan struct{}),
-		handler:  NewDefaultHandler(2000, 2000, 125, 125),
+		handler:  NewRegisterMap(2000, 2000, 125, 125),
 	}
 }
 
@@ -249,15 +262,25 @@ func (s *Server) Start() error {
 		s.mu.Unlock()
 		return errors.New("server already running")
 	}
+	if s.uart == nil {
+		s.mu.Unlock()
+		return errors.New("server has no UART, use ServeTCP")
+	}
 	s.running = true
+	cfg, err := s.uart.GetConfig()
+	if err != nil {
+		cfg = nil
+	}
+	s.timing = NewFrameTiming(cfg)
 	s.mu.Unlock()
 
 	go s.listenLoop()
 	return nil
 }
 
-// Stop 停止服务器
+// Stop 停止服务器，同时关闭 ServeTCP 的监听器与连接
 func (s *Server) Stop() {
+	s.tcp.closeAll()
 	s.mu.Lock()
 	defer s.mu.Unlock()
 	if !s.running {
@@ -268,29 +291,99 @@ func (s *Server) Stop() {
 }
 
 // listenLoop 监听循环，处理接收到的请求
+// 接收的数据在复用的缓冲区中按请求的期望长度组帧，无法确定长度时以 t3.5 静默作为帧边界。
 func (s *Server) listenLoop() {
+	ev, _ := s.uart.(eventUART)
+	s.mu.RLock()
+	idle := s.timeout
+	s.mu.RUnlock()
+	n := 0
+	var last time.Time
 	for {
 		select {
 		case <-s.stopChan:
 			return
 		default:
-			// 读取数据
-			data, err := s.uart.Read(256)
-			if err != nil {
-				continue
+		}
+
+		// 空闲时等待较长时间以便检查停止信号，帧接收中只等待到静默超时
+		wait := idle
+		if n > 0 {
+			wait = s.timing.Silence - time.Since(last)
+		}
+		k, err := s.receive(ev, s.rx[n:], wait)
+		if err != nil && err != io.EOF {
+			time.Sleep(idle / 10)
+			continue
+		}
+		if k > 0 {
+			n += k
+			last = time.Now()
+			for n > 0 {
+				need := requestLength(s.rx[:n])
+				if need <= 0 || need > n {
+					break
+				}
+				s.processFrame(s.rx[:need])
+				n = copy(s.rx[:], s.rx[need:n])
 			}
-			if len(data) == 0 {
-				time.Sleep(s.timeout / 10)
+			if n < len(s.rx) {
 				continue
 			}
+		} else if n == 0 || time.Since(last) < s.timing.Silence {
+			continue
+		}
 
-			// 处理接收到的数据
-			s.processFrame(data)
+		// 静默超时或缓冲区已满：未知长度的帧在此结束，不完整的帧丢弃
+		if requestLength(s.rx[:n]) < 0 {
+			s.processFrame(s.rx[:n])
 		}
+		n = 0
 	}
 }
 
+// receive 等待并读取数据到 buf，超时返回 0
+func (s *Server) receive(ev eventUART, buf []byte, wait time.Duration) (int, error) {
+	if wait < 0 {
+		wait = 0
+	}
+	if ev != nil {
+		ready, err := ev.WaitReadable(wait)
+		if err != nil || !ready {
+			return 0, err
+		}
+		return ev.ReadInto(buf)
+	}
+	data, err := s.uart.Read(len(buf))
+	if len(data) == 0 {
+		// 普通 UART 没有就绪通知，空读后休眠（接收帧时只休眠一个字符时间）
+		time.Sleep(min(wait, s.timeout/10))
+	}
+	return copy(buf, data), err
+}
+
+// requestLength 根据已收到的请求头部计算完整 RTU 请求帧长度
+// 返回值含义与 expectedLength 相同：>0 为帧长度，0 为需要更多数据，-1 为未知功能码。
+func requestLength(frame []byte) int {
+	if len(frame) < 2 {
+		return 0
+	}
+	switch frame[1] {
+	case FuncCodeReadCoils, FuncCodeReadDiscreteInputs,
+		FuncCodeReadHoldingRegisters, FuncCodeReadInputRegisters,
+		FuncCodeWriteSingleCoil, FuncCodeWriteSingleRegister:
+		return 8 // 地址 + 功能码 + 4 字节参数 + CRC
+	case FuncCodeWriteMultipleCoils, FuncCodeWriteMultipleRegisters:
+		if len(frame) < 7 {
+			return 0
+		}
+		return 9 + int(frame[6]) // 地址 + 功能码 + 地址/数量 + 字节数 + 数据 + CRC
+	}
+	return -1
+}
+
 // processFrame 处理接收到的 Modbus 帧
+// 处理器实现 BufferHandler 时响应直接构建在复用的发送缓冲区中，不产生分配。
 func (s *Server) processFrame(frame []byte) {
 	if len(frame) < 5 {
 		return // 帧太短
@@ -315,21 +408,125 @@ func (s *Server) processFrame(frame []byte) {
 	}
 
 	// 处理请求并生成响应
-	responsePDU := s.handleRequest(pdu)
-	if responsePDU == nil {
+	n := s.processPDU(pdu, s.tx[1:len(s.tx)-2])
+	if n == 0 || frame[0] == 0 {
 		return // 不需要响应（广播）
 	}
 
 	// 构建响应帧
-	responseFrame := make([]byte, 1+len(responsePDU)+2)
-	responseFrame[0] = s.slaveID
-	copy(responseFrame[1:], responsePDU)
-	crc := calculateCRC(responseFrame[:len(responseFrame)-2])
-	responseFrame[len(responseFrame)-2] = byte(crc & 0xFF)
-	responseFrame[len(responseFrame)-1] = byte(crc >> 8)
+	s.tx[0] = s.slaveID
+	crc := calculateCRC(s.tx[:1+n])
+	s.tx[1+n] = byte(crc & 0xFF)
+	s.tx[2+n] = byte(crc >> 8)
 
 	// 发送响应
-	s.uart.Write(responseFrame)
+	s.uart.Write(s.tx[:3+n])
+}
+
+// processPDU 处理请求 PDU，响应 PDU 写入 out，返回响应长度
+// 处理器实现 BufferHandler 时不产生分配。
+func (s *Server) processPDU(pdu, out []byte) int {
+	s.mu.RLock()
+	handler := s.handler
+	s.mu.RUnlock()
+	if bh, ok := handler.(BufferHandler); ok {
+		return handleBuffered(bh, pdu, out)
+	}
+	return copy(out, s.handleRequest(pdu))
+}
+
+// handleBuffered 使用 BufferHandler 处理请求，响应 PDU 写入 out，返回响应长度
+func handleBuffered(h BufferHandler, pdu, out []byte) int {
+	fc := pdu[0]
+	exception := func(code byte) int {
+		out[0], out[1] = fc|0x80, code
+		return 2
+	}
+	var err error
+	n := 0
+	switch fc {
+	case FuncCodeReadCoils, FuncCodeReadDiscreteInputs,
+		FuncCodeReadHoldingRegisters, FuncCodeReadInputRegisters:
+		if len(pdu) != 5 {
+			return exception(ExceptionIllegalDataValue)
+		}
+		address := uint16(pdu[1])<<8 | uint16(pdu[2])
+		quantity := uint16(pdu[3])<<8 | uint16(pdu[4])
+		if fc <= FuncCodeReadDiscreteInputs {
+			if quantity < 1 || quantity > 2000 {
+				return exception(ExceptionIllegalDataValue)
+			}
+			table := TableCoils
+			if fc == FuncCodeReadDiscreteInputs {
+				table = TableDiscreteInputs
+			}
+			n = 2 + (int(quantity)+7)/8
+			err = h.ReadBits(table, address, quantity, out[2:n])
+		} else {
+			if quantity < 1 || quantity > 125 {
+				return exception(ExceptionIllegalDataValue)
+			}
+			table := TableHoldingRegisters
+			if fc == FuncCodeReadInputRegisters {
+				table = TableInputRegisters
+			}
+			n = 2 + int(quantity)*2
+			err = h.ReadRegisters(table, address, quantity, out[2:n])
+		}
+		out[0], out[1] = fc, byte(n-2)
+	case FuncCodeWriteSingleCoil:
+		if len(pdu) != 5 {
+			return exception(ExceptionIllegalDataValue)
+		}
+		address := uint16(pdu[1])<<8 | uint16(pdu[2])
+		// 回显请求，并借用响应之后的一个字节存放打包的线圈值
+		n = copy(out, pdu)
+		out[n] = 0
+		if pdu[3] == 0xFF && pdu[4] == 0x00 {
+			out[n] = 1
+		}
+		err = h.WriteBits(address, 1, out[n:n+1])
+	case FuncCodeWriteSingleRegister:
+		if len(pdu) != 5 {
+			return exception(ExceptionIllegalDataValue)
+		}
+		address := uint16(pdu[1])<<8 | uint16(pdu[2])
+		err = h.WriteRegisters(address, 1, pdu[3:5])
+		n = copy(out, pdu)
+	case FuncCodeWriteMultipleCoils, FuncCodeWriteMultipleRegisters:
+		if len(pdu) < 6 {
+			return exception(ExceptionIllegalDataValue)
+		}
+		address := uint16(pdu[1])<<8 | uint16(pdu[2])
+		quantity := uint16(pdu[3])<<8 | uint16(pdu[4])
+		byteCount := int(pdu[5])
+		if len(pdu) < 6+byteCount {
+			return exception(ExceptionIllegalDataValue)
+		}
+		if fc == FuncCodeWriteMultipleCoils {
+			if quantity < 1 || quantity > 1968 || byteCount < (int(quantity)+7)/8 {
+				return exception(ExceptionIllegalDataValue)
+			}
+			err = h.WriteBits(address, quantity, pdu[6:6+byteCount])
+		} else {
+			if quantity < 1 || quantity > 123 || byteCount != int(quantity)*2 {
+				return exception(ExceptionIllegalDataValue)
+			}
+			err = h.WriteRegisters(address, quantity, pdu[6:6+byteCount])
+		}
+		// 返回地址和数量
+		n = copy(out, pdu[:5])
+	default:
+		// 非法功能码
+		return exception(ExceptionIllegalFunction)
+	}
+	if err != nil {
+		if e, ok := err.(*Exception); ok {
+			return exception(e.Code)
+		}
+		return exception(ExceptionServerDeviceFailure)
+	}
+	return n
 }
 
 // handleRequest 处理 Modbus 请求并返回响应 PDU
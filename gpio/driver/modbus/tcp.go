@@ -0,0 +1,324 @@
+package modbus
+
+import (
+	"circuit/gpio/driver"
+	"encoding/binary"
+	"errors"
+	"io"
+	"net"
+	"sync"
+	"time"
+)
+
+// Modbus TCP (MBAP) 帧格式常量
+const (
+	mbapHeaderLength = 7                            // 事务标识符(2) + 协议标识符(2) + 长度(2) + 单元标识符(1)
+	tcpMaxPDU        = 253                          // 最大 PDU 长度
+	tcpMaxADU        = mbapHeaderLength + tcpMaxPDU // 最大 TCP 帧长度
+	DefaultTCPPort   = "502"                        // Modbus TCP 默认端口
+)
+
+// putMBAP 在 buf 开头写入 MBAP 报文头
+func putMBAP(buf []byte, txn uint16, unit uint8, pduLength int) {
+	binary.BigEndian.PutUint16(buf[0:], txn)
+	binary.BigEndian.PutUint16(buf[2:], 0) // 协议标识符: 0 = Modbus
+	binary.BigEndian.PutUint16(buf[4:], uint16(pduLength+1))
+	buf[6] = unit
+}
+
+// readMBAP 从 r 读取一个完整的 MBAP 帧到 buf
+// 返回值:
+//   - txn: 事务标识符
+//   - unit: 单元标识符
+//   - pdu: 帧中的 PDU，指向 buf
+//   - err: 读取错误或帧格式错误
+func readMBAP(r io.Reader, buf []byte) (txn uint16, unit uint8, pdu []byte, err error) {
+	if _, err = io.ReadFull(r, buf[:mbapHeaderLength]); err != nil {
+		return
+	}
+	txn = binary.BigEndian.Uint16(buf[0:])
+	length := int(binary.BigEndian.Uint16(buf[4:]))
+	if binary.BigEndian.Uint16(buf[2:]) != 0 || length < 2 || length > tcpMaxPDU+1 {
+		err = errors.New("modbus: invalid MBAP header")
+		return
+	}
+	unit = buf[6]
+	n := mbapHeaderLength + length - 1
+	if _, err = io.ReadFull(r, buf[mbapHeaderLength:n]); err != nil {
+		return
+	}
+	pdu = buf[mbapHeaderLength:n]
+	return
+}
+
+// tcpTransport Modbus TCP 主站传输
+type tcpTransport struct {
+	conn net.Conn
+	txn  uint16
+	buf  [tcpMaxADU]byte
+}
+
+// NewTCPMaster 连接 Modbus TCP 服务器并创建主站
+// 参数:
+//   - address: 服务器地址，如 "192.168.1.10:502"，省略端口时使用 502
+//
+// 返回值:
+//   - *Master: 使用 TCP 传输的主站，读写方法与 RTU 主站相同，SetSlaveID 设置单元标识符
+//   - error: 连接失败
+//
+// 注意: 使用完毕后调用 Close 关闭连接
+func NewTCPMaster(address string) (*Master, error) {
+	if _, _, err := net.SplitHostPort(address); err != nil {
+		address = net.JoinHostPort(address, DefaultTCPPort)
+	}
+	conn, err := net.Dial("tcp", address)
+	if err != nil {
+		return nil, err
+	}
+	return &Master{
+		transport: &tcpTransport{conn: conn},
+		slaveID:   1,
+		timeout:   time.Second,
+	}, nil
+}
+
+// roundTrip 发送 MBAP 请求并接收事务标识符匹配的响应
+// 之前超时请求的迟到响应会因事务标识符不匹配而被丢弃。
+func (t *tcpTransport) roundTrip(slaveID uint8, pdu []byte, timeout time.Duration) ([]byte, error) {
+	if len(pdu) == 0 || len(pdu) > tcpMaxPDU {
+		return nil, errors.New("modbus: invalid PDU length")
+	}
+	t.txn++
+	putMBAP(t.buf[:], t.txn, slaveID, len(pdu))
+	n := mbapHeaderLength + copy(t.buf[mbapHeaderLength:], pdu)
+	if err := t.conn.SetDeadline(time.Now().Add(timeout)); err != nil {
+		return nil, err
+	}
+	if _, err := t.conn.Write(t.buf[:n]); err != nil {
+		return nil, err
+	}
+	for {
+		txn, unit, resp, err := readMBAP(t.conn, t.buf[:])
+		if err != nil {
+			var ne net.Error
+			if errors.As(err, &ne) && ne.Timeout() {
+				return nil, ErrTimeout
+			}
+			return nil, err
+		}
+		if txn != t.txn {
+			continue
+		}
+		if unit != slaveID {
+			return nil, errors.New("modbus: slave ID mismatch")
+		}
+		return resp, nil
+	}
+}
+
+// close 关闭 TCP 连接
+func (t *tcpTransport) close() error {
+	return t.conn.Close()
+}
+
+// tcpConns 记录服务中的监听器与连接，用于统一关闭
+type tcpConns struct {
+	mu        sync.Mutex
+	listeners map[net.Listener]struct{}
+	conns     map[net.Conn]struct{}
+	wg        sync.WaitGroup
+}
+
+// addListener 记录监听器
+func (c *tcpConns) addListener(l net.Listener) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.listeners == nil {
+		c.listeners = make(map[net.Listener]struct{})
+	}
+	c.listeners[l] = struct{}{}
+}
+
+// addConn 记录连接
+func (c *tcpConns) addConn(conn net.Conn) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.conns == nil {
+		c.conns = make(map[net.Conn]struct{})
+	}
+	c.conns[conn] = struct{}{}
+	c.wg.Add(1)
+}
+
+// removeConn 关闭并移除连接
+func (c *tcpConns) removeConn(conn net.Conn) {
+	conn.Close()
+	c.mu.Lock()
+	delete(c.conns, conn)
+	c.mu.Unlock()
+	c.wg.Done()
+}
+
+// closeAll 关闭所有监听器与连接，并等待连接处理协程退出
+func (c *tcpConns) closeAll() {
+	c.mu.Lock()
+	for l := range c.listeners {
+		l.Close()
+	}
+	for conn := range c.conns {
+		conn.Close()
+	}
+	c.listeners = nil
+	c.mu.Unlock()
+	c.wg.Wait()
+}
+
+// serve 接受连接并为每个连接启动 handle 协程，监听器关闭后返回
+func (c *tcpConns) serve(l net.Listener, handle func(net.Conn)) error {
+	c.addListener(l)
+	for {
+		conn, err := l.Accept()
+		if err != nil {
+			if errors.Is(err, net.ErrClosed) {
+				return nil
+			}
+			return err
+		}
+		c.addConn(conn)
+		go func() {
+			defer c.removeConn(conn)
+			handle(conn)
+		}()
+	}
+}
+
+// ServeTCP 以 Modbus TCP 协议在监听器 l 上提供服务，阻塞直到监听器关闭
+// 单元标识符为本从站地址、0 或 0xFF 的请求会被处理，请求使用与 RTU 相同的处理器。
+// 只提供 TCP 服务时可以使用 NewServer(nil, id) 创建服务器，Stop 会关闭所有监听器与连接。
+//
+// 示例用法：
+//
+//	l, _ := net.Listen("tcp", ":502")
+//	go server.ServeTCP(l)
+func (s *Server) ServeTCP(l net.Listener) error {
+	return s.tcp.serve(l, s.serveTCPConn)
+}
+
+// serveTCPConn 处理一个 TCP 连接上的请求，接收与发送缓冲区在连接内复用
+func (s *Server) serveTCPConn(conn net.Conn) {
+	var rx, tx [tcpMaxADU]byte
+	for {
+		txn, unit, pdu, err := readMBAP(conn, rx[:])
+		if err != nil {
+			return
+		}
+		if unit != s.slaveID && unit != 0 && unit != 0xFF {
+			continue
+		}
+		n := s.processPDU(pdu, tx[mbapHeaderLength:])
+		if n == 0 {
+			continue
+		}
+		putMBAP(tx[:], txn, unit, n)
+		if _, err := conn.Write(tx[:mbapHeaderLength+n]); err != nil {
+			return
+		}
+	}
+}
+
+// Gateway Modbus TCP 到 RTU 网关
+// 多个 TCP 客户端的请求按单元标识符排入 Pipeline 的从站队列，在同一条 RTU 总线上依次发送，
+// 响应按原请求的事务标识符返回给对应的客户端；同一连接上可以有多个未完成的请求，按提交顺序返回。
+// 从站超时以异常 0x0B（目标设备无响应）返回，网关停止时以异常 0x0A（路径不可用）返回。
+type Gateway struct {
+	pipeline *Pipeline
+	tcp      tcpConns
+	pending  int // 每个连接允许的未完成请求数
+}
+
+// gatewayRequest 网关中等待 RTU 响应的 TCP 请求
+type gatewayRequest struct {
+	txn  uint16
+	unit uint8
+	call *Call
+}
+
+// NewGateway 创建 Modbus TCP 到 RTU 网关
+// 参数:
+//   - uart: RTU 总线，单次读取应能在超时内返回（如设置 ByteTimeout）
+//
+// 返回值:
+//   - *Gateway: 网关实例，通过 Pipeline 配置从站超时与合并策略，调用 Serve 开始服务
+func NewGateway(uart driver.UART) *Gateway {
+	return &Gateway{pipeline: NewPipeline(uart), pending: 16}
+}
+
+// Pipeline 返回网关使用的 RTU 主站引擎
+func (g *Gateway) Pipeline() *Pipeline {
+	return g.pipeline
+}
+
+// Serve 在监听器 l 上接受 Modbus TCP 客户端，阻塞直到监听器关闭
+// 首次调用时启动 RTU 主站引擎，可以对多个监听器并发调用。
+func (g *Gateway) Serve(l net.Listener) error {
+	g.pipeline.Start()
+	return g.tcp.serve(l, g.serveConn)
+}
+
+// Close 关闭所有监听器与客户端连接并停止 RTU 主站引擎
+func (g *Gateway) Close() error {
+	g.tcp.closeAll()
+	g.pipeline.Stop()
+	return nil
+}
+
+// serveConn 处理一个客户端连接：读协程提交请求，写协程按顺序等待并返回响应
+func (g *Gateway) serveConn(conn net.Conn) {
+	queue := make(chan gatewayRequest, g.pending)
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		var tx [tcpMaxADU]byte
+		for req := range queue {
+			resp, err := req.call.Wait()
+			if req.unit == 0 {
+				continue // 广播没有响应
+			}
+			n := 0
+			if err != nil {
+				tx[mbapHeaderLength] = req.call.Request[0] | 0x80
+				tx[mbapHeaderLength+1] = gatewayException(err)
+				n = 2
+			} else {
+				n = copy(tx[mbapHeaderLength:], resp)
+			}
+			putMBAP(tx[:], req.txn, req.unit, n)
+			if _, err := conn.Write(tx[:mbapHeaderLength+n]); err != nil {
+				conn.Close()
+			}
+		}
+	}()
+
+	var rx [tcpMaxADU]byte
+	for {
+		txn, unit, pdu, err := readMBAP(conn, rx[:])
+		if err != nil {
+			break
+		}
+		queue <- gatewayRequest{txn: txn, unit: unit, call: g.pipeline.Submit(unit, pdu)}
+	}
+	close(queue)
+	<-done
+}
+
+// gatewayException 将 RTU 侧错误转换为返回给 TCP 客户端的异常码
+func gatewayException(err error) byte {
+	var e *Exception
+	switch {
+	case errors.As(err, &e):
+		return e.Code
+	case errors.Is(err, ErrPipelineStopped):
+		return ExceptionGatewayPathUnavailable
+	}
+	return ExceptionGatewayTargetDevice
+}
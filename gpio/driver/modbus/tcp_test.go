@@ -0,0 +1,60 @@
+package modbus
+
+import (
+	"net"
+	"sync"
+	"testing"
+)
+
+// listenLocal 在本地回环地址上监听随机端口。
+func listenLocal(t *testing.T) net.Listener {
+	t.Helper()
+	l, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		t.Skipf("无法监听本地端口: %s", err)
+	}
+	return l
+}
+
+func TestTCPServer(t *testing.T) {
+	regs := NewRegisterMap(16, 16, 32, 32)
+	regs.SetInputRegisters(0, []uint16{11, 22, 33})
+	server := NewServer(nil, 5)
+	server.SetHandler(regs)
+	l := listenLocal(t)
+	go server.ServeTCP(l)
+	defer server.Stop()
+
+	// 多个客户端并发读写各自的寄存器
+	var wg sync.WaitGroup
+	for c := range 4 {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			master, err := NewTCPMaster(l.Addr().String())
+			if err != nil {
+				t.Error(err)
+				return
+			}
+			defer master.Close()
+			master.SetSlaveID(5)
+			for i := range 50 {
+				value := uint16(c*1000 + i)
+				if err := master.WriteSingleRegister(uint16(c), value); err != nil {
+					t.Errorf("客户端 %d 写寄存器失败: %s", c, err)
+					return
+				}
+				regs, err := master.ReadHoldingRegisters(uint16(c), 1)
+				if err != nil || regs[0] != value {
+					t.Errorf("客户端 %d 读到 %v %v，期望 %d", c, regs, err, value)
+					return
+				}
+			}
+			input, err := master.ReadInputRegisters(0, 3)
+			if err != nil || input[2] != 33 {
+				t.Errorf("读输入寄存器: %v %v", input, err)
+			}
+		}()
+	}
+	wg.Wait()
+}
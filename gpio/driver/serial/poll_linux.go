@@ -0,0 +1,129 @@
+//go:build linux
+// +build linux
+
+package serial
+
+import (
+	"fmt"
+	"sync"
+
+	"golang.org/x/sys/unix"
+)
+
+// pollDesc 一个串口在 epoll 循环中的就绪通知
+// 可读、可写事件各以容量为 1 的通道通知，多次边沿触发合并为一次；
+// 收到通知后调用者重新尝试非阻塞读写，通道中残留的过期通知只会导致一次多余的重试。
+type pollDesc struct {
+	fd      int
+	rd, wr  chan struct{}
+	closing chan struct{} // 端口关闭时关闭，唤醒所有等待者
+}
+
+// notify 非阻塞地发送一次就绪通知
+func notify(ch chan struct{}) {
+	select {
+	case ch <- struct{}{}:
+	default:
+	}
+}
+
+// poller 进程内所有串口共享的 epoll 循环
+// 文件描述符以边沿触发方式注册，一个协程等待全部端口的事件，端口数量增加不会增加协程数。
+// epoll_wait 返回 EINTR 以外的错误时循环退出：记录错误并关闭 dead，所有等待者返回该错误。
+type poller struct {
+	epfd  int
+	mu    sync.RWMutex
+	descs map[int32]*pollDesc
+	dead  chan struct{} // 循环因错误退出时关闭
+	err   error         // 循环退出的原因，关闭 dead 之前写入
+}
+
+var (
+	pollerOnce sync.Once
+	pollerInst *poller
+	pollerErr  error
+)
+
+// getPoller 返回共享的 epoll 循环，首次调用时创建
+func getPoller() (*poller, error) {
+	pollerOnce.Do(func() {
+		epfd, err := unix.EpollCreate1(unix.EPOLL_CLOEXEC)
+		if err != nil {
+			pollerErr = err
+			return
+		}
+		pollerInst = &poller{epfd: epfd, descs: make(map[int32]*pollDesc), dead: make(chan struct{})}
+		go pollerInst.run()
+	})
+	if pollerErr != nil {
+		return nil, pollerErr
+	}
+	select {
+	case <-pollerInst.dead:
+		return nil, pollerInst.err
+	default:
+	}
+	return pollerInst, nil
+}
+
+// register 把非阻塞文件描述符加入 epoll 循环
+func (p *poller) register(fd int) (*pollDesc, error) {
+	pd := &pollDesc{
+		fd:      fd,
+		rd:      make(chan struct{}, 1),
+		wr:      make(chan struct{}, 1),
+		closing: make(chan struct{}),
+	}
+	p.mu.Lock()
+	p.descs[int32(fd)] = pd
+	p.mu.Unlock()
+	event := unix.EpollEvent{Events: unix.EPOLLIN | unix.EPOLLOUT | unix.EPOLLET, Fd: int32(fd)}
+	if err := unix.EpollCtl(p.epfd, unix.EPOLL_CTL_ADD, fd, &event); err != nil {
+		p.mu.Lock()
+		delete(p.descs, int32(fd))
+		p.mu.Unlock()
+		return nil, err
+	}
+	return pd, nil
+}
+
+// unregister 把文件描述符移出 epoll 循环，必须在关闭文件描述符之前调用
+func (p *poller) unregister(pd *pollDesc) {
+	unix.EpollCtl(p.epfd, unix.EPOLL_CTL_DEL, pd.fd, nil)
+	p.mu.Lock()
+	if p.descs[int32(pd.fd)] == pd {
+		delete(p.descs, int32(pd.fd))
+	}
+	p.mu.Unlock()
+}
+
+// run epoll 循环，把事件分发到对应端口的通知通道
+func (p *poller) run() {
+	var events [64]unix.EpollEvent
+	for {
+		n, err := unix.EpollWait(p.epfd, events[:], -1)
+		if err == unix.EINTR {
+			continue
+		}
+		if err != nil {
+			p.err = fmt.Errorf("serial: epoll_wait: %w", err)
+			close(p.dead)
+			return
+		}
+		p.mu.RLock()
+		for i := range events[:n] {
+			ev := &events[i]
+			pd := p.descs[ev.Fd]
+			if pd == nil {
+				continue
+			}
+			if ev.Events&(unix.EPOLLIN|unix.EPOLLERR|unix.EPOLLHUP) != 0 {
+				notify(pd.rd)
+			}
+			if ev.Events&(unix.EPOLLOUT|unix.EPOLLERR|unix.EPOLLHUP) != 0 {
+				notify(pd.wr)
+			}
+		}
+		p.mu.RUnlock()
+	}
+}
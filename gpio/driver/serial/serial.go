@@ -7,6 +7,7 @@
 //   - 打开和关闭串行端口
 //   - 读取和写入数据
 //   - 支持阻塞和非阻塞操作
+//   - Linux 下使用非阻塞文件描述符与共享 epoll 循环，读写分别加锁，支持读写截止时间
 //   - 实现 driver.UART 接口，可与 gogio/driver 系统集成
 //   - 支持 RS232、RS422、RS485 等串行接口
 //
@@ -56,6 +57,8 @@ import (
 	"circuit/gpio/driver"
 	"errors"
 	"sync"
+	"sync/atomic"
+	"time"
 )
 
 // DefaultSize 是 Config.Size 字段的默认值。
@@ -118,6 +121,9 @@ var ErrBadStopBits error = errors.New("unsupported stop bit setting")
 // ErrBadParity 在校验位不受支持时返回。
 var ErrBadParity error = errors.New("unsupported parity setting")
 
+// ErrClosed 在端口已关闭时返回，关闭端口会使正在等待的读写立即返回该错误。
+var ErrClosed error = errors.New("serial: port closed")
+
 // OpenPort 使用指定的配置打开一个串行端口
 func OpenPort(name string, config *driver.UARTConfig) (*Port, error) {
 	if config == nil {
@@ -128,15 +134,20 @@ func OpenPort(name string, config *driver.UARTConfig) (*Port, error) {
 
 // uartDriver 是 driver.UART 接口的实现，包装了底层的 serial.Port。
 // 它提供了线程安全的串口操作，支持动态配置和状态管理。
+// 读写路径只原子读取当前端口，不持有 mu，读写之间由 Port 自身的读锁、写锁分别串行化，
+// 阻塞中的读不会阻塞写，也不会阻塞其他端口。
 //
 // 字段说明：
-//   - mu: 互斥锁，确保并发访问的安全性
+//   - mu: 互斥锁，保护配置、Init 与 Close
 //   - port: 底层的串口端口实例
+//   - rmu: 保护 Read 使用的暂存缓冲区 rbuf
 //   - portName: 串口设备名称
 //   - config: 当前端口配置，使用 driver.UARTConfig 格式
 type uartDriver struct {
 	mu       sync.Mutex
-	port     *Port
+	port     atomic.Pointer[Port]
+	rmu      sync.Mutex
+	rbuf     []byte
 	portName string
 	config   *driver.UARTConfig
 }
@@ -174,20 +185,21 @@ func NewUART(portName string, config *driver.UARTConfig) (driver.UART, error) {
 	if err != nil {
 		return nil, err
 	}
-	return &uartDriver{port: port, config: config, portName: portName}, nil
+	u := &uartDriver{config: config, portName: portName}
+	u.port.Store(port)
+	return u, nil
 }
 
 // Close 关闭 UART 设备
 func (u *uartDriver) Close() error {
 	u.mu.Lock()
 	defer u.mu.Unlock()
-	if u.port == nil {
+	port := u.port.Swap(nil)
+	if port == nil {
 		return errors.New("serial: port already closed")
 	}
-	err := u.port.Close()
-	u.port = nil
 	u.config = nil
-	return err
+	return port.Close()
 }
 
 // Init 初始化 UART 配置
@@ -223,8 +235,7 @@ func (u *uartDriver) Init(baudRate int, byteSize, parity, stopBits, byteTimeout
 	}
 
 	// 成功打开新端口，关闭旧端口
-	oldPort := u.port
-	u.port = newPort
+	oldPort := u.port.Swap(newPort)
 	u.config = newConfig
 
 	// 关闭旧端口（忽略错误，因为新端口已打开）
@@ -248,27 +259,84 @@ func (u *uartDriver) GetConfig() (*driver.UARTConfig, error) {
 }
 
 // Read 从 UART 读取数据
+// 数据先读入复用的暂存缓冲区，只为实际读到的字节分配返回值；没有数据时返回 nil。
+// 需要完全避免分配时使用 ReadInto。
 func (u *uartDriver) Read(length int) ([]byte, error) {
-	u.mu.Lock()
-	defer u.mu.Unlock()
-	if u.port == nil {
-		return nil, errors.New("serial: port closed")
+	port := u.port.Load()
+	if port == nil {
+		return nil, ErrClosed
 	}
-	buf := make([]byte, length)
-	n, err := u.port.Read(buf)
-	if err != nil {
+	u.rmu.Lock()
+	defer u.rmu.Unlock()
+	if cap(u.rbuf) < length {
+		u.rbuf = make([]byte, length)
+	}
+	n, err := port.Read(u.rbuf[:length])
+	if err != nil || n == 0 {
 		return nil, err
 	}
-	return buf[:n], nil
+	return append([]byte(nil), u.rbuf[:n]...), nil
 }
 
 // Write 向 UART 写入数据
 func (u *uartDriver) Write(data []byte) error {
-	u.mu.Lock()
-	defer u.mu.Unlock()
-	if u.port == nil {
-		return errors.New("serial: port closed")
+	port := u.port.Load()
+	if port == nil {
+		return ErrClosed
 	}
-	_, err := u.port.Write(data)
+	_, err := port.Write(data)
 	return err
 }
+
+// ReadInto 从 UART 读取数据到调用者提供的缓冲区，不分配内存
+func (u *uartDriver) ReadInto(buf []byte) (int, error) {
+	port := u.port.Load()
+	if port == nil {
+		return 0, ErrClosed
+	}
+	return port.Read(buf)
+}
+
+// WaitReadable 等待 UART 有数据可读，等待期间不持有锁，不阻塞 Write
+// 参数：
+//   - timeout: 最长等待时间，小于 0 表示一直等待
+//
+// 返回值：
+//   - bool: 是否有数据可读，超时返回 false
+//   - error: 端口已关闭或底层等待失败
+func (u *uartDriver) WaitReadable(timeout time.Duration) (bool, error) {
+	port := u.port.Load()
+	if port == nil {
+		return false, ErrClosed
+	}
+	return port.WaitReadable(timeout)
+}
+
+// SetReadDeadline 设置读截止时间，零值表示取消
+// 超过截止时间的读返回 os.ErrDeadlineExceeded；不支持截止时间的平台返回 os.ErrNoDeadline。
+// Init 重新打开端口后截止时间不保留。
+func (u *uartDriver) SetReadDeadline(t time.Time) error {
+	port := u.port.Load()
+	if port == nil {
+		return ErrClosed
+	}
+	return port.SetReadDeadline(t)
+}
+
+// SetWriteDeadline 设置写截止时间，零值表示取消
+func (u *uartDriver) SetWriteDeadline(t time.Time) error {
+	port := u.port.Load()
+	if port == nil {
+		return ErrClosed
+	}
+	return port.SetWriteDeadline(t)
+}
+
+// SetDeadline 同时设置读写截止时间
+func (u *uartDriver) SetDeadline(t time.Time) error {
+	port := u.port.Load()
+	if port == nil {
+		return ErrClosed
+	}
+	return port.SetDeadline(t)
+}
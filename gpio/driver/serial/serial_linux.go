@@ -2,7 +2,7 @@
 // +build linux
 
 // 本文件包含 serial 包在 Linux 系统下的实现。
-// 提供了基于 termios 的串口操作。
+// 提供了基于 termios 的串口配置与基于 epoll 的非阻塞读写。
 //
 // 该实现使用 golang.org/x/sys/unix 包进行系统调用。
 package serial
@@ -10,7 +10,11 @@ package serial
 import (
 	"circuit/gpio/driver"
 	"fmt"
+	"io"
 	"os"
+	"sync"
+	"sync/atomic"
+	"time"
 	"unsafe"
 
 	"golang.org/x/sys/unix"
@@ -24,7 +28,7 @@ import (
 //   - databits: 数据位大小，支持 5、6、7、8
 //   - parity: 奇偶校验类型，使用 Parity 常量
 //   - stopbits: 停止位类型，使用 StopBits 常量
-//   - readTimeout: 读取超时时间，影响 VMIN 和 VTIME 设置
+//   - config.ByteTimeout: 等待数据的毫秒数，0 表示一直等待
 //
 // 返回值：
 //   - *Port: 打开的串口端口实例
@@ -32,7 +36,7 @@ import (
 //
 // 实现细节：
 //   - 使用 termios 结构进行串口配置
-//   - 支持阻塞和非阻塞模式（通过超时设置）
+//   - 文件描述符以非阻塞方式打开并注册到共享 epoll 循环
 //   - 自动处理文件描述符和资源清理
 func openPort(name string, config *driver.UARTConfig) (p *Port, err error) {
 	// 从配置中提取参数并设置默认值
@@ -115,14 +119,14 @@ func openPort(name string, config *driver.UARTConfig) (p *Port, err error) {
 	if !ok {
 		return nil, fmt.Errorf("Unrecognized baud rate")
 	}
-	f, err := os.OpenFile(name, unix.O_RDWR|unix.O_NOCTTY|unix.O_NONBLOCK, 0666)
+	// 以非阻塞方式打开，读写在 EAGAIN 时等待 epoll 就绪通知
+	fd, err := unix.Open(name, unix.O_RDWR|unix.O_NOCTTY|unix.O_NONBLOCK|unix.O_CLOEXEC, 0666)
 	if err != nil {
-		return nil, err
+		return nil, &os.PathError{Op: "open", Path: name, Err: err}
 	}
-
 	defer func() {
-		if err != nil && f != nil {
-			f.Close()
+		if err != nil {
+			unix.Close(fd)
 		}
 	}()
 	// 基础设置
@@ -161,31 +165,15 @@ func openPort(name string, config *driver.UARTConfig) (p *Port, err error) {
 	default:
 		return nil, ErrBadParity
 	}
-	fd := f.Fd()
-	// 设置阻塞/非阻塞读取
-	var vmin, vtime uint8
-	if config.ByteTimeout == 0 {
-		// 阻塞读取，无超时
-		vmin = 1
-		vtime = 0
-	} else {
-		// 非阻塞读取，字符间超时
-		vmin = 0
-		// 将毫秒超时转换为十分之一秒（VTIME单位）
-		vtime = config.ByteTimeout / 100
-		if vtime == 0 {
-			// 小于100毫秒的超时设为最小单位（0.1秒）
-			vtime = 1
-		}
-	}
+	// VMIN=1、VTIME=0：没有数据时非阻塞读返回 EAGAIN（VMIN=0 会直接返回 0），字节超时由 Port.Read 按毫秒实现
 	t := unix.Termios{
 		Iflag:  unix.IGNPAR,
 		Cflag:  cflagToUse,
 		Ispeed: rate,
 		Ospeed: rate,
 	}
-	t.Cc[unix.VMIN] = vmin
-	t.Cc[unix.VTIME] = vtime
+	t.Cc[unix.VMIN] = 1
+	t.Cc[unix.VTIME] = 0
 	if _, _, errno := unix.Syscall6(
 		unix.SYS_IOCTL,
 		uintptr(fd),
@@ -197,30 +185,309 @@ func openPort(name string, config *driver.UARTConfig) (p *Port, err error) {
 	); errno != 0 {
 		return nil, errno
 	}
-	if err = unix.SetNonblock(int(fd), false); err != nil {
-		return
+	poll, err := getPoller()
+	if err != nil {
+		return nil, err
+	}
+	pd, err := poll.register(fd)
+	if err != nil {
+		return nil, err
+	}
+	p = &Port{
+		fd:          fd,
+		pd:          pd,
+		poll:        poll,
+		byteTimeout: time.Duration(config.ByteTimeout) * time.Millisecond,
+		rtimer:      newStoppedTimer(),
+		wtimer:      newStoppedTimer(),
+		qtimer:      newStoppedTimer(),
 	}
-	return &Port{f: f}, nil
+	return p, nil
 }
 
 // Port 代表一个打开的 Linux 串行端口。
-// 它封装了底层的 os.File 并提供基本的读写操作。
+// 文件描述符工作在非阻塞模式，并注册到进程共享的 epoll 循环：
+// 读写先直接尝试系统调用，EAGAIN 时等待就绪通知、截止时间或端口关闭。
+// 读与写分别加锁，阻塞中的读不会阻塞写；Read 读入调用者的缓冲区，不分配内存。
 type Port struct {
-	f *os.File
+	fd          int
+	pd          *pollDesc
+	poll        *poller
+	byteTimeout time.Duration // 等待第一个字节的最长时间，0 表示一直等待
+
+	rmu, wmu       sync.Mutex
+	rtimer, wtimer *time.Timer // 等待用的定时器，分别由 rmu、wmu 保护
+	qmu            sync.Mutex
+	qtimer         *time.Timer  // WaitReadable 的定时器，由 qmu 保护
+	fdmu           sync.RWMutex // 不持有读写锁的文件描述符访问（WaitReadable 的 TIOCINQ）持有读锁，Close 持有写锁
+	rreading       atomic.Int32 // 正在进行（可能等待可读通知）的 Read 数量
+	rdeadline      atomic.Int64 // 读截止时间（UnixNano），0 表示没有
+	wdeadline      atomic.Int64 // 写截止时间（UnixNano），0 表示没有
+	closeOnce      sync.Once
+}
+
+// newStoppedTimer 创建一个未启动的定时器
+func newStoppedTimer() *time.Timer {
+	t := time.NewTimer(time.Hour)
+	t.Stop()
+	return t
+}
+
+// wait 等待就绪通知 ready
+// 参数：
+//   - deadline: 截止时间（UnixNano），0 表示没有
+//   - idle: 字节超时的结束时间，零值表示没有
+//
+// 返回值：
+//   - error: 收到通知返回 nil；超过截止时间返回 os.ErrDeadlineExceeded；
+//     字节超时返回 io.EOF（与 VTIME 超时时 read 返回 0 的行为一致）；端口关闭返回 ErrClosed；
+//     epoll 循环出错退出时返回其错误
+func (p *Port) wait(ready chan struct{}, t *time.Timer, deadline int64, idle time.Time) error {
+	var d time.Duration = -1
+	idleFirst := false
+	now := time.Now()
+	if deadline != 0 {
+		if d = time.Unix(0, deadline).Sub(now); d <= 0 {
+			return os.ErrDeadlineExceeded
+		}
+	}
+	if !idle.IsZero() {
+		if r := idle.Sub(now); d < 0 || r < d {
+			d, idleFirst = r, true
+		}
+		if d <= 0 {
+			return io.EOF
+		}
+	}
+	if d < 0 {
+		select {
+		case <-ready:
+			return nil
+		case <-p.pd.closing:
+			return ErrClosed
+		case <-p.poll.dead:
+			return p.poll.err
+		}
+	}
+	t.Reset(d)
+	select {
+	case <-ready:
+	case <-p.pd.closing:
+		stopTimer(t)
+		return ErrClosed
+	case <-p.poll.dead:
+		stopTimer(t)
+		return p.poll.err
+	case <-t.C:
+		if idleFirst {
+			return io.EOF
+		}
+		return os.ErrDeadlineExceeded
+	}
+	stopTimer(t)
+	return nil
+}
+
+// stopTimer 停止定时器并清空可能已经到期的通知
+func stopTimer(t *time.Timer) {
+	if !t.Stop() {
+		select {
+		case <-t.C:
+		default:
+		}
+	}
 }
 
 // Read 从串口读取数据到字节切片中。
-// 实现 io.Reader 接口，读取的字节数可能小于缓冲区长度。
-// 返回读取的字节数和可能的错误（如超时或连接断开）。
+// 实现 io.Reader 接口，读取的字节数可能小于缓冲区长度，不分配内存。
+// 没有数据时等待：ByteTimeout 为 0 时一直等待到有数据，否则最多等待 ByteTimeout 毫秒后返回 0, io.EOF；
+// 设置了读截止时间时超时返回 os.ErrDeadlineExceeded，端口关闭时返回 ErrClosed。
 func (p *Port) Read(b []byte) (n int, err error) {
-	return p.f.Read(b)
+	if len(b) == 0 {
+		return 0, nil
+	}
+	p.rmu.Lock()
+	defer p.rmu.Unlock()
+	if p.closed() {
+		return 0, ErrClosed
+	}
+	// 在第一次读之前登记，EAGAIN 之后到达的通知即使先被 WaitReadable 取走也会转交过来
+	p.rreading.Add(1)
+	defer p.rreading.Add(-1)
+	var idle time.Time
+	for {
+		n, err = unix.Read(p.fd, b)
+		switch {
+		case n > 0:
+			return n, nil
+		case err == unix.EINTR:
+			continue
+		case err == nil:
+			return 0, io.EOF
+		case err != unix.EAGAIN:
+			if p.closed() {
+				return 0, ErrClosed
+			}
+			return 0, err
+		}
+		if p.byteTimeout > 0 && idle.IsZero() {
+			idle = time.Now().Add(p.byteTimeout)
+		}
+		if err = p.wait(p.pd.rd, p.rtimer, p.rdeadline.Load(), idle); err != nil {
+			return 0, err
+		}
+	}
 }
 
 // Write 将字节切片中的数据写入串口。
-// 实现 io.Writer 接口，返回写入的字节数和可能的错误。
-// 如果写入部分数据后发生错误，返回的 n 可能小于 len(b)。
+// 实现 io.Writer 接口，发送缓冲区满时等待可写通知直到全部写入。
+// 超过写截止时间返回 os.ErrDeadlineExceeded，此时返回的 n 为已写入的字节数。
 func (p *Port) Write(b []byte) (n int, err error) {
-	return p.f.Write(b)
+	p.wmu.Lock()
+	defer p.wmu.Unlock()
+	if p.closed() {
+		return 0, ErrClosed
+	}
+	for n < len(b) {
+		k, err := unix.Write(p.fd, b[n:])
+		if k > 0 {
+			n += k
+			continue
+		}
+		switch {
+		case err == unix.EINTR:
+			continue
+		case err != unix.EAGAIN && err != nil:
+			if p.closed() {
+				return n, ErrClosed
+			}
+			return n, err
+		}
+		if err := p.wait(p.pd.wr, p.wtimer, p.wdeadline.Load(), time.Time{}); err != nil {
+			return n, err
+		}
+	}
+	return n, nil
+}
+
+// WaitReadable 阻塞等待串口有数据可读，不占用读锁。
+// 可读通知是边沿触发的，通道中可能残留过期的通知（读完数据没有遇到 EAGAIN、SetReadDeadline 等）；
+// 收到通知后直接消费，查询没有数据时等待新的边沿，不会在过期通知上反复查询。
+// 参数：
+//   - timeout: 最长等待时间；小于 0 表示一直等待
+//
+// 返回值：
+//   - bool: 是否有数据可读，超时返回 false
+//   - error: 端口已关闭、查询失败或 epoll 循环出错
+func (p *Port) WaitReadable(timeout time.Duration) (bool, error) {
+	var end time.Time
+	var t *time.Timer
+	if timeout >= 0 {
+		end = time.Now().Add(timeout)
+		// 读协程循环调用时复用端口上的定时器；少见的并发调用各自创建
+		if p.qmu.TryLock() {
+			defer p.qmu.Unlock()
+			t = p.qtimer
+		} else {
+			t = newStoppedTimer()
+		}
+	}
+	for {
+		avail, err := p.inputQueued()
+		if err != nil {
+			return false, err
+		}
+		if avail > 0 {
+			return true, nil
+		}
+		var d time.Duration = -1
+		if timeout >= 0 {
+			if d = time.Until(end); d <= 0 {
+				return false, nil
+			}
+		}
+		if d < 0 {
+			select {
+			case <-p.pd.rd:
+				p.passReadable()
+			case <-p.pd.closing:
+				return false, ErrClosed
+			case <-p.poll.dead:
+				return false, p.poll.err
+			}
+			continue
+		}
+		t.Reset(d)
+		select {
+		case <-p.pd.rd:
+			stopTimer(t)
+			p.passReadable()
+		case <-p.pd.closing:
+			stopTimer(t)
+			return false, ErrClosed
+		case <-p.poll.dead:
+			stopTimer(t)
+			return false, p.poll.err
+		case <-t.C:
+		}
+	}
+}
+
+// inputQueued 查询输入缓冲区中的字节数
+// 持有 fdmu 读锁并在其中检查关闭状态，Close 关闭文件描述符后不会把查询发给被复用的描述符。
+func (p *Port) inputQueued() (int, error) {
+	p.fdmu.RLock()
+	defer p.fdmu.RUnlock()
+	if p.closed() {
+		return 0, ErrClosed
+	}
+	return unix.IoctlGetInt(p.fd, unix.TIOCINQ)
+}
+
+// passReadable WaitReadable 消费了可读通知后，把通知转交给正在等待的 Read
+// 没有等待者时不重新发送，避免 WaitReadable 在同一个通知上空转。
+func (p *Port) passReadable() {
+	if p.rreading.Load() > 0 {
+		notify(p.pd.rd)
+	}
+}
+
+// SetReadDeadline 设置读截止时间，零值表示取消；正在等待的读会立即按新的截止时间重新计时
+func (p *Port) SetReadDeadline(t time.Time) error {
+	p.rdeadline.Store(deadlineNano(t))
+	notify(p.pd.rd)
+	return nil
+}
+
+// SetWriteDeadline 设置写截止时间，零值表示取消
+func (p *Port) SetWriteDeadline(t time.Time) error {
+	p.wdeadline.Store(deadlineNano(t))
+	notify(p.pd.wr)
+	return nil
+}
+
+// SetDeadline 同时设置读写截止时间
+func (p *Port) SetDeadline(t time.Time) error {
+	p.SetReadDeadline(t)
+	return p.SetWriteDeadline(t)
+}
+
+// deadlineNano 把截止时间转换为 UnixNano，零值为 0
+func deadlineNano(t time.Time) int64 {
+	if t.IsZero() {
+		return 0
+	}
+	return t.UnixNano()
+}
+
+// closed 端口是否已关闭
+func (p *Port) closed() bool {
+	select {
+	case <-p.pd.closing:
+		return true
+	default:
+		return false
+	}
 }
 
 // Flush 清空串口的输入和输出缓冲区。
@@ -232,7 +499,7 @@ func (p *Port) Flush() error {
 	const TCFLSH = 0x540B
 	_, _, errno := unix.Syscall(
 		unix.SYS_IOCTL,
-		uintptr(p.f.Fd()),
+		uintptr(p.fd),
 		uintptr(TCFLSH),
 		uintptr(unix.TCIOFLUSH),
 	)
@@ -243,8 +510,20 @@ func (p *Port) Flush() error {
 }
 
 // Close 关闭串行端口并释放底层文件描述符。
-// 关闭后，任何未完成的读写操作将返回错误。
+// 正在等待的读写立即返回 ErrClosed，文件描述符在读写都退出后才关闭。
 // 重复关闭是安全的，不会导致 panic。
 func (p *Port) Close() (err error) {
-	return p.f.Close()
+	err = ErrClosed
+	p.closeOnce.Do(func() {
+		close(p.pd.closing)
+		p.rmu.Lock()
+		p.wmu.Lock()
+		p.fdmu.Lock()
+		p.poll.unregister(p.pd)
+		err = unix.Close(p.fd)
+		p.fdmu.Unlock()
+		p.wmu.Unlock()
+		p.rmu.Unlock()
+	})
+	return err
 }
@@ -0,0 +1,242 @@
+//go:build linux
+
+package serial
+
+import (
+	"bytes"
+	"circuit/gpio/driver"
+	"circuit/gpio/driver/internal/ptytest"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"sync"
+	"testing"
+	"time"
+)
+
+// openPTY 打开一对 PTY：主端模拟对端设备，从端按串口打开
+func openPTY(t testing.TB, byteTimeout uint8) (*os.File, *uartDriver) {
+	t.Helper()
+	ptm, slave := ptytest.Open(t)
+	uart, err := NewUART(slave, &driver.UARTConfig{
+		BaudRate: 115200, ByteSize: 8, ByteTimeout: byteTimeout,
+	})
+	if err != nil {
+		t.Skipf("打开 PTY 从端失败: %s", err)
+	}
+	t.Cleanup(func() { uart.Close() })
+	return ptm, uart.(*uartDriver)
+}
+
+func TestPortReadInto(t *testing.T) {
+	ptm, uart := openPTY(t, 20)
+	// 没有数据时按字节超时返回 io.EOF
+	buf := make([]byte, 64)
+	start := time.Now()
+	if n, err := uart.ReadInto(buf); n != 0 || err != io.EOF {
+		t.Fatalf("空闲读取返回 %d, %v", n, err)
+	}
+	if d := time.Since(start); d < 15*time.Millisecond {
+		t.Fatalf("字节超时只等待了 %s", d)
+	}
+	if data, err := uart.Read(16); data != nil || err != io.EOF {
+		t.Fatalf("空闲 Read 返回 %q, %v", data, err)
+	}
+	msg := []byte("hello")
+	allocs := testing.AllocsPerRun(100, func() {
+		ptm.Write(msg)
+		if n, err := uart.ReadInto(buf); err != nil || !bytes.Equal(buf[:n], msg) {
+			t.Fatalf("读取 %q, %v", buf[:n], err)
+		}
+	})
+	if allocs != 0 {
+		t.Fatalf("ReadInto 每次分配 %.1f 次", allocs)
+	}
+	ptm.Write(msg)
+	if data, err := uart.Read(64); err != nil || !bytes.Equal(data, msg) {
+		t.Fatalf("Read 返回 %q, %v", data, err)
+	}
+}
+
+func TestPortReadDeadline(t *testing.T) {
+	ptm, uart := openPTY(t, 0)
+	buf := make([]byte, 16)
+	uart.SetReadDeadline(time.Now().Add(30 * time.Millisecond))
+	if _, err := uart.ReadInto(buf); !errors.Is(err, os.ErrDeadlineExceeded) {
+		t.Fatalf("超过截止时间返回 %v", err)
+	}
+	// 已过期的截止时间立即返回
+	if _, err := uart.ReadInto(buf); !errors.Is(err, os.ErrDeadlineExceeded) {
+		t.Fatalf("截止时间已过返回 %v", err)
+	}
+	// 等待中延长截止时间
+	done := make(chan error, 1)
+	uart.SetReadDeadline(time.Now().Add(20 * time.Millisecond))
+	go func() {
+		_, err := uart.ReadInto(buf)
+		done <- err
+	}()
+	time.Sleep(5 * time.Millisecond)
+	uart.SetReadDeadline(time.Time{})
+	time.Sleep(40 * time.Millisecond)
+	ptm.Write([]byte("x"))
+	if err := <-done; err != nil || buf[0] != 'x' {
+		t.Fatalf("取消截止时间后读取 %q, %v", buf[:1], err)
+	}
+}
+
+func TestPortWriteWhileReading(t *testing.T) {
+	ptm, uart := openPTY(t, 0)
+	got := make(chan []byte, 1)
+	go func() {
+		buf := make([]byte, 16)
+		n, _ := uart.ReadInto(buf)
+		got <- buf[:n]
+	}()
+	time.Sleep(20 * time.Millisecond)
+	// 读协程阻塞等待数据时写入不被阻塞
+	written := make(chan error, 1)
+	go func() { written <- uart.Write([]byte("ping")) }()
+	select {
+	case err := <-written:
+		if err != nil {
+			t.Fatal(err)
+		}
+	case <-time.After(time.Second):
+		t.Fatal("写入被阻塞的读取阻塞")
+	}
+	reply := make([]byte, 4)
+	if _, err := io.ReadFull(ptm, reply); err != nil || string(reply) != "ping" {
+		t.Fatalf("对端收到 %q, %v", reply, err)
+	}
+	ptm.Write([]byte("pong"))
+	if data := <-got; string(data) != "pong" {
+		t.Fatalf("读取 %q", data)
+	}
+}
+
+func TestPortCloseUnblocksRead(t *testing.T) {
+	_, uart := openPTY(t, 0)
+	done := make(chan error, 1)
+	go func() {
+		_, err := uart.ReadInto(make([]byte, 16))
+		done <- err
+	}()
+	time.Sleep(20 * time.Millisecond)
+	uart.Close()
+	select {
+	case err := <-done:
+		if err != ErrClosed {
+			t.Fatalf("关闭后读取返回 %v", err)
+		}
+	case <-time.After(time.Second):
+		t.Fatal("关闭没有唤醒阻塞的读取")
+	}
+	if _, err := uart.ReadInto(make([]byte, 1)); err != ErrClosed {
+		t.Fatalf("关闭后读取返回 %v", err)
+	}
+}
+
+func TestManyPorts(t *testing.T) {
+	const ports, rounds = 32, 50
+	var wg sync.WaitGroup
+	errs := make(chan error, ports)
+	for i := range ports {
+		ptm, uart := openPTY(t, 0)
+		// 每个端口一个回显协程，全部端口共享一个 epoll 循环
+		go func() {
+			buf := make([]byte, 64)
+			for {
+				n, err := uart.ReadInto(buf)
+				if err != nil {
+					return
+				}
+				uart.Write(buf[:n])
+			}
+		}()
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			msg := []byte(fmt.Sprintf("port %02d", i))
+			reply := make([]byte, len(msg))
+			for range rounds {
+				ptm.Write(msg)
+				if _, err := io.ReadFull(ptm, reply); err != nil || !bytes.Equal(reply, msg) {
+					errs <- fmt.Errorf("端口 %d 回显 %q, %v", i, reply, err)
+					return
+				}
+			}
+		}(i)
+	}
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		t.Fatal(err)
+	}
+}
+
+func TestPortWaitReadable(t *testing.T) {
+	ptm, uart := openPTY(t, 0)
+	port := uart.port.Load()
+	// 超时等待复用端口上的定时器，读协程循环调用不分配内存
+	allocs := testing.AllocsPerRun(20, func() {
+		if ok, err := port.WaitReadable(time.Millisecond); ok || err != nil {
+			t.Fatalf("空闲等待返回 %v, %v", ok, err)
+		}
+	})
+	if allocs != 0 {
+		t.Fatalf("WaitReadable 每次分配 %.1f 次", allocs)
+	}
+	go func() {
+		time.Sleep(10 * time.Millisecond)
+		ptm.Write([]byte("x"))
+	}()
+	if ok, err := port.WaitReadable(time.Second); !ok || err != nil {
+		t.Fatalf("有数据时返回 %v, %v", ok, err)
+	}
+}
+
+func TestPortWaitReadableIdle(t *testing.T) {
+	ptm, uart := openPTY(t, 0)
+	port := uart.port.Load()
+	// 读完数据时没有遇到 EAGAIN，设置截止时间也会发送通知，通道中留下过期的可读通知
+	ptm.Write([]byte("ping"))
+	if ok, err := port.WaitReadable(time.Second); !ok || err != nil {
+		t.Fatalf("有数据时返回 %v, %v", ok, err)
+	}
+	if n, err := uart.ReadInto(make([]byte, 4)); n != 4 || err != nil {
+		t.Fatalf("读取 %d, %v", n, err)
+	}
+	port.SetReadDeadline(time.Time{})
+	// 空闲的限时等待阻塞到超时，不在过期通知上反复查询
+	const idle = 300 * time.Millisecond
+	cpu := ptytest.CPUTime()
+	start := time.Now()
+	if ok, err := port.WaitReadable(idle); ok || err != nil {
+		t.Fatalf("空闲等待返回 %v, %v", ok, err)
+	}
+	if d := time.Since(start); d < idle {
+		t.Fatalf("空闲等待只持续了 %s", d)
+	}
+	if used := ptytest.CPUTime() - cpu; used > idle/4 {
+		t.Fatalf("空闲等待 %s 占用 CPU %s", idle, used)
+	}
+	// 与阻塞中的 Read 同时等待：WaitReadable 取走的通知转交给 Read
+	got := make(chan error, 1)
+	go func() {
+		_, err := uart.ReadInto(make([]byte, 4))
+		got <- err
+	}()
+	go port.WaitReadable(-1)
+	time.Sleep(20 * time.Millisecond)
+	ptm.Write([]byte("pong"))
+	select {
+	case err := <-got:
+		if err != nil {
+			t.Fatal(err)
+		}
+	case <-time.After(time.Second):
+		t.Fatal("Read 没有收到可读通知")
+	}
+}
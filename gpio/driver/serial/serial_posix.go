@@ -19,6 +19,7 @@ import (
 	"fmt"
 	"os"
 	"syscall"
+	"time"
 )
 
 // openPort 在 POSIX 系统上打开一个串行端口。
@@ -246,6 +247,28 @@ func (p *Port) Write(b []byte) (n int, err error) {
 	return p.f.Write(b)
 }
 
+// WaitReadable 等待串口有数据可读。
+// 该平台没有实现就绪通知，总是立即返回 true，由随后的 Read 按字节超时阻塞等待。
+func (p *Port) WaitReadable(timeout time.Duration) (bool, error) {
+	return true, nil
+}
+
+// SetReadDeadline 设置读截止时间。
+// 端口工作在阻塞模式，os.File 不支持截止时间，返回 os.ErrNoDeadline。
+func (p *Port) SetReadDeadline(t time.Time) error {
+	return p.f.SetReadDeadline(t)
+}
+
+// SetWriteDeadline 设置写截止时间，同 SetReadDeadline。
+func (p *Port) SetWriteDeadline(t time.Time) error {
+	return p.f.SetWriteDeadline(t)
+}
+
+// SetDeadline 同时设置读写截止时间，同 SetReadDeadline。
+func (p *Port) SetDeadline(t time.Time) error {
+	return p.f.SetDeadline(t)
+}
+
 // Flush 清空串口的输入和输出缓冲区。
 // 使用 tcflush 系统调用丢弃所有未读和未写的数据。
 // 常用于恢复通信状态或清除垃圾数据。
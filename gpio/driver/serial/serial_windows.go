@@ -13,6 +13,7 @@ import (
 	"os"
 	"sync"
 	"syscall"
+	"time"
 	"unsafe"
 )
 
@@ -212,6 +213,28 @@ func (p *Port) Read(buf []byte) (int, error) {
 	return getOverlappedResult(p.fd, p.ro)
 }
 
+// WaitReadable 等待串口有数据可读。
+// 该平台没有实现就绪通知，总是立即返回 true，由随后的 Read 按字节超时阻塞等待。
+func (p *Port) WaitReadable(timeout time.Duration) (bool, error) {
+	return true, nil
+}
+
+// SetReadDeadline 设置读截止时间。
+// 该平台由 SetCommTimeouts 的字节超时控制读写等待，不支持截止时间，返回 os.ErrNoDeadline。
+func (p *Port) SetReadDeadline(t time.Time) error {
+	return os.ErrNoDeadline
+}
+
+// SetWriteDeadline 设置写截止时间，该平台不支持，返回 os.ErrNoDeadline。
+func (p *Port) SetWriteDeadline(t time.Time) error {
+	return os.ErrNoDeadline
+}
+
+// SetDeadline 同时设置读写截止时间，该平台不支持，返回 os.ErrNoDeadline。
+func (p *Port) SetDeadline(t time.Time) error {
+	return os.ErrNoDeadline
+}
+
 // Flush 清空串口的输入和输出缓冲区。
 // 使用 PurgeComm API 丢弃所有未读和未写的数据。
 // 常用于恢复通信状态或清除垃圾数据。
@@ -0,0 +1,198 @@
+package gui
+
+import "math/bits"
+
+// dirtyTileShift 脏区域跟踪的块大小为 1<<dirtyTileShift 像素
+const dirtyTileShift = 3
+
+// dirtyMaxRects 参与代价合并的矩形上限，超过时直接合并为包围盒
+const dirtyMaxRects = 128
+
+// Rect 表示矩形区域，(X0, Y0) 包含，(X1, Y1) 不包含
+type Rect struct {
+	X0, Y0, X1, Y1 int
+}
+
+// Dx 返回矩形宽度
+func (r Rect) Dx() int { return r.X1 - r.X0 }
+
+// Dy 返回矩形高度
+func (r Rect) Dy() int { return r.Y1 - r.Y0 }
+
+// Area 返回矩形面积
+func (r Rect) Area() int { return r.Dx() * r.Dy() }
+
+// Empty 判断矩形是否为空
+func (r Rect) Empty() bool { return r.X0 >= r.X1 || r.Y0 >= r.Y1 }
+
+// Union 返回同时包含两个矩形的最小矩形
+func (r Rect) Union(o Rect) Rect {
+	return Rect{min(r.X0, o.X0), min(r.Y0, o.Y0), max(r.X1, o.X1), max(r.Y1, o.Y1)}
+}
+
+// contains 判断 o 是否完全位于 r 内
+func (r Rect) contains(o Rect) bool {
+	return o.X0 >= r.X0 && o.Y0 >= r.Y0 && o.X1 <= r.X1 && o.Y1 <= r.Y1
+}
+
+// dirtyMap 以 8x8 像素块记录可见区域中被修改过的位置
+// 每行块用一组 64 位字的位图表示，SetPixel 标记一个像素只需一次移位与按位或。
+type dirtyMap struct {
+	width, height int // 可见区域尺寸
+	words         int // 每行块占用的字数
+	bits          []uint64
+	any           bool
+}
+
+// newDirtyMap 创建可见区域尺寸为 width x height 的脏区域位图
+func newDirtyMap(width, height int) *dirtyMap {
+	cols := (width + 1<<dirtyTileShift - 1) >> dirtyTileShift
+	rows := (height + 1<<dirtyTileShift - 1) >> dirtyTileShift
+	words := (cols + 63) / 64
+	return &dirtyMap{width: width, height: height, words: words, bits: make([]uint64, rows*words)}
+}
+
+// mark 标记一个像素，坐标必须在可见区域内
+func (d *dirtyMap) mark(x, y int) {
+	tx := x >> dirtyTileShift
+	d.bits[(y>>dirtyTileShift)*d.words+tx>>6] |= 1 << (tx & 63)
+	d.any = true
+}
+
+// markRect 标记矩形区域，矩形必须已裁剪到可见区域内且不为空
+func (d *dirtyMap) markRect(r Rect) {
+	tx0, tx1 := r.X0>>dirtyTileShift, (r.X1-1)>>dirtyTileShift
+	for ty := r.Y0 >> dirtyTileShift; ty <= (r.Y1-1)>>dirtyTileShift; ty++ {
+		row := d.bits[ty*d.words : (ty+1)*d.words]
+		for tx := tx0; tx <= tx1; tx++ {
+			row[tx>>6] |= 1 << (tx & 63)
+		}
+	}
+	d.any = true
+}
+
+// reset 清除全部标记
+func (d *dirtyMap) reset() {
+	clear(d.bits)
+	d.any = false
+}
+
+// rects 把标记的块转换为矩形：每行块中连续的块组成水平段，相邻行中相同的段向下延伸为一个矩形
+func (d *dirtyMap) rects(dst []Rect) []Rect {
+	if !d.any {
+		return dst
+	}
+	const tile = 1 << dirtyTileShift
+	open := len(dst) // dst[open:] 为上一行仍可向下延伸的矩形
+	rows := len(d.bits) / d.words
+	for ty := 0; ty < rows; ty++ {
+		row := d.bits[ty*d.words : (ty+1)*d.words]
+		y0, y1 := ty*tile, min((ty+1)*tile, d.height)
+		next := len(dst)
+		for tx := 0; tx < d.words*64; {
+			w := row[tx>>6] >> (tx & 63)
+			if w == 0 {
+				tx = (tx | 63) + 1
+				continue
+			}
+			tx += bits.TrailingZeros64(w)
+			start := tx
+			for tx < d.words*64 && row[tx>>6]>>(tx&63)&1 != 0 {
+				tx++
+			}
+			r := Rect{start * tile, y0, min(tx*tile, d.width), y1}
+			// 与上一行相同的段合并为一个更高的矩形
+			merged := false
+			for i := open; i < next; i++ {
+				if dst[i].Y1 == y0 && dst[i].X0 == r.X0 && dst[i].X1 == r.X1 {
+					dst[i].Y1 = y1
+					merged = true
+					break
+				}
+			}
+			if !merged {
+				dst = append(dst, r)
+			}
+		}
+		// 上一行中没有延伸到本行的矩形不再参与合并
+		for i := open; i < next; i++ {
+			if dst[i].Y1 != y1 {
+				dst[i], dst[open] = dst[open], dst[i]
+				open++
+			}
+		}
+	}
+	return dst
+}
+
+// mergeRects 按代价模型合并矩形：每个矩形的代价为 setupCost 加上面积（像素数），
+// 反复合并总代价下降最多的一对矩形（代价不变时也合并，以减少矩形数），直到任何合并都会增加代价；
+// 被合并结果包含的其他矩形一并移除。
+func mergeRects(rs []Rect, setupCost int) []Rect {
+	if len(rs) > dirtyMaxRects {
+		u := rs[0]
+		for _, r := range rs[1:] {
+			u = u.Union(r)
+		}
+		return append(rs[:0], u)
+	}
+	for len(rs) > 1 {
+		bi, bj, best := 0, 1, -1
+		for i := range rs {
+			for j := i + 1; j < len(rs); j++ {
+				if gain := setupCost + rs[i].Area() + rs[j].Area() - rs[i].Union(rs[j]).Area(); gain > best {
+					bi, bj, best = i, j, gain
+				}
+			}
+		}
+		if best < 0 {
+			break
+		}
+		u := rs[bi].Union(rs[bj])
+		n := 0
+		for i, r := range rs {
+			if i != bi && i != bj && !u.contains(r) {
+				rs[n] = r
+				n++
+			}
+		}
+		rs = append(rs[:n], u)
+	}
+	return rs
+}
+
+// MarkDirty 把可见区域中的矩形标记为已修改，坐标范围与 ClearWindow 相同（不包含 xEnd、yEnd）
+// 直接修改 Image 缓冲区后调用，使 DirtyRects 包含该区域。
+func (p *Paint) MarkDirty(xStart, yStart, xEnd, yEnd int) {
+	if p.dirty == nil {
+		return
+	}
+	r := Rect{max(xStart, 0), max(yStart, 0), min(xEnd, p.Width), min(yEnd, p.Height)}
+	if !r.Empty() {
+		p.dirty.markRect(r)
+	}
+}
+
+// IsDirty 判断自上次 ClearDirty 以来是否有像素被修改
+func (p *Paint) IsDirty() bool {
+	return p.dirty == nil || p.dirty.any
+}
+
+// DirtyRects 返回自上次 ClearDirty 以来被修改的区域（可见区域坐标）
+// 绘图函数修改的像素按 8x8 像素块记录，相邻的块合并为矩形，
+// 再按代价模型合并：每个矩形的代价为 setupCost 加上其像素数，合并能降低总代价时就合并。
+// setupCost 表示刷新一个矩形的固定开销折算的像素数，例如设置显示窗口的命令开销。
+// 没有跟踪信息时（Paint 不是由 NewPaint 创建）返回整个可见区域。
+func (p *Paint) DirtyRects(setupCost int) []Rect {
+	if p.dirty == nil {
+		return []Rect{{0, 0, p.Width, p.Height}}
+	}
+	return mergeRects(p.dirty.rects(nil), setupCost)
+}
+
+// ClearDirty 清除已修改区域的记录，通常在把修改刷新到屏幕后调用
+func (p *Paint) ClearDirty() {
+	if p.dirty != nil {
+		p.dirty.reset()
+	}
+}
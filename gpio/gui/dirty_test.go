@@ -0,0 +1,117 @@
+package gui
+
+import (
+	"math/rand"
+	"testing"
+)
+
+// covered 判断像素是否位于某个矩形内
+func covered(rs []Rect, x, y int) bool {
+	for _, r := range rs {
+		if x >= r.X0 && x < r.X1 && y >= r.Y0 && y < r.Y1 {
+			return true
+		}
+	}
+	return false
+}
+
+func TestDirtyRectsCoverChanges(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	for _, rotate := range []Rotate{Rotate0, Rotate90} {
+		p := NewPaint(240, 320, rotate, White)
+		p.SetImage(make([]Color, 240*320))
+		if rs := p.DirtyRects(0); len(rs) != 1 || rs[0] != (Rect{0, 0, p.Width, p.Height}) {
+			t.Fatalf("新建的绘制上下文脏区域 %v，应为整个区域", rs)
+		}
+		p.ClearDirty()
+		if p.IsDirty() || len(p.DirtyRects(0)) != 0 {
+			t.Fatal("ClearDirty 后仍有脏区域")
+		}
+		prev := make([]Color, len(p.Image))
+		colors := []Color{Red, Blue, Green}
+		for round := range 50 {
+			copy(prev, p.Image)
+			for range rng.Intn(40) + 1 {
+				p.SetPixel(rng.Intn(p.Width), rng.Intn(p.Height), colors[rng.Intn(3)])
+			}
+			x0, y0 := rng.Intn(p.Width-20), rng.Intn(p.Height-20)
+			p.DrawRectangle(x0, y0, x0+rng.Intn(20), y0+rng.Intn(20), colors[rng.Intn(3)], DotPixel1x1, DrawFillFull)
+			for _, cost := range []int{0, 64, 4096} {
+				rs := p.DirtyRects(cost)
+				for _, r := range rs {
+					if r.Empty() || r.X0 < 0 || r.Y0 < 0 || r.X1 > p.Width || r.Y1 > p.Height {
+						t.Fatalf("脏区域 %v 越界", r)
+					}
+				}
+				// 每个内容改变的像素都必须在脏区域内
+				for y := range p.Height {
+					for x := range p.Width {
+						xm, ym := p.transform(x, y)
+						i := ym*p.WidthMemory + xm
+						if p.Image[i] != prev[i] && !covered(rs, x, y) {
+							t.Fatalf("第 %d 轮 cost=%d: 像素 (%d,%d) 不在脏区域 %v 中", round, cost, x, y, rs)
+						}
+					}
+				}
+			}
+			p.ClearDirty()
+		}
+	}
+}
+
+func TestMergeRectsCostModel(t *testing.T) {
+	a := Rect{0, 0, 8, 8}
+	b := Rect{16, 0, 24, 8}
+	// 窗口开销小于间隙面积时保持分开
+	if rs := mergeRects([]Rect{a, b}, 32); len(rs) != 2 {
+		t.Fatalf("开销 32: %v", rs)
+	}
+	// 窗口开销不小于间隙面积时合并
+	if rs := mergeRects([]Rect{a, b}, 64); len(rs) != 1 || rs[0] != (Rect{0, 0, 24, 8}) {
+		t.Fatalf("开销 64: %v", rs)
+	}
+	// 相邻矩形即使没有开销也合并，被包含的矩形被移除
+	c := Rect{8, 0, 16, 8}
+	inner := Rect{2, 2, 4, 4}
+	if rs := mergeRects([]Rect{a, inner, c, b}, 0); len(rs) != 1 || rs[0] != (Rect{0, 0, 24, 8}) {
+		t.Fatalf("开销 0: %v", rs)
+	}
+}
+
+func TestDirtyMapRects(t *testing.T) {
+	d := newDirtyMap(100, 50)
+	d.markRect(Rect{0, 0, 20, 20})  // 块 0-2 x 0-2
+	d.markRect(Rect{40, 8, 41, 30}) // 块 5 x 1-3
+	d.mark(99, 49)
+	rs := d.rects(nil)
+	want := map[Rect]bool{
+		{0, 0, 24, 24}:    true,
+		{40, 8, 48, 32}:   true,
+		{96, 48, 100, 50}: true,
+	}
+	if len(rs) != len(want) {
+		t.Fatalf("rects = %v", rs)
+	}
+	for _, r := range rs {
+		if !want[r] {
+			t.Fatalf("rects = %v", rs)
+		}
+	}
+}
+
+func BenchmarkSetPixelDirty(b *testing.B) {
+	p := NewPaint(240, 320, Rotate0, White)
+	p.SetImage(make([]Color, 240*320))
+	b.Run("tracked", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			p.SetPixel(i%240, (i/240)%320, Red)
+		}
+	})
+	b.Run("untracked", func(b *testing.B) {
+		q := *p
+		q.dirty = nil
+		for i := 0; i < b.N; i++ {
+			q.SetPixel(i%240, (i/240)%320, Red)
+		}
+	})
+}
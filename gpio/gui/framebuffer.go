@@ -0,0 +1,38 @@
+package gui
+
+import (
+	"encoding/binary"
+	"unsafe"
+)
+
+// hostLittleEndian 主机是否为小端字节序，小端主机上面板字节序的像素需要交换字节
+var hostLittleEndian = binary.NativeEndian.Uint16([]byte{1, 0}) == 1
+
+// SetPanelByteOrder 设置图像缓冲区是否按面板字节序（RGB565 大端，高字节在前）存储像素
+// 开启后 PanelBytes 返回的字节可以原样发送给 ST7789 等面板，刷新时不需要逐像素转换。
+// 绘图函数、GetPixel 与 Clear 仍使用 Color 值，字节交换在写入像素时完成；
+// 直接读写 Image 的代码需要自行处理字节序。切换时已有的缓冲区内容按新的字节序转换。
+func (p *Paint) SetPanelByteOrder(enable bool) {
+	if swap := enable && hostLittleEndian; swap != p.swap {
+		for i, c := range p.Image {
+			p.Image[i] = c>>8 | c<<8
+		}
+		p.swap = swap
+	}
+	p.panelOrder = enable
+}
+
+// PanelByteOrder 判断图像缓冲区是否按面板字节序存储
+func (p *Paint) PanelByteOrder() bool {
+	return p.panelOrder
+}
+
+// PanelBytes 以字节切片返回内存缓冲区（WidthMemory x HeightMemory 个像素，按行排列）
+// 返回的切片与 Image 共享内存，不复制数据；没有开启面板字节序或没有图像缓冲区时返回 nil。
+func (p *Paint) PanelBytes() []byte {
+	n := p.WidthMemory * p.HeightMemory
+	if !p.panelOrder || n == 0 || len(p.Image) < n {
+		return nil
+	}
+	return unsafe.Slice((*byte)(unsafe.Pointer(&p.Image[0])), n*2)
+}
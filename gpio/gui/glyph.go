@@ -0,0 +1,314 @@
+package gui
+
+import (
+	"image"
+	"sync"
+
+	"golang.org/x/image/font"
+	"golang.org/x/image/math/fixed"
+)
+
+// 字形缓存与排版缓存的容量，超过时清空重建
+const (
+	glyphCacheMax  = 4096
+	layoutCacheMax = 512
+)
+
+// glyphSpan 字形中一行内连续的有覆盖像素
+type glyphSpan struct {
+	row, x0, x1 int  // 相对字形矩形左上角，x1 不包含
+	opaque      bool // 区间内的像素全部完全覆盖（alpha 为 255）
+}
+
+// glyph 缓存的字形：alpha 位图与按行预先提取的覆盖区间
+type glyph struct {
+	ok      bool
+	dr      image.Rectangle // 以字符单元左上角为原点（基线在 ascent 处）的目标矩形
+	advance fixed.Int26_6
+	alpha   []uint8 // dr.Dx() x dr.Dy()，有覆盖的像素至少为 1
+	spans   []glyphSpan
+}
+
+// glyphKey 字形缓存的键
+type glyphKey struct {
+	face font.Face
+	r    rune
+}
+
+// placedGlyph 排版结果中的一个字形，x、y 为字形矩形左上角相对排版原点的位置
+type placedGlyph struct {
+	g    *glyph
+	x, y int
+}
+
+// textLayout 缓存的字符串排版结果
+type textLayout struct {
+	glyphs     []placedGlyph
+	endX, endY int // 排版结束时的笔位置（相对原点）
+	width      int // 最宽一行的宽度
+	height     int // 总高度
+}
+
+// layoutKey 排版缓存的键，kern 区分按步进与字距排版（DrawText）和按字形宽度排版（DrawString）
+type layoutKey struct {
+	face font.Face
+	str  string
+	kern bool
+}
+
+// textCache 字形与排版缓存，所有 Paint 共享
+// 字体以 font.Face 接口值为键，因此字体的动态类型必须可比较（通常为指针）。
+type textCache struct {
+	mu      sync.Mutex
+	glyphs  map[glyphKey]*glyph
+	layouts map[layoutKey]*textLayout
+}
+
+var texts = textCache{
+	glyphs:  make(map[glyphKey]*glyph),
+	layouts: make(map[layoutKey]*textLayout),
+}
+
+// ResetGlyphCache 清空字形与排版缓存
+// 不再使用的字体仍被缓存引用，关闭或替换字体后调用以释放内存。
+func ResetGlyphCache() {
+	texts.mu.Lock()
+	clear(texts.glyphs)
+	clear(texts.layouts)
+	texts.mu.Unlock()
+}
+
+// glyph 返回缓存的字形，不存在时从字体光栅化，调用时必须持有 mu
+func (c *textCache) glyph(face font.Face, r rune) *glyph {
+	key := glyphKey{face, r}
+	if g := c.glyphs[key]; g != nil {
+		return g
+	}
+	if len(c.glyphs) >= glyphCacheMax {
+		clear(c.glyphs)
+		clear(c.layouts)
+	}
+	g := newGlyph(face, r)
+	c.glyphs[key] = g
+	return g
+}
+
+// newGlyph 光栅化字形：读取一次 alpha 掩码并提取每行的覆盖区间
+func newGlyph(face font.Face, r rune) *glyph {
+	ascent := face.Metrics().Ascent.Ceil()
+	dr, mask, maskp, advance, ok := face.Glyph(fixed.P(0, ascent), r) // 笔位置在第一行基线上
+	g := &glyph{ok: ok, dr: dr, advance: advance}
+	if !ok {
+		return g
+	}
+	w, h := dr.Dx(), dr.Dy()
+	g.alpha = make([]uint8, w*h)
+	am, _ := mask.(*image.Alpha)
+	for my := range h {
+		row := g.alpha[my*w : (my+1)*w]
+		for mx := range row {
+			if am != nil {
+				row[mx] = am.Pix[am.PixOffset(maskp.X+mx, maskp.Y+my)]
+			} else if _, _, _, a := mask.At(maskp.X+mx, maskp.Y+my).RGBA(); a > 0 {
+				row[mx] = uint8(max(a>>8, 1))
+			}
+		}
+		for mx := 0; mx < w; {
+			if row[mx] == 0 {
+				mx++
+				continue
+			}
+			s := glyphSpan{row: my, x0: mx, opaque: true}
+			for ; mx < w && row[mx] != 0; mx++ {
+				s.opaque = s.opaque && row[mx] == 0xFF
+			}
+			s.x1 = mx
+			g.spans = append(g.spans, s)
+		}
+	}
+	return g
+}
+
+// layout 返回缓存的排版结果
+// kern 为 false 时与 DrawString 逐字调用 DrawCharRune 相同：按字形矩形宽度前进，换行时下移上一个字形的高度；
+// kern 为 true 时按字形步进与字距前进，字形按基线对齐，换行时下移字体行高。
+func (c *textCache) layout(face font.Face, str string, kern bool) *textLayout {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	key := layoutKey{face, str, kern}
+	if l := c.layouts[key]; l != nil {
+		return l
+	}
+	if len(c.layouts) >= layoutCacheMax {
+		clear(c.layouts)
+	}
+	l := &textLayout{}
+	if kern {
+		lineHeight := face.Metrics().Height.Ceil()
+		var pen fixed.Int26_6
+		y := 0
+		prev := rune(-1)
+		for _, r := range str {
+			if r == '\n' {
+				l.width = max(l.width, pen.Ceil())
+				pen, y, prev = 0, y+lineHeight, -1
+				continue
+			}
+			if prev >= 0 {
+				pen += face.Kern(prev, r)
+			}
+			g := c.glyph(face, r)
+			if g.ok {
+				l.glyphs = append(l.glyphs, placedGlyph{g, pen.Round() + g.dr.Min.X, y + g.dr.Min.Y})
+			}
+			pen += g.advance
+			prev = r
+		}
+		l.endX, l.endY = pen.Round(), y
+		l.width = max(l.width, pen.Ceil())
+		l.height = y + lineHeight
+	} else {
+		x, y, dy := 0, 0, 0
+		for _, r := range str {
+			if r == '\n' {
+				x, y = 0, y+dy
+				continue
+			}
+			g := c.glyph(face, r)
+			dy = 0
+			if g.ok {
+				l.glyphs = append(l.glyphs, placedGlyph{g, x + g.dr.Min.X, y + g.dr.Min.Y})
+				x += g.dr.Dx()
+				dy = g.dr.Dy()
+				l.width = max(l.width, x)
+				l.height = max(l.height, y+dy)
+			}
+		}
+		l.endX, l.endY = x, y
+	}
+	c.layouts[key] = l
+	return l
+}
+
+// SetTextAntialias 设置文字是否按字形的 alpha 抗锯齿混合到 RGB565
+// 关闭时（默认）有覆盖的像素直接使用前景色，与原来的逐像素绘制相同。
+// 开启时部分覆盖的像素与背景色混合；背景色为 FontBackground 时与缓冲区中已有的像素混合。
+func (p *Paint) SetTextAntialias(enable bool) {
+	p.textAntialias = enable
+}
+
+// blend565 按 alpha（0-255）把前景色混合到背景色上
+// 三个通道展开到 32 位字的不同位段后一次乘法完成插值。
+func blend565(fg, bg Color, alpha uint8) Color {
+	const mask = 0x07E0F81F
+	a := (uint32(alpha) + 4) >> 3 // 0-32
+	f := (uint32(fg) | uint32(fg)<<16) & mask
+	b := (uint32(bg) | uint32(bg)<<16) & mask
+	c := (f*a + b*(32-a)) >> 5 & mask
+	return Color(c | c>>16)
+}
+
+// drawGlyph 在字形矩形左上角 (x, y) 处绘制缓存的字形
+// 背景色不是 FontBackground 时先用背景色填充字形矩形；覆盖区间按区间填充，
+// 抗锯齿时部分覆盖的像素逐个混合。字形矩形在缓冲区内时直接按内存步长写入，不逐像素变换坐标。
+func (p *Paint) drawGlyph(x, y int, g *glyph, bgColor, fgColor Color) {
+	w, h := g.dr.Dx(), g.dr.Dy()
+	x0, y0 := max(x, 0), max(y, 0)
+	x1, y1 := min(x+w, p.Width), min(y+h, p.Height)
+	if x0 >= x1 || y0 >= y1 {
+		return
+	}
+	opaqueBg := bgColor != FontBackground
+	if opaqueBg {
+		p.fillRect(x0, y0, x1, y1, bgColor)
+	}
+	base, xStep, yStep, ok := p.affine(x0, y0, x1, y1)
+	if !ok {
+		p.drawGlyphPixels(x, y, g, bgColor, fgColor)
+		return
+	}
+	if p.dirty != nil && len(g.spans) > 0 {
+		p.dirty.markRect(Rect{x0, y0, x1, y1})
+	}
+	fg := fgColor
+	if p.swap {
+		fg = fg>>8 | fg<<8
+	}
+	for _, s := range g.spans {
+		py := y + s.row
+		sx0, sx1 := max(x+s.x0, x0), min(x+s.x1, x1)
+		if py < y0 || py >= y1 || sx0 >= sx1 {
+			continue
+		}
+		i := base + (sx0-x0)*xStep + (py-y0)*yStep
+		if !p.textAntialias || s.opaque {
+			if xStep == 1 {
+				fillColors(p.Image[i:i+sx1-sx0], fg)
+			} else {
+				p.fillRun(i, sx1-sx0, xStep, fg)
+			}
+			continue
+		}
+		alpha := g.alpha[s.row*w:]
+		for px := sx0; px < sx1; px, i = px+1, i+xStep {
+			dst := bgColor
+			if !opaqueBg {
+				dst = p.Image[i]
+				if p.swap {
+					dst = dst>>8 | dst<<8
+				}
+			}
+			c := blend565(fgColor, dst, alpha[px-x])
+			if p.swap {
+				c = c>>8 | c<<8
+			}
+			p.Image[i] = c
+		}
+	}
+}
+
+// drawGlyphPixels 逐像素绘制字形的覆盖像素，用于显示回调函数或字形超出缓冲区的情况
+func (p *Paint) drawGlyphPixels(x, y int, g *glyph, bgColor, fgColor Color) {
+	w := g.dr.Dx()
+	for _, s := range g.spans {
+		py := y + s.row
+		if py < 0 || py >= p.Height {
+			continue
+		}
+		alpha := g.alpha[s.row*w:]
+		for mx := max(s.x0, -x); mx < s.x1 && x+mx < p.Width; mx++ {
+			if !p.textAntialias || s.opaque {
+				p.SetPixel(x+mx, py, fgColor)
+				continue
+			}
+			dst := bgColor
+			if bgColor == FontBackground {
+				dst = p.GetPixel(x+mx, py)
+			}
+			p.SetPixel(x+mx, py, blend565(fgColor, dst, alpha[mx]))
+		}
+	}
+}
+
+// drawLayout 在 (x, y) 处绘制排版结果
+func (p *Paint) drawLayout(x, y int, l *textLayout, bgColor, fgColor Color) {
+	for _, pg := range l.glyphs {
+		p.drawGlyph(x+pg.x, y+pg.y, pg.g, bgColor, fgColor)
+	}
+}
+
+// DrawText 使用字形步进与字距排版并绘制字符串，(x, y) 为第一行文字的左上角
+// 字形与排版结果都被缓存，重复绘制相同的字符串不再访问字体。'\n' 换行，行距为字体行高。
+// 返回值:
+//   - 结束时的笔位置，可用于继续绘制
+func (p *Paint) DrawText(x, y int, str string, face font.Face, bgColor, fgColor Color) (int, int) {
+	l := texts.layout(face, str, true)
+	p.drawLayout(x, y, l, bgColor, fgColor)
+	return x + l.endX, y + l.endY
+}
+
+// MeasureText 返回 DrawText 绘制字符串占用的宽度和高度
+func MeasureText(str string, face font.Face) (width, height int) {
+	l := texts.layout(face, str, true)
+	return l.width, l.height
+}
@@ -0,0 +1,269 @@
+package gui
+
+import (
+	"image"
+	"testing"
+
+	"golang.org/x/image/font"
+	"golang.org/x/image/math/fixed"
+)
+
+// testFace 测试用字体：每个字符的掩码是确定的 alpha 图案，包含未覆盖、部分覆盖与完全覆盖的像素
+// gray 为 true 时掩码使用 image.Gray（不是 image.Alpha），'?' 不在字体中，"AV" 有字距调整。
+type testFace struct {
+	gray bool
+}
+
+func (f *testFace) size(r rune) (w, h int) {
+	if r == ' ' {
+		return 0, 0
+	}
+	return 5 + int(r%3), 9
+}
+
+func (f *testFace) Close() error { return nil }
+
+func (f *testFace) Glyph(dot fixed.Point26_6, r rune) (image.Rectangle, image.Image, image.Point, fixed.Int26_6, bool) {
+	if r == '?' {
+		return image.Rectangle{}, nil, image.Point{}, 0, false
+	}
+	w, h := f.size(r)
+	x, y := int(dot.X>>6)+1, int(dot.Y>>6)-8
+	dr := image.Rect(x, y, x+w, y+h)
+	// 掩码原点不为 0，检查 maskp 的处理
+	mr := image.Rect(3, 2, 3+w, 2+h)
+	alpha := func(mx, my int) uint8 {
+		return uint8(min((mx*7+my*13+int(r))%5*64, 255))
+	}
+	advance, _ := f.GlyphAdvance(r)
+	if f.gray {
+		m := image.NewGray(mr)
+		for my := range h {
+			for mx := range w {
+				m.Pix[m.PixOffset(3+mx, 2+my)] = alpha(mx, my)
+			}
+		}
+		return dr, m, mr.Min, advance, true
+	}
+	m := image.NewAlpha(mr)
+	for my := range h {
+		for mx := range w {
+			m.Pix[m.PixOffset(3+mx, 2+my)] = alpha(mx, my)
+		}
+	}
+	return dr, m, mr.Min, advance, true
+}
+
+func (f *testFace) GlyphBounds(r rune) (fixed.Rectangle26_6, fixed.Int26_6, bool) {
+	advance, ok := f.GlyphAdvance(r)
+	return fixed.Rectangle26_6{}, advance, ok
+}
+
+func (f *testFace) GlyphAdvance(r rune) (fixed.Int26_6, bool) {
+	w, _ := f.size(r)
+	return fixed.I(w + 2), r != '?'
+}
+
+func (f *testFace) Kern(r0, r1 rune) fixed.Int26_6 {
+	if r0 == 'A' && r1 == 'V' {
+		return -fixed.I(2)
+	}
+	return 0
+}
+
+func (f *testFace) Metrics() font.Metrics {
+	return font.Metrics{Height: fixed.I(13), Ascent: fixed.I(10), Descent: fixed.I(3)}
+}
+
+// refDrawCharRune 缓存之前逐像素读取掩码的实现，作为对照
+// 原实现把 ascent<<6 传给 fixed.P（笔位置下移了 64 倍）并再加一次 ascent，这里按修正后的基线位置对照。
+func refDrawCharRune(p *Paint, x, y int, ch rune, face font.Face, bgColor, fgColor Color) (int, int) {
+	metrics := face.Metrics()
+	ascent := metrics.Ascent.Ceil()
+	dot := fixed.P(0, ascent)
+	dr, mask, maskp, _, ok := face.Glyph(dot, ch)
+	if !ok {
+		return 0, 0
+	}
+	for my := 0; my < dr.Dy(); my++ {
+		for mx := 0; mx < dr.Dx(); mx++ {
+			px := x + dr.Min.X + mx
+			py := y + dr.Min.Y + my
+			if px < 0 || px >= p.Width || py < 0 || py >= p.Height {
+				continue
+			}
+			_, _, _, a := mask.At(maskp.X+mx, maskp.Y+my).RGBA()
+			if a > 0 {
+				p.SetPixel(px, py, fgColor)
+			} else if bgColor != FontBackground {
+				p.SetPixel(px, py, bgColor)
+			}
+		}
+	}
+	return dr.Dx(), dr.Dy()
+}
+
+// refDrawString 缓存之前逐字调用 DrawCharRune 的实现，作为对照
+func refDrawString(p *Paint, x, y int, str string, face font.Face, bgColor, fgColor Color) (int, int) {
+	if x < 0 || x >= p.Width || y < 0 || y >= p.Height {
+		return x, y
+	}
+	xPos, yPos := x, y
+	var dx, dy int
+	for _, ch := range str {
+		if ch == '\n' {
+			xPos = x
+			yPos += dy
+		} else {
+			dx, dy = refDrawCharRune(p, xPos, yPos, ch, face, bgColor, fgColor)
+			xPos += dx
+		}
+	}
+	return xPos, yPos
+}
+
+func TestGlyphCacheMatchesReference(t *testing.T) {
+	defer ResetGlyphCache()
+	strs := []string{"12.345", "AV?x\nQ z", "-0.5\n\n7", "温度 23℃"}
+	for _, face := range []font.Face{&testFace{}, &testFace{gray: true}} {
+		for _, rotate := range []Rotate{Rotate0, Rotate90} {
+			for _, bg := range []Color{FontBackground, Blue} {
+				for _, str := range strs {
+					for _, pos := range [][2]int{{0, 0}, {3, 5}, {55, 30}} {
+						got := NewPaint(60, 40, rotate, Black)
+						want := NewPaint(60, 40, rotate, Black)
+						got.SetImage(make([]Color, 60*40))
+						want.SetImage(make([]Color, 60*40))
+						// 两次绘制：第二次使用缓存
+						for range 2 {
+							gx, gy := got.DrawString(pos[0], pos[1], str, face, bg, Red)
+							wx, wy := refDrawString(want, pos[0], pos[1], str, face, bg, Red)
+							if gx != wx || gy != wy {
+								t.Fatalf("%q 结束位置 (%d,%d)，期望 (%d,%d)", str, gx, gy, wx, wy)
+							}
+						}
+						for i := range want.Image {
+							if got.Image[i] != want.Image[i] {
+								t.Fatalf("%q 旋转 %d 背景 %#04x 位置 %v: 内存 (%d,%d) = %#04x，期望 %#04x",
+									str, rotate, bg, pos, i%60, i/60, got.Image[i], want.Image[i])
+							}
+						}
+					}
+				}
+			}
+		}
+		got := NewPaint(20, 20, Rotate0, Black)
+		got.SetImage(make([]Color, 400))
+		if dx, dy := got.DrawCharRune(-3, -4, 'W', face, Blue, Red); dx != 5 || dy != 9 {
+			t.Fatalf("DrawCharRune 返回 (%d,%d)", dx, dy)
+		}
+		if dx, dy := got.DrawCharRune(0, 0, '?', face, Blue, Red); dx != 0 || dy != 0 {
+			t.Fatalf("缺少的字符返回 (%d,%d)", dx, dy)
+		}
+	}
+}
+
+func TestDrawTextKerning(t *testing.T) {
+	defer ResetGlyphCache()
+	face := &testFace{}
+	advA, _ := face.GlyphAdvance('A')
+	advV, _ := face.GlyphAdvance('V')
+	if w, h := MeasureText("AV", face); w != (advA+advV).Ceil()-2 || h != 13 {
+		t.Fatalf("MeasureText = %d x %d", w, h)
+	}
+	if w, h := MeasureText("AV\nA", face); w != (advA+advV).Ceil()-2 || h != 26 {
+		t.Fatalf("两行 MeasureText = %d x %d", w, h)
+	}
+	got := NewPaint(40, 30, Rotate0, Black)
+	want := NewPaint(40, 30, Rotate0, Black)
+	got.SetImage(make([]Color, 40*30))
+	want.SetImage(make([]Color, 40*30))
+	if x, y := got.DrawText(2, 3, "AV\nV", face, FontBackground, Red); x != 2+advV.Round() || y != 16 {
+		t.Fatalf("DrawText 结束于 (%d,%d)", x, y)
+	}
+	x, _ := want.DrawText(2, 3, "A", face, FontBackground, Red)
+	want.DrawText(x-2, 3, "V", face, FontBackground, Red)
+	want.DrawText(2, 16, "V", face, FontBackground, Red)
+	for i := range want.Image {
+		if got.Image[i] != want.Image[i] {
+			t.Fatalf("内存 (%d,%d) = %#04x，期望 %#04x", i%40, i/40, got.Image[i], want.Image[i])
+		}
+	}
+}
+
+func TestBlend565(t *testing.T) {
+	cases := []struct {
+		fg, bg Color
+		a      uint8
+		want   Color
+	}{
+		{White, Black, 255, White},
+		{White, Black, 0, Black},
+		{Red, Blue, 255, Red},
+		{Red, Blue, 0, Blue},
+		{White, Black, 128, 0x7BEF}, // 各通道一半（向下取整）
+		{Green, Red, 128, 0x7BE0},
+	}
+	for _, c := range cases {
+		if got := blend565(c.fg, c.bg, c.a); got != c.want {
+			t.Errorf("blend565(%#04x, %#04x, %d) = %#04x，期望 %#04x", c.fg, c.bg, c.a, got, c.want)
+		}
+	}
+}
+
+func TestTextAntialias(t *testing.T) {
+	defer ResetGlyphCache()
+	face := &testFace{}
+	for i, bg := range []Color{FontBackground, Blue, FontBackground, Blue} {
+		p := NewPaint(20, 20, []Rotate{Rotate0, Rotate90}[i/2], Black)
+		p.SetImage(make([]Color, 400))
+		p.SetPanelByteOrder(i >= 2)
+		p.Clear(Green)
+		p.SetTextAntialias(true)
+		p.DrawCharRune(0, 0, 'W', face, bg, White)
+		dr, mask, maskp, _, _ := face.Glyph(fixed.P(0, 10), 'W')
+		dst := bg
+		if bg == FontBackground {
+			dst = Green
+		}
+		for my := range dr.Dy() {
+			for mx := range dr.Dx() {
+				_, _, _, a := mask.At(maskp.X+mx, maskp.Y+my).RGBA()
+				want := dst
+				if a > 0 {
+					want = blend565(White, dst, uint8(a>>8))
+				}
+				if got := p.GetPixel(dr.Min.X+mx, dr.Min.Y+my); got != want {
+					t.Fatalf("背景 %#04x 像素 (%d,%d) alpha %d = %#04x，期望 %#04x", bg, mx, my, a>>8, got, want)
+				}
+			}
+		}
+	}
+}
+
+// BenchmarkDrawFloatNum 比较逐像素读取掩码（ref）与字形缓存（cached）绘制数值读数
+func BenchmarkDrawFloatNum(b *testing.B) {
+	face := &testFace{}
+	p := NewPaint(240, 320, Rotate0, White)
+	p.SetImage(make([]Color, 240*320))
+	b.Run("ref", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			refDrawString(p, 10, 10, "1234.56", face, Blue, White)
+		}
+	})
+	b.Run("cached", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			p.DrawFloatNum(10, 10, 1234.56, 2, face, Blue, White)
+		}
+	})
+	b.Run("cached-aa", func(b *testing.B) {
+		p.SetTextAntialias(true)
+		defer p.SetTextAntialias(false)
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			p.DrawFloatNum(10, 10, 1234.56, 2, face, FontBackground, White)
+		}
+	})
+}
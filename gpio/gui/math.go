@@ -85,6 +85,26 @@ func (m Mat4) TransformVec3(v Vec3) Vec3 {
 	return Vec3{X: x, Y: y, Z: z}
 }
 
+// TransformBatch 批量把顶点变换到齐次坐标，不做透视除法
+// 顶点按数组结构体（SoA）存储：xs、ys、zs 为输入坐标，ox、oy、oz、ow 为输出，长度都不小于 len(xs)。
+// 与逐个调用 TransformVec3 相比，矩阵元素只加载一次，每个分量的循环顺序访问连续内存。
+func (m Mat4) TransformBatch(xs, ys, zs, ox, oy, oz, ow []float64) {
+	n := len(xs)
+	ys, zs = ys[:n], zs[:n]
+	ox, oy, oz, ow = ox[:n], oy[:n], oz[:n], ow[:n]
+	m0, m1, m2, m3 := m[0], m[1], m[2], m[3]
+	m4, m5, m6, m7 := m[4], m[5], m[6], m[7]
+	m8, m9, m10, m11 := m[8], m[9], m[10], m[11]
+	m12, m13, m14, m15 := m[12], m[13], m[14], m[15]
+	for i, x := range xs {
+		y, z := ys[i], zs[i]
+		ox[i] = m0*x + m1*y + m2*z + m3
+		oy[i] = m4*x + m5*y + m6*z + m7
+		oz[i] = m8*x + m9*y + m10*z + m11
+		ow[i] = m12*x + m13*y + m14*z + m15
+	}
+}
+
 // NewIdentityMat4 创建单位矩阵
 func NewIdentityMat4() Mat4 {
 	return Mat4{
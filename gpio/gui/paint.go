@@ -5,10 +5,8 @@ import (
 	"errors"
 	"fmt"
 	"math"
-	"sort"
 
 	"golang.org/x/image/font"
-	"golang.org/x/image/math/fixed"
 )
 
 // Color 表示16位RGB565颜色。
@@ -131,6 +129,14 @@ type Paint struct {
 	// 回调函数
 	clearFunc   func(Color)
 	displayFunc func(int, int, Color)
+	// 已修改区域（可见区域坐标），由 NewPaint 创建
+	dirty *dirtyMap
+	// 图像缓冲区按面板字节序（RGB565 大端）存储，见 SetPanelByteOrder
+	panelOrder bool
+	// 小端主机上的面板字节序，读写像素时需要交换字节
+	swap bool
+	// 文字抗锯齿，见 SetTextAntialias
+	textAntialias bool
 }
 
 // PaintTime 表示用于绘制时间的时间结构。
@@ -162,6 +168,9 @@ func NewPaint(width, height int, rotate Rotate, color Color) *Paint {
 		p.Width = height
 		p.Height = width
 	}
+	// 屏幕内容未知，第一次刷新需要整个区域
+	p.dirty = newDirtyMap(p.Width, p.Height)
+	p.dirty.markRect(Rect{0, 0, p.Width, p.Height})
 	return p
 }
 
@@ -198,6 +207,9 @@ func (p *Paint) SetRotate(rotate Rotate) error {
 			p.Width = p.HeightMemory
 			p.Height = p.WidthMemory
 		}
+		// 可见坐标系改变，整个区域都需要重新刷新
+		p.dirty = newDirtyMap(p.Width, p.Height)
+		p.dirty.markRect(Rect{0, 0, p.Width, p.Height})
 		return nil
 	default:
 		return errors.New("rotate must be Rotate0, Rotate90, Rotate180, or Rotate270")
@@ -251,6 +263,9 @@ func (p *Paint) SetPixel(x, y int, color Color) {
 	if xm < 0 || xm >= p.WidthMemory || ym < 0 || ym >= p.HeightMemory {
 		return
 	}
+	if p.dirty != nil {
+		p.dirty.mark(x, y)
+	}
 	// 如果有显示回调函数，则使用它
 	if p.displayFunc != nil {
 		p.displayFunc(xm, ym, color)
@@ -259,18 +274,41 @@ func (p *Paint) SetPixel(x, y int, color Color) {
 	if p.Image != nil {
 		index := ym*p.WidthMemory + xm
 		if index < len(p.Image) {
+			if p.swap {
+				color = color>>8 | color<<8
+			}
 			p.Image[index] = color
 		}
 	}
 }
 
+// GetPixel 返回可见区域(x, y)位置的像素颜色，越界或没有图像缓冲区时返回 Black。
+func (p *Paint) GetPixel(x, y int) Color {
+	if x < 0 || x >= p.Width || y < 0 || y >= p.Height || p.Image == nil {
+		return Black
+	}
+	xm, ym := p.transform(x, y)
+	if xm < 0 || xm >= p.WidthMemory || ym < 0 || ym >= p.HeightMemory {
+		return Black
+	}
+	c := p.Image[ym*p.WidthMemory+xm]
+	if p.swap {
+		c = c>>8 | c<<8
+	}
+	return c
+}
+
 // Clear 使用给定颜色清除整个显示。
 func (p *Paint) Clear(color Color) {
+	p.MarkDirty(0, 0, p.Width, p.Height)
 	if p.clearFunc != nil {
 		p.clearFunc(color)
 	}
 	// 如果存在图像缓冲区，也清除它
 	if p.Image != nil {
+		if p.swap {
+			color = color>>8 | color<<8
+		}
 		for i := range p.Image {
 			p.Image[i] = color
 		}
@@ -279,11 +317,7 @@ func (p *Paint) Clear(color Color) {
 
 // ClearWindow 使用给定颜色清除一个矩形窗口。
 func (p *Paint) ClearWindow(xStart, yStart, xEnd, yEnd int, color Color) {
-	for y := yStart; y < yEnd; y++ {
-		for x := xStart; x < xEnd; x++ {
-			p.SetPixel(x, y, color)
-		}
-	}
+	p.fillRect(xStart, yStart, xEnd, yEnd, color)
 }
 
 // DrawPoint 使用给定颜色、点大小和填充样式在(x, y)位置绘制一个点。
@@ -295,25 +329,10 @@ func (p *Paint) DrawPoint(x, y int, color Color, dotPixel DotPixel, dotStyle Dot
 	if dotStyle == DotFillAround {
 		// 围绕中心点绘制，对于dotPixel=1，只绘制中心点
 		offset := int(dotPixel) - 1
-		for xd := 0; xd < 2*int(dotPixel)-1; xd++ {
-			for yd := 0; yd < 2*int(dotPixel)-1; yd++ {
-				px := x + xd - offset
-				py := y + yd - offset
-				if px < 0 || py < 0 {
-					continue
-				}
-				p.SetPixel(px, py, color)
-			}
-		}
+		p.fillRect(x-offset, y-offset, x+offset+1, y+offset+1, color)
 	} else { // DotFillRightUp 填充样式
 		// 向右和向上扩展，对于dotPixel=1，绘制在(x,y)
-		for xd := 0; xd < int(dotPixel); xd++ {
-			for yd := 0; yd < int(dotPixel); yd++ {
-				px := x + xd
-				py := y + yd
-				p.SetPixel(px, py, color)
-			}
-		}
+		p.fillRect(x, y, x+int(dotPixel), y+int(dotPixel), color)
 	}
 }
 
@@ -324,6 +343,18 @@ func (p *Paint) DrawLine(xStart, yStart, xEnd, yEnd int, color Color, lineWidth
 		// 超出可见区域
 		return
 	}
+	if lineStyle == LineStyleSolid && lineWidth >= DotPixel1x1 {
+		switch {
+		case xStart == xEnd || yStart == yEnd:
+			// 水平或垂直的粗线是一个矩形
+			o := int(lineWidth) - 1
+			p.fillRect(min(xStart, xEnd)-o, min(yStart, yEnd)-o, max(xStart, xEnd)+o+1, max(yStart, yEnd)+o+1, color)
+			return
+		case lineWidth > DotPixel1x1:
+			p.thickLine(xStart, yStart, xEnd, yEnd, color, lineWidth)
+			return
+		}
+	}
 	x := xStart
 	y := yStart
 	dx := xEnd - xStart
@@ -351,6 +382,8 @@ func (p *Paint) DrawLine(xStart, yStart, xEnd, yEnd int, color Color, lineWidth
 		if lineStyle == LineStyleDotted && dottedLen%3 == 0 {
 			dottedLen = 0
 			// 虚线间隔：跳过此像素
+		} else if lineWidth == DotPixel1x1 {
+			p.SetPixel(x, y, color)
 		} else {
 			p.DrawPoint(x, y, color, lineWidth, DotFillAround)
 		}
@@ -377,8 +410,10 @@ func (p *Paint) DrawRectangle(xStart, yStart, xEnd, yEnd int, color Color, lineW
 		return
 	}
 	if filled == DrawFillFull {
-		for y := yStart; y < yEnd; y++ {
-			p.DrawLine(xStart, y, xEnd, y, color, lineWidth, LineStyleSolid)
+		// 每行画一条粗线，合起来是一个矩形
+		if yStart < yEnd && lineWidth >= DotPixel1x1 {
+			o := int(lineWidth) - 1
+			p.fillRect(min(xStart, xEnd)-o, yStart-o, max(xStart, xEnd)+o+1, yEnd+o, color)
 		}
 	} else {
 		p.DrawLine(xStart, yStart, xEnd, yStart, color, lineWidth, LineStyleSolid)
@@ -400,17 +435,26 @@ func (p *Paint) DrawCircle(xCenter, yCenter, radius int, color Color, lineWidth
 	// 累积误差
 	esp := 3 - (radius << 1)
 	if fill == DrawFillFull {
+		if radius < 0 {
+			return
+		}
+		// 中点圆算法的每一步 (x, y) 覆盖 |dy| 在 [x, y] 内的行中 |dx| <= x 的部分，
+		// 以及 |dy| = x 的行中 |dx| <= y 的部分；先求出每行的半宽，再逐行填充
+		var buf [256]int
+		half := buf[:0]
+		if radius < len(buf) {
+			half = buf[:radius+1]
+		} else {
+			half = make([]int, radius+1)
+		}
+		for i := range half {
+			half[i] = -1
+		}
 		for xCurrent <= yCurrent {
-			for sCountY := xCurrent; sCountY <= yCurrent; sCountY++ {
-				p.DrawPoint(xCenter+xCurrent, yCenter+sCountY, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter-xCurrent, yCenter+sCountY, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter-sCountY, yCenter+xCurrent, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter-sCountY, yCenter-xCurrent, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter-xCurrent, yCenter-sCountY, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter+xCurrent, yCenter-sCountY, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter+sCountY, yCenter-xCurrent, color, DotPixel1x1, DotFillAround)
-				p.DrawPoint(xCenter+sCountY, yCenter+xCurrent, color, DotPixel1x1, DotFillAround)
+			for d := xCurrent; d <= yCurrent; d++ {
+				half[d] = max(half[d], xCurrent)
 			}
+			half[xCurrent] = max(half[xCurrent], yCurrent)
 			if esp < 0 {
 				esp += 4*xCurrent + 6
 			} else {
@@ -419,6 +463,15 @@ func (p *Paint) DrawCircle(xCenter, yCenter, radius int, color Color, lineWidth
 			}
 			xCurrent++
 		}
+		for d, w := range half {
+			if w < 0 {
+				continue
+			}
+			p.fillSpan(xCenter-w, xCenter+w+1, yCenter+d, color)
+			if d > 0 {
+				p.fillSpan(xCenter-w, xCenter+w+1, yCenter-d, color)
+			}
+		}
 	} else { // 空心圆
 		for xCurrent <= yCurrent {
 			p.DrawPoint(xCenter+xCurrent, yCenter+yCurrent, color, lineWidth, DotFillAround)
@@ -516,57 +569,29 @@ func (p *Paint) DrawNum(x, y int, num int32, face font.Face, bgColor, fgColor Co
 }
 
 // DrawString 使用DrawCharRune绘制字符串
+// 排版结果按 (字体, 字符串) 缓存，结果与逐字调用 DrawCharRune 相同。
 func (p *Paint) DrawString(x, y int, str string, face font.Face, bgColor, fgColor Color) (int, int) {
 	if x < 0 || x >= p.Width || y < 0 || y >= p.Height {
 		return x, y
 	}
-	xPos := x
-	yPos := y
-	var dx, dy int
-	dy = 0 // 显式初始化，确保换行前有有效值
-	for _, ch := range str {
-		if ch == '\n' {
-			xPos = x
-			yPos += dy
-		} else {
-			dx, dy = p.DrawCharRune(xPos, yPos, ch, face, bgColor, fgColor)
-			xPos += dx
-		}
-	}
-	return xPos, yPos
+	l := texts.layout(face, str, false)
+	p.drawLayout(x, y, l, bgColor, fgColor)
+	return x + l.endX, y + l.endY
 }
 
 // DrawCharRune 渲染字符
+// 字形的 alpha 位图与每行的覆盖区间按 (字体, 字符) 缓存，只在第一次绘制时访问字体。
+// 返回值为字形矩形的宽度和高度，字体中没有该字符时返回 0, 0。
 func (p *Paint) DrawCharRune(x, y int, ch rune, face font.Face, bgColor, fgColor Color) (int, int) {
-	// 获取字体度量
-	metrics := face.Metrics()
-	ascent := metrics.Ascent.Ceil()
-	// 计算基线位置
-	baseY := ascent
-	// 获取字形（dot 坐标为 26.6 定点数，64 单位 = 1 像素）
-	dot := fixed.P(0, baseY<<6)
-	dr, mask, maskp, _, ok := face.Glyph(dot, ch)
-	if !ok {
+	texts.mu.Lock()
+	g := texts.glyph(face, ch)
+	texts.mu.Unlock()
+	if !g.ok {
 		return 0, 0
 	}
-	// 遍历字形掩码的像素
-	for my := 0; my < dr.Dy(); my++ {
-		for mx := 0; mx < dr.Dx(); mx++ {
-			px := x + dr.Min.X + mx
-			py := y + baseY + dr.Min.Y + my
-			if px < 0 || px >= p.Width || py < 0 || py >= p.Height {
-				continue
-			}
-			// 获取掩码像素的alpha值
-			_, _, _, a := mask.At(maskp.X+mx, maskp.Y+my).RGBA()
-			if a > 0 {
-				p.SetPixel(px, py, fgColor)
-			} else if bgColor != FontBackground {
-				p.SetPixel(px, py, bgColor)
-			}
-		}
-	}
-	return dr.Dx(), dr.Dy()
+	// (x, y) 为字符单元左上角，基线在 y+ascent 处
+	p.drawGlyph(x+g.dr.Min.X, y+g.dr.Min.Y, g, bgColor, fgColor)
+	return g.dr.Dx(), g.dr.Dy()
 }
 
 // DrawRoundRect 绘制圆角矩形
@@ -596,18 +621,18 @@ func (p *Paint) DrawRoundRect(xStart, yStart, xEnd, yEnd, radius int, color Colo
 		// 填充整个圆角矩形
 		// 填充中心矩形区域
 		for y := yStart + radius; y < yEnd-radius; y++ {
-			p.DrawLine(xStart, y, xEnd, y, color, lineWidth, LineStyleSolid)
+			p.hLine(xStart, xEnd, y, color, lineWidth)
 		}
 		// 填充四个边角区域（使用半圆填充）
 		// 左上角
 		for dy := 0; dy < radius; dy++ {
 			dx := int(math.Sqrt(float64(radius*radius - dy*dy)))
-			p.DrawLine(xStart+radius-dx, yStart+dy, xEnd-radius+dx, yStart+dy, color, lineWidth, LineStyleSolid)
+			p.hLine(xStart+radius-dx, xEnd-radius+dx, yStart+dy, color, lineWidth)
 		}
 		// 左下角
 		for dy := 0; dy < radius; dy++ {
 			dx := int(math.Sqrt(float64(radius*radius - dy*dy)))
-			p.DrawLine(xStart+radius-dx, yEnd-radius+dy, xEnd-radius+dx, yEnd-radius+dy, color, lineWidth, LineStyleSolid)
+			p.hLine(xStart+radius-dx, xEnd-radius+dx, yEnd-radius+dy, color, lineWidth)
 		}
 	} else {
 		// 绘制圆角矩形的边框
@@ -781,11 +806,17 @@ func (p *Paint) DrawTriangle(x1, y1, x2, y2, x3, y3 int, color Color, lineWidth
 // fillTriangle 使用扫描线算法填充三角形
 func (p *Paint) fillTriangle(x1, y1, x2, y2, x3, y3 int, color Color) {
 	// 将三个顶点按y坐标排序
-	vertices := []struct{ x, y int }{{x1, y1}, {x2, y2}, {x3, y3}}
-	sort.Slice(vertices, func(i, j int) bool {
-		return vertices[i].y < vertices[j].y
-	})
-	v0, v1, v2 := vertices[0], vertices[1], vertices[2]
+	type vertex struct{ x, y int }
+	v0, v1, v2 := vertex{x1, y1}, vertex{x2, y2}, vertex{x3, y3}
+	if v1.y < v0.y {
+		v0, v1 = v1, v0
+	}
+	if v2.y < v1.y {
+		v1, v2 = v2, v1
+		if v1.y < v0.y {
+			v0, v1 = v1, v0
+		}
+	}
 	// 整个三角形的高度
 	totalHeight := v2.y - v0.y
 	if totalHeight == 0 {
@@ -793,9 +824,7 @@ func (p *Paint) fillTriangle(x1, y1, x2, y2, x3, y3 int, color Color) {
 		// 绘制水平线
 		minX := min(v2.x, min(v1.x, v0.x))
 		maxX := max(v2.x, max(v1.x, v0.x))
-		for x := minX; x <= maxX; x++ {
-			p.SetPixel(x, v0.y, color)
-		}
+		p.fillSpan(minX, maxX+1, v0.y, color)
 		return
 	}
 	// 扫描上半部分（v0到v1）
@@ -813,9 +842,7 @@ func (p *Paint) fillTriangle(x1, y1, x2, y2, x3, y3 int, color Color) {
 		if startX > endX {
 			startX, endX = endX, startX
 		}
-		for x := startX; x <= endX; x++ {
-			p.SetPixel(x, y, color)
-		}
+		p.fillSpan(startX, endX+1, y, color)
 	}
 	// 扫描下半部分（v1到v2）
 	for y := v1.y; y <= v2.y; y++ {
@@ -832,9 +859,7 @@ func (p *Paint) fillTriangle(x1, y1, x2, y2, x3, y3 int, color Color) {
 		if startX > endX {
 			startX, endX = endX, startX
 		}
-		for x := startX; x <= endX; x++ {
-			p.SetPixel(x, y, color)
-		}
+		p.fillSpan(startX, endX+1, y, color)
 	}
 }
 
@@ -912,17 +937,20 @@ func (p *Paint) fillPolygon(points [][2]int, color Color) {
 			aet = append(aet, et[y-minY]...)
 		}
 		// 从AET中移除yMax等于当前y的边
-		newAet := make([]edge, 0, len(aet))
+		n := 0
 		for _, e := range aet {
 			if e.yMax > y {
-				newAet = append(newAet, e)
+				aet[n] = e
+				n++
+			}
+		}
+		aet = aet[:n]
+		// 按当前x排序（相邻扫描线间顺序变化很小，插入排序）
+		for i := 1; i < len(aet); i++ {
+			for j := i; j > 0 && aet[j].x < aet[j-1].x; j-- {
+				aet[j], aet[j-1] = aet[j-1], aet[j]
 			}
 		}
-		aet = newAet
-		// 按当前x排序
-		sort.Slice(aet, func(i, j int) bool {
-			return aet[i].x < aet[j].x
-		})
 		// 填充扫描线
 		for i := 0; i < len(aet); i += 2 {
 			if i+1 >= len(aet) {
@@ -933,9 +961,7 @@ func (p *Paint) fillPolygon(points [][2]int, color Color) {
 			if startX > endX {
 				startX, endX = endX, startX
 			}
-			for x := startX; x <= endX; x++ {
-				p.SetPixel(x, y, color)
-			}
+			p.fillSpan(startX, endX+1, y, color)
 		}
 		// 更新AET中边的x值
 		for i := range aet {
@@ -0,0 +1,393 @@
+package gui
+
+import "math"
+
+// CullMode 背面剔除模式
+// 投影到屏幕后顶点按逆时针排列（y 轴向上，与 OpenGL 相同）的三角形为正面。
+type CullMode int
+
+const (
+	CullBack  CullMode = iota // 剔除背面（默认）
+	CullNone                  // 不剔除
+	CullFront                 // 剔除正面
+)
+
+// ShadeMode 着色模式
+type ShadeMode int
+
+const (
+	ShadeNone    ShadeMode = iota // 直接使用三角形颜色，不计算光照（默认）
+	ShadeFlat                     // 按面法线计算一次光照，整个三角形同一颜色
+	ShadeGouraud                  // 按顶点法线计算光照，在三角形内透视校正插值
+)
+
+// subpixel 屏幕坐标对齐的子像素精度，对齐后边函数的计算是精确的，共享边的像素不重复也不遗漏
+const subpixel = 16
+
+// clipVert 齐次裁剪坐标中的顶点，i 为顶点光照强度
+type clipVert struct {
+	x, y, z, w, i float64
+}
+
+// screenVert 屏幕坐标中的顶点：像素坐标、深度（0 为近平面，1 为远平面）、i/w 与 1/w
+type screenVert struct {
+	x, y, z, iw, rw float64
+}
+
+// SetCullMode 设置背面剔除模式
+func (r *Renderer3D) SetCullMode(mode CullMode) {
+	r.cull = mode
+}
+
+// SetShading 设置着色模式
+func (r *Renderer3D) SetShading(mode ShadeMode) {
+	r.shade = mode
+}
+
+// SetLight 设置平行光
+// 参数:
+//   - dir: 指向光源的方向（世界坐标），不需要归一化
+//   - ambient: 环境光强度 0-1，背光面的亮度
+func (r *Renderer3D) SetLight(dir Vec3, ambient float64) {
+	r.light = dir.Normalize()
+	r.ambient = min(max(ambient, 0), 1)
+}
+
+// SetDepthTest 设置是否进行深度测试
+// 关闭后三角形按绘制顺序覆盖，与画家算法相同。
+func (r *Renderer3D) SetDepthTest(enable bool) {
+	r.depthTest = enable
+}
+
+// ClearDepth 清空深度缓冲区
+// Clear 会同时清空深度缓冲区；只清除部分画面时需要单独调用。
+func (r *Renderer3D) ClearDepth() {
+	if n := r.screenW * r.screenH; len(r.depth) != n {
+		r.depth = make([]float32, n)
+	}
+	for i := range r.depth {
+		r.depth[i] = math.MaxFloat32
+	}
+}
+
+// mvp 返回模型-视图-投影矩阵
+func (r *Renderer3D) mvp() Mat4 {
+	return r.projMat.Mul(r.viewMat).Mul(r.modelMat)
+}
+
+// transformClip 用矩阵把顶点变换到齐次裁剪坐标，不做透视除法
+func (m Mat4) transformClip(v Vec3) clipVert {
+	return clipVert{
+		x: m[0]*v.X + m[1]*v.Y + m[2]*v.Z + m[3],
+		y: m[4]*v.X + m[5]*v.Y + m[6]*v.Z + m[7],
+		z: m[8]*v.X + m[9]*v.Y + m[10]*v.Z + m[11],
+		w: m[12]*v.X + m[13]*v.Y + m[14]*v.Z + m[15],
+	}
+}
+
+// transformDir 用矩阵的线性部分变换方向向量（法线），假定模型变换没有非均匀缩放
+func (m Mat4) transformDir(v Vec3) Vec3 {
+	return Vec3{
+		X: m[0]*v.X + m[1]*v.Y + m[2]*v.Z,
+		Y: m[4]*v.X + m[5]*v.Y + m[6]*v.Z,
+		Z: m[8]*v.X + m[9]*v.Y + m[10]*v.Z,
+	}
+}
+
+// lighting 返回法线（世界坐标）的漫反射光照强度
+func (r *Renderer3D) lighting(n Vec3) float64 {
+	d := n.Normalize().Dot(r.light)
+	return r.ambient + (1-r.ambient)*max(d, 0)
+}
+
+// shade565 按光照强度（0-1）调整颜色亮度
+func shade565(c Color, i float64) Color {
+	return blend565(c, Black, uint8(min(max(i, 0), 1)*255+0.5))
+}
+
+// faceNormal 返回三角形的法线（未归一化），顶点逆时针排列时指向观察者
+func faceNormal(v0, v1, v2 Vec3) Vec3 {
+	return v1.Sub(v0).Cross(v2.Sub(v0))
+}
+
+// vertexNormals 按共享位置的顶点平均相邻面的法线（按面积加权），用于 Gouraud 着色
+func vertexNormals(faces []Triangle3D) map[Vec3]Vec3 {
+	normals := make(map[Vec3]Vec3, len(faces)*3/2)
+	for _, f := range faces {
+		n := faceNormal(f.V0, f.V1, f.V2)
+		normals[f.V0] = normals[f.V0].Add(n)
+		normals[f.V1] = normals[f.V1].Add(n)
+		normals[f.V2] = normals[f.V2].Add(n)
+	}
+	return normals
+}
+
+// screenTri 裁剪、投影并通过剔除的屏幕三角形
+type screenTri struct {
+	v       [3]screenVert
+	color   Color
+	gouraud bool
+}
+
+// shadeTriangle 计算三角形的光照：平面着色时返回调整亮度后的颜色，Gouraud 着色时把顶点光照强度写入 v
+// normals 为 Gouraud 着色使用的模型坐标顶点法线，nil 时使用面法线。
+func (r *Renderer3D) shadeTriangle(t Triangle3D, normals *[3]Vec3, v *[3]clipVert) (Color, bool) {
+	switch r.shade {
+	case ShadeFlat:
+		return shade565(t.Color, r.lighting(r.modelMat.transformDir(faceNormal(t.V0, t.V1, t.V2)))), false
+	case ShadeGouraud:
+		if normals == nil {
+			return shade565(t.Color, r.lighting(r.modelMat.transformDir(faceNormal(t.V0, t.V1, t.V2)))), false
+		}
+		for k := range v {
+			v[k].i = r.lighting(r.modelMat.transformDir(normals[k]))
+		}
+		return t.Color, true
+	}
+	return t.Color, false
+}
+
+// assemble 裁剪、投影并剔除裁剪空间中的三角形，把得到的屏幕三角形按扇形顺序追加到 out
+func (r *Renderer3D) assemble(v *[3]clipVert, color Color, gouraud bool, out []screenTri) []screenTri {
+	var poly, tmp [9]clipVert
+	copy(poly[:], v[:])
+	n := 3
+	if !insideClip(v[0]) || !insideClip(v[1]) || !insideClip(v[2]) {
+		n = clipPolygon(&poly, &tmp, n)
+	}
+	if n < 3 {
+		return out
+	}
+	var s [9]screenVert
+	for k := range n {
+		if poly[k].w <= 0 {
+			return out
+		}
+		s[k] = r.toScreen(poly[k])
+	}
+	for k := 1; k+1 < n; k++ {
+		if !r.culled(s[0], s[k], s[k+1]) {
+			out = append(out, screenTri{[3]screenVert{s[0], s[k], s[k+1]}, color, gouraud})
+		}
+	}
+	return out
+}
+
+// drawTriangle 光照、裁剪、剔除并光栅化一个三角形
+func (r *Renderer3D) drawTriangle(mvp Mat4, t Triangle3D, normals *[3]Vec3) {
+	v := [3]clipVert{mvp.transformClip(t.V0), mvp.transformClip(t.V1), mvp.transformClip(t.V2)}
+	color, gouraud := r.shadeTriangle(t, normals, &v)
+	var buf [7]screenTri
+	tris := r.assemble(&v, color, gouraud, buf[:0])
+	if len(tris) == 0 {
+		return
+	}
+	target := rasterTarget{paint: r.paint, x0: 0, y0: 0, x1: r.screenW, y1: r.screenH}
+	if r.depthTest {
+		if len(r.depth) != r.screenW*r.screenH {
+			r.ClearDepth()
+		}
+		target.depth = r.depth
+	}
+	for i := range tris {
+		target.triangle(&tris[i])
+	}
+	if target.drawn && r.paint.dirty != nil {
+		r.paint.dirty.markRect(target.bounds)
+	}
+}
+
+// toScreen 透视除法后把顶点映射到屏幕坐标，坐标对齐到子像素网格
+func (r *Renderer3D) toScreen(v clipVert) screenVert {
+	rw := 1 / v.w
+	x := (v.x*rw + 1) * float64(r.screenW) / 2
+	y := (1 - v.y*rw) * float64(r.screenH) / 2 // Y轴翻转
+	return screenVert{
+		x:  math.Round(x*subpixel) / subpixel,
+		y:  math.Round(y*subpixel) / subpixel,
+		z:  v.z*rw*0.5 + 0.5,
+		iw: v.i * rw,
+		rw: rw,
+	}
+}
+
+// culled 判断屏幕三角形是否被剔除，退化的三角形总是被剔除
+func (r *Renderer3D) culled(a, b, c screenVert) bool {
+	// 屏幕 y 轴向下，正面（投影后逆时针）的有向面积为负
+	area := edgeFunc(a, b, c.x, c.y)
+	switch r.cull {
+	case CullBack:
+		return area >= 0
+	case CullFront:
+		return area <= 0
+	}
+	return area == 0
+}
+
+// clipDist 顶点到裁剪空间第 plane 个平面的有向距离，非负时在平面内
+func clipDist(v clipVert, plane int) float64 {
+	switch plane {
+	case 0:
+		return v.w + v.x
+	case 1:
+		return v.w - v.x
+	case 2:
+		return v.w + v.y
+	case 3:
+		return v.w - v.y
+	case 4:
+		return v.w + v.z
+	default:
+		return v.w - v.z
+	}
+}
+
+// insideClip 判断顶点是否在裁剪空间内
+func insideClip(v clipVert) bool {
+	return -v.w <= v.x && v.x <= v.w && -v.w <= v.y && v.y <= v.w && -v.w <= v.z && v.z <= v.w
+}
+
+// clipPolygon 用裁剪空间的六个平面依次裁剪多边形（Sutherland–Hodgman），返回裁剪后的顶点数
+// 每个平面最多增加一个顶点，三角形裁剪后不超过 9 个顶点。结果在 poly 中。
+func clipPolygon(poly, tmp *[9]clipVert, n int) int {
+	in, out := poly, tmp
+	for plane := range 6 {
+		m := 0
+		for k := range n {
+			a, b := in[k], in[(k+1)%n]
+			da, db := clipDist(a, plane), clipDist(b, plane)
+			if da >= 0 {
+				out[m] = a
+				m++
+			}
+			if (da >= 0) != (db >= 0) {
+				t := da / (da - db)
+				out[m] = clipVert{
+					x: a.x + (b.x-a.x)*t,
+					y: a.y + (b.y-a.y)*t,
+					z: a.z + (b.z-a.z)*t,
+					w: a.w + (b.w-a.w)*t,
+					i: a.i + (b.i-a.i)*t,
+				}
+				m++
+			}
+		}
+		in, out, n = out, in, m
+		if n < 3 {
+			return 0
+		}
+	}
+	// 经过偶数次交换，结果已经在 poly 中
+	return n
+}
+
+// edgeFunc 边函数：点 (x, y) 相对有向边 a→b 的叉积
+func edgeFunc(a, b screenVert, x, y float64) float64 {
+	return (b.x-a.x)*(y-a.y) - (b.y-a.y)*(x-a.x)
+}
+
+// topLeft 判断有向边 a→b 是否为上边或左边（按 edgeFunc(v0, v1, v2.x, v2.y) > 0 的顶点顺序）
+// 像素中心正好落在边上时只归属上边或左边所在的三角形。
+func topLeft(a, b screenVert) bool {
+	return (a.y == b.y && b.x > a.x) || b.y < a.y
+}
+
+// rasterTarget 光栅化目标：可见区域中的矩形与对应的深度缓冲区
+type rasterTarget struct {
+	paint          *Paint
+	x0, y0, x1, y1 int       // 目标矩形 [x0, x1) x [y0, y1)
+	depth          []float32 // 按目标矩形逐行排列的深度缓冲区，nil 时不做深度测试
+	drawn          bool      // 是否直接写入了图像缓冲区
+	bounds         Rect      // 直接写入的像素的包围矩形，由调用者标记修改
+}
+
+// pixelBounds 返回像素中心 (px+0.5, py+0.5) 落在三角形包围盒内的像素范围（包含两端）
+func pixelBounds(v *[3]screenVert) (minX, minY, maxX, maxY int) {
+	minX = int(math.Ceil(min(v[0].x, v[1].x, v[2].x) - 0.5))
+	maxX = int(math.Floor(max(v[0].x, v[1].x, v[2].x) - 0.5))
+	minY = int(math.Ceil(min(v[0].y, v[1].y, v[2].y) - 0.5))
+	maxY = int(math.Floor(max(v[0].y, v[1].y, v[2].y) - 0.5))
+	return
+}
+
+// triangle 用边函数光栅化屏幕三角形，只写入目标矩形内的像素
+// 深度在屏幕空间线性插值，Gouraud 着色的光照强度透视校正插值。
+// 像素中心的边函数值只与像素坐标有关，同一三角形在不同目标矩形中光栅化的结果完全相同。
+func (t *rasterTarget) triangle(tri *screenTri) {
+	v0, v1, v2 := tri.v[0], tri.v[1], tri.v[2]
+	color, gouraud := tri.color, tri.gouraud
+	area := edgeFunc(v0, v1, v2.x, v2.y)
+	if area < 0 {
+		v1, v2 = v2, v1
+		area = -area
+	}
+	if area == 0 {
+		return
+	}
+	minX, minY, maxX, maxY := pixelBounds(&tri.v)
+	minX, minY = max(minX, t.x0), max(minY, t.y0)
+	maxX, maxY = min(maxX, t.x1-1), min(maxY, t.y1-1)
+	if minX > maxX || minY > maxY {
+		return
+	}
+	// 坐标对齐到子像素网格后边函数的值是 1/subpixel² 的整数倍，用小于一个单位的偏移区分 > 0 与 >= 0
+	const half = 0.25 / (subpixel * subpixel)
+	bias := func(a, b screenVert) float64 {
+		if topLeft(a, b) {
+			return half
+		}
+		return -half
+	}
+	b0, b1, b2 := bias(v1, v2), bias(v2, v0), bias(v0, v1)
+	// 边函数沿 x、y 的增量
+	a0, a1, a2 := v1.y-v2.y, v2.y-v0.y, v0.y-v1.y
+	c0, c1, c2 := v2.x-v1.x, v0.x-v2.x, v1.x-v0.x
+	px, py := float64(minX)+0.5, float64(minY)+0.5
+	r0, r1, r2 := edgeFunc(v1, v2, px, py), edgeFunc(v2, v0, px, py), edgeFunc(v0, v1, px, py)
+	inv := 1 / area
+
+	p := t.paint
+	base, xStep, yStep, direct := p.affine(minX, minY, maxX+1, maxY+1)
+	stride := t.x1 - t.x0
+	drawn := false
+	for y := minY; y <= maxY; y++ {
+		e0, e1, e2 := r0, r1, r2
+		i := base + (y-minY)*yStep
+		d := (y-t.y0)*stride + minX - t.x0
+		for x := minX; x <= maxX; x, i, d = x+1, i+xStep, d+1 {
+			if e0+b0 > 0 && e1+b1 > 0 && e2+b2 > 0 {
+				l0, l1, l2 := e0*inv, e1*inv, e2*inv
+				if t.depth != nil {
+					z := float32(l0*v0.z + l1*v1.z + l2*v2.z)
+					if z >= t.depth[d] {
+						e0, e1, e2 = e0+a0, e1+a1, e2+a2
+						continue
+					}
+					t.depth[d] = z
+				}
+				c := color
+				if gouraud {
+					c = shade565(color, (l0*v0.iw+l1*v1.iw+l2*v2.iw)/(l0*v0.rw+l1*v1.rw+l2*v2.rw))
+				}
+				if direct {
+					if p.swap {
+						c = c>>8 | c<<8
+					}
+					p.Image[i] = c
+					drawn = true
+				} else {
+					p.SetPixel(x, y, c)
+				}
+			}
+			e0, e1, e2 = e0+a0, e1+a1, e2+a2
+		}
+		r0, r1, r2 = r0+c0, r1+c1, r2+c2
+	}
+	if drawn {
+		r := Rect{minX, minY, maxX + 1, maxY + 1}
+		if t.drawn {
+			r = r.Union(t.bounds)
+		}
+		t.drawn, t.bounds = true, r
+	}
+}
@@ -27,9 +27,19 @@ type Renderer3D struct {
 	screenH   int  // 屏幕高度
 	cameraPos Vec3 // 相机位置
 	cameraDir Vec3 // 相机方向
+
+	cull      CullMode  // 背面剔除模式
+	shade     ShadeMode // 着色模式
+	light     Vec3      // 指向光源的单位向量（世界坐标）
+	ambient   float64   // 环境光强度
+	depthTest bool      // 是否进行深度测试
+	depth     []float32 // 深度缓冲区，screenW x screenH
+	workers   int       // 网格光栅化协程数
+	batch     meshBatch // 分块光栅化的缓冲区
 }
 
 // NewRenderer3D 创建新的3D渲染器
+// 默认开启深度测试并剔除背面，不计算光照（见 SetShading）。
 func NewRenderer3D(paint *Paint) *Renderer3D {
 	return &Renderer3D{
 		paint:     paint,
@@ -40,6 +50,10 @@ func NewRenderer3D(paint *Paint) *Renderer3D {
 		screenH:   paint.Height,
 		cameraPos: NewVec3(0, 0, -5),
 		cameraDir: NewVec3(0, 0, 1),
+		light:     NewVec3(0, 0, 1),
+		ambient:   0.2,
+		depthTest: true,
+		workers:   1,
 	}
 }
 
@@ -111,12 +125,13 @@ func (r *Renderer3D) SetCamera(pos, target Vec3) {
 	}
 	right := forward.Cross(up).Normalize()
 	realUp := right.Cross(forward).Normalize()
-	// 构建视图矩阵（LookAt矩阵）
+	// 构建视图矩阵（LookAt矩阵），与 TransformVec3 相同按行存储
+	r.cameraDir = forward
 	r.viewMat = Mat4{
-		right.X, realUp.X, -forward.X, 0,
-		right.Y, realUp.Y, -forward.Y, 0,
-		right.Z, realUp.Z, -forward.Z, 0,
-		-right.Dot(pos), -realUp.Dot(pos), forward.Dot(pos), 1,
+		right.X, right.Y, right.Z, -right.Dot(pos),
+		realUp.X, realUp.Y, realUp.Z, -realUp.Dot(pos),
+		-forward.X, -forward.Y, -forward.Z, forward.Dot(pos),
+		0, 0, 0, 1,
 	}
 }
 
@@ -143,13 +158,10 @@ func (r *Renderer3D) project(v Vec3) (int, int) {
 }
 
 // DrawTriangle3D 绘制三维三角形
+// 三角形在齐次裁剪空间中按视景体裁剪（包括近平面），按 SetCullMode 剔除，
+// 再用边函数光栅化并进行深度测试。ShadeGouraud 时单个三角形按面法线着色。
 func (r *Renderer3D) DrawTriangle3D(t Triangle3D) {
-	// 投影三个顶点到屏幕空间
-	x0, y0 := r.project(t.V0)
-	x1, y1 := r.project(t.V1)
-	x2, y2 := r.project(t.V2)
-	// 使用Paint的三角形绘制功能
-	r.paint.DrawTriangle(x0, y0, x1, y1, x2, y2, t.Color, DotPixel1x1, DrawFillFull)
+	r.drawTriangle(r.mvp(), t, nil)
 }
 
 // DrawWireframeTriangle3D 绘制三维三角形线框
@@ -161,18 +173,42 @@ func (r *Renderer3D) DrawWireframeTriangle3D(t Triangle3D, lineWidth DotPixel) {
 }
 
 // DrawMesh3D 绘制三维网格
+// 面的顶点从外侧看应按逆时针排列，背面剔除才能正确去掉不可见的面。
+// ShadeGouraud 时位置相同的顶点共享法线（相邻面法线的平均），网格表面平滑着色。
+// SetParallel 设置多个协程时分块并行光栅化。
 func (r *Renderer3D) DrawMesh3D(mesh Mesh3D, wireframe bool, lineWidth DotPixel) {
-	for _, face := range mesh.Faces {
-		if wireframe {
+	if wireframe {
+		for _, face := range mesh.Faces {
 			r.DrawWireframeTriangle3D(face, lineWidth)
-		} else {
-			r.DrawTriangle3D(face)
 		}
+		return
+	}
+	mvp := r.mvp()
+	var normals map[Vec3]Vec3
+	if r.shade == ShadeGouraud {
+		normals = vertexNormals(mesh.Faces)
+	}
+	if r.canTile() {
+		r.drawMeshTiled(mvp, mesh.Faces, normals)
+		return
+	}
+	for _, face := range mesh.Faces {
+		if normals == nil {
+			r.drawTriangle(mvp, face, nil)
+			continue
+		}
+		n := [3]Vec3{normals[face.V0], normals[face.V1], normals[face.V2]}
+		r.drawTriangle(mvp, face, &n)
 	}
 }
 
 // DrawCube 绘制立方体
 func (r *Renderer3D) DrawCube(center Vec3, size float64, color Color, wireframe bool, lineWidth DotPixel) {
+	r.DrawMesh3D(NewCubeMesh(center, size, color), wireframe, lineWidth)
+}
+
+// NewCubeMesh 创建立方体网格，面从外侧看按逆时针排列
+func NewCubeMesh(center Vec3, size float64, color Color) Mesh3D {
 	half := size / 2
 	vertices := []Vec3{
 		// 前面
@@ -207,18 +243,16 @@ func (r *Renderer3D) DrawCube(center Vec3, size float64, color Color, wireframe
 		{V0: vertices[1], V1: vertices[5], V2: vertices[6], Color: color},
 		{V0: vertices[1], V1: vertices[6], V2: vertices[2], Color: color},
 	}
-	// 绘制所有面
-	for _, face := range faces {
-		if wireframe {
-			r.DrawWireframeTriangle3D(face, lineWidth)
-		} else {
-			r.DrawTriangle3D(face)
-		}
-	}
+	return Mesh3D{Vertices: vertices, Faces: faces}
 }
 
 // DrawSphere 绘制球体（近似）
 func (r *Renderer3D) DrawSphere(center Vec3, radius float64, color Color, segments int, wireframe bool, lineWidth DotPixel) {
+	r.DrawMesh3D(NewSphereMesh(center, radius, color, segments), wireframe, lineWidth)
+}
+
+// NewSphereMesh 创建球体网格（经纬线划分），面从外侧看按逆时针排列
+func NewSphereMesh(center Vec3, radius float64, color Color, segments int) Mesh3D {
 	if segments < 4 {
 		segments = 4
 	}
@@ -236,6 +270,10 @@ func (r *Renderer3D) DrawSphere(center Vec3, radius float64, color Color, segmen
 		}
 		vertices = append(vertices, row)
 	}
+	var mesh Mesh3D
+	for _, row := range vertices {
+		mesh.Vertices = append(mesh.Vertices, row...)
+	}
 	// 创建三角形面片
 	for i := 0; i < segments; i++ {
 		for j := 0; j < segments; j++ {
@@ -244,21 +282,22 @@ func (r *Renderer3D) DrawSphere(center Vec3, radius float64, color Color, segmen
 			v10 := vertices[i+1][j]
 			v11 := vertices[i+1][j+1]
 			// 两个三角形构成一个四边形
-			tri1 := Triangle3D{V0: v00, V1: v10, V2: v01, Color: color}
-			tri2 := Triangle3D{V0: v01, V1: v10, V2: v11, Color: color}
-			if wireframe {
-				r.DrawWireframeTriangle3D(tri1, lineWidth)
-				r.DrawWireframeTriangle3D(tri2, lineWidth)
-			} else {
-				r.DrawTriangle3D(tri1)
-				r.DrawTriangle3D(tri2)
-			}
+			mesh.Faces = append(mesh.Faces,
+				Triangle3D{V0: v00, V1: v01, V2: v10, Color: color},
+				Triangle3D{V0: v01, V1: v11, V2: v10, Color: color},
+			)
 		}
 	}
+	return mesh
 }
 
 // DrawCylinder 绘制圆柱体（近似）
 func (r *Renderer3D) DrawCylinder(center Vec3, radius, height float64, color Color, segments int, wireframe bool, lineWidth DotPixel) {
+	r.DrawMesh3D(NewCylinderMesh(center, radius, height, color, segments), wireframe, lineWidth)
+}
+
+// NewCylinderMesh 创建沿 Y 轴的圆柱体网格，面从外侧看按逆时针排列
+func NewCylinderMesh(center Vec3, radius, height float64, color Color, segments int) Mesh3D {
 	if segments < 3 {
 		segments = 3
 	}
@@ -271,36 +310,25 @@ func (r *Renderer3D) DrawCylinder(center Vec3, radius, height float64, color Col
 		topVerts = append(topVerts, NewVec3(center.X+x, center.Y+height/2, center.Z+z))
 		bottomVerts = append(bottomVerts, NewVec3(center.X+x, center.Y-height/2, center.Z+z))
 	}
-	// 绘制顶部和底部圆
+	topCenter := NewVec3(center.X, center.Y+height/2, center.Z)
+	bottomCenter := NewVec3(center.X, center.Y-height/2, center.Z)
+	mesh := Mesh3D{Vertices: append(append([]Vec3{topCenter, bottomCenter}, topVerts...), bottomVerts...)}
 	for i := 0; i < segments; i++ {
 		next := (i + 1) % segments
-		// 顶部三角形
-		topCenter := NewVec3(center.X, center.Y+height/2, center.Z)
-		topTri := Triangle3D{V0: topCenter, V1: topVerts[i], V2: topVerts[next], Color: color}
-		// 底部三角形（注意顶点顺序以确保法线正确）
-		bottomCenter := NewVec3(center.X, center.Y-height/2, center.Z)
-		bottomTri := Triangle3D{V0: bottomCenter, V1: bottomVerts[next], V2: bottomVerts[i], Color: color}
-		if wireframe {
-			r.DrawWireframeTriangle3D(topTri, lineWidth)
-			r.DrawWireframeTriangle3D(bottomTri, lineWidth)
-		} else {
-			r.DrawTriangle3D(topTri)
-			r.DrawTriangle3D(bottomTri)
-		}
-		// 绘制侧面四边形（两个三角形）
-		sideTri1 := Triangle3D{V0: topVerts[i], V1: bottomVerts[i], V2: topVerts[next], Color: color}
-		sideTri2 := Triangle3D{V0: bottomVerts[i], V1: bottomVerts[next], V2: topVerts[next], Color: color}
-		if wireframe {
-			r.DrawWireframeTriangle3D(sideTri1, lineWidth)
-			r.DrawWireframeTriangle3D(sideTri2, lineWidth)
-		} else {
-			r.DrawTriangle3D(sideTri1)
-			r.DrawTriangle3D(sideTri2)
-		}
+		mesh.Faces = append(mesh.Faces,
+			// 顶部与底部三角形（从外侧看逆时针）
+			Triangle3D{V0: topCenter, V1: topVerts[next], V2: topVerts[i], Color: color},
+			Triangle3D{V0: bottomCenter, V1: bottomVerts[i], V2: bottomVerts[next], Color: color},
+			// 侧面四边形（两个三角形）
+			Triangle3D{V0: topVerts[i], V1: topVerts[next], V2: bottomVerts[i], Color: color},
+			Triangle3D{V0: bottomVerts[i], V1: topVerts[next], V2: bottomVerts[next], Color: color},
+		)
 	}
+	return mesh
 }
 
-// Clear 清空屏幕
+// Clear 清空屏幕和深度缓冲区
 func (r *Renderer3D) Clear(color Color) {
 	r.paint.Clear(color)
+	r.ClearDepth()
 }
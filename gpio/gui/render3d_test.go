@@ -0,0 +1,278 @@
+package gui
+
+import (
+	"math"
+	"testing"
+)
+
+// newTestRenderer 创建使用透视投影、相机位于 (0, 0, 5) 看向原点的渲染器
+func newTestRenderer(w, h int) (*Renderer3D, *Paint) {
+	p := NewPaint(w, h, Rotate0, Black)
+	p.SetImage(make([]Color, w*h))
+	r := NewRenderer3D(p)
+	r.SetCamera(NewVec3(0, 0, 5), NewVec3(0, 0, 0))
+	r.SetPerspectiveProjection(math.Pi/3, float64(w)/float64(h), 0.5, 50)
+	r.Clear(Black)
+	return r, p
+}
+
+func TestPrimitiveWinding(t *testing.T) {
+	center := NewVec3(1, -2, 3)
+	meshes := map[string]Mesh3D{
+		"cube":     NewCubeMesh(center, 2, Red),
+		"sphere":   NewSphereMesh(center, 1.5, Red, 8),
+		"cylinder": NewCylinderMesh(center, 1, 2, Red, 7),
+	}
+	for name, mesh := range meshes {
+		for i, f := range mesh.Faces {
+			n := faceNormal(f.V0, f.V1, f.V2)
+			if n.Length() < 1e-12 {
+				continue // 球体两极的退化三角形
+			}
+			centroid := f.V0.Add(f.V1).Add(f.V2).Mul(1.0 / 3)
+			if n.Dot(centroid.Sub(center)) <= 0 {
+				t.Errorf("%s 第 %d 个面的法线指向内侧", name, i)
+			}
+		}
+	}
+}
+
+func TestSetCamera(t *testing.T) {
+	r, _ := newTestRenderer(100, 100)
+	if x, y := r.project(NewVec3(0, 0, 0)); x != 50 || y != 50 {
+		t.Fatalf("原点投影到 (%d,%d)", x, y)
+	}
+	if x, _ := r.project(NewVec3(1, 0, 0)); x <= 50 {
+		t.Fatalf("+X 投影到 x=%d，应在屏幕右侧", x)
+	}
+	if _, y := r.project(NewVec3(0, 1, 0)); y >= 50 {
+		t.Fatalf("+Y 投影到 y=%d，应在屏幕上方", y)
+	}
+}
+
+func TestSharedEdgeCoverage(t *testing.T) {
+	r, p := newTestRenderer(64, 48)
+	r.SetCullMode(CullNone)
+	r.SetDepthTest(false)
+	counts := make([]int, 64*48)
+	p.SetDisplayFunc(func(x, y int, c Color) { counts[y*64+x]++ })
+	// 共享对角线与内部顶点的四边形扇形，每个像素最多被写一次
+	c := NewVec3(0.13, -0.07, 0)
+	quad := []Vec3{{-1.7, -1.1, 0}, {1.3, -1.5, 0}, {1.9, 1.2, 0}, {-1.2, 1.4, 0}}
+	for i := range quad {
+		r.DrawTriangle3D(Triangle3D{V0: c, V1: quad[i], V2: quad[(i+1)%4], Color: Red})
+	}
+	covered := 0
+	for i, n := range counts {
+		if n > 1 {
+			t.Fatalf("像素 (%d,%d) 被写入 %d 次", i%64, i/64, n)
+		}
+		covered += n
+	}
+	// 内部像素都被覆盖
+	for y := 18; y < 30; y++ {
+		for x := 24; x < 40; x++ {
+			if counts[y*64+x] != 1 {
+				t.Fatalf("内部像素 (%d,%d) 没有被覆盖", x, y)
+			}
+		}
+	}
+	if covered == 0 {
+		t.Fatal("没有绘制任何像素")
+	}
+}
+
+func TestDepthTest(t *testing.T) {
+	near := Triangle3D{V0: NewVec3(-1, -1, 1), V1: NewVec3(1, -1, 1), V2: NewVec3(0, 1, 1), Color: Blue}
+	far := Triangle3D{V0: NewVec3(-2, -2, -1), V1: NewVec3(2, -2, -1), V2: NewVec3(0, 2, -1), Color: Red}
+	for _, order := range [][]Triangle3D{{near, far}, {far, near}} {
+		r, p := newTestRenderer(64, 64)
+		for _, tri := range order {
+			r.DrawTriangle3D(tri)
+		}
+		if c := p.GetPixel(32, 36); c != Blue {
+			t.Fatalf("重叠处为 %#04x，应为近处的蓝色", c)
+		}
+		if c := p.GetPixel(32, 48); c != Red {
+			t.Fatalf("只有远处三角形的像素为 %#04x", c)
+		}
+	}
+	// 关闭深度测试后按绘制顺序覆盖
+	r, p := newTestRenderer(64, 64)
+	r.SetDepthTest(false)
+	r.DrawTriangle3D(near)
+	r.DrawTriangle3D(far)
+	if c := p.GetPixel(32, 36); c != Red {
+		t.Fatalf("关闭深度测试后重叠处为 %#04x", c)
+	}
+}
+
+func TestBackFaceCulling(t *testing.T) {
+	front := Triangle3D{V0: NewVec3(-1, -1, 0), V1: NewVec3(1, -1, 0), V2: NewVec3(0, 1, 0), Color: Green}
+	back := Triangle3D{V0: front.V0, V1: front.V2, V2: front.V1, Color: Green}
+	for _, c := range []struct {
+		mode        CullMode
+		front, back bool
+	}{{CullBack, true, false}, {CullFront, false, true}, {CullNone, true, true}} {
+		for _, tri := range []Triangle3D{front, back} {
+			r, p := newTestRenderer(32, 32)
+			r.SetCullMode(c.mode)
+			r.DrawTriangle3D(tri)
+			want := c.front
+			if tri == back {
+				want = c.back
+			}
+			if got := p.GetPixel(16, 17) == Green; got != want {
+				t.Fatalf("剔除模式 %d：三角形绘制 = %v，期望 %v", c.mode, got, want)
+			}
+		}
+	}
+	// 剔除背面后立方体的图像不变，写入的像素更少
+	writes := func(mode CullMode) ([]Color, int) {
+		r, p := newTestRenderer(64, 64)
+		r.SetCullMode(mode)
+		r.RotateModelY(0.6)
+		r.RotateModelX(0.4)
+		r.DrawCube(NewVec3(0, 0, 0), 2, White, false, DotPixel1x1)
+		img := append([]Color(nil), p.Image...)
+		n := 0
+		p.SetDisplayFunc(func(int, int, Color) { n++ })
+		r.Clear(Black)
+		r.DrawCube(NewVec3(0, 0, 0), 2, White, false, DotPixel1x1)
+		return img, n
+	}
+	culled, nc := writes(CullBack)
+	all, na := writes(CullNone)
+	for i := range culled {
+		if culled[i] != all[i] {
+			t.Fatalf("剔除背面后像素 %d 不同", i)
+		}
+	}
+	if nc >= na {
+		t.Fatalf("剔除背面写入 %d 个像素，不剔除 %d 个", nc, na)
+	}
+}
+
+func TestNearPlaneClipping(t *testing.T) {
+	r, p := newTestRenderer(64, 64)
+	r.SetCullMode(CullNone)
+	// 地面三角形的一个顶点在相机后方
+	r.DrawTriangle3D(Triangle3D{V0: NewVec3(-3, -1, -10), V1: NewVec3(3, -1, -10), V2: NewVec3(0, -1, 20), Color: Yellow})
+	// 地面在视平线以下：下半部分有像素，上半部分没有
+	top, bottom := 0, 0
+	for y := range 64 {
+		for x := range 64 {
+			if p.GetPixel(x, y) == Yellow {
+				if y < 32 {
+					top++
+				} else {
+					bottom++
+				}
+			}
+		}
+	}
+	if top != 0 || bottom == 0 {
+		t.Fatalf("上半部分 %d 个像素，下半部分 %d 个像素", top, bottom)
+	}
+	// 完全在相机后方的三角形不绘制
+	r.Clear(Black)
+	r.DrawTriangle3D(Triangle3D{V0: NewVec3(-1, -1, 8), V1: NewVec3(1, -1, 8), V2: NewVec3(0, 1, 8), Color: Yellow})
+	for i, c := range p.Image {
+		if c != Black {
+			t.Fatalf("相机后方的三角形绘制了像素 %d", i)
+		}
+	}
+}
+
+func TestShading(t *testing.T) {
+	tri := Triangle3D{V0: NewVec3(-1, -1, 0), V1: NewVec3(1, -1, 0), V2: NewVec3(0, 1, 0), Color: White}
+	// 平面着色：整个三角形同一颜色，等于按面法线计算的光照
+	r, p := newTestRenderer(48, 48)
+	r.SetShading(ShadeFlat)
+	r.SetLight(NewVec3(0, 1, 1), 0.1)
+	r.DrawTriangle3D(tri)
+	want := shade565(White, 0.1+0.9*math.Sqrt(0.5))
+	for i, c := range p.Image {
+		if c != Black && c != want {
+			t.Fatalf("平面着色像素 %d = %#04x，期望 %#04x", i, c, want)
+		}
+	}
+	// Gouraud 着色：球体从受光一侧到背光一侧逐渐变暗
+	r, p = newTestRenderer(64, 64)
+	r.SetShading(ShadeGouraud)
+	r.SetLight(NewVec3(1, 0, 0), 0)
+	r.DrawSphere(NewVec3(0, 0, 0), 1.5, White, 16, false, DotPixel1x1)
+	green := func(x int) int { return int(p.GetPixel(x, 32)>>5) & 0x3F }
+	prev := green(48)
+	if prev == 0 {
+		t.Fatal("受光一侧没有亮度")
+	}
+	for x := 47; x > 16; x-- {
+		g := green(x)
+		if g > prev {
+			t.Fatalf("x=%d 亮度 %d 大于右侧的 %d", x, g, prev)
+		}
+		prev = g
+	}
+	if green(18) != 0 {
+		t.Fatalf("背光一侧亮度 %d", green(18))
+	}
+}
+
+func TestRasterRotatedPaint(t *testing.T) {
+	// 旋转、面板字节序与显示回调函数的结果与直接写入相同
+	draw := func(p *Paint) {
+		r := NewRenderer3D(p)
+		r.SetCamera(NewVec3(0, 0, 5), NewVec3(0, 0, 0))
+		r.SetPerspectiveProjection(math.Pi/3, float64(p.Width)/float64(p.Height), 0.5, 50)
+		r.SetShading(ShadeGouraud)
+		r.RotateModelY(0.5)
+		r.DrawSphere(NewVec3(0, 0, 0), 1.5, Cyan, 10, false, DotPixel1x1)
+	}
+	for _, rotate := range []Rotate{Rotate0, Rotate90, Rotate180, Rotate270} {
+		want := NewPaint(40, 30, rotate, Black)
+		want.SetImage(make([]Color, 40*30))
+		shown := make([]Color, 40*30)
+		want.SetDisplayFunc(func(x, y int, c Color) { shown[y*want.WidthMemory+x] = c })
+		draw(want)
+		got := NewPaint(40, 30, rotate, Black)
+		got.SetImage(make([]Color, 40*30))
+		got.SetPanelByteOrder(true)
+		draw(got)
+		for y := range got.Height {
+			for x := range got.Width {
+				xm, ym := got.transform(x, y)
+				if c := got.GetPixel(x, y); c != shown[ym*got.WidthMemory+xm] {
+					t.Fatalf("旋转 %d 像素 (%d,%d) = %#04x，期望 %#04x", rotate, x, y, c, shown[ym*got.WidthMemory+xm])
+				}
+			}
+		}
+	}
+}
+
+// BenchmarkDrawMesh3D 比较原来的画家顺序逐面 DrawTriangle（ref）与裁剪、剔除、深度测试的光栅化
+func BenchmarkDrawMesh3D(b *testing.B) {
+	mesh := NewSphereMesh(NewVec3(0, 0, 0), 1.5, White, 24)
+	r, p := newTestRenderer(240, 240)
+	r.RotateModelY(0.3)
+	b.Run("ref", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for _, f := range mesh.Faces {
+				x0, y0 := r.project(f.V0)
+				x1, y1 := r.project(f.V1)
+				x2, y2 := r.project(f.V2)
+				p.DrawTriangle(x0, y0, x1, y1, x2, y2, f.Color, DotPixel1x1, DrawFillFull)
+			}
+		}
+	})
+	for _, mode := range []ShadeMode{ShadeNone, ShadeGouraud} {
+		name := map[ShadeMode]string{ShadeNone: "zbuffer", ShadeGouraud: "gouraud"}[mode]
+		b.Run(name, func(b *testing.B) {
+			r.SetShading(mode)
+			for i := 0; i < b.N; i++ {
+				r.ClearDepth()
+				r.DrawMesh3D(mesh, false, DotPixel1x1)
+			}
+		})
+	}
+}
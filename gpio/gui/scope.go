@@ -0,0 +1,275 @@
+package gui
+
+import (
+	"math"
+	"sync/atomic"
+)
+
+// ScopeChannel 示波器通道
+type ScopeChannel struct {
+	Color    Color   // 波形颜色
+	Min, Max float64 // 纵轴范围，分别对应绘图区的底边和顶边
+}
+
+// ScopeStats 示波器统计
+type ScopeStats struct {
+	Pushed  uint64 // Push 写入环形缓冲区的采样数
+	Dropped uint64 // 环形缓冲区已满而丢弃的采样数
+	Columns uint64 // 已完成的像素列数
+}
+
+// scopeColumn 一个像素列内某个通道的采样统计
+type scopeColumn struct {
+	min, max, last float64
+	ok             bool // 列内有采样
+}
+
+// Scope 滚动示波器（走纸记录仪）组件，把仿真等来源的采样绘制为从右向左滚动的波形
+//
+// 采样通过 Push 写入单生产者单消费者的无锁环形缓冲区，仿真协程写入时不等待绘制。
+// Draw 在绘制协程中取出新的采样，按时间归入像素列，每列每通道只保留最小值、最大值与最后一个值，
+// 因此任意多的采样都按绘图区宽度的代价绘制。新完成的列到达时，Draw 把绘图区已有的内容在缓冲区中
+// 左移（见 scrollLeft），只绘制右侧新露出的列；列数超过绘图区宽度、修改了样式或绘制到其他 Paint 时全部重绘。
+//
+// Push 只能由一个协程调用；Draw、SetStyle、SetRange、Invalidate 只能由另一个（绘制）协程调用。
+//
+// 示例用法：
+//
+//	scope := gui.NewScope(0, 40, 240, 120, 1e-5, 4096,
+//		gui.ScopeChannel{Color: gui.Yellow, Min: -5, Max: 5},
+//		gui.ScopeChannel{Color: gui.Cyan, Min: -0.1, Max: 0.1})
+//	go time.TransientSimulation(con, time.Sampler(con, scope.Push,
+//		time.NodeVoltage(2), time.BranchCurrent(con.Nodelist[1], 0)))
+//	for range ticker.C {
+//		scope.Draw(paint)
+//		lcd.ShowPaintDirty(paint)
+//	}
+type Scope struct {
+	// 环形缓冲区：每个采样占 stride 个值（时间与各通道值）
+	ring    []float64
+	stride  int
+	mask    uint64
+	head    atomic.Uint64 // 已写入的采样数，只由生产者修改
+	tail    atomic.Uint64 // 已取出的采样数，只由消费者修改
+	dropped atomic.Uint64
+
+	// 以下只由绘制协程访问
+	channels     []ScopeChannel
+	x, y, w, h   int
+	bg, grid     Color
+	gridX, gridY int
+	colTime      float64
+	cols         []scopeColumn // 最近 w 列，按列号对 w 取模存放，每列 len(channels) 个
+	cur          []scopeColumn // 正在累积的列
+	last         []float64     // 上一个采样的各通道值，用于空隙列的插值
+	curIdx       int64         // 正在累积的列号
+	nCols        int64         // 已完成的列数
+	started      bool
+	t0, lastT    float64
+	pending      int  // 上次绘制以来完成的列数
+	full         bool // 需要全部重绘
+	paint        *Paint
+}
+
+// NewScope 创建示波器组件
+// 参数:
+//   - x, y, width, height: 绘图区在 Paint 可见区域中的位置与尺寸
+//   - timePerColumn: 每个像素列对应的时间（与 Push 的时间单位相同）
+//   - capacity: 环形缓冲区的采样数（向上取整为 2 的幂），应大于两次 Draw 之间的采样数，否则新的采样被丢弃
+//   - channels: 各通道的颜色与纵轴范围
+func NewScope(x, y, width, height int, timePerColumn float64, capacity int, channels ...ScopeChannel) *Scope {
+	width, height = max(width, 1), max(height, 1)
+	size := 1
+	for size < capacity {
+		size <<= 1
+	}
+	s := &Scope{
+		stride:   1 + len(channels),
+		mask:     uint64(size - 1),
+		channels: append([]ScopeChannel(nil), channels...),
+		x:        x, y: y, w: width, h: height,
+		bg:      Black,
+		grid:    Gray,
+		gridX:   width / 6,
+		gridY:   height / 4,
+		colTime: timePerColumn,
+		cols:    make([]scopeColumn, width*len(channels)),
+		cur:     make([]scopeColumn, len(channels)),
+		last:    make([]float64, len(channels)),
+		full:    true,
+	}
+	s.ring = make([]float64, size*s.stride)
+	for ch := range s.last {
+		s.last[ch] = math.NaN()
+	}
+	return s
+}
+
+// Push 写入一个采样，values 按通道顺序排列，缺少的通道记为 NaN（不绘制）
+// 时间应单调递增。环形缓冲区已满时丢弃该采样并计入 Dropped。不分配内存，不等待绘制协程。
+// 签名与 element/time.Sampler 的 sink 相同，可以直接作为仿真回调的接收者。
+func (s *Scope) Push(t float64, values []float64) {
+	head := s.head.Load()
+	if head-s.tail.Load() > s.mask {
+		s.dropped.Add(1)
+		return
+	}
+	i := int(head&s.mask) * s.stride
+	sample := s.ring[i : i+s.stride]
+	sample[0] = t
+	n := copy(sample[1:], values)
+	for k := 1 + n; k < s.stride; k++ {
+		sample[k] = math.NaN()
+	}
+	s.head.Store(head + 1)
+}
+
+// Stats 返回示波器统计，Columns 只在绘制协程中准确
+func (s *Scope) Stats() ScopeStats {
+	return ScopeStats{Pushed: s.head.Load(), Dropped: s.dropped.Load(), Columns: uint64(s.nCols)}
+}
+
+// SetStyle 设置背景色、网格颜色与网格间距（像素，0 表示不画），下一次 Draw 全部重绘
+func (s *Scope) SetStyle(bg, grid Color, gridX, gridY int) {
+	s.bg, s.grid, s.gridX, s.gridY = bg, grid, gridX, gridY
+	s.full = true
+}
+
+// SetRange 设置通道的纵轴范围，下一次 Draw 全部重绘
+func (s *Scope) SetRange(channel int, min, max float64) {
+	if channel >= 0 && channel < len(s.channels) {
+		s.channels[channel].Min, s.channels[channel].Max = min, max
+		s.full = true
+	}
+}
+
+// Invalidate 使下一次 Draw 全部重绘，例如绘图区被其他内容覆盖之后
+func (s *Scope) Invalidate() {
+	s.full = true
+}
+
+// drain 取出环形缓冲区中的全部采样并归入像素列
+func (s *Scope) drain() {
+	tail, head := s.tail.Load(), s.head.Load()
+	for ; tail < head; tail++ {
+		i := int(tail&s.mask) * s.stride
+		s.accumulate(s.ring[i], s.ring[i+1:i+s.stride])
+	}
+	s.tail.Store(tail)
+}
+
+// accumulate 把一个采样归入像素列，跨过的列按前后两个采样线性插值，使波形连续
+func (s *Scope) accumulate(t float64, values []float64) {
+	if !s.started {
+		s.started, s.t0, s.lastT = true, t, t
+	}
+	if c := math.Floor((t - s.t0) / s.colTime); c > float64(s.curIdx) {
+		idx := int64(min(c, math.MaxInt64/2))
+		s.commit()
+		// 超过绘图区宽度的空隙不会显示，直接跳过，剩下的 w 列覆盖全部列缓冲区
+		if skip := idx - s.curIdx - 1 - int64(s.w); skip > 0 {
+			s.curIdx += skip
+			s.nCols += skip
+		}
+		for s.curIdx++; s.curIdx < idx; s.curIdx++ {
+			tc := s.t0 + (float64(s.curIdx)+0.5)*s.colTime
+			for ch := range s.cur {
+				v := s.last[ch] + (values[ch]-s.last[ch])*(tc-s.lastT)/(t-s.lastT)
+				s.cur[ch] = scopeColumn{min: v, max: v, last: v, ok: !math.IsNaN(v)}
+			}
+			s.commit()
+		}
+		clear(s.cur)
+	}
+	for ch, v := range values {
+		s.last[ch] = v
+		if math.IsNaN(v) {
+			continue
+		}
+		c := &s.cur[ch]
+		if !c.ok {
+			c.min, c.max, c.ok = v, v, true
+		}
+		c.min, c.max, c.last = min(c.min, v), max(c.max, v), v
+	}
+	s.lastT = t
+}
+
+// commit 完成正在累积的列，绘制时每列与上一列的最后一个值连接
+func (s *Scope) commit() {
+	slot := int(s.nCols%int64(s.w)) * len(s.channels)
+	copy(s.cols[slot:slot+len(s.channels)], s.cur)
+	s.nCols++
+	s.pending = min(s.pending+1, s.w)
+}
+
+// rowOf 把通道值映射为绘图区中的行（可见坐标）
+func (s *Scope) rowOf(ch *ScopeChannel, v float64) int {
+	span := ch.Max - ch.Min
+	if span == 0 {
+		return s.y + s.h - 1
+	}
+	r := math.Round((ch.Max - v) / span * float64(s.h-1))
+	return s.y + int(min(max(r, 0), float64(s.h-1)))
+}
+
+// drawColumn 绘制绘图区第 sx 列（可见坐标），显示第 a 列的采样（a < 0 时只绘制背景与网格）
+func (s *Scope) drawColumn(p *Paint, sx int, a int64) {
+	p.fillRect(sx, s.y, sx+1, s.y+s.h, s.bg)
+	if s.gridY > 0 {
+		for gy := s.y + s.h - 1; gy >= s.y; gy -= s.gridY {
+			p.SetPixel(sx, gy, s.grid)
+		}
+	}
+	if a >= 0 && s.gridX > 0 && a%int64(s.gridX) == 0 {
+		for gy := s.y; gy < s.y+s.h; gy += 2 {
+			p.SetPixel(sx, gy, s.grid)
+		}
+	}
+	if a < 0 {
+		return
+	}
+	n := len(s.channels)
+	col := s.cols[int(a%int64(s.w))*n:][:n]
+	var prev []scopeColumn
+	if a > 0 && a > s.nCols-int64(s.w) {
+		prev = s.cols[int((a-1)%int64(s.w))*n:][:n]
+	}
+	for ch := range s.channels {
+		c := col[ch]
+		if !c.ok {
+			continue
+		}
+		lo, hi := c.min, c.max
+		if prev != nil && prev[ch].ok && !math.IsNaN(prev[ch].last) {
+			lo, hi = min(lo, prev[ch].last), max(hi, prev[ch].last)
+		}
+		info := &s.channels[ch]
+		r0, r1 := s.rowOf(info, hi), s.rowOf(info, lo)
+		p.fillRect(sx, min(r0, r1), sx+1, max(r0, r1)+1, info.Color)
+	}
+}
+
+// Draw 取出新的采样并绘制到 p 中
+// 只有新完成的列需要绘制：已有内容在缓冲区中左移，再绘制右侧的新列。不能移动时（例如 Paint
+// 使用显示回调函数）全部重绘。修改的区域记录在 p 的修改记录中，可以用 DirtyRects 只刷新绘图区。
+func (s *Scope) Draw(p *Paint) {
+	s.drain()
+	if s.paint != p {
+		s.paint, s.full = p, true
+	}
+	if !s.full && s.pending == 0 {
+		return
+	}
+	first := s.nCols - int64(s.w) // 绘图区最左列显示的列号
+	if s.full || s.pending >= s.w || !p.scrollLeft(s.x, s.y, s.x+s.w, s.y+s.h, s.pending) {
+		for k := range s.w {
+			s.drawColumn(p, s.x+k, first+int64(k))
+		}
+	} else {
+		for k := s.w - s.pending; k < s.w; k++ {
+			s.drawColumn(p, s.x+k, first+int64(k))
+		}
+	}
+	s.full, s.pending = false, 0
+}
@@ -0,0 +1,224 @@
+package gui
+
+import (
+	"math"
+	"sync"
+	"testing"
+)
+
+// scopeWave 测试用的两通道波形：正弦与方波
+func scopeWave(i int) (float64, []float64) {
+	t := float64(i) * 0.37
+	sq := -1.0
+	if i/23%2 == 0 {
+		sq = 1
+	}
+	return t, []float64{math.Sin(t / 7), sq}
+}
+
+// newScopePaint 创建带图像缓冲区的绘制上下文
+func newScopePaint(rotate Rotate, swap bool) *Paint {
+	p := NewPaint(90, 70, rotate, Black)
+	p.SetImage(make([]Color, 90*70))
+	p.SetPanelByteOrder(swap)
+	return p
+}
+
+func newTestScope(capacity int) *Scope {
+	return NewScope(7, 5, 60, 41, 1, capacity,
+		ScopeChannel{Color: Yellow, Min: -1.2, Max: 1.2},
+		ScopeChannel{Color: Cyan, Min: -2, Max: 2})
+}
+
+func TestScopeIncrementalMatchesFull(t *testing.T) {
+	for _, rotate := range []Rotate{Rotate0, Rotate90, Rotate180, Rotate270} {
+		for _, swap := range []bool{false, true} {
+			got, want := newScopePaint(rotate, swap), newScopePaint(rotate, swap)
+			inc, ref := newTestScope(1024), newTestScope(1<<14)
+			// 每次绘制之间的列数不同，包括 0 列、1 列和超过绘图区宽度
+			i := 0
+			for _, n := range []int{1, 3, 0, 5, 40, 2, 170, 9, 1, 60, 33} {
+				for range n {
+					ti, v := scopeWave(i)
+					inc.Push(ti, v)
+					ref.Push(ti, v)
+					i++
+				}
+				inc.Draw(got)
+			}
+			ref.Draw(want)
+			if st := inc.Stats(); st.Dropped != 0 || st.Pushed != uint64(i) {
+				t.Fatalf("统计 %+v", st)
+			}
+			for k := range want.Image {
+				if got.Image[k] != want.Image[k] {
+					t.Fatalf("旋转 %d 字节序 %v：内存 (%d,%d) = %#04x，期望 %#04x",
+						rotate, swap, k%want.WidthMemory, k/want.WidthMemory, got.Image[k], want.Image[k])
+				}
+			}
+		}
+	}
+}
+
+func TestScrollLeft(t *testing.T) {
+	for _, rotate := range []Rotate{Rotate0, Rotate90, Rotate180, Rotate270} {
+		p := newScopePaint(rotate, false)
+		for y := range p.Height {
+			for x := range p.Width {
+				p.SetPixel(x, y, Color(x*131+y))
+			}
+		}
+		p.ClearDirty()
+		if !p.scrollLeft(4, 6, 30, 20, 3) {
+			t.Fatalf("旋转 %d 不能移动", rotate)
+		}
+		for y := range p.Height {
+			for x := range p.Width {
+				want := Color(x*131 + y)
+				if x >= 4 && x < 27 && y >= 6 && y < 20 {
+					want = Color((x+3)*131 + y)
+				}
+				if c := p.GetPixel(x, y); c != want {
+					t.Fatalf("旋转 %d 像素 (%d,%d) = %#04x，期望 %#04x", rotate, x, y, c, want)
+				}
+			}
+		}
+		if rects := p.DirtyRects(0); len(rects) == 0 {
+			t.Fatalf("旋转 %d 没有标记修改", rotate)
+		}
+	}
+	p := newScopePaint(Rotate0, false)
+	p.SetDisplayFunc(func(int, int, Color) {})
+	if p.scrollLeft(0, 0, 10, 10, 1) {
+		t.Fatal("有显示回调函数时不能移动")
+	}
+}
+
+func TestScopeDecimation(t *testing.T) {
+	// 一百万个采样，每列 1000 个，方波周期 10 个采样：每个已绘制的列都从顶边画到底边
+	p := newScopePaint(Rotate0, false)
+	s := NewScope(0, 0, 80, 50, 1000, 8192, ScopeChannel{Color: White, Min: -1, Max: 1})
+	s.SetStyle(Black, Gray, 0, 0)
+	v := []float64{0}
+	for i := range 1000000 {
+		v[0] = 1
+		if i%10 >= 5 {
+			v[0] = -1
+		}
+		s.Push(float64(i), v)
+		if i%4096 == 4095 {
+			s.Draw(p)
+		}
+	}
+	s.Draw(p)
+	if st := s.Stats(); st.Dropped != 0 || st.Columns != 999 {
+		t.Fatalf("统计 %+v", st)
+	}
+	for x := range 80 {
+		for y := range 50 {
+			if c := p.GetPixel(x, y); c != White {
+				t.Fatalf("像素 (%d,%d) = %#04x", x, y, c)
+			}
+		}
+	}
+}
+
+func TestScopeDrop(t *testing.T) {
+	s := newTestScope(6) // 向上取整为 8
+	for i := range 20 {
+		ti, v := scopeWave(i)
+		s.Push(ti, v)
+	}
+	if st := s.Stats(); st.Pushed != 8 || st.Dropped != 12 {
+		t.Fatalf("统计 %+v", st)
+	}
+	s.Draw(newScopePaint(Rotate0, false))
+	for i := range 8 {
+		ti, v := scopeWave(20 + i)
+		s.Push(ti, v)
+	}
+	if st := s.Stats(); st.Pushed != 16 || st.Dropped != 12 {
+		t.Fatalf("取出后统计 %+v", st)
+	}
+}
+
+func TestScopeConcurrent(t *testing.T) {
+	p := newScopePaint(Rotate90, true)
+	s := newTestScope(256)
+	const n = 200000
+	var wg sync.WaitGroup
+	done := make(chan struct{})
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		defer close(done)
+		for i := range n {
+			s.Push(scopeWave(i))
+		}
+	}()
+	for drawing := true; drawing; {
+		select {
+		case <-done:
+			drawing = false
+		default:
+		}
+		s.Draw(p)
+	}
+	wg.Wait()
+	if st := s.Stats(); st.Pushed+st.Dropped != n || st.Pushed == 0 {
+		t.Fatalf("统计 %+v", st)
+	}
+}
+
+func TestScopeGapInterpolation(t *testing.T) {
+	// 两个相距 50 列的采样之间的列按直线插值
+	p := newScopePaint(Rotate0, false)
+	s := NewScope(0, 0, 60, 51, 1, 16, ScopeChannel{Color: Red, Min: 0, Max: 50})
+	s.SetStyle(Black, Gray, 0, 0)
+	s.Push(0, []float64{0})
+	s.Push(50, []float64{50})
+	s.Draw(p)
+	first := int(s.nCols) - s.w // 绘图区最左列的列号
+	for a := 1; a < 50; a++ {
+		y := s.rowOf(&s.channels[0], float64(a)+0.5)
+		if c := p.GetPixel(a-first, y); c != Red {
+			t.Fatalf("第 %d 列第 %d 行 = %#04x", a, y, c)
+		}
+	}
+	// 缺少的通道记为 NaN，不绘制
+	s.Push(51, nil)
+	s.Push(52, nil)
+	s.Draw(p)
+	for y := range 51 {
+		if c := p.GetPixel(59, y); c != Black {
+			t.Fatalf("NaN 列第 %d 行 = %#04x", y, c)
+		}
+	}
+}
+
+// BenchmarkScopeDraw 比较每次全部重绘（full）与移动已有内容后只绘制新列（scroll），每次绘制 2 个新列
+func BenchmarkScopeDraw(b *testing.B) {
+	for _, full := range []bool{true, false} {
+		name := map[bool]string{true: "full", false: "scroll"}[full]
+		b.Run(name, func(b *testing.B) {
+			p := NewPaint(240, 320, Rotate90, Black)
+			p.SetImage(make([]Color, 240*320))
+			s := NewScope(0, 40, 320, 160, 1, 1024,
+				ScopeChannel{Color: Yellow, Min: -1.2, Max: 1.2},
+				ScopeChannel{Color: Cyan, Min: -2, Max: 2})
+			i := 0
+			b.ReportAllocs()
+			for k := 0; k < b.N; k++ {
+				for range 2 * 50 {
+					t, v := scopeWave(i)
+					s.Push(t/0.37/50, v)
+					i++
+				}
+				if full {
+					s.Invalidate()
+				}
+				s.Draw(p)
+			}
+		})
+	}
+}
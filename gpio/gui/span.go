@@ -0,0 +1,200 @@
+package gui
+
+// fillColors 用颜色填充切片，按倍增的 copy 展开，长区间接近 memset 的速度
+func fillColors(s []Color, color Color) {
+	if len(s) == 0 {
+		return
+	}
+	s[0] = color
+	for n := 1; n < len(s); n *= 2 {
+		copy(s[n:], s[:n])
+	}
+}
+
+// fillRun 从 Image[i] 开始沿步长 step 填充 n 个像素，步长为 ±1 时按连续区间填充
+func (p *Paint) fillRun(i, n, step int, color Color) {
+	switch step {
+	case 1:
+		fillColors(p.Image[i:i+n], color)
+	case -1:
+		fillColors(p.Image[i-n+1:i+1], color)
+	default:
+		for ; n > 0; n-- {
+			p.Image[i] = color
+			i += step
+		}
+	}
+}
+
+// index 返回可见坐标对应的内存缓冲区索引，越界时返回 -1
+func (p *Paint) index(x, y int) int {
+	xm, ym := p.transform(x, y)
+	if xm < 0 || xm >= p.WidthMemory || ym < 0 || ym >= p.HeightMemory {
+		return -1
+	}
+	if i := ym*p.WidthMemory + xm; i < len(p.Image) {
+		return i
+	}
+	return -1
+}
+
+// affine 返回已裁剪的矩形 [x0, x1) x [y0, y1) 在内存缓冲区中的起点与 x、y 方向的步长
+// 变换是仿射的：index(x, y) = base + (x-x0)*xStep + (y-y0)*yStep。
+// 有显示回调函数、没有图像缓冲区或矩形超出缓冲区时 ok 为 false，需要逐像素调用 SetPixel。
+func (p *Paint) affine(x0, y0, x1, y1 int) (base, xStep, yStep int, ok bool) {
+	if p.displayFunc != nil || p.Image == nil {
+		return 0, 0, 0, false
+	}
+	base = p.index(x0, y0)
+	// 四个角都在缓冲区内时整个矩形都在缓冲区内
+	if base < 0 || p.index(x1-1, y0) < 0 || p.index(x0, y1-1) < 0 || p.index(x1-1, y1-1) < 0 {
+		return 0, 0, 0, false
+	}
+	if x1-x0 > 1 {
+		xStep = p.index(x0+1, y0) - base
+	}
+	if y1-y0 > 1 {
+		yStep = p.index(x0, y0+1) - base
+	}
+	return base, xStep, yStep, true
+}
+
+// fillRect 用颜色填充可见区域中的矩形 [x0, x1) x [y0, y1)
+// 矩形先一次裁剪到可见区域，旋转与镜像解析为内存中的起点与 x、y 方向的步长，
+// 然后沿内存中连续的方向逐段填充，不再逐像素变换坐标。有显示回调函数时逐像素调用 SetPixel。
+func (p *Paint) fillRect(x0, y0, x1, y1 int, color Color) {
+	x0, y0 = max(x0, 0), max(y0, 0)
+	x1, y1 = min(x1, p.Width), min(y1, p.Height)
+	if x0 >= x1 || y0 >= y1 {
+		return
+	}
+	base, xStep, yStep, ok := p.affine(x0, y0, x1, y1)
+	if !ok {
+		for y := y0; y < y1; y++ {
+			for x := x0; x < x1; x++ {
+				p.SetPixel(x, y, color)
+			}
+		}
+		return
+	}
+	if p.dirty != nil {
+		p.dirty.markRect(Rect{x0, y0, x1, y1})
+	}
+	if p.swap {
+		color = color>>8 | color<<8
+	}
+	// 旋转 90°/270° 时可见区域的列在内存中连续，按列填充
+	w, h := x1-x0, y1-y0
+	if yStep == 1 || yStep == -1 || xStep == 0 {
+		w, h, xStep, yStep = h, w, yStep, xStep
+	}
+	for ; h > 0; h-- {
+		p.fillRun(base, w, xStep, color)
+		base += yStep
+	}
+}
+
+// fillSpan 用颜色填充可见区域中第 y 行的 [x0, x1) 区间
+func (p *Paint) fillSpan(x0, x1, y int, color Color) {
+	p.fillRect(x0, y, x1, y+1, color)
+}
+
+// hLine 与 DrawLine 画水平实线的结果相同：线宽按 DotFillAround 向四周扩展，端点超出可见区域时不绘制
+func (p *Paint) hLine(xStart, xEnd, y int, color Color, lineWidth DotPixel) {
+	if xStart < 0 || xStart >= p.Width || xEnd < 0 || xEnd >= p.Width || y < 0 || y >= p.Height {
+		return
+	}
+	if xStart > xEnd {
+		xStart, xEnd = xEnd, xStart
+	}
+	o := int(lineWidth) - 1
+	p.fillRect(xStart-o, y-o, xEnd+o+1, y+o+1, color)
+}
+
+// thickLine 绘制实线：沿 Bresenham 直线移动 (2w-1)x(2w-1) 的方形笔刷
+// 每步只填充笔刷相对上一步新覆盖的一列和一行，结果与逐点绘制方形相同，但每步只写 O(w) 个像素。
+func (p *Paint) thickLine(xStart, yStart, xEnd, yEnd int, color Color, lineWidth DotPixel) {
+	o := int(lineWidth) - 1
+	dx, dy := abs(xEnd-xStart), abs(yEnd-yStart)
+	xAdd, yAdd := 1, 1
+	if xStart > xEnd {
+		xAdd = -1
+	}
+	if yStart > yEnd {
+		yAdd = -1
+	}
+	x, y := xStart, yStart
+	p.fillRect(x-o, y-o, x+o+1, y+o+1, color)
+	err := dx - dy
+	for x != xEnd || y != yEnd {
+		e2 := 2 * err
+		sx, sy := 0, 0
+		if e2 > -dy {
+			err -= dy
+			sx = xAdd
+		}
+		if e2 < dx {
+			err += dx
+			sy = yAdd
+		}
+		x, y = x+sx, y+sy
+		if sx != 0 {
+			c := x + sx*o // 笔刷前进方向上新露出的一列
+			p.fillRect(c, y-o, c+1, y+o+1, color)
+		}
+		if sy != 0 {
+			r := y + sy*o // 新露出的一行
+			p.fillRect(x-o, r, x+o+1, r+1, color)
+		}
+	}
+}
+
+// abs 返回整数的绝对值
+func abs(v int) int {
+	if v < 0 {
+		return -v
+	}
+	return v
+}
+
+// copyRun 把从 Image[src] 开始沿步长 step 的 n 个像素复制到从 Image[dst] 开始的位置，区间可以重叠
+func (p *Paint) copyRun(dst, src, n, step int) {
+	switch step {
+	case 1:
+		copy(p.Image[dst:dst+n], p.Image[src:src+n])
+	case -1:
+		copy(p.Image[dst-n+1:dst+1], p.Image[src-n+1:src+1])
+	default:
+		for k := 0; k < n; k++ {
+			p.Image[dst+k*step] = p.Image[src+k*step]
+		}
+	}
+}
+
+// scrollLeft 把可见区域中矩形 [x0, x1) x [y0, y1) 的内容向左移动 dx 列，右侧 dx 列保留原内容，由调用者重绘
+// 沿内存中连续的方向整段复制：未旋转时逐行复制，旋转 90°/270° 时逐列复制。
+// 有显示回调函数、矩形超出缓冲区或 dx 不在 (0, 宽度) 内时不移动并返回 false，调用者需要全部重绘。
+func (p *Paint) scrollLeft(x0, y0, x1, y1, dx int) bool {
+	w, h := x1-x0, y1-y0
+	if dx <= 0 || dx >= w || h <= 0 || x0 < 0 || y0 < 0 || x1 > p.Width || y1 > p.Height {
+		return false
+	}
+	base, xStep, yStep, ok := p.affine(x0, y0, x1, y1)
+	if !ok {
+		return false
+	}
+	if xStep == 1 || xStep == -1 {
+		for row := 0; row < h; row++ {
+			i := base + row*yStep
+			p.copyRun(i, i+dx*xStep, w-dx, xStep)
+		}
+	} else {
+		for col := 0; col < w-dx; col++ {
+			p.copyRun(base+col*xStep, base+(col+dx)*xStep, h, yStep)
+		}
+	}
+	if p.dirty != nil {
+		p.dirty.markRect(Rect{x0, y0, x1, y1})
+	}
+	return true
+}
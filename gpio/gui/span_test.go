@@ -0,0 +1,572 @@
+package gui
+
+import (
+	"math"
+	"math/rand"
+	"sort"
+	"testing"
+)
+
+// 以下 ref* 函数是改写为区间填充之前的逐像素实现，作为对照和基准测试的基线
+
+func refClearWindow(p *Paint, xStart, yStart, xEnd, yEnd int, color Color) {
+	for y := yStart; y < yEnd; y++ {
+		for x := xStart; x < xEnd; x++ {
+			p.SetPixel(x, y, color)
+		}
+	}
+}
+
+func refDrawPoint(p *Paint, x, y int, color Color, dotPixel DotPixel, dotStyle DotStyle) {
+	if x < 0 || x >= p.Width || y < 0 || y >= p.Height {
+		// 超出可见区域
+		return
+	}
+	if dotStyle == DotFillAround {
+		// 围绕中心点绘制，对于dotPixel=1，只绘制中心点
+		offset := int(dotPixel) - 1
+		for xd := 0; xd < 2*int(dotPixel)-1; xd++ {
+			for yd := 0; yd < 2*int(dotPixel)-1; yd++ {
+				px := x + xd - offset
+				py := y + yd - offset
+				if px < 0 || py < 0 {
+					continue
+				}
+				p.SetPixel(px, py, color)
+			}
+		}
+	} else { // DotFillRightUp 填充样式
+		// 向右和向上扩展，对于dotPixel=1，绘制在(x,y)
+		for xd := 0; xd < int(dotPixel); xd++ {
+			for yd := 0; yd < int(dotPixel); yd++ {
+				px := x + xd
+				py := y + yd
+				p.SetPixel(px, py, color)
+			}
+		}
+	}
+}
+
+func refDrawLine(p *Paint, xStart, yStart, xEnd, yEnd int, color Color, lineWidth DotPixel, lineStyle LineStyle) {
+	if xStart < 0 || xStart >= p.Width || yStart < 0 || yStart >= p.Height ||
+		xEnd < 0 || xEnd >= p.Width || yEnd < 0 || yEnd >= p.Height {
+		// 超出可见区域
+		return
+	}
+	x := xStart
+	y := yStart
+	dx := xEnd - xStart
+	if dx < 0 {
+		dx = -dx
+	}
+	dy := yEnd - yStart
+	if dy < 0 {
+		dy = -dy
+	}
+	// 增量方向
+	xAdd := 1
+	if xStart > xEnd {
+		xAdd = -1
+	}
+	yAdd := 1
+	if yStart > yEnd {
+		yAdd = -1
+	}
+	// Bresenham 直线算法（全八分圆通用）
+	err := dx - dy
+	dottedLen := 0
+	for {
+		dottedLen++
+		if lineStyle == LineStyleDotted && dottedLen%3 == 0 {
+			dottedLen = 0
+			// 虚线间隔：跳过此像素
+		} else {
+			refDrawPoint(p, x, y, color, lineWidth, DotFillAround)
+		}
+		if x == xEnd && y == yEnd {
+			break
+		}
+		e2 := 2 * err
+		if e2 > -dy {
+			err -= dy
+			x += xAdd
+		}
+		if e2 < dx {
+			err += dx
+			y += yAdd
+		}
+	}
+}
+
+func refDrawRectangle(p *Paint, xStart, yStart, xEnd, yEnd int, color Color, lineWidth DotPixel, filled DrawFill) {
+	if xStart < 0 || xStart >= p.Width || yStart < 0 || yStart >= p.Height ||
+		xEnd < 0 || xEnd >= p.Width || yEnd < 0 || yEnd >= p.Height {
+		// 超出可见区域
+		return
+	}
+	if filled == DrawFillFull {
+		for y := yStart; y < yEnd; y++ {
+			refDrawLine(p, xStart, y, xEnd, y, color, lineWidth, LineStyleSolid)
+		}
+	} else {
+		refDrawLine(p, xStart, yStart, xEnd, yStart, color, lineWidth, LineStyleSolid)
+		refDrawLine(p, xStart, yStart, xStart, yEnd, color, lineWidth, LineStyleSolid)
+		refDrawLine(p, xEnd, yEnd, xEnd, yStart, color, lineWidth, LineStyleSolid)
+		refDrawLine(p, xEnd, yEnd, xStart, yEnd, color, lineWidth, LineStyleSolid)
+	}
+}
+
+func refDrawCircle(p *Paint, xCenter, yCenter, radius int, color Color, lineWidth DotPixel, fill DrawFill) {
+	if xCenter < 0 || xCenter >= p.Width || yCenter < 0 || yCenter >= p.Height {
+		// 超出可见区域
+		return
+	}
+	// 从(0, radius)开始
+	xCurrent := 0
+	yCurrent := radius
+	// 累积误差
+	esp := 3 - (radius << 1)
+	if fill == DrawFillFull {
+		for xCurrent <= yCurrent {
+			for sCountY := xCurrent; sCountY <= yCurrent; sCountY++ {
+				refDrawPoint(p, xCenter+xCurrent, yCenter+sCountY, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter-xCurrent, yCenter+sCountY, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter-sCountY, yCenter+xCurrent, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter-sCountY, yCenter-xCurrent, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter-xCurrent, yCenter-sCountY, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter+xCurrent, yCenter-sCountY, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter+sCountY, yCenter-xCurrent, color, DotPixel1x1, DotFillAround)
+				refDrawPoint(p, xCenter+sCountY, yCenter+xCurrent, color, DotPixel1x1, DotFillAround)
+			}
+			if esp < 0 {
+				esp += 4*xCurrent + 6
+			} else {
+				esp += 10 + 4*(xCurrent-yCurrent)
+				yCurrent--
+			}
+			xCurrent++
+		}
+	} else { // 空心圆
+		for xCurrent <= yCurrent {
+			refDrawPoint(p, xCenter+xCurrent, yCenter+yCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter-xCurrent, yCenter+yCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter-yCurrent, yCenter+xCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter-yCurrent, yCenter-xCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter-xCurrent, yCenter-yCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter+xCurrent, yCenter-yCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter+yCurrent, yCenter-xCurrent, color, lineWidth, DotFillAround)
+			refDrawPoint(p, xCenter+yCurrent, yCenter+xCurrent, color, lineWidth, DotFillAround)
+			if esp < 0 {
+				esp += 4*xCurrent + 6
+			} else {
+				esp += 10 + 4*(xCurrent-yCurrent)
+				yCurrent--
+			}
+			xCurrent++
+		}
+	}
+}
+
+func refDrawRoundRect(p *Paint, xStart, yStart, xEnd, yEnd, radius int, color Color, lineWidth DotPixel, filled DrawFill) {
+	if xStart < 0 || xStart >= p.Width || yStart < 0 || yStart >= p.Height ||
+		xEnd < 0 || xEnd >= p.Width || yEnd < 0 || yEnd >= p.Height {
+		return
+	}
+	// 确保起点在终点之前
+	if xStart > xEnd {
+		xStart, xEnd = xEnd, xStart
+	}
+	if yStart > yEnd {
+		yStart, yEnd = yEnd, yStart
+	}
+	width := xEnd - xStart
+	height := yEnd - yStart
+	// 限制半径大小
+	maxRadius := min(height/2, width/2)
+	if radius > maxRadius {
+		radius = maxRadius
+	}
+	if radius < 0 {
+		radius = 0
+	}
+	if filled == DrawFillFull {
+		// 填充整个圆角矩形
+		// 填充中心矩形区域
+		for y := yStart + radius; y < yEnd-radius; y++ {
+			refDrawLine(p, xStart, y, xEnd, y, color, lineWidth, LineStyleSolid)
+		}
+		// 填充四个边角区域（使用半圆填充）
+		// 左上角
+		for dy := 0; dy < radius; dy++ {
+			dx := int(math.Sqrt(float64(radius*radius - dy*dy)))
+			refDrawLine(p, xStart+radius-dx, yStart+dy, xEnd-radius+dx, yStart+dy, color, lineWidth, LineStyleSolid)
+		}
+		// 左下角
+		for dy := 0; dy < radius; dy++ {
+			dx := int(math.Sqrt(float64(radius*radius - dy*dy)))
+			refDrawLine(p, xStart+radius-dx, yEnd-radius+dy, xEnd-radius+dx, yEnd-radius+dy, color, lineWidth, LineStyleSolid)
+		}
+	}
+}
+
+func refFillTriangle(p *Paint, x1, y1, x2, y2, x3, y3 int, color Color) {
+	// 将三个顶点按y坐标排序
+	vertices := []struct{ x, y int }{{x1, y1}, {x2, y2}, {x3, y3}}
+	sort.Slice(vertices, func(i, j int) bool {
+		return vertices[i].y < vertices[j].y
+	})
+	v0, v1, v2 := vertices[0], vertices[1], vertices[2]
+	// 整个三角形的高度
+	totalHeight := v2.y - v0.y
+	if totalHeight == 0 {
+		// 退化三角形，所有顶点在同一水平线上
+		// 绘制水平线
+		minX := min(v2.x, min(v1.x, v0.x))
+		maxX := max(v2.x, max(v1.x, v0.x))
+		for x := minX; x <= maxX; x++ {
+			p.SetPixel(x, v0.y, color)
+		}
+		return
+	}
+	// 扫描上半部分（v0到v1）
+	for y := v0.y; y <= v1.y; y++ {
+		segmentHeight := v1.y - v0.y
+		if segmentHeight == 0 {
+			continue
+		}
+		alpha := float64(y-v0.y) / float64(totalHeight)
+		beta := float64(y-v0.y) / float64(segmentHeight)
+		ax := float64(v0.x) + alpha*float64(v2.x-v0.x)
+		bx := float64(v0.x) + beta*float64(v1.x-v0.x)
+		startX := int(ax + 0.5)
+		endX := int(bx + 0.5)
+		if startX > endX {
+			startX, endX = endX, startX
+		}
+		for x := startX; x <= endX; x++ {
+			p.SetPixel(x, y, color)
+		}
+	}
+	// 扫描下半部分（v1到v2）
+	for y := v1.y; y <= v2.y; y++ {
+		segmentHeight := v2.y - v1.y
+		if segmentHeight == 0 {
+			continue
+		}
+		alpha := float64(y-v0.y) / float64(totalHeight)
+		beta := float64(y-v1.y) / float64(segmentHeight)
+		ax := float64(v0.x) + alpha*float64(v2.x-v0.x)
+		bx := float64(v1.x) + beta*float64(v2.x-v1.x)
+		startX := int(ax + 0.5)
+		endX := int(bx + 0.5)
+		if startX > endX {
+			startX, endX = endX, startX
+		}
+		for x := startX; x <= endX; x++ {
+			p.SetPixel(x, y, color)
+		}
+	}
+}
+
+func refFillPolygon(p *Paint, points [][2]int, color Color) {
+	// 找到多边形的y范围
+	minY := points[0][1]
+	maxY := points[0][1]
+	for _, pt := range points {
+		if pt[1] < minY {
+			minY = pt[1]
+		}
+		if pt[1] > maxY {
+			maxY = pt[1]
+		}
+	}
+	// 边表（ET）：按边的较小y坐标索引
+	et := make([][]edge, maxY-minY+1)
+	// 构建边表
+	for i := range points {
+		j := (i + 1) % len(points)
+		x1, y1 := points[i][0], points[i][1]
+		x2, y2 := points[j][0], points[j][1]
+		// 忽略水平线
+		if y1 == y2 {
+			continue
+		}
+		// 确保y1 < y2
+		if y1 > y2 {
+			x1, x2 = x2, x1
+			y1, y2 = y2, y1
+		}
+		dx := float64(x2-x1) / float64(y2-y1)
+		et[y1-minY] = append(et[y1-minY], edge{
+			yMax: y2,
+			x:    float64(x1),
+			dx:   dx,
+		})
+	}
+	// 活动边表（AET）
+	var aet []edge
+	// 扫描每条扫描线
+	for y := minY; y <= maxY; y++ {
+		// 将边表中起始y等于当前y的边添加到AET
+		if y-minY < len(et) {
+			aet = append(aet, et[y-minY]...)
+		}
+		// 从AET中移除yMax等于当前y的边
+		newAet := make([]edge, 0, len(aet))
+		for _, e := range aet {
+			if e.yMax > y {
+				newAet = append(newAet, e)
+			}
+		}
+		aet = newAet
+		// 按当前x排序
+		sort.Slice(aet, func(i, j int) bool {
+			return aet[i].x < aet[j].x
+		})
+		// 填充扫描线
+		for i := 0; i < len(aet); i += 2 {
+			if i+1 >= len(aet) {
+				break
+			}
+			startX := int(aet[i].x + 0.5)
+			endX := int(aet[i+1].x + 0.5)
+			if startX > endX {
+				startX, endX = endX, startX
+			}
+			for x := startX; x <= endX; x++ {
+				p.SetPixel(x, y, color)
+			}
+		}
+		// 更新AET中边的x值
+		for i := range aet {
+			aet[i].x += aet[i].dx
+		}
+	}
+}
+
+// drawOp 在绘制上下文上执行一个随机图元，ref 为 true 时使用逐像素的对照实现
+type drawOp struct {
+	name string
+	do   func(p *Paint, ref bool)
+}
+
+// opNames 随机图元的名称
+var opNames = []string{"ClearWindow", "DrawPoint", "DrawLine", "DrawLine", "DrawRectangle", "DrawCircle", "DrawRoundRect", "DrawTriangle", "DrawPolygon"}
+
+// randomOps 生成覆盖全部填充图元与粗线的随机操作，坐标可能超出可见区域
+func randomOps(rng *rand.Rand, w, h, n int) []drawOp {
+	c := func() int { return rng.Intn(w+20) - 10 }
+	r := func() int { return rng.Intn(h+20) - 10 }
+	ops := make([]drawOp, 0, n)
+	for range n {
+		color := Color(rng.Intn(0x10000))
+		width := DotPixel(rng.Intn(4) + 1)
+		x0, y0, x1, y1, x2, y2 := c(), r(), c(), r(), c(), r()
+		var op func(p *Paint, ref bool)
+		k := rng.Intn(len(opNames))
+		switch k {
+		case 0:
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refClearWindow(p, x0, y0, x1, y1, color)
+				} else {
+					p.ClearWindow(x0, y0, x1, y1, color)
+				}
+			}
+		case 1:
+			style := DotStyle(rng.Intn(2) + 1)
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refDrawPoint(p, x0, y0, color, width, style)
+				} else {
+					p.DrawPoint(x0, y0, color, width, style)
+				}
+			}
+		case 2, 3:
+			style := LineStyle(rng.Intn(2))
+			if rng.Intn(3) == 0 {
+				y1 = y0 // 水平线
+			}
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refDrawLine(p, x0, y0, x1, y1, color, width, style)
+				} else {
+					p.DrawLine(x0, y0, x1, y1, color, width, style)
+				}
+			}
+		case 4:
+			fill := DrawFill(rng.Intn(2))
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refDrawRectangle(p, x0, y0, x1, y1, color, width, fill)
+				} else {
+					p.DrawRectangle(x0, y0, x1, y1, color, width, fill)
+				}
+			}
+		case 5:
+			radius := rng.Intn(2 * w)
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refDrawCircle(p, x0, y0, radius, color, width, DrawFillFull)
+				} else {
+					p.DrawCircle(x0, y0, radius, color, width, DrawFillFull)
+				}
+			}
+		case 6:
+			radius := rng.Intn(10)
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refDrawRoundRect(p, x0, y0, x1, y1, radius, color, width, DrawFillFull)
+				} else {
+					p.DrawRoundRect(x0, y0, x1, y1, radius, color, width, DrawFillFull)
+				}
+			}
+		case 7:
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refFillTriangle(p, x0, y0, x1, y1, x2, y2, color)
+				} else {
+					p.DrawTriangle(x0, y0, x1, y1, x2, y2, color, width, DrawFillFull)
+				}
+			}
+		case 8:
+			points := [][2]int{{x0, y0}, {x1, y1}, {x2, y2}, {c(), r()}, {c(), r()}}
+			op = func(p *Paint, ref bool) {
+				if ref {
+					refFillPolygon(p, points, color)
+				} else {
+					p.DrawPolygon(points, color, width, DrawFillFull)
+				}
+			}
+		}
+		ops = append(ops, drawOp{opNames[k], op})
+	}
+	return ops
+}
+
+func TestSpanMatchesReference(t *testing.T) {
+	const w, h = 61, 45
+	rng := rand.New(rand.NewSource(2))
+	for _, rotate := range []Rotate{Rotate0, Rotate90, Rotate180, Rotate270} {
+		for _, mirror := range []Mirror{MirrorNone, MirrorHorizontal, MirrorVertical, MirrorOrigin} {
+			for _, panel := range []bool{false, true} {
+				got := NewPaint(w, h, rotate, White)
+				want := NewPaint(w, h, rotate, White)
+				got.SetImage(make([]Color, w*h))
+				want.SetImage(make([]Color, w*h))
+				got.Mirror, want.Mirror = mirror, mirror
+				got.SetPanelByteOrder(panel)
+				want.SetPanelByteOrder(panel)
+				for i, op := range randomOps(rng, got.Width, got.Height, 300) {
+					got.ClearDirty()
+					want.ClearDirty()
+					op.do(got, false)
+					op.do(want, true)
+					for j := range want.Image {
+						if got.Image[j] != want.Image[j] {
+							t.Fatalf("旋转 %d 镜像 %d 面板字节序 %v 第 %d 个操作 %s: 内存 (%d,%d) = %#04x，期望 %#04x",
+								rotate, mirror, panel, i, op.name, j%w, j/w, got.Image[j], want.Image[j])
+						}
+					}
+					if g, w := got.DirtyRects(0), want.DirtyRects(0); !sameRects(g, w) {
+						t.Fatalf("旋转 %d 镜像 %d 第 %d 个操作 %s: 脏区域 %v，期望 %v", rotate, mirror, i, op.name, g, w)
+					}
+				}
+			}
+		}
+	}
+}
+
+// sameRects 判断两组矩形是否相同（不计顺序）
+func sameRects(a, b []Rect) bool {
+	if len(a) != len(b) {
+		return false
+	}
+	less := func(rs []Rect) func(i, j int) bool {
+		return func(i, j int) bool {
+			if rs[i].Y0 != rs[j].Y0 {
+				return rs[i].Y0 < rs[j].Y0
+			}
+			return rs[i].X0 < rs[j].X0
+		}
+	}
+	sort.Slice(a, less(a))
+	sort.Slice(b, less(b))
+	for i := range a {
+		if a[i] != b[i] {
+			return false
+		}
+	}
+	return true
+}
+
+func TestSpanDisplayFunc(t *testing.T) {
+	// 有显示回调函数时仍逐像素调用
+	p := NewPaint(20, 10, Rotate90, White)
+	n := 0
+	p.SetDisplayFunc(func(x, y int, c Color) { n++ })
+	p.ClearWindow(2, 2, 6, 5, Red)
+	if n != 12 {
+		t.Fatalf("显示回调 %d 次，期望 12", n)
+	}
+}
+
+// BenchmarkPrimitives 比较逐像素实现（ref）与区间填充实现（span）
+func BenchmarkPrimitives(b *testing.B) {
+	points := [][2]int{{10, 10}, {200, 40}, {150, 300}, {60, 250}, {20, 120}}
+	cases := []struct {
+		name      string
+		ref, span func(p *Paint)
+	}{
+		{"ClearWindow",
+			func(p *Paint) { refClearWindow(p, 0, 0, p.Width, p.Height, Red) },
+			func(p *Paint) { p.ClearWindow(0, 0, p.Width, p.Height, Red) }},
+		{"FillRectangle",
+			func(p *Paint) { refDrawRectangle(p, 20, 30, 200, 250, Red, DotPixel1x1, DrawFillFull) },
+			func(p *Paint) { p.DrawRectangle(20, 30, 200, 250, Red, DotPixel1x1, DrawFillFull) }},
+		{"FillCircle",
+			func(p *Paint) { refDrawCircle(p, 120, 160, 100, Red, DotPixel1x1, DrawFillFull) },
+			func(p *Paint) { p.DrawCircle(120, 160, 100, Red, DotPixel1x1, DrawFillFull) }},
+		{"FillRoundRect",
+			func(p *Paint) { refDrawRoundRect(p, 20, 30, 200, 250, 16, Red, DotPixel1x1, DrawFillFull) },
+			func(p *Paint) { p.DrawRoundRect(20, 30, 200, 250, 16, Red, DotPixel1x1, DrawFillFull) }},
+		{"FillTriangle",
+			func(p *Paint) { refFillTriangle(p, 10, 10, 230, 100, 60, 310, Red) },
+			func(p *Paint) { p.DrawTriangle(10, 10, 230, 100, 60, 310, Red, DotPixel1x1, DrawFillFull) }},
+		{"FillPolygon",
+			func(p *Paint) { refFillPolygon(p, points, Red) },
+			func(p *Paint) { p.DrawPolygon(points, Red, DotPixel1x1, DrawFillFull) }},
+		{"ThickLine",
+			func(p *Paint) { refDrawLine(p, 10, 20, 230, 300, Red, DotPixel5x5, LineStyleSolid) },
+			func(p *Paint) { p.DrawLine(10, 20, 230, 300, Red, DotPixel5x5, LineStyleSolid) }},
+		{"Line",
+			func(p *Paint) { refDrawLine(p, 10, 20, 230, 300, Red, DotPixel1x1, LineStyleSolid) },
+			func(p *Paint) { p.DrawLine(10, 20, 230, 300, Red, DotPixel1x1, LineStyleSolid) }},
+	}
+	for _, rotate := range []Rotate{Rotate0, Rotate90} {
+		p := NewPaint(240, 320, Rotate0, White)
+		if rotate == Rotate90 {
+			p = NewPaint(320, 240, Rotate90, White)
+		}
+		p.SetImage(make([]Color, 240*320))
+		for _, c := range cases {
+			b.Run(c.name+"/"+rotateName(rotate)+"/ref", func(b *testing.B) {
+				for i := 0; i < b.N; i++ {
+					c.ref(p)
+				}
+			})
+			b.Run(c.name+"/"+rotateName(rotate)+"/span", func(b *testing.B) {
+				for i := 0; i < b.N; i++ {
+					c.span(p)
+				}
+			})
+		}
+	}
+}
+
+func rotateName(r Rotate) string {
+	if r == Rotate90 {
+		return "rot90"
+	}
+	return "rot0"
+}
@@ -0,0 +1,188 @@
+package gui
+
+import (
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// tileSize 分块光栅化的块边长（像素），是修改记录块的整数倍
+const tileSize = 32
+
+// meshBatch 分块光栅化在多次绘制之间复用的缓冲区
+type meshBatch struct {
+	px, py, pz     []float64     // 模型坐标顶点（数组结构体，每个面三个顶点）
+	cx, cy, cz, cw []float64     // 齐次裁剪坐标
+	chunks         [][]screenTri // 每个协程装配的屏幕三角形，按面的顺序
+	tris           []screenTri   // 按提交顺序合并的屏幕三角形
+	bins           [][]int32     // 每个块覆盖的三角形下标，按提交顺序
+	tileDrawn      []bool        // 块是否写入了像素
+	tileBounds     []Rect        // 块内写入的像素的包围矩形
+	scratch        [][]float32   // 每个协程的块深度缓冲区
+}
+
+// SetParallel 设置填充网格时使用的光栅化协程数
+// workers 大于 1 时 DrawMesh3D（以及 DrawCube、DrawSphere、DrawCylinder）使用分块并行光栅化：
+// 先批量变换全部顶点，各协程分段完成裁剪、投影与剔除，再把屏幕三角形按包围盒分配到 32x32 像素的块中，
+// 各协程把块的深度缓冲区复制到自己的块缓冲区中，按提交顺序独立光栅化不同的块。
+// 每个像素只属于一个块并且块内按提交顺序绘制，结果与串行光栅化逐像素相同。
+// workers <= 0 时使用 GOMAXPROCS，1 为串行（默认）。有显示回调函数时总是串行绘制。
+func (r *Renderer3D) SetParallel(workers int) {
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	r.workers = workers
+}
+
+// canTile 判断绘制目标是否可以分块并行写入：像素直接写入图像缓冲区，不经过显示回调函数
+func (r *Renderer3D) canTile() bool {
+	p := r.paint
+	return r.workers > 1 && p.displayFunc == nil && len(p.Image) >= p.WidthMemory*p.HeightMemory
+}
+
+// grow 返回长度为 n 的切片，容量足够时复用原来的内存
+func grow[T any](s []T, n int) []T {
+	if cap(s) >= n {
+		return s[:n]
+	}
+	return make([]T, n)
+}
+
+// drawMeshTiled 分块并行绘制网格的面
+// normals 为 Gouraud 着色的顶点法线，nil 时按 shadeTriangle 的规则使用面法线。
+func (r *Renderer3D) drawMeshTiled(mvp Mat4, faces []Triangle3D, normals map[Vec3]Vec3) {
+	b := &r.batch
+	workers := r.workers
+
+	// 批量变换：每个面的三个顶点按数组结构体排列
+	n := len(faces) * 3
+	b.px, b.py, b.pz = grow(b.px, n), grow(b.py, n), grow(b.pz, n)
+	b.cx, b.cy, b.cz, b.cw = grow(b.cx, n), grow(b.cy, n), grow(b.cz, n), grow(b.cw, n)
+	for i, f := range faces {
+		b.px[3*i], b.py[3*i], b.pz[3*i] = f.V0.X, f.V0.Y, f.V0.Z
+		b.px[3*i+1], b.py[3*i+1], b.pz[3*i+1] = f.V1.X, f.V1.Y, f.V1.Z
+		b.px[3*i+2], b.py[3*i+2], b.pz[3*i+2] = f.V2.X, f.V2.Y, f.V2.Z
+	}
+	mvp.TransformBatch(b.px, b.py, b.pz, b.cx, b.cy, b.cz, b.cw)
+
+	// 装配：按面分段并行光照、裁剪、投影与剔除
+	if len(b.chunks) < workers {
+		b.chunks = append(b.chunks, make([][]screenTri, workers-len(b.chunks))...)
+	}
+	var wg sync.WaitGroup
+	chunk := (len(faces) + workers - 1) / workers
+	for w := range workers {
+		lo, hi := w*chunk, min((w+1)*chunk, len(faces))
+		b.chunks[w] = b.chunks[w][:0]
+		if lo >= hi {
+			continue
+		}
+		wg.Add(1)
+		go func(w, lo, hi int) {
+			defer wg.Done()
+			out := b.chunks[w]
+			for i := lo; i < hi; i++ {
+				var v [3]clipVert
+				for k := range v {
+					j := 3*i + k
+					v[k] = clipVert{x: b.cx[j], y: b.cy[j], z: b.cz[j], w: b.cw[j]}
+				}
+				var nrm *[3]Vec3
+				if normals != nil {
+					f := &faces[i]
+					nrm = &[3]Vec3{normals[f.V0], normals[f.V1], normals[f.V2]}
+				}
+				color, gouraud := r.shadeTriangle(faces[i], nrm, &v)
+				out = r.assemble(&v, color, gouraud, out)
+			}
+			b.chunks[w] = out
+		}(w, lo, hi)
+	}
+	wg.Wait()
+
+	// 分块：按提交顺序把三角形下标加入包围盒覆盖的块
+	tilesX := (r.screenW + tileSize - 1) / tileSize
+	tilesY := (r.screenH + tileSize - 1) / tileSize
+	tiles := tilesX * tilesY
+	if len(b.bins) < tiles {
+		b.bins = append(b.bins, make([][]int32, tiles-len(b.bins))...)
+	}
+	b.bins = b.bins[:tiles]
+	for i := range b.bins {
+		b.bins[i] = b.bins[i][:0]
+	}
+	b.tris = b.tris[:0]
+	for _, c := range b.chunks[:workers] {
+		b.tris = append(b.tris, c...)
+	}
+	for i := range b.tris {
+		minX, minY, maxX, maxY := pixelBounds(&b.tris[i].v)
+		minX, minY = max(minX, 0), max(minY, 0)
+		maxX, maxY = min(maxX, r.screenW-1), min(maxY, r.screenH-1)
+		if minX > maxX || minY > maxY {
+			continue
+		}
+		for ty := minY / tileSize; ty <= maxY/tileSize; ty++ {
+			for tx := minX / tileSize; tx <= maxX/tileSize; tx++ {
+				b.bins[ty*tilesX+tx] = append(b.bins[ty*tilesX+tx], int32(i))
+			}
+		}
+	}
+	if len(b.tris) == 0 {
+		return
+	}
+
+	// 光栅化：各协程依次领取块，使用块内的深度缓冲区
+	if r.depthTest && len(r.depth) != r.screenW*r.screenH {
+		r.ClearDepth()
+	}
+	b.tileDrawn, b.tileBounds = grow(b.tileDrawn, tiles), grow(b.tileBounds, tiles)
+	for len(b.scratch) < workers {
+		b.scratch = append(b.scratch, make([]float32, tileSize*tileSize))
+	}
+	var next atomic.Int32
+	for w := range min(workers, tiles) {
+		wg.Add(1)
+		go func(scratch []float32) {
+			defer wg.Done()
+			for {
+				tile := int(next.Add(1)) - 1
+				if tile >= tiles {
+					return
+				}
+				b.tileDrawn[tile] = false
+				if len(b.bins[tile]) == 0 {
+					continue
+				}
+				x0, y0 := tile%tilesX*tileSize, tile/tilesX*tileSize
+				t := rasterTarget{paint: r.paint, x0: x0, y0: y0, x1: min(x0+tileSize, r.screenW), y1: min(y0+tileSize, r.screenH)}
+				tw := t.x1 - t.x0
+				if r.depthTest {
+					t.depth = scratch[:tw*(t.y1-t.y0)]
+					for y := t.y0; y < t.y1; y++ {
+						copy(t.depth[(y-t.y0)*tw:], r.depth[y*r.screenW+t.x0:y*r.screenW+t.x1])
+					}
+				}
+				for _, i := range b.bins[tile] {
+					t.triangle(&b.tris[i])
+				}
+				if r.depthTest {
+					for y := t.y0; y < t.y1; y++ {
+						copy(r.depth[y*r.screenW+t.x0:y*r.screenW+t.x1], t.depth[(y-t.y0)*tw:])
+					}
+				}
+				b.tileDrawn[tile], b.tileBounds[tile] = t.drawn, t.bounds
+			}
+		}(b.scratch[w])
+	}
+	wg.Wait()
+
+	// 修改记录不是并发安全的，光栅化完成后按块标记
+	if r.paint.dirty != nil {
+		for tile, drawn := range b.tileDrawn {
+			if drawn {
+				r.paint.dirty.markRect(b.tileBounds[tile])
+			}
+		}
+	}
+}
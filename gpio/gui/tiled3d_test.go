@@ -0,0 +1,178 @@
+package gui
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+)
+
+// tiledScene 分块并行与串行光栅化对照的场景
+type tiledScene struct {
+	name  string
+	setup func(r *Renderer3D)
+	draw  func(r *Renderer3D)
+}
+
+// randomMesh 生成随机的小三角形网格，大量三角形互相穿插并跨越块边界
+func randomMesh(n int, seed int64) Mesh3D {
+	rng := rand.New(rand.NewSource(seed))
+	var mesh Mesh3D
+	for range n {
+		c := NewVec3(rng.Float64()*6-3, rng.Float64()*6-3, rng.Float64()*6-3)
+		v := func() Vec3 {
+			return c.Add(NewVec3(rng.Float64()*1.6-0.8, rng.Float64()*1.6-0.8, rng.Float64()*1.6-0.8))
+		}
+		mesh.Faces = append(mesh.Faces, Triangle3D{V0: v(), V1: v(), V2: v(), Color: Color(rng.Intn(0x10000))})
+	}
+	return mesh
+}
+
+var tiledScenes = []tiledScene{
+	{"gouraud", func(r *Renderer3D) {
+		r.SetShading(ShadeGouraud)
+		r.SetLight(NewVec3(1, 1, 1), 0.15)
+	}, func(r *Renderer3D) {
+		r.RotateModelY(0.7)
+		r.DrawSphere(NewVec3(-0.8, 0, 0), 1.6, Cyan, 20, false, DotPixel1x1)
+		r.DrawCylinder(NewVec3(1, 0.3, 0.5), 0.8, 3, Yellow, 15, false, DotPixel1x1)
+	}},
+	{"flat", func(r *Renderer3D) {
+		r.SetShading(ShadeFlat)
+	}, func(r *Renderer3D) {
+		r.RotateModelX(0.5)
+		r.RotateModelZ(0.3)
+		r.DrawCube(NewVec3(0, 0, 0), 2.5, Red, false, DotPixel1x1)
+		r.DrawCube(NewVec3(1.2, 0.8, 1), 1.5, Green, false, DotPixel1x1)
+	}},
+	{"random", func(r *Renderer3D) {
+		r.SetCullMode(CullNone)
+	}, func(r *Renderer3D) {
+		r.DrawMesh3D(randomMesh(600, 1), false, DotPixel1x1)
+	}},
+	{"near-plane", func(r *Renderer3D) {
+		r.SetCullMode(CullNone)
+	}, func(r *Renderer3D) {
+		var ground Mesh3D
+		for i := -4; i < 4; i++ {
+			for j := -4; j < 8; j++ {
+				x, z := float64(i), float64(j)
+				c := Color(0xFFFF)
+				if (i+j)&1 != 0 {
+					c = Blue
+				}
+				ground.Faces = append(ground.Faces,
+					Triangle3D{V0: NewVec3(x, -1, z), V1: NewVec3(x+1, -1, z), V2: NewVec3(x, -1, z+1), Color: c},
+					Triangle3D{V0: NewVec3(x+1, -1, z), V1: NewVec3(x+1, -1, z+1), V2: NewVec3(x, -1, z+1), Color: c})
+			}
+		}
+		r.DrawMesh3D(ground, false, DotPixel1x1)
+	}},
+	{"no-depth", func(r *Renderer3D) {
+		r.SetDepthTest(false)
+		r.SetCullMode(CullNone)
+	}, func(r *Renderer3D) {
+		r.DrawMesh3D(randomMesh(300, 2), false, DotPixel1x1)
+	}},
+}
+
+// renderScene 用给定的协程数绘制场景，返回绘制上下文与渲染器
+func renderScene(s tiledScene, workers, w, h int, rotate Rotate) (*Paint, *Renderer3D) {
+	p := NewPaint(w, h, rotate, Black)
+	p.SetImage(make([]Color, w*h))
+	p.SetPanelByteOrder(rotate != Rotate0)
+	r := NewRenderer3D(p)
+	r.SetCamera(NewVec3(0.5, 1, 6), NewVec3(0, 0, 0))
+	r.SetPerspectiveProjection(math.Pi/3, float64(p.Width)/float64(p.Height), 0.5, 50)
+	r.SetParallel(workers)
+	s.setup(r)
+	r.Clear(Black)
+	p.ClearDirty()
+	s.draw(r)
+	// 第二次绘制检查深度缓冲区在多次绘制之间保持一致
+	r.ResetModelMatrix()
+	r.TranslateModel(0.3, -0.2, 0.4)
+	s.draw(r)
+	return p, r
+}
+
+func TestTiledMatchesSerial(t *testing.T) {
+	for _, s := range tiledScenes {
+		for _, rotate := range []Rotate{Rotate0, Rotate90} {
+			// 尺寸不是块边长的整数倍，检查边缘的不完整块
+			want, wr := renderScene(s, 1, 150, 110, rotate)
+			for _, workers := range []int{2, 3, 8} {
+				got, gr := renderScene(s, workers, 150, 110, rotate)
+				for i := range want.Image {
+					if got.Image[i] != want.Image[i] {
+						t.Fatalf("%s 旋转 %d 协程 %d：内存 (%d,%d) = %#04x，期望 %#04x",
+							s.name, rotate, workers, i%want.WidthMemory, i/want.WidthMemory, got.Image[i], want.Image[i])
+					}
+				}
+				for i := range wr.depth {
+					if gr.depth[i] != wr.depth[i] {
+						t.Fatalf("%s 协程 %d：深度 %d = %g，期望 %g", s.name, workers, i, gr.depth[i], wr.depth[i])
+					}
+				}
+				// 修改记录覆盖所有绘制的像素
+				rects := got.DirtyRects(0)
+				for y := range got.Height {
+					for x := range got.Width {
+						if got.GetPixel(x, y) == Black {
+							continue
+						}
+						covered := false
+						for _, rc := range rects {
+							if x >= rc.X0 && x < rc.X1 && y >= rc.Y0 && y < rc.Y1 {
+								covered = true
+								break
+							}
+						}
+						if !covered {
+							t.Fatalf("%s 协程 %d：像素 (%d,%d) 没有标记修改", s.name, workers, x, y)
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+func TestTransformBatch(t *testing.T) {
+	m := NewPerspectiveMat4(1, 1.3, 0.5, 20).Mul(NewRotationYMat4(0.4)).Mul(NewTranslationMat4(1, 2, -3))
+	xs, ys, zs := []float64{0, 1, -2.5}, []float64{0, -1, 3}, []float64{0, 2, 0.25}
+	ox, oy, oz, ow := make([]float64, 3), make([]float64, 3), make([]float64, 3), make([]float64, 3)
+	m.TransformBatch(xs, ys, zs, ox, oy, oz, ow)
+	for i := range xs {
+		v := NewVec3(xs[i], ys[i], zs[i])
+		c := m.transformClip(v)
+		if ox[i] != c.x || oy[i] != c.y || oz[i] != c.z || ow[i] != c.w {
+			t.Fatalf("顶点 %d: (%g,%g,%g,%g)，期望 %+v", i, ox[i], oy[i], oz[i], ow[i], c)
+		}
+		p := m.TransformVec3(v)
+		if math.Abs(p.X-ox[i]/ow[i]) > 1e-12 || math.Abs(p.Y-oy[i]/ow[i]) > 1e-12 || math.Abs(p.Z-oz[i]/ow[i]) > 1e-12 {
+			t.Fatalf("顶点 %d 透视除法后与 TransformVec3 不同", i)
+		}
+	}
+}
+
+// BenchmarkDrawMeshTiled 比较串行与分块并行光栅化 240x320 屏幕上的 Gouraud 着色网格
+func BenchmarkDrawMeshTiled(b *testing.B) {
+	mesh := NewSphereMesh(NewVec3(0, 0, 0), 2, White, 48)
+	for _, workers := range []int{1, 2, 4, 0} {
+		name := map[int]string{1: "serial", 2: "workers=2", 4: "workers=4", 0: "workers=max"}[workers]
+		b.Run(name, func(b *testing.B) {
+			p := NewPaint(240, 320, Rotate0, Black)
+			p.SetImage(make([]Color, 240*320))
+			r := NewRenderer3D(p)
+			r.SetCamera(NewVec3(0, 0, 6), NewVec3(0, 0, 0))
+			r.SetPerspectiveProjection(math.Pi/3, 0.75, 0.5, 50)
+			r.SetShading(ShadeGouraud)
+			r.SetParallel(workers)
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				r.Clear(Black)
+				r.DrawMesh3D(mesh, false, DotPixel1x1)
+			}
+		})
+	}
+}
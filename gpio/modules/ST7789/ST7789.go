@@ -23,11 +23,23 @@ const (
 	CS1                  = 0x80 // SPI片选CS1
 )
 
+// DefaultWindowCost 局部刷新时设置一个显示窗口的默认开销，折算为像素数
+// SetWindow 需要约 10 次 SPI 与 GPIO 调用，USB 转 SPI 适配器上每次调用约一个 USB 往返（约 1ms），
+// 7.5MHz 时钟下 1ms 约可传输 470 个像素，因此一个窗口约相当于 4096 个像素。
+const DefaultWindowCost = 4096
+
+// pixelChunk 像素数据每次 SPI 写入的最大字节数
+const pixelChunk = 1024
+
 // Driver 显示屏的LCD驱动
 type Driver struct {
 	*driverTypes
-	spi  driver.SPI
-	gpio driver.GPIO
+	spi        driver.SPI
+	gpio       driver.GPIO
+	windowCost int        // 局部刷新时一个窗口的开销（像素数）
+	pixelBuf   []byte     // 局部刷新的像素数据缓冲区
+	rotate     gui.Rotate // SetRotation 设置的面板方向
+	cmdBuf     [4]byte    // 命令与参数缓冲区，避免每次发送时分配
 }
 
 // DriverType 屏幕类型
@@ -54,6 +66,8 @@ type driverTypes struct {
 	XOffset             int  // X方向偏移量
 	YOffset             int  // Y方向偏移量
 	OffsetScanDependent bool // 偏移量是否依赖扫描方向（true: horizontal时X加偏移，vertical时Y加偏移；false: 总是加偏移）
+	RAMWidth            int  // 控制器显存列数（MADCTL 为 0 时），0 表示 ST7789 的 240
+	RAMHeight           int  // 控制器显存行数（MADCTL 为 0 时），0 表示 ST7789 的 320
 	Commands            []struct {
 		Cmd  byte
 		Data []byte
@@ -67,6 +81,8 @@ var driverType = map[DriverType]*driverTypes{
 		XOffset:             1,
 		YOffset:             26,
 		OffsetScanDependent: false,
+		RAMWidth:            132, // ST7735S
+		RAMHeight:           162,
 		Commands: []struct {
 			Cmd  byte
 			Data []byte
@@ -299,6 +315,8 @@ var driverType = map[DriverType]*driverTypes{
 		XOffset:             2,
 		YOffset:             1,
 		OffsetScanDependent: true,
+		RAMWidth:            132, // ST7735S
+		RAMHeight:           162,
 		Commands: []struct {
 			Cmd  byte
 			Data []byte
@@ -423,7 +441,17 @@ func NewDriver(spi driver.SPI, gpio driver.GPIO, dtype DriverType) *Driver {
 		spi:         spi,
 		gpio:        gpio,
 		driverTypes: driverType[dtype],
+		windowCost:  DefaultWindowCost,
+	}
+}
+
+// SetWindowCost 设置局部刷新时一个显示窗口的开销（像素数），用于决定是否合并相邻的修改区域
+// 直连 SPI 控制器时窗口开销很小，可以设置为几十个像素；0 使用 DefaultWindowCost。
+func (lcd *Driver) SetWindowCost(pixels int) {
+	if pixels <= 0 {
+		pixels = DefaultWindowCost
 	}
+	lcd.windowCost = pixels
 }
 
 // Close 关闭LCD驱动。
@@ -495,6 +523,8 @@ func (lcd *Driver) Init() error {
 	if err := lcd.SPIInit(); err != nil {
 		return err
 	}
+	// 初始化命令恢复默认的 MADCTL
+	lcd.rotate = gui.Rotate0
 	// 发送指令
 	for _, cmd := range lcd.Commands {
 		if err := lcd.SendCommand(cmd.Cmd); err != nil {
@@ -689,10 +719,15 @@ func (lcd *Driver) ShowImage(img image.Image) error {
 }
 
 // ShowPaint 在LCD上显示绘制
+// 面板字节序的帧缓冲区（见 NewFramebuffer）交给 ShowFramebuffer 直接发送。
 func (lcd *Driver) ShowPaint(paint *gui.Paint) error {
 	if paint == nil || paint.Image == nil {
 		return fmt.Errorf("paint or image is nil")
 	}
+	// 面板字节序的帧缓冲区直接发送
+	if paint.PanelByteOrder() {
+		return lcd.ShowFramebuffer(paint)
+	}
 	// 设置窗口覆盖整个物理屏幕
 	// 使用默认水平扫描方向（false），因为我们将按可见坐标顺序发送像素
 	horizontal := false
@@ -755,6 +790,55 @@ func (lcd *Driver) ShowPaint(paint *gui.Paint) error {
 			return err
 		}
 	}
+	paint.ClearDirty()
+	return nil
+}
+
+// ShowPaintDirty 只刷新绘制上下文中自上次刷新以来被修改的区域
+// 修改区域由 gui.Paint 跟踪并按窗口开销合并（见 SetWindowCost），每个区域设置一次窗口并只发送该区域的像素。
+// 面板字节序的帧缓冲区按 SetRotation 设置的方向与偏移设置窗口，直接发送帧缓冲区中的字节（要求同 ShowFramebuffer）。
+// 其他绘制上下文的可见尺寸与屏幕不同时退化为 ShowPaint。刷新成功后清除修改记录。
+func (lcd *Driver) ShowPaintDirty(paint *gui.Paint) error {
+	if paint == nil || paint.Image == nil {
+		return fmt.Errorf("paint or image is nil")
+	}
+	if paint.PanelByteOrder() {
+		return lcd.showFramebufferDirty(paint)
+	}
+	if paint.Width != lcd.Width || paint.Height != lcd.Height {
+		return lcd.ShowPaint(paint)
+	}
+	if !paint.IsDirty() {
+		return nil
+	}
+	for _, r := range paint.DirtyRects(lcd.windowCost) {
+		if err := lcd.SetWindow(r.X0, r.Y0, r.X1, r.Y1, false); err != nil {
+			return err
+		}
+		if err := lcd.DCHigh(); err != nil {
+			return err
+		}
+		buf := lcd.pixelBuf[:0]
+		for y := r.Y0; y < r.Y1; y++ {
+			for x := r.X0; x < r.X1; x++ {
+				c := paint.GetPixel(x, y)
+				buf = append(buf, byte(c>>8), byte(c))
+				if len(buf) == pixelChunk {
+					if err := lcd.spi.Write(false, CS1, buf); err != nil {
+						return err
+					}
+					buf = buf[:0]
+				}
+			}
+		}
+		if len(buf) > 0 {
+			if err := lcd.spi.Write(false, CS1, buf); err != nil {
+				return err
+			}
+		}
+		lcd.pixelBuf = buf
+	}
+	paint.ClearDirty()
 	return nil
 }
 
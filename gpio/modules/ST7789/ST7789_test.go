@@ -0,0 +1,239 @@
+package ST7789
+
+import (
+	"fmt"
+	"testing"
+	"time"
+
+	"circuit/gpio/gui"
+)
+
+// checkPanel 比较模拟屏幕显存与绘制上下文的可见内容
+func checkPanel(t *testing.T, b *VirtualPanel, paint *gui.Paint) {
+	t.Helper()
+	for y := range paint.Height {
+		for x := range paint.Width {
+			if got, want := b.Pixel(x, y), uint16(paint.GetPixel(x, y)); got != want {
+				t.Fatalf("像素 (%d,%d) = %#04x，期望 %#04x", x, y, got, want)
+			}
+		}
+	}
+}
+
+func newTestDisplay(rotate gui.Rotate) (*Driver, *VirtualPanel, *gui.Paint) {
+	lcd, bus := NewVirtualDisplay(Lcd2inch)
+	w, h := lcd.Width, lcd.Height
+	if rotate == gui.Rotate90 || rotate == gui.Rotate270 {
+		w, h = h, w
+	}
+	paint := gui.NewPaint(w, h, rotate, gui.White)
+	paint.SetImage(make([]gui.Color, w*h))
+	paint.Clear(gui.White)
+	return lcd, bus, paint
+}
+
+func TestShowPaintDirty(t *testing.T) {
+	for _, rotate := range []gui.Rotate{gui.Rotate0, gui.Rotate90} {
+		lcd, bus, paint := newTestDisplay(rotate)
+		// 第一次刷新发送整个屏幕
+		if err := lcd.ShowPaintDirty(paint); err != nil {
+			t.Fatal(err)
+		}
+		checkPanel(t, bus, paint)
+		full := bus.Stats().Bytes
+		if full < lcd.Width*lcd.Height*2 {
+			t.Fatalf("第一次刷新只发送 %d 字节", full)
+		}
+		// 没有修改时不发送任何数据
+		bus.ResetStats()
+		lcd.ShowPaintDirty(paint)
+		if st := bus.Stats(); st.Bytes != 0 {
+			t.Fatalf("没有修改时发送 %d 字节", st.Bytes)
+		}
+		// 修改一个仪表读数和屏幕另一端的一个像素
+		paint.ClearWindow(100, 50, 140, 66, gui.Blue)
+		paint.SetPixel(10, 300, gui.Red)
+		bus.ResetStats()
+		if err := lcd.ShowPaintDirty(paint); err != nil {
+			t.Fatal(err)
+		}
+		checkPanel(t, bus, paint)
+		if st := bus.Stats(); st.Windows != 2 || st.Bytes*20 > full {
+			t.Fatalf("局部刷新 %d 个窗口 %d 字节，全屏 %d 字节", st.Windows, st.Bytes, full)
+		}
+		// 相邻的两个小区域在默认窗口开销下合并为一个窗口
+		paint.ClearWindow(20, 20, 28, 28, gui.Green)
+		paint.ClearWindow(40, 20, 48, 28, gui.Green)
+		bus.ResetStats()
+		lcd.ShowPaintDirty(paint)
+		checkPanel(t, bus, paint)
+		if st := bus.Stats(); st.Windows != 1 {
+			t.Fatalf("相邻区域使用 %d 个窗口", st.Windows)
+		}
+		// 窗口开销很小时保持分开
+		lcd.SetWindowCost(1)
+		paint.ClearWindow(20, 20, 28, 28, gui.Red)
+		paint.ClearWindow(40, 20, 48, 28, gui.Red)
+		bus.ResetStats()
+		lcd.ShowPaintDirty(paint)
+		checkPanel(t, bus, paint)
+		if st := bus.Stats(); st.Windows != 2 {
+			t.Fatalf("窗口开销为 1 时使用 %d 个窗口", st.Windows)
+		}
+	}
+}
+
+// reportBus 报告每帧的总线字节数、SPI 传输次数与模型帧延迟
+func reportBus(b *testing.B, bus *VirtualPanel) {
+	st := bus.Stats()
+	b.ReportMetric(float64(st.Bytes)/float64(b.N), "bytes/frame")
+	b.ReportMetric(float64(st.Transfers)/float64(b.N), "writes/frame")
+	b.ReportMetric(float64(st.BusTime.Microseconds())/1000/float64(b.N), "model-ms/frame")
+}
+
+// BenchmarkShowPaint 比较三种刷新方式在虚拟面板上的每帧总线开销，每次调用按 1ms 的 USB 往返计算模型帧延迟
+func BenchmarkShowPaint(b *testing.B) {
+	lcd, bus, paint := newTestDisplay(gui.Rotate0)
+	bus.Overhead = time.Millisecond
+	lcd.ShowPaint(paint)
+	b.Run("full", func(b *testing.B) {
+		bus.ResetStats()
+		for i := 0; i < b.N; i++ {
+			paint.ClearWindow(100, 50, 140, 66, gui.Color(i))
+			lcd.ShowPaint(paint)
+		}
+		reportBus(b, bus)
+	})
+	b.Run("dirty", func(b *testing.B) {
+		bus.ResetStats()
+		for i := 0; i < b.N; i++ {
+			paint.ClearWindow(100, 50, 140, 66, gui.Color(i))
+			lcd.ShowPaintDirty(paint)
+		}
+		reportBus(b, bus)
+	})
+	b.Run("framebuffer", func(b *testing.B) {
+		fb := lcd.NewFramebuffer(gui.White)
+		bus.ResetStats()
+		for i := 0; i < b.N; i++ {
+			fb.ClearWindow(100, 50, 140, 66, gui.Color(i))
+			lcd.ShowFramebuffer(fb)
+		}
+		reportBus(b, bus)
+	})
+}
+
+// drawPattern 绘制覆盖整个可见区域、各方向都不对称的图案
+func drawPattern(p *gui.Paint) {
+	p.Clear(gui.White)
+	p.ClearWindow(0, 0, 30, 10, gui.Red)
+	p.ClearWindow(p.Width-5, p.Height-40, p.Width, p.Height, gui.Blue)
+	p.DrawLine(0, 0, p.Width-1, p.Height/2, gui.Green, gui.DotPixel1x1, gui.LineStyleSolid)
+	for x := range p.Width {
+		p.SetPixel(x, 20, gui.Color(x*7))
+	}
+}
+
+func TestShowFramebuffer(t *testing.T) {
+	for _, rotate := range []gui.Rotate{gui.Rotate0, gui.Rotate90, gui.Rotate180, gui.Rotate270} {
+		// 参考：内存缓冲区与面板显存方向相同、按 rotate 旋转可见坐标的 Paint
+		paint := gui.NewPaint(240, 320, rotate, gui.White)
+		paint.SetImage(make([]gui.Color, 240*320))
+		drawPattern(paint)
+		// 帧缓冲区：按可见方向存储，旋转由 MADCTL 完成
+		lcd, bus := NewVirtualDisplay(Lcd2inch)
+		if err := lcd.SetRotation(rotate); err != nil {
+			t.Fatal(err)
+		}
+		fb := lcd.NewFramebuffer(gui.White)
+		if fb.Width != paint.Width || fb.Height != paint.Height {
+			t.Fatalf("%d°: 帧缓冲区 %dx%d，期望 %dx%d", rotate, fb.Width, fb.Height, paint.Width, paint.Height)
+		}
+		drawPattern(fb)
+		if fb.GetPixel(28, 1) != gui.Red {
+			t.Fatalf("%d°: GetPixel = %#04x", rotate, fb.GetPixel(28, 1))
+		}
+		bus.ResetStats()
+		if err := lcd.ShowFramebuffer(fb); err != nil {
+			t.Fatal(err)
+		}
+		for i := range paint.Image {
+			if x, y := i%240, i/240; bus.Pixel(x, y) != uint16(paint.Image[i]) {
+				t.Fatalf("%d°: 显存 (%d,%d) = %#04x，期望 %#04x", rotate, x, y, bus.Pixel(x, y), paint.Image[i])
+			}
+		}
+		// 像素数据一次写入
+		if want, st := fb.Width*fb.Height*2+3+2*4, bus.Stats(); st.Bytes != want || st.Transfers != 6 {
+			t.Fatalf("%d°: 发送 %d 字节 %d 次，期望 %d 字节 6 次", rotate, st.Bytes, st.Transfers, want)
+		}
+		if fb.IsDirty() {
+			t.Fatalf("%d°: 刷新后仍有修改记录", rotate)
+		}
+		if allocs := testing.AllocsPerRun(10, func() { lcd.ShowFramebuffer(fb) }); allocs != 0 {
+			t.Fatalf("%d°: 每帧分配 %.0f 次", rotate, allocs)
+		}
+	}
+	// 不是面板字节序或尺寸不符时返回错误
+	lcd, _, paint := newTestDisplay(gui.Rotate0)
+	if lcd.ShowFramebuffer(paint) == nil {
+		t.Fatal("普通 Paint 应返回错误")
+	}
+	fb := lcd.NewFramebuffer(gui.White)
+	lcd.SetRotation(gui.Rotate90)
+	if lcd.ShowFramebuffer(fb) == nil {
+		t.Fatal("尺寸不符应返回错误")
+	}
+}
+
+func TestOrientationOffsets(t *testing.T) {
+	// 带偏移的面板：旋转后可见区域仍落在显存中的同一位置
+	for _, dtype := range []DriverType{Lcd1in14, Lcd1in69, Lcd0in96, Lcd1in47} {
+		lcd := NewDriver(nil, nil, dtype)
+		ramW, ramH := lcd.ramSize()
+		base := orientationOf(lcd.baseMADCTL())
+		_, col0, row0, w0, h0 := lcd.frameGeometry()
+		x0, y0 := base.apply(col0, row0, ramW, ramH)
+		x1, y1 := base.apply(col0+w0-1, row0+h0-1, ramW, ramH)
+		for _, rotate := range []gui.Rotate{gui.Rotate90, gui.Rotate180, gui.Rotate270} {
+			lcd.rotate = rotate
+			madctl, col, row, w, h := lcd.frameGeometry()
+			o := orientationOf(madctl)
+			a, b := o.apply(col, row, ramW, ramH)
+			c, d := o.apply(col+w-1, row+h-1, ramW, ramH)
+			if min(a, c) != min(x0, x1) || max(a, c) != max(x0, x1) || min(b, d) != min(y0, y1) || max(b, d) != max(y0, y1) {
+				t.Fatalf("类型 %d %d°: 显存区域 (%d,%d)-(%d,%d)，期望 (%d,%d)-(%d,%d)", dtype, rotate, a, b, c, d, x0, y0, x1, y1)
+			}
+		}
+	}
+}
+
+// BenchmarkFramePush 比较整帧刷新的主机 CPU 时间：ShowPaint 逐像素旋转与转换，ShowFramebuffer 直接交出缓冲区
+func BenchmarkFramePush(b *testing.B) {
+	for _, rotate := range []gui.Rotate{gui.Rotate0, gui.Rotate90} {
+		b.Run(fmt.Sprintf("ShowPaint/%d", rotate), func(b *testing.B) {
+			lcd, bus, paint := newTestDisplay(rotate)
+			lcd.spi = discardSPI{bus}
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				lcd.ShowPaint(paint)
+			}
+		})
+		b.Run(fmt.Sprintf("ShowFramebuffer/%d", rotate), func(b *testing.B) {
+			lcd, bus, _ := newTestDisplay(gui.Rotate0)
+			lcd.spi = discardSPI{bus}
+			lcd.SetRotation(rotate)
+			fb := lcd.NewFramebuffer(gui.White)
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				lcd.ShowFramebuffer(fb)
+			}
+		})
+	}
+}
+
+// discardSPI 丢弃写入数据的 SPI，基准测试只计量主机侧的开销
+type discardSPI struct {
+	*VirtualPanel
+}
+
+func (discardSPI) Write(ignoreCS bool, cs uint8, data []byte) error { return nil }
@@ -0,0 +1,277 @@
+package ST7789
+
+import (
+	"errors"
+	"fmt"
+
+	"circuit/gpio/gui"
+)
+
+// MADCTL（0x36）中的扫描方向位
+const (
+	madctlMY = 0x80 // 行地址逆序
+	madctlMX = 0x40 // 列地址逆序
+	madctlMV = 0x20 // 行列交换
+)
+
+// orientation 列/行地址到显存坐标的映射，对应 MADCTL 的 MY、MX、MV 位
+// 地址 (c, r) 先按 MV 交换，再按 MX、MY 在显存范围内镜像。
+type orientation struct {
+	mv, mx, my bool
+}
+
+// orientationOf 从 MADCTL 值取出扫描方向
+func orientationOf(madctl byte) orientation {
+	return orientation{madctl&madctlMV != 0, madctl&madctlMX != 0, madctl&madctlMY != 0}
+}
+
+// bits 返回扫描方向对应的 MADCTL 位
+func (o orientation) bits() byte {
+	var b byte
+	if o.mv {
+		b |= madctlMV
+	}
+	if o.mx {
+		b |= madctlMX
+	}
+	if o.my {
+		b |= madctlMY
+	}
+	return b
+}
+
+// apply 把地址 (c, r) 映射到 ramW x ramH 显存中的坐标
+func (o orientation) apply(c, r, ramW, ramH int) (int, int) {
+	if o.mv {
+		c, r = r, c
+	}
+	if o.mx {
+		c = ramW - 1 - c
+	}
+	if o.my {
+		r = ramH - 1 - r
+	}
+	return c, r
+}
+
+// invert 把显存坐标映射回地址，是 apply 的逆映射
+func (o orientation) invert(x, y, ramW, ramH int) (int, int) {
+	if o.mx {
+		x = ramW - 1 - x
+	}
+	if o.my {
+		y = ramH - 1 - y
+	}
+	if o.mv {
+		x, y = y, x
+	}
+	return x, y
+}
+
+// rotate 先按 gui.Paint 的旋转把可见坐标变换到原方向坐标，再应用 o
+// 返回的扫描方向使面板直接按可见坐标接收像素。
+func (o orientation) rotate(rotate gui.Rotate) orientation {
+	// 原方向坐标为 (±x 或 ±y, ±y 或 ±x)，用 swap 与符号表示旋转
+	swap, nx, ny := false, false, false
+	switch rotate {
+	case gui.Rotate90: // (W-1-y, x)
+		swap, nx = true, true
+	case gui.Rotate180: // (W-1-x, H-1-y)
+		nx, ny = true, true
+	case gui.Rotate270: // (y, H-1-x)
+		swap, ny = true, true
+	}
+	// 原方向坐标经 o 映射：交换后镜像，镜像跟随坐标轴移动
+	if o.mv {
+		nx, ny = ny, nx
+	}
+	return orientation{mv: swap != o.mv, mx: nx != o.mx, my: ny != o.my}
+}
+
+// baseMADCTL 返回初始化命令设置的 MADCTL 值
+func (lcd *Driver) baseMADCTL() byte {
+	var v byte
+	for _, cmd := range lcd.Commands {
+		if cmd.Cmd == 0x36 && len(cmd.Data) > 0 {
+			v = cmd.Data[0]
+		}
+	}
+	return v
+}
+
+// ramSize 返回控制器显存尺寸（MADCTL 为 0 时的列数与行数）
+func (lcd *Driver) ramSize() (int, int) {
+	w, h := lcd.RAMWidth, lcd.RAMHeight
+	if w == 0 || h == 0 {
+		w, h = 240, 320
+	}
+	return w, h
+}
+
+// frameGeometry 计算当前方向下的 MADCTL 值、可见区域的列/行地址偏移和可见尺寸
+// 偏移按 ShowPaint（垂直扫描的 SetWindow）的规则确定，使两种刷新方式显示的位置相同。
+func (lcd *Driver) frameGeometry() (madctl byte, col, row, width, height int) {
+	base := lcd.baseMADCTL()
+	o := orientationOf(base)
+	ramW, ramH := lcd.ramSize()
+	col, row = lcd.XOffset, lcd.YOffset
+	if lcd.OffsetScanDependent {
+		col = 0
+	}
+	width, height = lcd.Width, lcd.Height
+	if lcd.rotate == gui.Rotate0 {
+		return base, col, row, width, height
+	}
+	// 可见区域左上角在原方向地址中的位置（与 gui.Paint.transform 相同）
+	var x, y int
+	switch lcd.rotate {
+	case gui.Rotate90:
+		x, y = width-1, 0
+	case gui.Rotate180:
+		x, y = width-1, height-1
+	case gui.Rotate270:
+		x, y = 0, height-1
+	}
+	n := o.rotate(lcd.rotate)
+	gx, gy := o.apply(col+x, row+y, ramW, ramH)
+	col, row = n.invert(gx, gy, ramW, ramH)
+	if lcd.rotate == gui.Rotate90 || lcd.rotate == gui.Rotate270 {
+		width, height = height, width
+	}
+	return base&^(madctlMY|madctlMX|madctlMV) | n.bits(), col, row, width, height
+}
+
+// command 发送命令及其参数，使用驱动内的缓冲区，不分配内存
+func (lcd *Driver) command(cmd byte, args ...byte) error {
+	lcd.cmdBuf[0] = cmd
+	if err := lcd.DCLow(); err != nil {
+		return err
+	}
+	if err := lcd.spi.Write(false, CS1, lcd.cmdBuf[:1]); err != nil {
+		return err
+	}
+	if len(args) == 0 {
+		return nil
+	}
+	n := copy(lcd.cmdBuf[:], args)
+	if err := lcd.DCHigh(); err != nil {
+		return err
+	}
+	return lcd.spi.Write(false, CS1, lcd.cmdBuf[:n])
+}
+
+// SetRotation 通过面板的 MADCTL 寄存器设置显示方向，旋转方向与 gui.Paint 相同
+// 设置后 ShowFramebuffer 按旋转后的可见坐标逐行发送像素，旋转由面板的地址计数器完成，主机不做任何坐标变换。
+// SetRotation 只影响 ShowFramebuffer；使用 ShowPaint 等按原方向发送的函数前需要恢复为 gui.Rotate0。
+func (lcd *Driver) SetRotation(rotate gui.Rotate) error {
+	switch rotate {
+	case gui.Rotate0, gui.Rotate90, gui.Rotate180, gui.Rotate270:
+	default:
+		return errors.New("rotate must be Rotate0, Rotate90, Rotate180, or Rotate270")
+	}
+	lcd.rotate = rotate
+	madctl, _, _, _, _ := lcd.frameGeometry()
+	return lcd.command(0x36, madctl)
+}
+
+// FrameSize 返回当前显示方向下的可见宽度和高度
+func (lcd *Driver) FrameSize() (width, height int) {
+	_, _, _, width, height = lcd.frameGeometry()
+	return width, height
+}
+
+// NewFramebuffer 创建与当前显示方向匹配的帧缓冲区绘制上下文
+// 图像缓冲区按面板字节序（RGB565 大端）存储，可以直接交给 ShowFramebuffer 发送。
+//
+// 示例用法：
+//
+//	lcd.SetRotation(gui.Rotate90)
+//	fb := lcd.NewFramebuffer(gui.White)
+//	fb.DrawString(10, 10, "Hello", face, gui.White, gui.Black)
+//	lcd.ShowFramebuffer(fb)
+func (lcd *Driver) NewFramebuffer(color gui.Color) *gui.Paint {
+	width, height := lcd.FrameSize()
+	paint := gui.NewPaint(width, height, gui.Rotate0, color)
+	paint.SetImage(make([]gui.Color, width*height))
+	paint.SetPanelByteOrder(true)
+	paint.Clear(color)
+	return paint
+}
+
+// framebuffer 检查帧缓冲区与当前方向匹配，返回像素数据与可见区域的列/行地址偏移和尺寸
+func (lcd *Driver) framebuffer(paint *gui.Paint) (data []byte, col, row, width, height int, err error) {
+	if paint == nil {
+		return nil, 0, 0, 0, 0, errors.New("paint is nil")
+	}
+	data = paint.PanelBytes()
+	if data == nil {
+		return nil, 0, 0, 0, 0, errors.New("paint is not a panel byte order framebuffer")
+	}
+	_, col, row, width, height = lcd.frameGeometry()
+	if paint.Rotate != gui.Rotate0 || paint.Mirror != gui.MirrorNone || paint.WidthMemory != width || paint.HeightMemory != height {
+		return nil, 0, 0, 0, 0, fmt.Errorf("framebuffer must be %dx%d without rotation or mirror", width, height)
+	}
+	return data, col, row, width, height, nil
+}
+
+// ramWindow 设置列/行地址窗口 [x0, x1) x [y0, y1)，开始内存写入并切换到数据模式
+func (lcd *Driver) ramWindow(x0, y0, x1, y1 int) error {
+	if err := lcd.command(0x2A, byte(x0>>8), byte(x0), byte((x1-1)>>8), byte(x1-1)); err != nil {
+		return err
+	}
+	if err := lcd.command(0x2B, byte(y0>>8), byte(y0), byte((y1-1)>>8), byte(y1-1)); err != nil {
+		return err
+	}
+	if err := lcd.command(0x2C); err != nil {
+		return err
+	}
+	return lcd.DCHigh()
+}
+
+// ShowFramebuffer 把面板字节序的帧缓冲区整帧发送到屏幕
+// 帧缓冲区必须按面板字节序存储（见 gui.Paint.SetPanelByteOrder），不旋转、不镜像，尺寸与 FrameSize 相同。
+// 缓冲区原样交给 SPI 写入，不做像素转换，也不分配内存。刷新成功后清除修改记录。
+func (lcd *Driver) ShowFramebuffer(paint *gui.Paint) error {
+	data, col, row, width, height, err := lcd.framebuffer(paint)
+	if err != nil {
+		return err
+	}
+	if err := lcd.ramWindow(col, row, col+width, row+height); err != nil {
+		return err
+	}
+	if err := lcd.spi.Write(false, CS1, data); err != nil {
+		return err
+	}
+	paint.ClearDirty()
+	return nil
+}
+
+// showFramebufferDirty 只发送帧缓冲区的修改区域，窗口按当前方向的列/行地址偏移设置
+// 整行宽度的区域直接交出帧缓冲区中连续的字节，其他区域逐行复制到像素缓冲区后一次写入。
+func (lcd *Driver) showFramebufferDirty(paint *gui.Paint) error {
+	data, col, row, width, _, err := lcd.framebuffer(paint)
+	if err != nil {
+		return err
+	}
+	if !paint.IsDirty() {
+		return nil
+	}
+	for _, r := range paint.DirtyRects(lcd.windowCost) {
+		if err := lcd.ramWindow(col+r.X0, row+r.Y0, col+r.X1, row+r.Y1); err != nil {
+			return err
+		}
+		chunk := data[r.Y0*width*2 : r.Y1*width*2]
+		if r.Dx() != width {
+			buf := lcd.pixelBuf[:0]
+			for y := r.Y0; y < r.Y1; y++ {
+				buf = append(buf, data[(y*width+r.X0)*2:(y*width+r.X1)*2]...)
+			}
+			lcd.pixelBuf, chunk = buf, buf
+		}
+		if err := lcd.spi.Write(false, CS1, chunk); err != nil {
+			return err
+		}
+	}
+	paint.ClearDirty()
+	return nil
+}
@@ -0,0 +1,209 @@
+package ST7789
+
+import (
+	"errors"
+	"sync"
+	"time"
+
+	"circuit/gpio/gui"
+)
+
+// ErrPresenterClosed 呈现器已关闭
+var ErrPresenterClosed = errors.New("ST7789: presenter closed")
+
+// PresenterStats 呈现器统计
+type PresenterStats struct {
+	Submitted    uint64        // Present 提交的帧数
+	Presented    uint64        // 发送到屏幕的帧数
+	Dropped      uint64        // 三缓冲时被更新的帧替换而没有发送的帧数
+	Late         uint64        // 开始发送时已错过一个以上节拍的帧数（发送或绘制超过了帧间隔）
+	LastTransfer time.Duration // 最近一帧的发送时间
+	MaxTransfer  time.Duration // 最长的一帧发送时间
+}
+
+// Presenter 双缓冲/三缓冲的异步显示流水线
+// 应用在后台缓冲区中绘制，Present 把它交给后台协程整帧发送（ShowFramebuffer），
+// 发送期间应用可以获取另一个缓冲区绘制下一帧，绘制与 SPI 传输互相重叠。
+//
+// 双缓冲时帧按提交顺序全部发送：发送中的帧没有完成前 BackBuffer 等待，相当于垂直同步交换。
+// 三缓冲时 Present 不等待，等待发送的帧被更新的帧替换并计入 Dropped，屏幕总是显示最新的一帧。
+// 帧间隔大于 0 时两帧开始发送的时间至少相隔一个帧间隔。
+//
+// 呈现器运行期间由后台协程独占驱动，不要直接调用 Driver 的其他方法。
+//
+// 示例用法：
+//
+//	p := ST7789.NewPresenter(lcd, 2, time.Second/30)
+//	defer p.Close()
+//	for {
+//		fb, err := p.BackBuffer()
+//		if err != nil {
+//			break
+//		}
+//		drawFrame(fb)
+//		p.Present(fb)
+//	}
+type Presenter struct {
+	lcd      *Driver
+	interval time.Duration
+	mailbox  bool
+
+	mu       sync.Mutex
+	cond     *sync.Cond
+	free     []*gui.Paint // 可以绘制的缓冲区
+	queue    []*gui.Paint // 等待发送的帧
+	last     *gui.Paint   // 最近提交的帧
+	preserve bool
+	closed   bool
+	err      error
+	stats    PresenterStats
+	done     chan struct{}
+}
+
+// NewPresenter 创建呈现器并启动发送协程
+// 参数:
+//   - lcd: 显示驱动，缓冲区按其当前方向创建（见 SetRotation、NewFramebuffer）
+//   - buffers: 缓冲区数，2 为双缓冲，3 为三缓冲，其他值按最接近的处理
+//   - interval: 帧间隔，0 表示不限制帧率
+func NewPresenter(lcd *Driver, buffers int, interval time.Duration) *Presenter {
+	buffers = min(max(buffers, 2), 3)
+	p := &Presenter{
+		lcd:      lcd,
+		interval: interval,
+		mailbox:  buffers == 3,
+		done:     make(chan struct{}),
+	}
+	p.cond = sync.NewCond(&p.mu)
+	for range buffers {
+		p.free = append(p.free, lcd.NewFramebuffer(gui.Black))
+	}
+	go p.run()
+	return p
+}
+
+// SetPreserve 设置 BackBuffer 是否先复制最近提交的帧
+// 开启后每帧只需重绘变化的部分（例如曲线区域），代价是每帧一次缓冲区复制。
+func (p *Presenter) SetPreserve(enable bool) {
+	p.mu.Lock()
+	p.preserve = enable
+	p.mu.Unlock()
+}
+
+// BackBuffer 获取一个可以绘制的缓冲区，没有空闲缓冲区时等待正在发送的帧完成
+// 返回的缓冲区必须通过 Present 交回。呈现器关闭或发送出错后返回错误。
+func (p *Presenter) BackBuffer() (*gui.Paint, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	for len(p.free) == 0 && !p.closed && p.err == nil {
+		p.cond.Wait()
+	}
+	if p.err != nil {
+		return nil, p.err
+	}
+	if p.closed {
+		return nil, ErrPresenterClosed
+	}
+	fb := p.free[len(p.free)-1]
+	p.free = p.free[:len(p.free)-1]
+	if p.preserve && p.last != nil && p.last != fb {
+		copy(fb.Image, p.last.Image)
+	}
+	return fb, nil
+}
+
+// Present 提交绘制完成的缓冲区，由后台协程发送到屏幕
+// 三缓冲时替换尚未开始发送的帧。返回此前发送中出现的错误。
+func (p *Presenter) Present(fb *gui.Paint) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if p.err != nil {
+		return p.err
+	}
+	if p.closed {
+		return ErrPresenterClosed
+	}
+	p.stats.Submitted++
+	if p.mailbox && len(p.queue) > 0 {
+		p.free = append(p.free, p.queue...)
+		p.stats.Dropped += uint64(len(p.queue))
+		p.queue = p.queue[:0]
+	}
+	p.queue = append(p.queue, fb)
+	p.last = fb
+	p.cond.Broadcast()
+	return nil
+}
+
+// Stats 返回呈现器统计
+func (p *Presenter) Stats() PresenterStats {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.stats
+}
+
+// Close 等待已提交的帧发送完成并停止发送协程，返回发送中出现的错误
+func (p *Presenter) Close() error {
+	p.mu.Lock()
+	if !p.closed {
+		p.closed = true
+		p.cond.Broadcast()
+	}
+	p.mu.Unlock()
+	<-p.done
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.err
+}
+
+// run 发送协程：按帧间隔依次发送队列中的帧，发送完成后把缓冲区放回空闲列表
+func (p *Presenter) run() {
+	defer close(p.done)
+	var next time.Time // 下一帧最早的开始时间
+	for {
+		p.mu.Lock()
+		for len(p.queue) == 0 && !p.closed {
+			p.cond.Wait()
+		}
+		if len(p.queue) == 0 || p.err != nil {
+			p.mu.Unlock()
+			return
+		}
+		// 等待节拍时刻，期间提交的更新的帧仍可以替换队首的帧
+		if wait := time.Until(next); wait > 0 && p.interval > 0 {
+			p.mu.Unlock()
+			time.Sleep(wait)
+			p.mu.Lock()
+		}
+		fb := p.queue[0]
+		p.queue = p.queue[:copy(p.queue, p.queue[1:])]
+		p.mu.Unlock()
+
+		start := time.Now()
+		if p.interval > 0 {
+			if !next.IsZero() && start.Sub(next) >= p.interval {
+				p.mu.Lock()
+				p.stats.Late++
+				p.mu.Unlock()
+			}
+			// 落后超过一帧时从当前时间重新计算节拍，不追赶
+			if next.IsZero() || start.Sub(next) >= p.interval {
+				next = start
+			}
+			next = next.Add(p.interval)
+		}
+		err := p.lcd.ShowFramebuffer(fb)
+		elapsed := time.Since(start)
+
+		p.mu.Lock()
+		p.free = append(p.free, fb)
+		if err != nil {
+			p.err = err
+		} else {
+			p.stats.Presented++
+		}
+		p.stats.LastTransfer = elapsed
+		p.stats.MaxTransfer = max(p.stats.MaxTransfer, elapsed)
+		p.cond.Broadcast()
+		p.mu.Unlock()
+	}
+}
@@ -0,0 +1,133 @@
+package ST7789
+
+import (
+	"errors"
+	"testing"
+	"time"
+
+	"circuit/gpio/gui"
+)
+
+// slowSPI 像素数据写入需要 delay 的 SPI，模拟整帧传输时间
+// 像素数据不解码，只记录帧的第一个像素。
+type slowSPI struct {
+	*VirtualPanel
+	delay time.Duration
+	err   error
+	first gui.Color // 最近一帧的第一个像素
+}
+
+func (s *slowSPI) Write(ignoreCS bool, cs uint8, data []byte) error {
+	if len(data) <= 4 {
+		return s.VirtualPanel.Write(ignoreCS, cs, data)
+	}
+	time.Sleep(s.delay)
+	s.first = gui.Color(data[0])<<8 | gui.Color(data[1])
+	return s.err
+}
+
+func newSlowDisplay(delay time.Duration) (*Driver, *slowSPI) {
+	lcd, panel := NewVirtualDisplay(Lcd2inch)
+	bus := &slowSPI{VirtualPanel: panel, delay: delay}
+	lcd.spi = bus
+	return lcd, bus
+}
+
+func TestPresenterOverlap(t *testing.T) {
+	const frames = 10
+	const cost = 10 * time.Millisecond
+	lcd, bus := newSlowDisplay(cost)
+	p := NewPresenter(lcd, 2, 0)
+	start := time.Now()
+	for i := range frames {
+		fb, err := p.BackBuffer()
+		if err != nil {
+			t.Fatal(err)
+		}
+		fb.Clear(gui.Color(i + 1))
+		time.Sleep(cost) // 绘制时间与发送时间相同
+		if err := p.Present(fb); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := p.Close(); err != nil {
+		t.Fatal(err)
+	}
+	// 串行需要 frames*2*cost，重叠后约为 (frames+1)*cost
+	if elapsed := time.Since(start); elapsed > frames*2*cost*8/10 {
+		t.Fatalf("%d 帧用时 %v，绘制与发送没有重叠", frames, elapsed)
+	}
+	s := p.Stats()
+	if s.Submitted != frames || s.Presented != frames || s.Dropped != 0 {
+		t.Fatalf("统计 %+v", s)
+	}
+	if got := bus.first; got != frames {
+		t.Fatalf("屏幕显示第 %d 帧，期望第 %d 帧", got, frames)
+	}
+	if _, err := p.BackBuffer(); err != ErrPresenterClosed {
+		t.Fatalf("关闭后 BackBuffer 返回 %v", err)
+	}
+}
+
+func TestPresenterTripleDrops(t *testing.T) {
+	const frames = 20
+	lcd, bus := newSlowDisplay(20 * time.Millisecond)
+	p := NewPresenter(lcd, 3, 0)
+	for i := range frames {
+		fb, err := p.BackBuffer()
+		if err != nil {
+			t.Fatal(err)
+		}
+		fb.Clear(gui.Color(i + 1))
+		p.Present(fb)
+	}
+	p.Close()
+	s := p.Stats()
+	if s.Dropped == 0 || s.Presented+s.Dropped != frames || s.Submitted != frames {
+		t.Fatalf("统计 %+v", s)
+	}
+	// 最后提交的帧总是被发送
+	if got := bus.first; got != frames {
+		t.Fatalf("屏幕显示第 %d 帧，期望第 %d 帧", got, frames)
+	}
+}
+
+func TestPresenterPacing(t *testing.T) {
+	const frames = 5
+	const interval = 10 * time.Millisecond
+	lcd, _ := newSlowDisplay(0)
+	p := NewPresenter(lcd, 2, interval)
+	p.SetPreserve(true)
+	start := time.Now()
+	for i := range frames {
+		fb, _ := p.BackBuffer()
+		fb.SetPixel(i, 0, gui.Red)
+		p.Present(fb)
+	}
+	p.Close()
+	if elapsed := time.Since(start); elapsed < (frames-1)*interval {
+		t.Fatalf("%d 帧用时 %v，少于帧间隔", frames, elapsed)
+	}
+	// 保留模式下每帧都包含之前绘制的内容
+	fb := p.last
+	for i := range frames {
+		if fb.GetPixel(i, 0) != gui.Red {
+			t.Fatalf("像素 %d 没有保留", i)
+		}
+	}
+}
+
+func TestPresenterError(t *testing.T) {
+	lcd, bus := newSlowDisplay(0)
+	fail := errors.New("usb disconnected")
+	bus.err = fail
+	p := NewPresenter(lcd, 2, 0)
+	fb, _ := p.BackBuffer()
+	p.Present(fb)
+	if err := p.Close(); err != fail {
+		t.Fatalf("Close 返回 %v", err)
+	}
+	if err := p.Present(fb); err != fail {
+		t.Fatalf("Present 返回 %v", err)
+	}
+}
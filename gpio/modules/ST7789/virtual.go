@@ -0,0 +1,408 @@
+package ST7789
+
+import (
+	"image"
+	"image/color"
+	"sync"
+	"time"
+	"unsafe"
+
+	"circuit/gpio/driver"
+)
+
+// 编译期检查虚拟面板实现 driver.SPI 与 driver.GPIO
+var (
+	_ driver.SPI  = (*VirtualPanel)(nil)
+	_ driver.GPIO = (*VirtualPanel)(nil)
+)
+
+// DefaultVirtualClock 虚拟面板的默认 SPI 时钟，与 SPIInit 设置的频率相同
+const DefaultVirtualClock = 7500000
+
+// VirtualStats 虚拟面板的总线统计
+type VirtualStats struct {
+	Bytes     int // SPI 写入的字节数
+	Transfers int // SPI 传输次数（Write/Read/WriteRead/ChangeCS）
+	GPIOCalls int // GPIO Set 调用次数
+	Commands  int // 收到的命令字节数
+	Windows   int // 内存写入（RAMWR）次数
+	Pixels    int // 写入显存的像素数
+	Overflow  int // 超出窗口、回绕到窗口起点的像素数
+	// BusTime 模型总线时间：每个字节 8 个 SPI 时钟周期，加上每次 SPI 传输与 GPIO 调用的固定开销 (Overhead)
+	BusTime time.Duration
+}
+
+// VirtualPanel 进程内的虚拟 ST7789 面板，同时实现 driver.SPI 与 driver.GPIO
+//
+// 按 DC 引脚电平区分命令与数据，解释 CASET(0x2A)/RASET(0x2B)/RAMWR(0x2C)/RAMWRC(0x3C)/MADCTL(0x36)，
+// 把像素按扫描方向写入控制器显存；复位引脚拉低或 SWRESET(0x01) 恢复寄存器默认值（显存内容保持不变），
+// 其他命令只记录显示开关、睡眠与反色状态。同时统计字节数、传输次数与按 SPI 时钟计算的模型总线时间，
+// 没有硬件时可以测试显示流程、比较参考图像，并在基准测试中报告每帧字节数与模型帧延迟。
+// 读取返回全 0（不模拟 MISO）。虚拟面板是并发安全的。
+//
+// 示例用法：
+//
+//	lcd, panel := ST7789.NewVirtualDisplay(ST7789.Lcd2inch)
+//	panel.Overhead = time.Millisecond // USB 转 SPI 适配器的往返时间
+//	lcd.ShowPaint(paint)
+//	st := panel.Stats()
+//	fmt.Println(st.Bytes, st.BusTime)
+//	png.Encode(f, panel.Image())
+type VirtualPanel struct {
+	// Overhead 每次 SPI 传输与 GPIO 调用的固定开销，计入 BusTime；应在使用前设置
+	Overhead time.Duration
+
+	mu       sync.Mutex
+	ramW     int
+	ramH     int
+	view     orientation // 初始化命令的扫描方向，Image 按它把可见坐标映射到显存
+	col, row int         // 可见区域左上角的列/行地址
+	w, h     int         // 可见尺寸
+	ram      []uint16
+	clock    uint32
+	dir      uint8 // GPIO 方向
+	level    uint8 // GPIO 输出电平
+	cmd      byte
+	args     []byte
+	x0, x1   int
+	y0, y1   int
+	x, y     int
+	half     int // 内存写入中已收到的像素高字节（-1 表示没有）
+	madctl   byte
+	colmod   byte
+	on       bool // DISPON
+	sleeping bool // SLPIN
+	inverted bool // INVON
+	stats    VirtualStats
+}
+
+// NewVirtualPanel 创建与 dtype 屏幕相同显存尺寸与可见区域的虚拟面板
+// 初始状态与上电复位后相同：复位引脚为高电平，显存为 0。
+func NewVirtualPanel(dtype DriverType) *VirtualPanel {
+	lcd := &Driver{driverTypes: driverType[dtype]}
+	ramW, ramH := lcd.ramSize()
+	madctl, col, row, w, h := lcd.frameGeometry()
+	p := &VirtualPanel{
+		ramW:  ramW,
+		ramH:  ramH,
+		view:  orientationOf(madctl),
+		col:   col,
+		row:   row,
+		w:     w,
+		h:     h,
+		ram:   make([]uint16, ramW*ramH),
+		clock: DefaultVirtualClock,
+		dir:   OLED_Reset_SetDirOut,
+		level: OLED_Reset_OUT_H,
+		args:  make([]byte, 0, 4),
+	}
+	p.hardReset()
+	return p
+}
+
+// NewVirtualDisplay 创建连接到虚拟面板的驱动
+func NewVirtualDisplay(dtype DriverType) (*Driver, *VirtualPanel) {
+	p := NewVirtualPanel(dtype)
+	return NewDriver(p, p, dtype), p
+}
+
+// hardReset 恢复寄存器默认值
+func (p *VirtualPanel) hardReset() {
+	p.cmd, p.args, p.half = 0, p.args[:0], -1
+	p.madctl, p.colmod = 0, 0x66
+	p.x0, p.x1, p.y0, p.y1 = 0, p.ramW-1, 0, p.ramH-1
+	p.x, p.y = 0, 0
+	p.on, p.sleeping, p.inverted = false, true, false
+}
+
+// Stats 返回总线统计
+func (p *VirtualPanel) Stats() VirtualStats {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.stats
+}
+
+// ResetStats 清零总线统计，显存与寄存器状态不变
+func (p *VirtualPanel) ResetStats() {
+	p.mu.Lock()
+	p.stats = VirtualStats{}
+	p.mu.Unlock()
+}
+
+// Pixel 返回显存坐标 (x, y) 的 RGB565 像素，超出显存返回 0
+func (p *VirtualPanel) Pixel(x, y int) uint16 {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if x < 0 || x >= p.ramW || y < 0 || y >= p.ramH {
+		return 0
+	}
+	return p.ram[y*p.ramW+x]
+}
+
+// MADCTL 返回当前的扫描方向寄存器
+func (p *VirtualPanel) MADCTL() byte {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.madctl
+}
+
+// DisplayOn 返回面板是否已退出睡眠并打开显示
+func (p *VirtualPanel) DisplayOn() bool {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.on && !p.sleeping
+}
+
+// Inverted 返回是否打开了显示反色（INVON）
+func (p *VirtualPanel) Inverted() bool {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.inverted
+}
+
+// visible 返回未旋转时可见坐标 (x, y) 处的显存像素，地址超出显存返回 0
+func (p *VirtualPanel) visible(x, y int) uint16 {
+	gx, gy := p.view.apply(p.col+x, p.row+y, p.ramW, p.ramH)
+	if gx < 0 || gx >= p.ramW || gy < 0 || gy >= p.ramH {
+		return 0
+	}
+	return p.ram[gy*p.ramW+gx]
+}
+
+// Image 把可见区域转换为屏幕类型宽高的图像，方向与未旋转（初始化命令的 MADCTL）时的可见坐标相同
+// RGB565 按位复制扩展到 8 位，经 RGB888ToRGB565 转换回去与显存内容相同。显示反色不影响结果。
+func (p *VirtualPanel) Image() *image.RGBA {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	img := image.NewRGBA(image.Rect(0, 0, p.w, p.h))
+	for y := 0; y < p.h; y++ {
+		for x := 0; x < p.w; x++ {
+			img.SetRGBA(x, y, rgb565ToRGBA(p.visible(x, y)))
+		}
+	}
+	return img
+}
+
+// Compare 按 RGB565 比较可见区域与图像
+// 返回值: 不同的像素数与第一个不同像素的位置（与 Image 的坐标相同）；尺寸不同时返回 -1
+func (p *VirtualPanel) Compare(img image.Image) (int, image.Point) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	b := img.Bounds()
+	if b.Dx() != p.w || b.Dy() != p.h {
+		return -1, image.Point{}
+	}
+	n, first := 0, image.Point{}
+	for y := 0; y < p.h; y++ {
+		for x := 0; x < p.w; x++ {
+			cr, cg, cb, _ := img.At(b.Min.X+x, b.Min.Y+y).RGBA()
+			if RGB888ToRGB565(uint8(cr>>8), uint8(cg>>8), uint8(cb>>8)) == p.visible(x, y) {
+				continue
+			}
+			if n == 0 {
+				first = image.Pt(x, y)
+			}
+			n++
+		}
+	}
+	return n, first
+}
+
+// rgb565ToRGBA 把 RGB565 像素按位复制扩展为 8 位颜色
+func rgb565ToRGBA(c uint16) color.RGBA {
+	r, g, b := uint8(c>>11), uint8(c>>5)&0x3F, uint8(c)&0x1F
+	return color.RGBA{r<<3 | r>>2, g<<2 | g>>4, b<<3 | b>>2, 0xFF}
+}
+
+// transfer 记录一次 SPI 传输的字节数与模型时间
+func (p *VirtualPanel) transfer(n int) {
+	p.stats.Transfers++
+	p.stats.Bytes += n
+	p.stats.BusTime += p.Overhead + time.Duration(uint64(n)*8*uint64(time.Second)/uint64(p.clock))
+}
+
+// SPI 接口
+
+// Close 关闭设备
+func (p *VirtualPanel) Close() error { return nil }
+
+// SetFrequency 设置模型使用的 SPI 时钟，0 使用 DefaultVirtualClock
+func (p *VirtualPanel) SetFrequency(freqHz uint32) error {
+	if freqHz == 0 {
+		freqHz = DefaultVirtualClock
+	}
+	p.mu.Lock()
+	p.clock = freqHz
+	p.mu.Unlock()
+	return nil
+}
+
+// Init 按 cfg.Clock 的分频设置 SPI 时钟（0 为 60MHz，每级减半）
+func (p *VirtualPanel) Init(cfg *driver.SPIConfig) error {
+	return p.SetFrequency(60000000 >> min(cfg.Clock, 7))
+}
+
+// GetConfig 返回与当前时钟最接近且不高于它的分频
+func (p *VirtualPanel) GetConfig(cfg *driver.SPIConfig) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	cfg.Clock = 0
+	for cfg.Clock < 7 && 60000000>>cfg.Clock > p.clock {
+		cfg.Clock++
+	}
+	return nil
+}
+
+// SetAutoCS 设置SPI自动片选
+func (p *VirtualPanel) SetAutoCS(disable bool) error { return nil }
+
+// SetDataBits 设置SPI数据位宽
+func (p *VirtualPanel) SetDataBits(dataBits uint8) error { return nil }
+
+// GetHwStreamCfg 获取SPI硬件流配置
+func (p *VirtualPanel) GetHwStreamCfg(streamCfg unsafe.Pointer) error { return nil }
+
+// ChangeCS 改变SPI片选状态，计为一次传输
+func (p *VirtualPanel) ChangeCS(status uint8) error {
+	p.mu.Lock()
+	p.transfer(0)
+	p.mu.Unlock()
+	return nil
+}
+
+// Read 读取SPI数据，返回全 0
+func (p *VirtualPanel) Read(ignoreCS bool, chipSelect uint8, length int) ([]byte, error) {
+	p.mu.Lock()
+	p.transfer(length)
+	p.mu.Unlock()
+	return make([]byte, length), nil
+}
+
+// WriteRead 写入数据，读取的数据为全 0
+func (p *VirtualPanel) WriteRead(ignoreCS bool, chipSelect uint8, data []byte) ([]byte, error) {
+	if err := p.Write(ignoreCS, chipSelect, data); err != nil {
+		return nil, err
+	}
+	return make([]byte, len(data)), nil
+}
+
+// Write 写入SPI数据：DC 为低电平时每个字节是一条命令，高电平时是当前命令的参数或像素数据
+func (p *VirtualPanel) Write(ignoreCS bool, chipSelect uint8, data []byte) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.transfer(len(data))
+	if p.level&OLED_Reset_OUT_H == 0 {
+		return nil // 复位期间忽略输入
+	}
+	if p.level&OLED_DC_OUT_H == 0 {
+		for _, v := range data {
+			p.command(v)
+		}
+		return nil
+	}
+	for _, v := range data {
+		p.data(v)
+	}
+	return nil
+}
+
+// command 执行一条命令
+func (p *VirtualPanel) command(v byte) {
+	p.stats.Commands++
+	p.cmd, p.args, p.half = v, p.args[:0], -1
+	switch v {
+	case 0x01: // SWRESET
+		p.hardReset()
+	case 0x10: // SLPIN
+		p.sleeping = true
+	case 0x11: // SLPOUT
+		p.sleeping = false
+	case 0x20: // INVOFF
+		p.inverted = false
+	case 0x21: // INVON
+		p.inverted = true
+	case 0x28: // DISPOFF
+		p.on = false
+	case 0x29: // DISPON
+		p.on = true
+	case 0x2C: // RAMWR
+		p.stats.Windows++
+		p.x, p.y = p.x0, p.y0
+	}
+}
+
+// data 处理当前命令的一个数据字节
+func (p *VirtualPanel) data(v byte) {
+	switch p.cmd {
+	case 0x36: // MADCTL
+		p.madctl = v
+	case 0x3A: // COLMOD
+		p.colmod = v
+	case 0x2A, 0x2B: // CASET/RASET
+		if len(p.args) == 4 {
+			return
+		}
+		p.args = append(p.args, v)
+		if len(p.args) < 4 {
+			return
+		}
+		lo, hi := int(p.args[0])<<8|int(p.args[1]), int(p.args[2])<<8|int(p.args[3])
+		if p.cmd == 0x2A {
+			p.x0, p.x1 = lo, hi
+		} else {
+			p.y0, p.y1 = lo, hi
+		}
+	case 0x2C, 0x3C: // RAMWR/RAMWRC
+		if p.half < 0 {
+			p.half = int(v)
+			return
+		}
+		p.pixel(uint16(p.half)<<8 | uint16(v))
+		p.half = -1
+	}
+}
+
+// pixel 在当前地址写入一个像素并前进，超过窗口末尾时回绕到窗口起点
+func (p *VirtualPanel) pixel(c uint16) {
+	if p.y > p.y1 {
+		p.stats.Overflow++
+		p.x, p.y = p.x0, p.y0
+	}
+	gx, gy := orientationOf(p.madctl).apply(p.x, p.y, p.ramW, p.ramH)
+	if gx >= 0 && gx < p.ramW && gy >= 0 && gy < p.ramH {
+		p.ram[gy*p.ramW+gx] = c
+	}
+	p.stats.Pixels++
+	if p.x++; p.x > p.x1 {
+		p.x, p.y = p.x0, p.y+1
+	}
+}
+
+// GPIO 接口
+
+// Get 返回 Set 设置的方向与电平
+func (p *VirtualPanel) Get() (dir, data uint8, err error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.dir, p.level, nil
+}
+
+// Set 设置 enable 选中的引脚的方向与电平；复位引脚由高变低时复位寄存器
+func (p *VirtualPanel) Set(enable, dirOut, dataOut uint8) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.stats.GPIOCalls++
+	p.stats.BusTime += p.Overhead
+	prev := p.level
+	p.dir = p.dir&^enable | dirOut&enable
+	p.level = p.level&^enable | dataOut&enable
+	if prev&OLED_Reset_OUT_H != 0 && p.level&OLED_Reset_OUT_H == 0 {
+		p.hardReset()
+	}
+	return nil
+}
+
+// SetIRQ 设置GPIO中断，虚拟面板不产生中断
+func (p *VirtualPanel) SetIRQ(gpioIndex uint8, enable bool, irqType uint8, handler any) error {
+	return nil
+}
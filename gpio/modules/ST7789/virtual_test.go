@@ -0,0 +1,248 @@
+package ST7789
+
+import (
+	"flag"
+	"image"
+	"image/png"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+
+	"circuit/gpio/driver"
+	"circuit/gpio/gui"
+)
+
+var update = flag.Bool("update", false, "重新生成 testdata 中的参考图像")
+
+// drawScene 在 drawPattern 之上绘制填充与描边的各种形状
+func drawScene(p *gui.Paint) {
+	drawPattern(p)
+	p.DrawCircle(p.Width/2, p.Height/2, 40, gui.Blue, gui.DotPixel1x1, gui.DrawFillFull)
+	p.DrawCircle(p.Width/2, p.Height/2, 60, gui.Red, gui.DotPixel2x2, gui.DrawFillEmpty)
+	p.DrawRectangle(10, p.Height-60, 80, p.Height-10, gui.Green, gui.DotPixel1x1, gui.DrawFillFull)
+	p.DrawTriangle(p.Width-70, 40, p.Width-10, 40, p.Width-40, 100, gui.Color(0xF81F), gui.DotPixel1x1, gui.DrawFillFull)
+	p.DrawRoundRect(20, 120, 100, 160, 8, gui.Color(0x07FF), gui.DotPixel1x1, gui.DrawFillEmpty)
+}
+
+// checkGolden 比较虚拟面板的可见内容与 testdata 中的参考图像，-update 时重新生成参考图像
+func checkGolden(t *testing.T, panel *VirtualPanel, name string) {
+	t.Helper()
+	path := filepath.Join("testdata", name+".png")
+	if *update {
+		f, err := os.Create(path)
+		if err != nil {
+			t.Fatal(err)
+		}
+		defer f.Close()
+		if err := png.Encode(f, panel.Image()); err != nil {
+			t.Fatal(err)
+		}
+		return
+	}
+	f, err := os.Open(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	want, err := png.Decode(f)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if n, at := panel.Compare(want); n != 0 {
+		got := filepath.Join(t.TempDir(), name+".png")
+		if out, err := os.Create(got); err == nil {
+			png.Encode(out, panel.Image())
+			out.Close()
+		}
+		t.Fatalf("%s: %d 个像素不同，第一个在 %v，实际图像 %s", name, n, at, got)
+	}
+}
+
+func TestVirtualGolden(t *testing.T) {
+	// 逐像素转换与局部刷新按可见坐标发送，绘制上下文的旋转不影响显示结果
+	for _, rotate := range []gui.Rotate{gui.Rotate0, gui.Rotate90} {
+		lcd, panel, paint := newTestDisplay(rotate)
+		drawScene(paint)
+		if err := lcd.ShowPaint(paint); err != nil {
+			t.Fatal(err)
+		}
+		checkGolden(t, panel, "scene")
+
+		lcd, panel, paint = newTestDisplay(rotate)
+		drawScene(paint)
+		if err := lcd.ShowPaintDirty(paint); err != nil {
+			t.Fatal(err)
+		}
+		checkGolden(t, panel, "scene")
+	}
+	// 帧缓冲区按当前方向的可见尺寸绘制，90° 时是横向画面
+	for _, c := range []struct {
+		name   string
+		rotate gui.Rotate
+	}{{"scene", gui.Rotate0}, {"scene90", gui.Rotate90}} {
+		lcd, panel := NewVirtualDisplay(Lcd2inch)
+		lcd.SetRotation(c.rotate)
+		fb := lcd.NewFramebuffer(gui.White)
+		drawScene(fb)
+		if err := lcd.ShowFramebuffer(fb); err != nil {
+			t.Fatal(err)
+		}
+		checkGolden(t, panel, c.name)
+	}
+	// 带偏移的面板旋转后局部刷新帧缓冲区：与整帧刷新相同画面，只发送修改区域
+	// （Lcd1in9 与 Lcd1in47 一样，未旋转时 320 列的可见宽度超出显存，不在此检查）
+	for _, dtype := range []DriverType{Lcd0in96, Lcd1in14, Lcd1in69} {
+		for _, rotate := range []gui.Rotate{gui.Rotate90, gui.Rotate180, gui.Rotate270} {
+			lcd, panel := NewVirtualDisplay(dtype)
+			lcd.SetRotation(rotate)
+			fb := lcd.NewFramebuffer(gui.White)
+			drawPattern(fb)
+			if err := lcd.ShowPaintDirty(fb); err != nil {
+				t.Fatal(err)
+			}
+			fb.ClearWindow(20, 30, 60, 50, gui.Blue)
+			fb.SetPixel(fb.Width-1, fb.Height-1, gui.Red)
+			panel.ResetStats()
+			if err := lcd.ShowPaintDirty(fb); err != nil {
+				t.Fatal(err)
+			}
+			if st := panel.Stats(); st.Windows != 2 || st.Pixels*4 > fb.Width*fb.Height {
+				t.Fatalf("类型 %d %d°: 局部刷新 %d 个窗口 %d 个像素", dtype, rotate, st.Windows, st.Pixels)
+			}
+			ref, refPanel := NewVirtualDisplay(dtype)
+			ref.SetRotation(rotate)
+			if err := ref.ShowFramebuffer(fb); err != nil {
+				t.Fatal(err)
+			}
+			if n, at := panel.Compare(refPanel.Image()); n != 0 {
+				t.Fatalf("类型 %d %d°: 与整帧刷新 %d 个像素不同，第一个在 %v", dtype, rotate, n, at)
+			}
+		}
+	}
+	// 参考图像经 ShowImage 显示后与原图相同
+	lcd, panel := NewVirtualDisplay(Lcd2inch)
+	f, err := os.Open(filepath.Join("testdata", "scene.png"))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	img, err := png.Decode(f)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := lcd.ShowImage(img); err != nil {
+		t.Fatal(err)
+	}
+	if n, at := panel.Compare(img); n != 0 {
+		t.Fatalf("ShowImage: %d 个像素不同，第一个在 %v", n, at)
+	}
+	if n, _ := panel.Compare(image.NewRGBA(image.Rect(0, 0, 320, 240))); n != -1 {
+		t.Fatalf("尺寸不同时返回 %d", n)
+	}
+}
+
+func TestVirtualInit(t *testing.T) {
+	lcd, panel := NewVirtualDisplay(Lcd1in69)
+	if panel.DisplayOn() {
+		t.Fatal("上电后显示已打开")
+	}
+	if err := lcd.Init(); err != nil {
+		t.Fatal(err)
+	}
+	if !panel.DisplayOn() || !panel.Inverted() || panel.MADCTL() != lcd.baseMADCTL() {
+		t.Fatalf("初始化后显示 %v 反色 %v MADCTL %#02x", panel.DisplayOn(), panel.Inverted(), panel.MADCTL())
+	}
+	var cfg driver.SPIConfig
+	panel.GetConfig(&cfg)
+	if cfg.Clock != 3 {
+		t.Fatalf("SPIInit 后时钟分频 %d，期望 3 (7.5MHz)", cfg.Clock)
+	}
+	// 复位引脚拉低恢复寄存器默认值，复位期间忽略输入
+	lcd.SetRotation(gui.Rotate90)
+	lcd.ResetLow()
+	if panel.MADCTL() != 0 || panel.DisplayOn() {
+		t.Fatalf("复位后 MADCTL %#02x", panel.MADCTL())
+	}
+	lcd.SetRotation(gui.Rotate90)
+	if panel.MADCTL() != 0 {
+		t.Fatal("复位期间接受了命令")
+	}
+	lcd.ResetHigh()
+	lcd.SetRotation(gui.Rotate90)
+	if panel.MADCTL() == 0 {
+		t.Fatal("复位结束后没有接受命令")
+	}
+	if _, level, _ := panel.Get(); level&OLED_Reset_OUT_H == 0 {
+		t.Fatalf("GPIO 电平 %#02x", level)
+	}
+	// SWRESET
+	lcd.SendCommand(0x01)
+	if panel.MADCTL() != 0 {
+		t.Fatal("SWRESET 没有恢复 MADCTL")
+	}
+}
+
+func TestVirtualVisible(t *testing.T) {
+	// 带偏移与不同显存尺寸的屏幕：帧缓冲区恰好覆盖可见区域
+	// （Lcd1in47 的初始化命令不设置 MADCTL，320 列的可见宽度超出显存，不在此检查）
+	for _, dtype := range []DriverType{Lcd0in96, Lcd1in14, Lcd1in69, Lcd2inch} {
+		lcd, panel := NewVirtualDisplay(dtype)
+		lcd.SetRotation(gui.Rotate0)
+		fb := lcd.NewFramebuffer(gui.Red)
+		fb.Clear(gui.Red)
+		if err := lcd.ShowFramebuffer(fb); err != nil {
+			t.Fatal(err)
+		}
+		img := panel.Image()
+		if b := img.Bounds(); b.Dx() != lcd.Width || b.Dy() != lcd.Height {
+			t.Fatalf("类型 %d: 图像 %v，期望 %dx%d", dtype, b, lcd.Width, lcd.Height)
+		}
+		if st := panel.Stats(); st.Pixels != lcd.Width*lcd.Height || st.Overflow != 0 {
+			t.Fatalf("类型 %d: 写入 %d 个像素，溢出 %d", dtype, st.Pixels, st.Overflow)
+		}
+		for i := 0; i < len(img.Pix); i += 4 {
+			if img.Pix[i] != 0xFF || img.Pix[i+1] != 0 || img.Pix[i+2] != 0 {
+				t.Fatalf("类型 %d: 可见区域像素 %d 不是红色", dtype, i/4)
+			}
+		}
+	}
+}
+
+func TestVirtualBusModel(t *testing.T) {
+	panel := NewVirtualPanel(Lcd2inch)
+	panel.Overhead = 100 * time.Microsecond
+	lcd := NewDriver(panel, panel, Lcd2inch)
+	lcd.SPIInit()
+	// 2x2 窗口写入 5 个像素：第 5 个像素回绕到窗口起点
+	lcd.SetWindow(10, 10, 12, 12, false)
+	panel.ResetStats()
+	lcd.SendData([]byte{0, 1, 0, 2, 0, 3, 0, 4, 0, 5})
+	if panel.Pixel(10, 10) != 5 || panel.Pixel(11, 10) != 2 || panel.Pixel(11, 11) != 4 {
+		t.Fatalf("像素 %d %d %d", panel.Pixel(10, 10), panel.Pixel(11, 10), panel.Pixel(11, 11))
+	}
+	// 10 字节 7.5MHz 约 10.7µs，加上一次 SPI 与一次 GPIO 调用的开销
+	st := panel.Stats()
+	if want := 200*time.Microsecond + 10*8*time.Second/7500000; st.BusTime != want {
+		t.Fatalf("模型时间 %v，期望 %v", st.BusTime, want)
+	}
+	if st.Bytes != 10 || st.Transfers != 1 || st.GPIOCalls != 1 || st.Pixels != 5 || st.Overflow != 1 {
+		t.Fatalf("统计 %+v", st)
+	}
+	// 时钟减半，整帧的模型时间加倍
+	panel.Overhead = 0
+	fb := lcd.NewFramebuffer(gui.White)
+	panel.ResetStats()
+	lcd.ShowFramebuffer(fb)
+	fast := panel.Stats().BusTime
+	panel.Init(&driver.SPIConfig{Clock: 4})
+	panel.ResetStats()
+	lcd.ShowFramebuffer(fb)
+	if slow := panel.Stats().BusTime; slow < 2*fast-time.Microsecond || slow > 2*fast+time.Microsecond {
+		t.Fatalf("3.75MHz 模型时间 %v，7.5MHz %v", slow, fast)
+	}
+	// 整帧 240x320 在 7.5MHz 下约 164ms
+	if fast < 163*time.Millisecond || fast > 165*time.Millisecond {
+		t.Fatalf("整帧模型时间 %v", fast)
+	}
+}
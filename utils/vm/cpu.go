@@ -1,5 +1,7 @@
 package vm
 
+import "encoding/binary"
+
 // VmInaState 定义了 RISC-V 虚拟机核心的状态。
 // 这个结构体是 CPU 状态的快照，包含了所有处理器寄存器。
 type VmInaState struct {
@@ -433,6 +435,64 @@ func (vmst *VmState) handleTrap(trap_code VmMcauseCode, trap_val uint32) {
 	}
 }
 
+// icacheBits 预解码指令缓存的索引位数，缓存为直接映射结构，共 1<<icacheBits 项。
+const icacheBits = 12
+
+// decodedInst 预解码指令缓存项。
+// 16 位压缩指令在填充时即展开为等价的 32 位指令，与标准指令共用处理函数。
+type decodedInst struct {
+	handler InstructionFunc // 指令处理函数。
+	tag     uint32          // 指令所在的物理地址，奇数表示缓存项无效。
+	raw     uint32          // 取指地址处的原始 32 位字，用于检测代码被改写。
+	ir      uint32          // 交给处理函数的 32 位指令（压缩指令为展开并调整偏移后的形式）。
+	pcBias  uint32          // 调用处理函数时从 PC 中减去的偏移（压缩指令为 2，其余为 0）。
+}
+
+// fetchDecoded 从预解码缓存中取出 paddr 处的指令，未命中时解码并填充。
+// 仅缓存主内存中的指令；设备地址或主内存末尾不足 4 字节时返回 nil，由调用方走慢路径。
+// 每次取指都会与缓存中的原始指令字比较，因此自修改代码无需显式刷新缓存。
+func (vmst *VmState) fetchDecoded(paddr uint32) *decodedInst {
+	offset := paddr - vmst.RamImageOffSet
+	if paddr < vmst.RamImageOffSet || offset+3 >= vmst.VmMemorySize {
+		return nil
+	}
+	raw := binary.LittleEndian.Uint32(vmst.Data[offset:])
+	if vmst.icache == nil {
+		vmst.icache = make([]decodedInst, 1<<icacheBits)
+		for i := range vmst.icache {
+			vmst.icache[i].tag = 1
+		}
+	}
+	entry := &vmst.icache[(paddr>>1)&(1<<icacheBits-1)]
+	if entry.tag == paddr && entry.raw == raw {
+		return entry
+	}
+	// 未命中：设备映射的地址不缓存
+	if vmst.Dm != nil {
+		if dev, _ := vmst.Dm.FindDevice(paddr); dev != nil {
+			return nil
+		}
+	}
+	if raw&0x3 != 0x3 {
+		// 16 位压缩指令：展开为 32 位等价指令，以 pc-2 执行使顺序地址为 pc+2
+		ir, ok := expandCompressed(uint16(raw))
+		handler := Instructions[ir&0x7f]
+		if !ok || handler == nil {
+			ir, handler = raw&0xffff, handleIllegal
+		} else {
+			ir = rebaseCompressed(ir)
+		}
+		*entry = decodedInst{handler: handler, tag: paddr, raw: raw, ir: ir, pcBias: 2}
+		return entry
+	}
+	handler, ok := Instructions[raw&0x7f]
+	if !ok {
+		handler = handleIllegal
+	}
+	*entry = decodedInst{handler: handler, tag: paddr, raw: raw, ir: raw}
+	return entry
+}
+
 // VmImaStep 是虚拟机的核心执行循环。它负责获取、解码和执行指令。
 //
 // 参数:
@@ -460,35 +520,43 @@ func (vmst *VmState) VmImaStep(count int) VmMcauseCode {
 			return CAUSE_INSTRUCTION_ADDRESS_MISALIGNED
 		}
 
-		ir16, ok := vmst.LoadUint16(paddr)
-		if !ok {
-			vmst.handleTrap(CAUSE_INSTRUCTION_ACCESS_FAULT, pc)
-			return CAUSE_INSTRUCTION_ACCESS_FAULT
-		}
-
 		var rdid, rval, newPC uint32
 		var trap VmMcauseCode
 		var ir uint32
+		var compressed bool
 
 		// --- 2. 解码与执行 ---
-		if (ir16 & 0x3) != 0x3 {
-			// 16位压缩指令
-			ir = uint32(ir16)
-			rdid, rval, newPC, trap = handleCompressed(vmst, ir16, pc)
+		if entry := vmst.fetchDecoded(paddr); entry != nil {
+			// 快速路径：命中预解码缓存，压缩指令与 32 位指令共用处理函数
+			ir = entry.raw
+			compressed = entry.pcBias != 0
+			rdid, rval, newPC, trap = entry.handler(vmst, entry.ir, pc-entry.pcBias)
 		} else {
-			// 32位指令
-			// 【修复】：使用 LoadUint32，它会自动处理偏移并检查边界
-			ir, ok = vmst.LoadUint32(paddr)
+			ir16, ok := vmst.LoadUint16(paddr)
 			if !ok {
 				vmst.handleTrap(CAUSE_INSTRUCTION_ACCESS_FAULT, pc)
 				return CAUSE_INSTRUCTION_ACCESS_FAULT
 			}
-			opcode := ir & 0x7f
-			handler, ok := Instructions[opcode]
-			if ok {
-				rdid, rval, newPC, trap = handler(vmst, ir, pc)
+			if (ir16 & 0x3) != 0x3 {
+				// 16位压缩指令
+				ir = uint32(ir16)
+				compressed = true
+				rdid, rval, newPC, trap = handleCompressed(vmst, ir16, pc)
 			} else {
-				rdid, rval, newPC, trap = handleIllegal(vmst, ir, pc)
+				// 32位指令
+				// 【修复】：使用 LoadUint32，它会自动处理偏移并检查边界
+				ir, ok = vmst.LoadUint32(paddr)
+				if !ok {
+					vmst.handleTrap(CAUSE_INSTRUCTION_ACCESS_FAULT, pc)
+					return CAUSE_INSTRUCTION_ACCESS_FAULT
+				}
+				opcode := ir & 0x7f
+				handler, ok := Instructions[opcode]
+				if ok {
+					rdid, rval, newPC, trap = handler(vmst, ir, pc)
+				} else {
+					rdid, rval, newPC, trap = handleIllegal(vmst, ir, pc)
+				}
 			}
 		}
 
@@ -498,8 +566,8 @@ func (vmst *VmState) VmImaStep(count int) VmMcauseCode {
 				return trap
 			}
 			trap_val := ir
-			if (ir16 & 0x3) != 0x3 {
-				trap_val = uint32(ir16)
+			if compressed {
+				trap_val = ir & 0xffff
 			}
 			// Load/Store 故障应该提供故障地址 (已经在处理程序中存入 Mtval)
 			if trap == CAUSE_LOAD_ACCESS_FAULT || trap == CAUSE_STORE_ACCESS_FAULT || trap == CAUSE_LOAD_ADDRESS_MISALIGNED || trap == CAUSE_STORE_ADDRESS_MISALIGNED {
@@ -644,7 +644,8 @@ func handleMiscMem(vmst *VmState, ir uint32, pc uint32) (uint32, uint32, uint32,
 		// 重新从主内存中获取，从而确保执行的是最新写入的代码。
 		//
 		// **在当前模拟器中的实现**:
-		// 我们的模拟器没有实现分离的数据缓存和指令缓存。每次取指都是直接从 `vmst.Memory` 字节数组中读取。
+		// 我们的模拟器没有实现分离的数据缓存和指令缓存。预解码缓存在每次取指时都会与
+		// `vmst.Memory` 中的原始指令字比较，不一致时重新解码。
 		// 因此，不存在指令缓存与主存不一致的问题。任何对内存的写入都会立即对下一次取指可见。
 		// 所以，FENCE.I 在此也可以安全地实现为空操作（NOP）。
 		return 0, 0, pc + 4, CAUSE_TRAP_CODE_OK
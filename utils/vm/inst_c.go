@@ -9,246 +9,192 @@ func signExtend(val uint32, bits uint) uint32 {
 	return uint32(int32(val<<shift) >> shift)
 }
 
-// handleCompressed 是 16 位指令的处理入口
+// handleCompressed 是 16 位指令的处理入口（未命中预解码缓存时的慢路径）。
+// 压缩指令先展开为等价的 32 位指令，再交由标准处理函数执行，
+// 因此与预解码缓存中的快速路径共享同一套语义。
 func handleCompressed(vmst *VmState, ir16 uint16, pc uint32) (rdid, rval, newPC uint32, trap VmMcauseCode) {
-	// RISC-V 压缩指令通过低 2 位决定象限 (Quadrant)
-	quadrant := ir16 & 0x3
-	switch quadrant {
-	case OPCODE_C0:
-		return handleC0(vmst, ir16, pc)
-	case OPCODE_C1:
-		return handleC1(vmst, ir16, pc)
-	case OPCODE_C2:
-		return handleC2(vmst, ir16, pc)
-	default:
+	ir, ok := expandCompressed(ir16)
+	if !ok {
 		return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
 	}
-}
-
-// handleC0 处理象限 0：主要是基于基址寄存器的加载/存储指令
-func handleC0(vmst *VmState, ir uint16, pc uint32) (uint32, uint32, uint32, VmMcauseCode) {
-	funct3 := (ir >> 13) & 0x7
-	rs1_p := (ir >> 7) & 0x7 // rd' / rs1'
-	rd_p := (ir >> 2) & 0x7  // rd' / rs2'
-
-	switch funct3 {
-	case FUNCT3_C_ADDI4SPN: // C.ADDI4SPN: 立即数加到栈指针，结果存于 rd'
-		// imm[9:2] 布局: 12:11=5:4, 10:7=9:6, 6=2, 5=3
-		imm := (uint32(ir>>7) & 0x30) | (uint32(ir>>1) & 0x3C0) | ((uint32(ir) >> 2) & 8) | ((uint32(ir) >> 4) & 4)
-		if imm == 0 {
-			return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-		}
-		return CRegs[rd_p], vmst.Core.Regs[2] + imm, pc + 2, CAUSE_TRAP_CODE_OK
-
-	case FUNCT3_C_LW: // C.LW: 加载字
-		// imm[6:2] 布局: 5=6, 10:12=5:3, 6=2
-		offset := (uint32(ir>>7) & 0x38) | (uint32(ir>>4) & 0x4) | (uint32(ir<<1) & 0x40)
-		addr := vmst.Core.Regs[CRegs[rs1_p]] + offset
-		return performLoad(vmst, addr, CRegs[rd_p], pc)
-
-	case FUNCT3_C_SW: // C.SW: 存储字
-		offset := (uint32(ir>>7) & 0x38) | (uint32(ir>>4) & 0x4) | (uint32(ir<<1) & 0x40)
-		addr := vmst.Core.Regs[CRegs[rs1_p]] + offset
-		val := vmst.Core.Regs[CRegs[rd_p]]
-		return performStore(vmst, addr, val, pc)
-
-	case FUNCT3_C_FLD, FUNCT3_C_FSD: // C.FLD, C.FSD (RV64/128 专有，RV32 非法)
+	handler, ok := Instructions[ir&0x7f]
+	if !ok {
 		return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
+	}
+	return handler(vmst, rebaseCompressed(ir), pc-2)
+}
 
-	case FUNCT3_C_FLW, FUNCT3_C_FSW: // C.FLW, C.FSW (RV32 浮点暂占位实现)
-		return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK
-
+// rebaseCompressed 调整展开后控制流指令的偏移量，使其可以在 pc-2 处执行。
+//
+// 标准处理函数按 4 字节指令长度计算顺序地址（pc+4）与链接地址。
+// 压缩指令以 pc-2 作为执行地址调用处理函数，顺序地址与链接地址即为正确的 pc+2；
+// 对于 JAL 与条件分支，跳转目标相对于 pc 计算，因此偏移量需同步增加 2 进行补偿。
+// JALR 的目标地址与 pc 无关，无需调整。
+func rebaseCompressed(ir uint32) uint32 {
+	switch ir & 0x7f {
+	case OPCODE_JAL:
+		return encodeJ((ir>>7)&0x1f, decodeJImm(ir)+2)
+	case OPCODE_BRANCH:
+		return encodeB((ir>>12)&0x7, (ir>>15)&0x1f, (ir>>20)&0x1f, decodeBImm(ir)+2)
 	default:
-		return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
+		return ir
 	}
 }
 
-// handleC1 处理象限 1：算术、跳转和立即数指令
-func handleC1(vmst *VmState, ir uint16, pc uint32) (uint32, uint32, uint32, VmMcauseCode) {
-	funct3 := (ir >> 13) & 0x7
-	rd_rs1 := (ir >> 7) & 0x1f
-	imm6 := (uint32(ir>>12)&0x1)<<5 | uint32(ir>>2)&0x1f
-
-	switch funct3 {
-	case FUNCT3_C_NOP_ADDI: // C.ADDI / C.NOP
-		if rd_rs1 == 0 {
-			return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // C.NOP
-		}
-		imm := signExtend(imm6, 6)
-		return uint32(rd_rs1), vmst.Core.Regs[rd_rs1] + imm, pc + 2, CAUSE_TRAP_CODE_OK
-
-	case FUNCT3_C_JAL: // C.JAL (RV32 专用)
-		offset := decodeCJImm(ir)
-		return 1, pc + 2, pc + offset, CAUSE_TRAP_CODE_OK // 返回地址存入 x1 (ra)
-
-	case FUNCT3_C_LI: // C.LI (Load Immediate)
-		if rd_rs1 == 0 {
-			return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // HINT
-		}
-		return uint32(rd_rs1), signExtend(imm6, 6), pc + 2, CAUSE_TRAP_CODE_OK
-
-	case FUNCT3_C_LUI_ADDI16SP: // C.LUI / C.ADDI16SP
-		if rd_rs1 == 2 { // C.ADDI16SP
-			// 修正后的提取逻辑：
-			imm := ((uint32(ir)>>12)&1)<<9 | // bit 9 (sign)
-				((uint32(ir)>>6)&1)<<4 | // bit 4
-				((uint32(ir)>>5)&1)<<6 | // bit 6
-				((uint32(ir)>>3)&3)<<7 | // bits 8:7 (注意是 >> 3)
-				((uint32(ir)>>2)&1)<<5 // bit 5
-
-			imm_s := signExtend(imm, 10)
-			final_imm := int32(imm_s) << 4
-			if final_imm == 0 {
-				return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-			}
-			return 2, uint32(int32(vmst.Core.Regs[2]) + final_imm), pc + 2, CAUSE_TRAP_CODE_OK
-		} else { // C.LUI
-			if rd_rs1 == 0 {
-				return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // HINT
-			}
-			imm := signExtend(imm6, 6) << 12
+// expandCompressed 将 16 位 RVC 指令展开为等价的 32 位指令（RV32IMAFDC）。
+// 对于保留编码或 RV32 下非法的编码，返回 false。
+// HINT 编码（rd=x0 等）展开为写 x0 的指令，执行效果等同于 NOP。
+func expandCompressed(ir uint16) (uint32, bool) {
+	in := uint32(ir)
+	funct3 := (in >> 13) & 0x7
+	switch in & 0x3 {
+	case OPCODE_C0:
+		rs1 := CRegs[(in>>7)&0x7] // rs1'
+		rd := CRegs[(in>>2)&0x7]  // rd' / rs2'
+		// C.LW/C.SW/C.FLW/C.FSW 的偏移: uimm[5:3]=inst[12:10], uimm[2]=inst[6], uimm[6]=inst[5]
+		offW := (in>>7)&0x38 | (in>>4)&0x4 | (in<<1)&0x40
+		// C.FLD/C.FSD 的偏移: uimm[5:3]=inst[12:10], uimm[7:6]=inst[6:5]
+		offD := (in>>7)&0x38 | (in<<1)&0xc0
+		switch funct3 {
+		case FUNCT3_C_ADDI4SPN: // addi rd', x2, nzuimm
+			// nzuimm[5:4]=inst[12:11], nzuimm[9:6]=inst[10:7], nzuimm[2]=inst[6], nzuimm[3]=inst[5]
+			imm := (in>>7)&0x30 | (in>>1)&0x3c0 | (in>>4)&0x4 | (in>>2)&0x8
 			if imm == 0 {
-				return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
+				return 0, false
 			}
-			return uint32(rd_rs1), imm, pc + 2, CAUSE_TRAP_CODE_OK
+			return encodeI(OPCODE_OP_IMM, rd, FUNCT3_ADD_SUB, 2, imm), true
+		case FUNCT3_C_FLD:
+			return encodeI(OPCODE_LOAD_FP, rd, FUNCT3_FLD, rs1, offD), true
+		case FUNCT3_C_LW:
+			return encodeI(OPCODE_LOAD, rd, FUNCT3_LW, rs1, offW), true
+		case FUNCT3_C_FLW:
+			return encodeI(OPCODE_LOAD_FP, rd, FUNCT3_FLW, rs1, offW), true
+		case FUNCT3_C_FSD:
+			return encodeS(OPCODE_STORE_FP, FUNCT3_FSD, rs1, rd, offD), true
+		case FUNCT3_C_SW:
+			return encodeS(OPCODE_STORE, FUNCT3_SW, rs1, rd, offW), true
+		case FUNCT3_C_FSW:
+			return encodeS(OPCODE_STORE_FP, FUNCT3_FSW, rs1, rd, offW), true
 		}
 
-	case FUNCT3_C_MISC_ALU: // 杂项算术指令 (SRLI, SRAI, ANDI, 以及 R-type 压缩)
-		subop := (ir >> 10) & 0x3
-		rd_p := CRegs[(ir>>7)&0x7]
-		switch subop {
-		case FUNCT2_C_SRLI, FUNCT2_C_SRAI, FUNCT2_C_ANDI: // SRLI, SRAI, ANDI
-			shamt := imm6
-			if subop != FUNCT2_C_ANDI && shamt >= 32 {
-				return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
+	case OPCODE_C1:
+		rd := (in >> 7) & 0x1f
+		imm6 := signExtend((in>>7)&0x20|(in>>2)&0x1f, 6)
+		switch funct3 {
+		case FUNCT3_C_NOP_ADDI: // addi rd, rd, imm
+			return encodeI(OPCODE_OP_IMM, rd, FUNCT3_ADD_SUB, rd, imm6), true
+		case FUNCT3_C_JAL: // jal x1, offset
+			return encodeJ(1, decodeCJImm(ir)), true
+		case FUNCT3_C_LI: // addi rd, x0, imm
+			return encodeI(OPCODE_OP_IMM, rd, FUNCT3_ADD_SUB, 0, imm6), true
+		case FUNCT3_C_LUI_ADDI16SP:
+			if rd == 2 { // C.ADDI16SP: addi x2, x2, nzimm
+				// nzimm[9]=inst[12], nzimm[4]=inst[6], nzimm[6]=inst[5], nzimm[8:7]=inst[4:3], nzimm[5]=inst[2]
+				imm := (in>>3)&0x200 | (in>>2)&0x10 | (in<<1)&0x40 | (in<<4)&0x180 | (in<<3)&0x20
+				if imm == 0 {
+					return 0, false
+				}
+				return encodeI(OPCODE_OP_IMM, 2, FUNCT3_ADD_SUB, 2, signExtend(imm, 10)), true
 			}
-			var res uint32
-			switch subop {
-			case FUNCT2_C_SRLI:
-				res = vmst.Core.Regs[rd_p] >> shamt // SRLI
-			case FUNCT2_C_SRAI:
-				res = uint32(int32(vmst.Core.Regs[rd_p]) >> shamt) // SRAI
-			case FUNCT2_C_ANDI:
-				res = vmst.Core.Regs[rd_p] & signExtend(imm6, 6) // ANDI
+			// C.LUI: lui rd, nzimm
+			if imm6 == 0 {
+				return 0, false
 			}
-			return rd_p, res, pc + 2, CAUSE_TRAP_CODE_OK
-		case FUNCT2_C_REG_ALU: // C.SUB, C.XOR, C.OR, C.AND
-			rs2_p := CRegs[(ir>>2)&0x7]
-			funct2 := (ir >> 5) & 0x3
-			is_sub := (ir >> 12) & 0x1
-			v1, v2 := vmst.Core.Regs[rd_p], vmst.Core.Regs[rs2_p]
-			var res uint32
-			if is_sub == 0 {
-				switch funct2 {
-				case 0:
-					res = v1 - v2 // SUB
-				case 1:
-					res = v1 ^ v2 // XOR
-				case 2:
-					res = v1 | v2 // OR
-				case 3:
-					res = v1 & v2 // AND
+			return encodeU(OPCODE_LUI, rd, imm6<<12), true
+		case FUNCT3_C_MISC_ALU:
+			rd := CRegs[(in>>7)&0x7]
+			switch (in >> 10) & 0x3 {
+			case FUNCT2_C_SRLI, FUNCT2_C_SRAI:
+				if in&0x1000 != 0 { // RV32 中 shamt[5] 必须为 0
+					return 0, false
+				}
+				shamt := (in >> 2) & 0x1f
+				if (in>>10)&0x3 == FUNCT2_C_SRAI {
+					shamt |= FUNCT7_SRA << 5
+				}
+				return encodeI(OPCODE_OP_IMM, rd, FUNCT3_SRL_SRA, rd, shamt), true
+			case FUNCT2_C_ANDI:
+				return encodeI(OPCODE_OP_IMM, rd, FUNCT3_AND, rd, imm6), true
+			case FUNCT2_C_REG_ALU:
+				if in&0x1000 != 0 { // C.SUBW/C.ADDW 仅存在于 RV64
+					return 0, false
+				}
+				rs2 := CRegs[(in>>2)&0x7]
+				switch (in >> 5) & 0x3 {
+				case 0: // C.SUB
+					return encodeR(OPCODE_OP, rd, FUNCT3_ADD_SUB, rd, rs2, FUNCT7_SUB), true
+				case 1: // C.XOR
+					return encodeR(OPCODE_OP, rd, FUNCT3_XOR, rd, rs2, 0), true
+				case 2: // C.OR
+					return encodeR(OPCODE_OP, rd, FUNCT3_OR, rd, rs2, 0), true
+				case 3: // C.AND
+					return encodeR(OPCODE_OP, rd, FUNCT3_AND, rd, rs2, 0), true
 				}
-			} else {
-				// 注意：在标准 C 扩展中，funct2 的 0-3 对应 SUB, XOR, OR, AND
-				// 这里保留原始逻辑中的 switch 结构
-				return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
 			}
-			return rd_p, res, pc + 2, CAUSE_TRAP_CODE_OK
-		}
-
-	case FUNCT3_C_J: // C.J (无条件跳转)
-		return 0, 0, pc + decodeCJImm(ir), CAUSE_TRAP_CODE_OK
-
-	case FUNCT3_C_BEQZ, FUNCT3_C_BNEZ: // C.BEQZ, C.BNEZ (条件分支)
-		rs1_p := CRegs[(ir>>7)&0x7]
-		offset := decodeCBImm(ir)
-		cond := vmst.Core.Regs[rs1_p] == 0
-		if funct3 == FUNCT3_C_BNEZ {
-			cond = !cond // BNEZ
-		}
-		if cond {
-			return 0, 0, pc + offset, CAUSE_TRAP_CODE_OK
+		case FUNCT3_C_J: // jal x0, offset
+			return encodeJ(0, decodeCJImm(ir)), true
+		case FUNCT3_C_BEQZ: // beq rs1', x0, offset
+			return encodeB(FUNCT3_BEQ, CRegs[(in>>7)&0x7], 0, decodeCBImm(ir)), true
+		case FUNCT3_C_BNEZ: // bne rs1', x0, offset
+			return encodeB(FUNCT3_BNE, CRegs[(in>>7)&0x7], 0, decodeCBImm(ir)), true
 		}
-		return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK
-	}
-	return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-}
-
-// handleC2 处理象限 2：栈指针相关加载/存储、跳转和寄存器指令
-func handleC2(vmst *VmState, ir uint16, pc uint32) (uint32, uint32, uint32, VmMcauseCode) {
-	funct3 := (ir >> 13) & 0x7
-	rd_rs1 := (uint32(ir) >> 7) & 0x1f
-	rs2 := (uint32(ir) >> 2) & 0x1f
-
-	switch funct3 {
-	case FUNCT3_C_SLLI: // C.SLLI
-		shamt := (uint32(ir>>12)&1)<<5 | rs2
-		if rd_rs1 == 0 {
-			return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // HINT
-		}
-		if shamt >= 32 {
-			return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-		}
-		return rd_rs1, vmst.Core.Regs[rd_rs1] << shamt, pc + 2, 0
-
-	case FUNCT3_C_LWSP: // C.LWSP (Load Word from Stack Pointer)
-		rd := (uint32(ir) >> 7) & 0x1f
-		if rd == 0 {
-			return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-		}
-		// 立即数拼接:
-		imm := ((uint32(ir)>>12)&1)<<5 |
-			((uint32(ir)>>4)&7)<<2 |
-			((uint32(ir)>>2)&3)<<6
-		return performLoad(vmst, vmst.Core.Regs[2]+imm, rd, pc)
 
-	case FUNCT3_C_JR_MV_ADD: // C.JR, C.MV, C.EBREAK, C.JALR, C.ADD
-		bit12 := (ir >> 12) & 1
-		if bit12 == 0 {
-			if rs2 == 0 { // C.JR
-				if rd_rs1 == 0 {
-					return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-				}
-				return 0, 0, vmst.Core.Regs[rd_rs1] & ^uint32(1), CAUSE_TRAP_CODE_OK
-			} else { // C.MV
-				if rd_rs1 == 0 {
-					return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // HINT
-				}
-				return rd_rs1, vmst.Core.Regs[rs2], pc + 2, CAUSE_TRAP_CODE_OK
+	case OPCODE_C2:
+		rd := (in >> 7) & 0x1f
+		rs2 := (in >> 2) & 0x1f
+		// C.LWSP/C.FLWSP 的偏移: uimm[5]=inst[12], uimm[4:2]=inst[6:4], uimm[7:6]=inst[3:2]
+		offW := (in>>7)&0x20 | (in>>2)&0x1c | (in<<4)&0xc0
+		// C.FLDSP 的偏移: uimm[5]=inst[12], uimm[4:3]=inst[6:5], uimm[8:6]=inst[4:2]
+		offD := (in>>7)&0x20 | (in>>2)&0x18 | (in<<4)&0x1c0
+		switch funct3 {
+		case FUNCT3_C_SLLI: // slli rd, rd, shamt
+			if rd == 0 { // HINT
+				return encodeI(OPCODE_OP_IMM, 0, FUNCT3_ADD_SUB, 0, 0), true
+			}
+			if in&0x1000 != 0 { // RV32 中 shamt[5] 必须为 0
+				return 0, false
+			}
+			return encodeI(OPCODE_OP_IMM, rd, FUNCT3_SLL, rd, rs2), true
+		case FUNCT3_C_FLDSP:
+			return encodeI(OPCODE_LOAD_FP, rd, FUNCT3_FLD, 2, offD), true
+		case FUNCT3_C_LWSP:
+			if rd == 0 {
+				return 0, false
 			}
-		} else {
-			if rd_rs1 == 0 && rs2 == 0 { // C.EBREAK
-				return 0, 0, 0, CAUSE_BREAKPOINT
-			} else if rs2 == 0 { // C.JALR
-				if rd_rs1 == 0 {
-					return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
+			return encodeI(OPCODE_LOAD, rd, FUNCT3_LW, 2, offW), true
+		case FUNCT3_C_FLWSP:
+			return encodeI(OPCODE_LOAD_FP, rd, FUNCT3_FLW, 2, offW), true
+		case FUNCT3_C_JR_MV_ADD:
+			if in&0x1000 == 0 {
+				if rs2 == 0 { // C.JR: jalr x0, 0(rs1)
+					if rd == 0 {
+						return 0, false
+					}
+					return encodeI(OPCODE_JALR, 0, 0, rd, 0), true
 				}
-				target := vmst.Core.Regs[rd_rs1] & ^uint32(1)
-				return 1, pc + 2, target, CAUSE_TRAP_CODE_OK // x1 = pc + 2
-			} else { // C.ADD
-				if rd_rs1 == 0 {
-					return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK // HINT
+				// C.MV: add rd, x0, rs2
+				return encodeR(OPCODE_OP, rd, FUNCT3_ADD_SUB, 0, rs2, 0), true
+			}
+			if rs2 == 0 {
+				if rd == 0 { // C.EBREAK
+					return encodeI(OPCODE_SYSTEM, 0, FUNCT3_SYSTEM_ECALL_EBREAK, 0, 1), true
 				}
-				return rd_rs1, vmst.Core.Regs[rd_rs1] + vmst.Core.Regs[rs2], pc + 2, CAUSE_TRAP_CODE_OK
+				// C.JALR: jalr x1, 0(rs1)
+				return encodeI(OPCODE_JALR, 1, 0, rd, 0), true
 			}
+			// C.ADD: add rd, rd, rs2
+			return encodeR(OPCODE_OP, rd, FUNCT3_ADD_SUB, rd, rs2, 0), true
+		case FUNCT3_C_FSDSP:
+			// uimm[5:3]=inst[12:10], uimm[8:6]=inst[9:7]
+			return encodeS(OPCODE_STORE_FP, FUNCT3_FSD, 2, rs2, (in>>7)&0x38|(in>>1)&0x1c0), true
+		case FUNCT3_C_SWSP:
+			// uimm[5:2]=inst[12:9], uimm[7:6]=inst[8:7]
+			return encodeS(OPCODE_STORE, FUNCT3_SW, 2, rs2, (in>>7)&0x3c|(in>>1)&0xc0), true
+		case FUNCT3_C_FSWSP:
+			return encodeS(OPCODE_STORE_FP, FUNCT3_FSW, 2, rs2, (in>>7)&0x3c|(in>>1)&0xc0), true
 		}
-
-	case FUNCT3_C_SWSP: // C.SWSP (Store Word to Stack Pointer)
-		rs2 := (uint32(ir) >> 2) & 0x1f
-		// imm[5:2] 在 inst[12:9], imm[7:6] 在 inst[8:7]
-		imm := ((uint32(ir)>>9)&0xf)<<2 | // imm[5:2]
-			((uint32(ir)>>7)&0x3)<<6 // imm[7:6]
-		return performStore(vmst, vmst.Core.Regs[2]+imm, vmst.Core.Regs[rs2], pc)
-
-	case FUNCT3_C_FLDSP, FUNCT3_C_FSDSP: // C.FLDSP, C.FSDSP (RV64 非法)
-		return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
-	case FUNCT3_C_FLWSP, FUNCT3_C_FSWSP: // C.FLWSP, C.FSWSP (RV32 浮点占位)
-		return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK
-
-	default:
-		return 0, 0, 0, CAUSE_ILLEGAL_INSTRUCTION
 	}
+	return 0, false
 }
 
 // --- 辅助解码函数 ---
@@ -288,31 +234,47 @@ func decodeCBImm(ir uint16) uint32 {
 	return signExtend(uint32(imm), 9)
 }
 
-// performLoad 抽象加载逻辑
-func performLoad(vmst *VmState, addr uint32, rdid uint32, pc uint32) (uint32, uint32, uint32, VmMcauseCode) {
-	paddr, trap := vmst.TranslateAddress(addr, VmMemAccessLoad)
-	if trap != 0 {
-		vmst.Core.Mtval = addr
-		return 0, 0, 0, trap
-	}
-	val, ok := vmst.LoadUint32(paddr)
-	if !ok {
-		vmst.Core.Mtval = addr
-		return 0, 0, 0, CAUSE_LOAD_ACCESS_FAULT
-	}
-	return rdid, val, pc + 2, CAUSE_TRAP_CODE_OK
+// decodeJImm 解码 J-Type 指令的 21 位有符号立即数。
+func decodeJImm(ir uint32) uint32 {
+	imm := ((ir>>31)&1)<<20 | ((ir>>12)&0xff)<<12 | ((ir>>20)&1)<<11 | ((ir>>21)&0x3ff)<<1
+	return signExtend(imm, 21)
 }
 
-// performStore 抽象存储逻辑
-func performStore(vmst *VmState, addr uint32, val uint32, pc uint32) (uint32, uint32, uint32, VmMcauseCode) {
-	paddr, trap := vmst.TranslateAddress(addr, VmMemAccessStore)
-	if trap != 0 {
-		vmst.Core.Mtval = addr
-		return 0, 0, 0, trap
-	}
-	if !vmst.PutUint32(paddr, val) {
-		vmst.Core.Mtval = addr
-		return 0, 0, 0, CAUSE_STORE_ACCESS_FAULT
-	}
-	return 0, 0, pc + 2, CAUSE_TRAP_CODE_OK
+// decodeBImm 解码 B-Type 指令的 13 位有符号立即数。
+func decodeBImm(ir uint32) uint32 {
+	imm := ((ir>>31)&1)<<12 | ((ir>>7)&1)<<11 | ((ir>>25)&0x3f)<<5 | ((ir>>8)&0xf)<<1
+	return signExtend(imm, 13)
+}
+
+// --- 32 位指令编码函数 ---
+
+// encodeR 编码 R-Type 指令。
+func encodeR(opcode, rd, funct3, rs1, rs2, funct7 uint32) uint32 {
+	return funct7<<25 | rs2<<20 | rs1<<15 | funct3<<12 | rd<<7 | opcode
+}
+
+// encodeI 编码 I-Type 指令（imm 取低 12 位）。
+func encodeI(opcode, rd, funct3, rs1, imm uint32) uint32 {
+	return (imm&0xfff)<<20 | rs1<<15 | funct3<<12 | rd<<7 | opcode
+}
+
+// encodeS 编码 S-Type 指令（imm 取低 12 位）。
+func encodeS(opcode, funct3, rs1, rs2, imm uint32) uint32 {
+	return ((imm>>5)&0x7f)<<25 | rs2<<20 | rs1<<15 | funct3<<12 | (imm&0x1f)<<7 | opcode
+}
+
+// encodeB 编码 B-Type 条件分支指令（imm 为 13 位有符号偏移）。
+func encodeB(funct3, rs1, rs2, imm uint32) uint32 {
+	return ((imm>>12)&1)<<31 | ((imm>>5)&0x3f)<<25 | rs2<<20 | rs1<<15 | funct3<<12 |
+		((imm>>1)&0xf)<<8 | ((imm>>11)&1)<<7 | OPCODE_BRANCH
+}
+
+// encodeJ 编码 JAL 指令（imm 为 21 位有符号偏移）。
+func encodeJ(rd, imm uint32) uint32 {
+	return ((imm>>20)&1)<<31 | ((imm>>1)&0x3ff)<<21 | ((imm>>11)&1)<<20 | ((imm>>12)&0xff)<<12 | rd<<7 | OPCODE_JAL
+}
+
+// encodeU 编码 U-Type 指令（imm 为已对齐到高 20 位的值）。
+func encodeU(opcode, rd, imm uint32) uint32 {
+	return imm&0xfffff000 | rd<<7 | opcode
 }
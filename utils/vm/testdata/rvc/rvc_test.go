@@ -0,0 +1,127 @@
+package rvc
+
+import (
+	"bytes"
+	"circuit/utils/vm"
+	"debug/elf"
+	"io"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"testing"
+)
+
+// runCycles 每次运行的指令数，足以让各程序执行完毕并进入末尾的死循环。
+const runCycles = 200000
+
+// programs 现有的 testdata 程序，每个目录的 Makefile 同时构建 main.elf（rv32imafd）与 main_c.elf（rv32imafdc）。
+var programs = []string{"add", "branch", "compare", "fp", "logic", "memory", "shift", "sub"}
+
+// buildELF 把程序的源码、链接脚本与 Makefile 复制到临时目录后调用 make，
+// 构建非压缩与压缩两个版本的 ELF 文件，避免与程序目录中并行运行的测试互相清理产物。
+// 返回值: 构建目录。
+func buildELF(tb testing.TB, prog string) string {
+	tb.Helper()
+	dir := tb.TempDir()
+	for _, name := range []string{"Makefile", "link.ld", "main.c"} {
+		data, err := os.ReadFile(filepath.Join("..", prog, name))
+		if err != nil {
+			tb.Fatalf("%s: 读取 %s 失败: %v", prog, name, err)
+		}
+		if err := os.WriteFile(filepath.Join(dir, name), data, 0o644); err != nil {
+			tb.Fatal(err)
+		}
+	}
+	cmd := exec.Command("make", "main.elf", "main_c.elf")
+	cmd.Dir = dir
+	if err := cmd.Run(); err != nil {
+		tb.Fatalf("%s: 构建 ELF 文件失败: %v", prog, err)
+	}
+	return dir
+}
+
+// loadELF 创建模拟器，加载 ELF 的全部 PT_LOAD 段并将 PC 设置到入口点。
+// 返回值: 模拟器与结果区域的地址范围；有 .bss 段的程序（fp）结果位于 .bss，其余位于 0x80001000 起的固定地址。
+func loadELF(tb testing.TB, name string) (v_m *vm.VmState, addr, size uint32) {
+	tb.Helper()
+	v_m = vm.NewVmState(1024 * 64)
+	elfData, err := os.ReadFile(name)
+	if err != nil {
+		tb.Fatalf("读取 ELF 文件失败: %v", err)
+	}
+	file, err := elf.NewFile(bytes.NewReader(elfData))
+	if err != nil {
+		tb.Fatalf("解析 ELF 文件失败: %v", err)
+	}
+	defer file.Close()
+	for _, prog := range file.Progs {
+		if prog.Type == elf.PT_LOAD {
+			if prog.Paddr < uint64(v_m.RamImageOffSet) {
+				tb.Fatalf("程序段地址 (0x%x) 无效", prog.Paddr)
+			}
+			memOffset := prog.Paddr - uint64(v_m.RamImageOffSet)
+			if memOffset+prog.Filesz > uint64(len(v_m.GetMemory())) {
+				tb.Fatalf("程序段对于模拟器内存来说太大了")
+			}
+			data, err := io.ReadAll(prog.Open())
+			if err != nil {
+				tb.Fatalf("读取程序段失败: %v", err)
+			}
+			copy(v_m.GetMemory()[memOffset:], data)
+		}
+	}
+	v_m.SetProgramCounter(uint32(file.Entry))
+	addr, size = 0x80001000, 0x200
+	if sec := file.Section(".bss"); sec != nil {
+		addr, size = uint32(sec.Addr), uint32(sec.Size)
+	}
+	return v_m, addr, size
+}
+
+// results 运行 ELF 文件直到进入死循环，返回结果区域的内容。
+func results(t *testing.T, name string) []byte {
+	t.Helper()
+	v_m, addr, size := loadELF(t, name)
+	_, evt := v_m.Run(runCycles)
+	if evt.Typ != vm.VmEvtTypErr || evt.Err.Errcode != vm.VmErrNone {
+		t.Fatalf("%s: 模拟器在意外的状态下停止: Evt=%v, Err=%v", name, evt.Typ, evt.Err.Errcode)
+	}
+	offset := addr - v_m.RamImageOffSet
+	return v_m.GetMemory()[offset : offset+size]
+}
+
+// TestCompressedMatchesUncompressed 验证每个程序的压缩指令版本与非压缩版本写出相同的结果，
+// 非压缩版本的结果本身由各程序目录中的测试检查。
+func TestCompressedMatchesUncompressed(t *testing.T) {
+	for _, prog := range programs {
+		t.Run(prog, func(t *testing.T) {
+			dir := buildELF(t, prog)
+			want := results(t, filepath.Join(dir, "main.elf"))
+			if got := results(t, filepath.Join(dir, "main_c.elf")); !bytes.Equal(got, want) {
+				t.Errorf("压缩版本结果 %x，非压缩版本 %x", got, want)
+			}
+		})
+	}
+}
+
+// benchmarkELF 对每个程序重复加载并运行指定构建的 ELF 文件，只统计执行部分的耗时。
+func benchmarkELF(b *testing.B, name string) {
+	for _, prog := range programs {
+		b.Run(prog, func(b *testing.B) {
+			dir := buildELF(b, prog)
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				v_m, _, _ := loadELF(b, filepath.Join(dir, name))
+				b.StartTimer()
+				v_m.Run(runCycles)
+			}
+		})
+	}
+}
+
+// BenchmarkRV32IMAFD 基准测试：现有程序的非压缩指令版本。
+func BenchmarkRV32IMAFD(b *testing.B) { benchmarkELF(b, "main.elf") }
+
+// BenchmarkRV32IMAFDC 基准测试：同一批程序的压缩指令版本，覆盖压缩指令的预展开快速路径。
+func BenchmarkRV32IMAFDC(b *testing.B) { benchmarkELF(b, "main_c.elf") }
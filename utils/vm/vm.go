@@ -41,14 +41,15 @@ type VmArg int
 
 // VmState 表示虚拟机的完整状态，包括核心、内存、I/O事件和状态标志。
 type VmState struct {
-	Memory                 // 主内存区域。
-	Status      VmStatus   // 虚拟机的当前运行状态 (例如，运行中、暂停、错误)。
-	Err         VmErr      // 如果发生错误，记录错误代码。
-	Core        VmInaState // 虚拟机核心的状态，包括寄存器和程序计数器。
-	Ioevt       VmEvt      // 当前待处理的I/O事件，如系统调用。
-	StackCanary *byte      // 栈保护金丝雀值，用于检测栈溢出（当前未使用）。
-	Garbage     uint32     // 一个丢弃值的存储位置，用于无效的指针操作。
-	lastIR      uint32     // 最近执行的指令，用于某些指令的内部状态。
+	Memory                    // 主内存区域。
+	Status      VmStatus      // 虚拟机的当前运行状态 (例如，运行中、暂停、错误)。
+	Err         VmErr         // 如果发生错误，记录错误代码。
+	Core        VmInaState    // 虚拟机核心的状态，包括寄存器和程序计数器。
+	Ioevt       VmEvt         // 当前待处理的I/O事件，如系统调用。
+	StackCanary *byte         // 栈保护金丝雀值，用于检测栈溢出（当前未使用）。
+	Garbage     uint32        // 一个丢弃值的存储位置，用于无效的指针操作。
+	lastIR      uint32        // 最近执行的指令，用于某些指令的内部状态。
+	icache      []decodedInst // 预解码指令缓存（直接映射），首次取指时分配。
 }
 
 // NewVmState 创建并初始化一个新的虚拟机状态实例。